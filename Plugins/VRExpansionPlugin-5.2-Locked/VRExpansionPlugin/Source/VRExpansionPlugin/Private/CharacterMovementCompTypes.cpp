@@ -9,11 +9,44 @@
 #include UE_INLINE_GENERATED_CPP_BY_NAME(CharacterMovementCompTypes)
 
 #include "VRBaseCharacterMovementComponent.h"
+#include "VRCharacterMovementComponent.h"
 #include "VRBPDatatypes.h"
 #include "VRBaseCharacter.h"
 #include "VRRootComponent.h"
 #include "VRPlayerController.h"
 	
+void FVRMoveActionArray::CombineMoveActions(const TArray<FVRMoveActionContainer>& InMoveActions, TArray<FVRMoveActionContainer>& OutMoveActions)
+{
+	OutMoveActions.Reset(InMoveActions.Num());
+
+	for (const FVRMoveActionContainer& MoveAction : InMoveActions)
+	{
+		if (OutMoveActions.Num() > 0)
+		{
+			FVRMoveActionContainer& LastAction = OutMoveActions.Last();
+
+			const bool bIsRotation = MoveAction.MoveAction == EVRMoveAction::VRMOVEACTION_SnapTurn || MoveAction.MoveAction == EVRMoveAction::VRMOVEACTION_SetRotation;
+			if (bIsRotation && LastAction.MoveAction == MoveAction.MoveAction &&
+				LastAction.MoveActionFlags == MoveAction.MoveActionFlags &&
+				LastAction.VelRetentionSetting == MoveAction.VelRetentionSetting)
+			{
+				// Yaw is the absolute target so the last one wins, loc only turns are offsets so they add up
+				// Velocity was already rotated in order on the client, the last value is the final one
+				if (MoveAction.MoveActionFlags & 0x04)
+				{
+					LastAction.MoveActionLoc += MoveAction.MoveActionLoc;
+				}
+
+				LastAction.MoveActionRot.Yaw = MoveAction.MoveActionRot.Yaw;
+				LastAction.MoveActionVel = MoveAction.MoveActionVel;
+				continue;
+			}
+		}
+
+		OutMoveActions.Add(MoveAction);
+	}
+}
+
 FSavedMove_VRBaseCharacter::FSavedMove_VRBaseCharacter() : FSavedMove_Character()
 {
 	VRCapsuleLocation = FVector::ZeroVector;
@@ -317,6 +350,7 @@ void FVRCharacterNetworkMoveData::ClientFillNetworkMoveData(const FSavedMove_Cha
 bool FVRCharacterNetworkMoveData::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType)
 {
 	NetworkMoveType = MoveType;
+	VR_NET_PROFILE_SCOPE(TEXT("ServerMovePacked"), CharacterMovement.GetOwner());
 
 	bool bLocalSuccess = true;
 	const bool bIsSaving = Ar.IsSaving();
@@ -422,7 +456,25 @@ bool FVRCharacterNetworkMoveData::Serialize(UCharacterMovementComponent& Charact
 	}
 
 	// Rep out our custom move settings
-	ConditionalMoveReps.NetSerialize(Ar, PackageMap, bLocalSuccess);
+	// Move actions pack teleports relative to the move location, rounded the same as its serialization so both sides match
+	const FVector MoveActionReferenceLocation(
+		FMath::RoundToDouble(Location.X * 100.0) / 100.0,
+		FMath::RoundToDouble(Location.Y * 100.0) / 100.0,
+		FMath::RoundToDouble(Location.Z * 100.0) / 100.0);
+
+#if VR_NET_PROFILER_ENABLED
+	if (bIsSaving && FVRNetProfiler::IsEnabled())
+	{
+		FVRConditionalMoveRep MeasuredMoveReps = ConditionalMoveReps;
+		FVRNetProfiler::Get().MeasureBits(TEXT("FVRConditionalMoveRep"), PackageMap, [&](FArchive& MeasureAr, UPackageMap* MeasureMap)
+		{
+			bool bMeasureSuccess = true;
+			MeasuredMoveReps.NetSerialize(MeasureAr, MeasureMap, bMeasureSuccess, MoveActionReferenceLocation);
+		});
+	}
+#endif
+
+	ConditionalMoveReps.NetSerialize(Ar, PackageMap, bLocalSuccess, MoveActionReferenceLocation);
 
 	//VRCapsuleLocation.NetSerialize(Ar, PackageMap, bLocalSuccess);
 	if (AVRBaseCharacter* VRChar = Cast<AVRBaseCharacter>(CharacterOwner))
@@ -458,6 +510,150 @@ void FVRCharacterMoveResponseDataContainer::ServerFillResponseData(const UCharac
 		//bHasRotation = CharacterMovement.ShouldCorrectRotation();
 		bHasRotation = !BaseMovecomp->bUseClientControlRotation;
 	}
+
+	bHasCompactCorrection = false;
+	CorrectionDelta = FVector::ZeroVector;
+
+	if (IsGoodMove() || bRootMotionMontageCorrection || bRootMotionSourceCorrection || PendingAdjustment.bBaseRelativePosition)
+		return;
+
+	if (const UVRCharacterMovementComponent* VRMovecomp = Cast<const UVRCharacterMovementComponent>(&CharacterMovement))
+	{
+		if (!VRMovecomp->bUseServerMoveHistory)
+			return;
+
+		const FNetworkPredictionData_Server_VRCharacter* ServerData = static_cast<const FNetworkPredictionData_Server_VRCharacter*>(VRMovecomp->GetPredictionData_Server_Character());
+
+		// Only valid if the client sent an absolute location for this exact move, it resolves the delta against that saved move
+		if (ServerData && ServerData->bPendingAdjustmentHasClientLocation && ServerData->PendingAdjustmentClientTimeStamp == PendingAdjustment.TimeStamp)
+		{
+			const FVector Delta = PendingAdjustment.NewLoc - ServerData->PendingAdjustmentClientLocation;
+			if (Delta.GetAbsMax() <= VRMovecomp->MaxCompactCorrectionDelta)
+			{
+				CorrectionDelta = Delta;
+				bHasCompactCorrection = true;
+			}
+		}
+	}
+}
+
+bool FVRCharacterMoveResponseDataContainer::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap)
+{
+	VR_NET_PROFILE_SCOPE(TEXT("ClientMoveResponsePacked"), CharacterMovement.GetOwner());
+
+#if VR_NET_PROFILER_ENABLED
+	if (Ar.IsSaving() && FVRNetProfiler::IsEnabled())
+	{
+		FVRNetProfiler::Get().MeasureBits(bHasCompactCorrection ? TEXT("MoveResponse_CompactCorrection") : (IsGoodMove() ? TEXT("MoveResponse_GoodMove") : TEXT("MoveResponse_Correction")), PackageMap, [&](FArchive& MeasureAr, UPackageMap* MeasureMap)
+		{
+			Serialize(CharacterMovement, MeasureAr, MeasureMap);
+		});
+	}
+#endif
+
+	Ar.SerializeBits(&bHasCompactCorrection, 1);
+
+	if (!bHasCompactCorrection)
+	{
+		return FCharacterMoveResponseDataContainer::Serialize(CharacterMovement, Ar, PackageMap);
+	}
+
+	bool bLocalSuccess = true;
+	const bool bIsSaving = Ar.IsSaving();
+
+	Ar << ClientAdjustment.TimeStamp;
+	Ar.SerializeBits(&bHasBase, 1);
+	Ar.SerializeBits(&bHasRotation, 1);
+
+	bLocalSuccess &= SerializePackedVector<100, 20>(CorrectionDelta, Ar);
+	bLocalSuccess &= SerializePackedVector<100, 30>(ClientAdjustment.NewVel, Ar);
+
+	if (bHasRotation)
+	{
+		ClientAdjustment.NewRot.SerializeCompressedShort(Ar);
+	}
+	else if (!bIsSaving)
+	{
+		ClientAdjustment.NewRot = FRotator::ZeroRotator;
+	}
+
+	if (bHasBase)
+	{
+		Ar << ClientAdjustment.NewBase;
+		SerializeOptionalValue<FName>(bIsSaving, Ar, ClientAdjustment.NewBaseBoneName, NAME_None);
+	}
+	else if (!bIsSaving)
+	{
+		ClientAdjustment.NewBase = nullptr;
+		ClientAdjustment.NewBaseBoneName = NAME_None;
+	}
+
+	SerializeOptionalValue<uint8>(bIsSaving, Ar, ClientAdjustment.MovementMode, MOVE_Walking);
+
+	if (!bIsSaving)
+	{
+		// Compact corrections are only ever absolute position corrections, NewLoc is resolved against the saved move on the client
+		ClientAdjustment.bAckGoodMove = false;
+		ClientAdjustment.bBaseRelativePosition = false;
+		ClientAdjustment.bBaseRelativeVelocity = false;
+		ClientAdjustment.NewLoc = FVector::ZeroVector;
+		bRootMotionMontageCorrection = false;
+		bRootMotionSourceCorrection = false;
+	}
+
+	return bLocalSuccess && !Ar.IsError();
+}
+
+void FVRServerMoveHistory::Init(int32 InCapacity)
+{
+	States.SetNum(FMath::Max(InCapacity, 1));
+	Reset();
+}
+
+void FVRServerMoveHistory::Reset()
+{
+	Head = 0;
+	NumStates = 0;
+}
+
+void FVRServerMoveHistory::Add(const FVRServerMoveState& NewState)
+{
+	if (States.Num() < 1)
+	{
+		return;
+	}
+
+	States[Head] = NewState;
+	Head = (Head + 1) % States.Num();
+	NumStates = FMath::Min(NumStates + 1, States.Num());
+}
+
+const FVRServerMoveState* FVRServerMoveHistory::FindStateAtTime(float TimeStamp) const
+{
+	for (int32 i = 0; i < NumStates; ++i)
+	{
+		const FVRServerMoveState& State = GetFromNewest(i);
+		if (State.TimeStamp <= TimeStamp)
+		{
+			return &State;
+		}
+	}
+
+	return nullptr;
+}
+
+const FVRServerMoveState* FVRServerMoveHistory::FindLastCorrection() const
+{
+	for (int32 i = 0; i < NumStates; ++i)
+	{
+		const FVRServerMoveState& State = GetFromNewest(i);
+		if (State.bSentCorrection)
+		{
+			return &State;
+		}
+	}
+
+	return nullptr;
 }
 
 FScopedMeshBoneUpdateOverrideVR::FScopedMeshBoneUpdateOverrideVR(USkeletalMeshComponent* Mesh, EKinematicBonesUpdateToPhysics::Type OverrideSetting)
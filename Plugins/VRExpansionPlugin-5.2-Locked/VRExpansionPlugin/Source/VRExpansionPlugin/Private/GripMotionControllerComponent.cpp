@@ -4761,7 +4761,10 @@ void UGripMotionControllerComponent::UpdateTracking(float DeltaTime)
 							(OwningChar->* (OverrideSendTransform))(ReplicatedControllerTransform);
 						}
 						else
+						{
+							VR_NET_PROFILE_SCOPE(TEXT("Server_SendControllerTransform"), GetOwner());
 							Server_SendControllerTransform(ReplicatedControllerTransform);
+						}
 					}
 				}
 			}
@@ -11,6 +11,7 @@
 #include "GripMotionControllerComponent.h"
 #include "VRExpansionFunctionLibrary.h"
 #include "Misc/BucketUpdateSubsystem.h"
+#include "VRPlayerController.h"
 #include "GripScripts/VRGripScriptBase.h"
 #include "DrawDebugHelpers.h"
 
@@ -462,6 +463,7 @@ bool AGrippableActor::RemoveFromClientReplicationBucket()
 	if (ClientAuthReplicationData.bIsCurrentlyClientAuth)
 	{
 		GetWorld()->GetSubsystem<UBucketUpdateSubsystem>()->RemoveObjectFromBucketByFunctionName(this, FName(TEXT("PollReplicationEvent")));
+		GetWorld()->GetSubsystem<UBucketUpdateSubsystem>()->RemoveThrownObject(this);
 		CeaseReplicationBlocking();
 		return true;
 	}
@@ -560,7 +562,11 @@ bool AGrippableActor::PollReplicationEvent()
 					FRepMovementVR ClientAuthMovementRep;
 					if (ClientAuthMovementRep.GatherActorsMovement(this))
 					{
-						Server_GetClientAuthReplication(ClientAuthMovementRep);
+						// Batched with the rest of our connections thrown objects if possible
+						if (!OurWorld->GetSubsystem<UBucketUpdateSubsystem>()->QueueThrownObjectMovement(this, ClientAuthMovementRep))
+						{
+							Server_GetClientAuthReplication(ClientAuthMovementRep);
+						}
 
 						if (PrimComp->RigidBodyIsAwake())
 						{
@@ -618,6 +624,8 @@ bool AGrippableActor::PollReplicationEvent()
 		CeaseReplicationBlocking();
 	}
 
+	OurWorld->GetSubsystem<UBucketUpdateSubsystem>()->RemoveThrownObject(this);
+
 	// Tell server to kill us
 	Server_EndClientAuthReplication();
 	return false; // Tell the bucket subsystem to remove us from consideration
@@ -663,6 +671,9 @@ bool AGrippableActor::Server_EndClientAuthReplication_Validate()
 
 void AGrippableActor::Server_EndClientAuthReplication_Implementation()
 {
+	// The next throw starts from a new keyframe
+	AVRBasePlayerController::EndThrownObject(this);
+
 	if (UWorld* World = GetWorld())
 	{
 		if (FPhysScene* PhysScene = World->GetPhysicsScene())
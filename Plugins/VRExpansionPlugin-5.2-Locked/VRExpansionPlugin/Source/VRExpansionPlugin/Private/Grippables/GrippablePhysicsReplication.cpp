@@ -11,9 +11,10 @@
 #include "PBDRigidsSolver.h"
 #include "Chaos/PBDRigidsEvolutionGBF.h"
 #include "VRGlobalSettings.h"
+#include "Misc/VRNetProfiler.h"
 #include "PhysicsEngine/PhysicsSettings.h"
 #include "Physics/Experimental/PhysScene_Chaos.h"
-//#include "Components/SkeletalMeshComponent.h"
+#include "Components/SkeletalMeshComponent.h"
 #include "Misc/ScopeRWLock.h"
 
 #include "GameFramework/PlayerController.h"
@@ -545,17 +546,110 @@ bool FPhysicsReplicationVR::ApplyRigidBodyState(float DeltaSeconds, FBodyInstanc
 	return bRestoredState;
 }
 
+bool FPhysicsReplicationVR::IsServerReplication() const
+{
+	if (const UWorld* World = GetOwningWorld())
+	{
+		return World->GetNetMode() != ENetMode::NM_Client;
+	}
+
+	return true;
+}
+
+FReplicatedBodyVR& FPhysicsReplicationVR::FindOrAddReplicatedBody(UPrimitiveComponent* Component, const FVector& InitialPosition)
+{
+	TWeakObjectPtr<UPrimitiveComponent> TargetKey(Component);
+	if (const int32* ExistingIndex = ReplicatedBodyIndices.Find(TargetKey))
+	{
+		return ReplicatedBodies[*ExistingIndex];
+	}
+
+	// First time, add a target
+	const int32 NewIndex = ReplicatedBodies.Add(FReplicatedBodyVR());
+	ReplicatedBodyIndices.Add(TargetKey, NewIndex);
+
+	FReplicatedBodyVR& NewBody = ReplicatedBodies[NewIndex];
+	NewBody.Component = TargetKey;
+	NewBody.PhysicsTarget.PrevPosTarget = InitialPosition;
+	NewBody.PhysicsTarget.PrevPos = InitialPosition;
+	return NewBody;
+}
+
+void FPhysicsReplicationVR::ResolveReplicatedBody(FReplicatedBodyVR& Body, UPrimitiveComponent* Component)
+{
+	// Resolved here instead of on tick, targets are re-set on every client update so these never get very stale
+	Body.BodyInstance = Component->GetBodyInstance(Body.PhysicsTarget.BoneName);
+	Body.bIsSkeletal = Cast<USkeletalMeshComponent>(Component) != nullptr;
+	Body.bResolveBodyOnTick = Body.bIsSkeletal || Component->IsWelded();
+
+	AActor* OwningActor = Component->GetOwner();
+	Body.OwningPlayer = OwningActor ? OwningActor->GetNetOwningPlayer() : nullptr;
+
+	Body.ErrorCorrection = UPhysicsSettings::Get()->PhysicErrorCorrection;
+}
+
+void FPhysicsReplicationVR::RemoveReplicatedBodyAt(int32 Index)
+{
+	ReplicatedBodyIndices.Remove(ReplicatedBodies[Index].Component);
+	ReplicatedBodies.RemoveAt(Index);
+}
+
+void FPhysicsReplicationVR::SetReplicatedTarget(UPrimitiveComponent* Component, FName BoneName, const FRigidBodyState& ReplicatedTarget, int32 ServerFrame)
+{
+	// Clients use the default replication path
+	if (!IsServerReplication())
+	{
+		FPhysicsReplication::SetReplicatedTarget(Component, BoneName, ReplicatedTarget, ServerFrame);
+		return;
+	}
+
+	UWorld* OwningWorld = GetOwningWorld();
+	if (!OwningWorld || !Component)
+	{
+		return;
+	}
+
+	FReplicatedBodyVR& Body = FindOrAddReplicatedBody(Component, ReplicatedTarget.Position);
+
+	FReplicatedPhysicsTarget& Target = Body.PhysicsTarget;
+	Target.TargetState = ReplicatedTarget;
+	Target.BoneName = BoneName;
+	Target.ArrivedTimeSeconds = OwningWorld->GetTimeSeconds();
+	Target.ServerFrame = ServerFrame;
+
+	ResolveReplicatedBody(Body, Component);
+
+	ensure(!Target.PrevPos.ContainsNaN());
+	ensure(!Target.PrevPosTarget.ContainsNaN());
+	ensure(!Target.TargetState.Position.ContainsNaN());
+}
+
+void FPhysicsReplicationVR::RemoveReplicatedTarget(UPrimitiveComponent* Component)
+{
+	if (const int32* ExistingIndex = ReplicatedBodyIndices.Find(TWeakObjectPtr<UPrimitiveComponent>(Component)))
+	{
+		RemoveReplicatedBodyAt(*ExistingIndex);
+	}
+
+	FPhysicsReplication::RemoveReplicatedTarget(Component);
+}
+
 void FPhysicsReplicationVR::OnTick(float DeltaSeconds, TMap<TWeakObjectPtr<UPrimitiveComponent>, FReplicatedPhysicsTarget>& ComponentsToTargets)
 {
 	// Skip all of the custom logic if we aren't the server
-	if (const UWorld* World = GetOwningWorld())
+	if (!IsServerReplication())
 	{
-		if (World->GetNetMode() == ENetMode::NM_Client)
-		{
-			return FPhysicsReplication::OnTick(DeltaSeconds, ComponentsToTargets);
-		}
+		return FPhysicsReplication::OnTick(DeltaSeconds, ComponentsToTargets);
 	}
 
+	OnTickServer(DeltaSeconds, ComponentsToTargets);
+
+	//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, TEXT("Phys Rep Tick!"));
+	//FPhysicsReplication::OnTick(DeltaSeconds, ComponentsToTargets);
+}
+
+void FPhysicsReplicationVR::OnTickServer(float DeltaSeconds, TMap<TWeakObjectPtr<UPrimitiveComponent>, FReplicatedPhysicsTarget>& ComponentsToTargets)
+{
 	using namespace Chaos;
 	if (AsyncCallbackServer == nullptr)
 	{
@@ -565,141 +659,104 @@ void FPhysicsReplicationVR::OnTick(float DeltaSeconds, TMap<TWeakObjectPtr<UPrim
 		}
 	}
 
-	using namespace Chaos;
-
-
-	int32 LocalFrameOffset = 0;		// LocalFrame = ServerFrame + LocalFrameOffset;
-	int32 NumPredictedFrames = 0;	// How many frames "ahead" of the server we are predicting. That is, how many frames are in flight between us and the server.
-
-	if (UWorld* World = GetOwningWorld())
+	// Anything that landed in the engine map (set before we became the server) gets moved over into our registry
+	if (ComponentsToTargets.Num() > 0)
 	{
-		if (World->GetNetMode() == NM_Client)
+		for (TPair<TWeakObjectPtr<UPrimitiveComponent>, FReplicatedPhysicsTarget>& TargetPair : ComponentsToTargets)
 		{
-			if (APlayerController* PlayerController = World->GetFirstPlayerController())
+			if (UPrimitiveComponent* PrimComp = TargetPair.Key.Get())
 			{
-				Chaos::FPhysicsSolver* Solver = PhysSceneVR->GetSolver();
-				check(Solver);
-
-				static IConsoleVariable* EnableNetworkPhysicsCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("np2.EnableNetworkPhysicsPrediction"));
-				if (EnableNetworkPhysicsCVar && EnableNetworkPhysicsCVar->GetInt() == 1)
-				{
-					LocalFrameOffset = PlayerController->GetLocalToServerAsyncPhysicsTickOffset();
-				}
-				//TODO: as we send physics updates down we need to record latest seen
-				//NumPredictedFrames = Solver->GetCurrentFrame() - ClientFrameInfo.LastProcessedInputFrame;
+				FReplicatedBodyVR& Body = FindOrAddReplicatedBody(PrimComp, TargetPair.Value.PrevPos);
+				Body.PhysicsTarget = TargetPair.Value;
+				ResolveReplicatedBody(Body, PrimComp);
 			}
 		}
+
+		ComponentsToTargets.Empty();
+	}
+
+	if (ReplicatedBodies.Num() < 1)
+	{
+		return;
 	}
 
-	const FRigidBodyErrorCorrection& PhysicErrorCorrection = UPhysicsSettings::Get()->PhysicErrorCorrection;
+	// We are always the server here, clients were filtered out to the default logic, so there is no local frame offset
+	// or predicted frames to account for.
+	const int32 LocalFrameOffset = 0;		// LocalFrame = ServerFrame + LocalFrameOffset;
+	const int32 NumPredictedFrames = 0;		// How many frames "ahead" of the server we are predicting.
+
+	// Get the total ping - this approximates the time since the update was
+	// actually generated on the machine that is doing the authoritative sim.
+	const float PingSecondsOneWay = 0.0f;
 
 	if (AsyncCallbackServer)
 	{
-		PrepareAsyncData_ExternalVR(PhysicErrorCorrection);
+		PrepareAsyncData_ExternalVR(UPhysicsSettings::Get()->PhysicErrorCorrection);
+
+		// Every body can at most push one desired state, size the buffer once for the whole pass
+		CurAsyncDataVR->Buffer.Reserve(CurAsyncDataVR->Buffer.Num() + ReplicatedBodies.Num());
 	}
 
-	// Get the ping between this PC & the server
-	const float LocalPing = 0.0f;//GetLocalPing();
+	//simulated skeletal mesh does its own polling of physics results so we don't need to sync it as it'll happen at the end of the physics sim
+	static const auto CVarSkipSkeletalRepOptimization = IConsoleManager::Get().FindConsoleVariable(TEXT("p.SkipSkeletalRepOptimization"));
+	const bool bSyncSkeletalMeshes = CVarSkipSkeletalRepOptimization->GetInt() == 0;
 
-	/*float CurrentTimeSeconds = 0.0f;
+	PendingBodyRemovals.Reset();
 
-	if (UWorld* OwningWorld = GetOwningWorld())
+	for (auto Itr = ReplicatedBodies.CreateIterator(); Itr; ++Itr)
 	{
-		CurrentTimeSeconds = OwningWorld->GetTimeSeconds();
-	}*/
+		FReplicatedBodyVR& Body = *Itr;
+		UPrimitiveComponent* PrimComp = Body.Component.Get();
 
-	for (auto Itr = ComponentsToTargets.CreateIterator(); Itr; ++Itr)
-	{
+		// Remove if the component is gone or there is no owner connection anymore
+		if (!PrimComp || !Body.OwningPlayer.IsValid())
+		{
+			PendingBodyRemovals.Add(Itr.GetIndex());
+			continue;
+		}
 
-		// Its been more than half a second since the last update, lets cease using the target as a failsafe
-		// Clients will never update with that much latency, and if they somehow are, then they are dropping so many
-		// packets that it will be useless to use their data anyway
-		/*if ((CurrentTimeSeconds - Itr.Value().ArrivedTimeSeconds) > 0.5f)
+		if (Body.bResolveBodyOnTick)
 		{
-			OnTargetRestored(Itr.Key().Get(), Itr.Value());
-			Itr.RemoveCurrent();
+			Body.BodyInstance = PrimComp->GetBodyInstance(Body.PhysicsTarget.BoneName);
 		}
-		else */if (UPrimitiveComponent* PrimComp = Itr.Key().Get())
+
+		if (!Body.BodyInstance)
 		{
-			bool bRemoveItr = false;
+			continue;
+		}
 
-			if (FBodyInstance* BI = PrimComp->GetBodyInstance(Itr.Value().BoneName))
-			{
-				FReplicatedPhysicsTarget& PhysicsTarget = Itr.Value();
-				FRigidBodyState& UpdatedState = PhysicsTarget.TargetState;
-				bool bUpdated = false;
-				if (AActor* OwningActor = PrimComp->GetOwner())
-				{
+		FReplicatedPhysicsTarget& PhysicsTarget = Body.PhysicsTarget;
+		const FRigidBodyState& UpdatedState = PhysicsTarget.TargetState;
 
-					// Remove if there is no owner
-					if (!OwningActor->GetNetOwningPlayer())
-					{
-						bRemoveItr = true;
-					}
-					else
-					{
-						// Removed as this is server sided
-						/*const ENetRole OwnerRole = OwningActor->GetLocalRole();
-						const bool bIsSimulated = OwnerRole == ROLE_SimulatedProxy;
-						const bool bIsReplicatedAutonomous = OwnerRole == ROLE_AutonomousProxy && PrimComp->bReplicatePhysicsToAutonomousProxy;
-						if (bIsSimulated || bIsReplicatedAutonomous)*/
-
-
-						// Deleted everything here, we will always be the server, I already filtered out clients to default logic
-						{
-							/*const*/ float OwnerPing = 0.0f;// GetOwnerPing(OwningActor, PhysicsTarget);
-
-							/*if (UPlayer* OwningPlayer = OwningActor->GetNetOwningPlayer())
-							{
-								if (APlayerController* PlayerController = OwningPlayer->GetPlayerController(nullptr))
-								{
-									if (APlayerState* PlayerState = PlayerController->PlayerState)
-									{
-										OwnerPing = PlayerState->ExactPing;
-									}
-								}
-							}*/
-
-							// Get the total ping - this approximates the time since the update was
-							// actually generated on the machine that is doing the authoritative sim.
-							// NOTE: We divide by 2 to approximate 1-way ping from 2-way ping.
-							const float PingSecondsOneWay = 0.0f;// (LocalPing + OwnerPing) * 0.5f * 0.001f;
-
-
-							if (UpdatedState.Flags & ERigidBodyFlags::NeedsUpdate)
-							{
-								const int32 LocalFrame = PhysicsTarget.ServerFrame + LocalFrameOffset;
-								const bool bRestoredState = ApplyRigidBodyState(DeltaSeconds, BI, PhysicsTarget, PhysicErrorCorrection, PingSecondsOneWay, LocalFrame, NumPredictedFrames);
-
-								// Need to update the component to match new position.
-								static const auto CVarSkipSkeletalRepOptimization = IConsoleManager::Get().FindConsoleVariable(TEXT("p.SkipSkeletalRepOptimization"));
-								if (/*PhysicsReplicationCVars::SkipSkeletalRepOptimization*/CVarSkipSkeletalRepOptimization->GetInt() == 0 || Cast<USkeletalMeshComponent>(PrimComp) == nullptr)	//simulated skeletal mesh does its own polling of physics results so we don't need to call this as it'll happen at the end of the physics sim
-								{
-									PrimComp->SyncComponentToRBPhysics();
-								}
-
-								// Added a sleeping check from the input state as well, we always want to cease activity on sleep
-								if (bRestoredState || ((UpdatedState.Flags & ERigidBodyFlags::Sleeping) != 0))
-								{
-									bRemoveItr = true;
-								}
-							}
-						}
-					}
-				}
+		if (UpdatedState.Flags & ERigidBodyFlags::NeedsUpdate)
+		{
+			const int32 LocalFrame = PhysicsTarget.ServerFrame + LocalFrameOffset;
+			const bool bRestoredState = ApplyRigidBodyState(DeltaSeconds, Body.BodyInstance, PhysicsTarget, Body.ErrorCorrection, PingSecondsOneWay, LocalFrame, NumPredictedFrames);
+
+			// Need to update the component to match new position.
+			if (bSyncSkeletalMeshes || !Body.bIsSkeletal)
+			{
+				PrimComp->SyncComponentToRBPhysics();
 			}
 
-			if (bRemoveItr)
+			// Added a sleeping check from the input state as well, we always want to cease activity on sleep
+			if (bRestoredState || ((UpdatedState.Flags & ERigidBodyFlags::Sleeping) != 0))
 			{
-				OnTargetRestored(Itr.Key().Get(), Itr.Value());
-				Itr.RemoveCurrent();
+				PendingBodyRemovals.Add(Itr.GetIndex());
 			}
 		}
 	}
+
 	CurAsyncDataVR = nullptr;
 
-	//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, TEXT("Phys Rep Tick!"));
-	//FPhysicsReplication::OnTick(DeltaSeconds, ComponentsToTargets);
+	for (const int32 RemovalIndex : PendingBodyRemovals)
+	{
+		const FReplicatedBodyVR& Body = ReplicatedBodies[RemovalIndex];
+		OnTargetRestored(Body.Component.Get(), Body.PhysicsTarget);
+		RemoveReplicatedBodyAt(RemovalIndex);
+	}
+
+	PendingBodyRemovals.Reset();
 }
 
 FRepMovementVR::FRepMovementVR() : FRepMovement()
@@ -736,6 +793,93 @@ bool FRepMovementVR::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bO
 	return FRepMovement::NetSerialize(Ar, Map, bOutSuccess);
 }
 
+bool FVRThrownObjectSample::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	bOutSuccess = true;
+
+	UObject* ActorObject = ThrownActor;
+	bOutSuccess &= Map->SerializeObject(Ar, AActor::StaticClass(), ActorObject);
+
+	if (Ar.IsLoading())
+	{
+		ThrownActor = Cast<AActor>(ActorObject);
+	}
+
+	Ar << Sequence;
+
+	uint8 bKeyframe = bIsKeyframe;
+	Ar.SerializeBits(&bKeyframe, 1);
+
+	uint8 bSleeping = Movement.bSimulatedPhysicSleep;
+	Ar.SerializeBits(&bSleeping, 1);
+
+	uint8 bRepPhysics = Movement.bRepPhysics;
+	Ar.SerializeBits(&bRepPhysics, 1);
+
+	if (Ar.IsLoading())
+	{
+		bIsKeyframe = bKeyframe != 0;
+		Movement.bSimulatedPhysicSleep = bSleeping != 0;
+		Movement.bRepPhysics = bRepPhysics != 0;
+	}
+
+	// Deltas are small between samples, the packed vector will only write the bits that it needs
+	if (bIsKeyframe)
+	{
+		bOutSuccess &= SerializePackedVector<100, 30>(Movement.Location, Ar);
+	}
+	else
+	{
+		bOutSuccess &= SerializePackedVector<100, 20>(Movement.Location, Ar);
+	}
+
+	Movement.Rotation.SerializeCompressedShort(Ar);
+
+	// A sleeping body has no velocity to send
+	if (!Movement.bSimulatedPhysicSleep)
+	{
+		bOutSuccess &= SerializePackedVector<100, 30>(Movement.LinearVelocity, Ar);
+		bOutSuccess &= SerializePackedVector<100, 30>(Movement.AngularVelocity, Ar);
+	}
+	else if (Ar.IsLoading())
+	{
+		Movement.LinearVelocity = FVector::ZeroVector;
+		Movement.AngularVelocity = FVector::ZeroVector;
+	}
+
+	return bOutSuccess;
+}
+
+bool FVRThrownObjectBatch::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	VR_NET_PROFILE_STRUCT(FVRThrownObjectBatch, Ar, Map);
+
+	bOutSuccess = true;
+
+	uint32 NumSamples = FMath::Min(Samples.Num(), MaxSamplesPerBatch);
+	Ar.SerializeIntPacked(NumSamples);
+
+	if (Ar.IsLoading())
+	{
+		if (NumSamples > (uint32)MaxSamplesPerBatch)
+		{
+			bOutSuccess = false;
+			return false;
+		}
+
+		Samples.SetNum(NumSamples);
+	}
+
+	for (uint32 i = 0; i < NumSamples; ++i)
+	{
+		bool bSampleSuccess = true;
+		Samples[i].NetSerialize(Ar, Map, bSampleSuccess);
+		bOutSuccess &= bSampleSuccess;
+	}
+
+	return bOutSuccess;
+}
+
 bool FRepMovementVR::GatherActorsMovement(AActor* OwningActor)
 {
 	//if (/*bReplicateMovement || (RootComponent && RootComponent->GetAttachParent())*/)
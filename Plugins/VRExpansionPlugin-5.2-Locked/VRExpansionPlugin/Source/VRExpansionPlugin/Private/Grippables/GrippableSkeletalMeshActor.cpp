@@ -9,6 +9,7 @@
 #include "GripMotionControllerComponent.h"
 #include "VRExpansionFunctionLibrary.h"
 #include "Misc/BucketUpdateSubsystem.h"
+#include "VRPlayerController.h"
 #include "Net/UnrealNetwork.h"
 #include "PhysicsReplication.h"
 #include "Physics/Experimental/PhysScene_Chaos.h"
@@ -431,6 +432,7 @@ bool AGrippableSkeletalMeshActor::RemoveFromClientReplicationBucket()
 	if (ClientAuthReplicationData.bIsCurrentlyClientAuth)
 	{
 		GetWorld()->GetSubsystem<UBucketUpdateSubsystem>()->RemoveObjectFromBucketByFunctionName(this, FName(TEXT("PollReplicationEvent")));
+		GetWorld()->GetSubsystem<UBucketUpdateSubsystem>()->RemoveThrownObject(this);
 		CeaseReplicationBlocking();
 		return true;
 	}
@@ -529,7 +531,11 @@ bool AGrippableSkeletalMeshActor::PollReplicationEvent()
 					FRepMovementVR ClientAuthMovementRep;
 					if (ClientAuthMovementRep.GatherActorsMovement(this))
 					{
-						Server_GetClientAuthReplication(ClientAuthMovementRep);
+						// Batched with the rest of our connections thrown objects if possible
+						if (!OurWorld->GetSubsystem<UBucketUpdateSubsystem>()->QueueThrownObjectMovement(this, ClientAuthMovementRep))
+						{
+							Server_GetClientAuthReplication(ClientAuthMovementRep);
+						}
 
 						if (PrimComp->RigidBodyIsAwake())
 						{
@@ -587,6 +593,8 @@ bool AGrippableSkeletalMeshActor::PollReplicationEvent()
 		CeaseReplicationBlocking();
 	}
 
+	OurWorld->GetSubsystem<UBucketUpdateSubsystem>()->RemoveThrownObject(this);
+
 	// Tell server to kill us
 	Server_EndClientAuthReplication();
 	return false; // Tell the bucket subsystem to remove us from consideration
@@ -631,6 +639,9 @@ bool AGrippableSkeletalMeshActor::Server_EndClientAuthReplication_Validate()
 
 void AGrippableSkeletalMeshActor::Server_EndClientAuthReplication_Implementation()
 {
+	// The next throw starts from a new keyframe
+	AVRBasePlayerController::EndThrownObject(this);
+
 	if (UWorld* World = GetWorld())
 	{
 		if (FPhysScene* PhysScene = World->GetPhysicsScene())
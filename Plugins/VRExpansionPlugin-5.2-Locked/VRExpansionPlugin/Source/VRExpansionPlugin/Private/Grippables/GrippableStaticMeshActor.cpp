@@ -9,6 +9,7 @@
 #include "GripMotionControllerComponent.h"
 #include "VRExpansionFunctionLibrary.h"
 #include "Misc/BucketUpdateSubsystem.h"
+#include "VRPlayerController.h"
 #include "Net/UnrealNetwork.h"
 #include "PhysicsReplication.h"
 #include "GripScripts/VRGripScriptBase.h"
@@ -456,6 +457,7 @@ bool AGrippableStaticMeshActor::RemoveFromClientReplicationBucket()
 	if (ClientAuthReplicationData.bIsCurrentlyClientAuth)
 	{
 		GetWorld()->GetSubsystem<UBucketUpdateSubsystem>()->RemoveObjectFromBucketByFunctionName(this, FName(TEXT("PollReplicationEvent")));
+		GetWorld()->GetSubsystem<UBucketUpdateSubsystem>()->RemoveThrownObject(this);
 		CeaseReplicationBlocking();
 		return true;
 	}
@@ -549,7 +551,11 @@ bool AGrippableStaticMeshActor::PollReplicationEvent()
 					FRepMovementVR ClientAuthMovementRep;
 					if (ClientAuthMovementRep.GatherActorsMovement(this))
 					{
-						Server_GetClientAuthReplication(ClientAuthMovementRep);
+						// Batched with the rest of our connections thrown objects if possible
+						if (!OurWorld->GetSubsystem<UBucketUpdateSubsystem>()->QueueThrownObjectMovement(this, ClientAuthMovementRep))
+						{
+							Server_GetClientAuthReplication(ClientAuthMovementRep);
+						}
 
 						if (PrimComp->RigidBodyIsAwake())
 						{
@@ -607,6 +613,8 @@ bool AGrippableStaticMeshActor::PollReplicationEvent()
 		CeaseReplicationBlocking();
 	}
 
+	OurWorld->GetSubsystem<UBucketUpdateSubsystem>()->RemoveThrownObject(this);
+
 	// Tell server to kill us
 	Server_EndClientAuthReplication();
 	return false; // Tell the bucket subsystem to remove us from consideration
@@ -651,6 +659,9 @@ bool AGrippableStaticMeshActor::Server_EndClientAuthReplication_Validate()
 
 void AGrippableStaticMeshActor::Server_EndClientAuthReplication_Implementation()
 {
+	// The next throw starts from a new keyframe
+	AVRBasePlayerController::EndThrownObject(this);
+
 	if (UWorld* World = GetWorld())
 	{
 		if (FPhysScene* PhysScene = World->GetPhysicsScene())
@@ -10,6 +10,7 @@
 #include "Animation/AnimData/AnimDataModel.h"
 //#include "VRExpansionFunctionLibrary.h"
 #include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkinnedAsset.h"
 #include "Components/PoseableMeshComponent.h"
 #include "GripMotionControllerComponent.h"
 //#include "VRGripInterface.h"
@@ -24,6 +25,45 @@ const FGuid FVRHandSocketCustomVersion::GUID(0x5A018B7F, 0x48A7AFDE, 0xAFBEB580,
 // Register the custom version with core
 FCustomVersionRegistration GRegisterHandSocketCustomVersion(FVRHandSocketCustomVersion::GUID, FVRHandSocketCustomVersion::LatestVersion, TEXT("HandSocketVer"));
 
+namespace HandSocketPoseHelpers
+{
+	// Swaps the _r and _l postfixes of a bone name
+	static FName GetMirroredBoneName(const FName& BoneName)
+	{
+		FString bName = BoneName.ToString();
+
+		if (bName.Contains("_r"))
+		{
+			bName = bName.Replace(TEXT("_r"), TEXT("_l"));
+		}
+		else
+		{
+			bName = bName.Replace(TEXT("_l"), TEXT("_r"));
+		}
+
+		return FName(bName);
+	}
+
+	// Inverse of the track map so that each bone doesn't have to scan it
+	static void BuildBoneToTrackMap(const TArray<FTrackToSkeletonMap>& TrackMap, int32 NumBones, TArray<int32>& OutBoneToTrack)
+	{
+		OutBoneToTrack.Init(INDEX_NONE, NumBones);
+
+		for (int32 TrackIndex = 0; TrackIndex < TrackMap.Num(); ++TrackIndex)
+		{
+			const int32 BoneIndex = TrackMap[TrackIndex].BoneTreeIndex;
+			if (BoneIndex < 0 || BoneIndex >= NumBones)
+				continue;
+
+			// Tracks normally line up with their bone, prefer that one, otherwise take the first track for the bone
+			if (BoneIndex == TrackIndex || OutBoneToTrack[BoneIndex] == INDEX_NONE)
+			{
+				OutBoneToTrack[BoneIndex] = TrackIndex;
+			}
+		}
+	}
+}
+
 
 void UHandSocketComponent::Serialize(FArchive& Ar)
 {
@@ -108,18 +148,7 @@ bool UHandSocketComponent::GetAnimationSequenceAsPoseSnapShot(UAnimSequence* InA
 				OutPoseSnapShot.BoneNames[i] = AnimationSkele->GetReferenceSkeleton().GetBoneName(i);
 				if (bFlipHand)
 				{
-					FString bName = OutPoseSnapShot.BoneNames[i].ToString();
-
-					if (bName.Contains("_r"))
-					{
-						bName = bName.Replace(TEXT("_r"), TEXT("_l"));
-					}
-					else
-					{
-						bName = bName.Replace(TEXT("_l"), TEXT("_r"));
-					}
-
-					OutPoseSnapShot.BoneNames[i] = FName(bName);
+					OutPoseSnapShot.BoneNames[i] = HandSocketPoseHelpers::GetMirroredBoneName(OutPoseSnapShot.BoneNames[i]);
 				}
 			}
 		}
@@ -134,6 +163,9 @@ bool UHandSocketComponent::GetAnimationSequenceAsPoseSnapShot(UAnimSequence* InA
 		const TArray<FTrackToSkeletonMap>& TrackMap = InAnimationSequence->GetCompressedTrackToSkeletonMapTable();
 		int32 TrackIndex = INDEX_NONE;
 
+		TArray<int32> BoneToTrack;
+		HandSocketPoseHelpers::BuildBoneToTrackMap(TrackMap, OutPoseSnapShot.BoneNames.Num(), BoneToTrack);
+
 		OutPoseSnapShot.LocalTransforms.Reserve(OutPoseSnapShot.BoneNames.Num());
 
 		for (int32 BoneNameIndex = 0; BoneNameIndex < OutPoseSnapShot.BoneNames.Num(); ++BoneNameIndex)
@@ -141,24 +173,7 @@ bool UHandSocketComponent::GetAnimationSequenceAsPoseSnapShot(UAnimSequence* InA
 
 			const FName& BoneName = OutPoseSnapShot.BoneNames[BoneNameIndex];
 
-			TrackIndex = INDEX_NONE;
-			if (BoneNameIndex != INDEX_NONE && BoneNameIndex < TrackMap.Num() && TrackMap[BoneNameIndex].BoneTreeIndex == BoneNameIndex)
-			{
-				TrackIndex = BoneNameIndex;
-			}
-			else
-			{
-				// This shouldn't happen but I need a fallback
-				// Don't currently want to reconstruct the map inversely
-				for (int i = 0; i < TrackMap.Num(); ++i)
-				{
-					if (TrackMap[i].BoneTreeIndex == BoneNameIndex)
-					{
-						TrackIndex = i;
-						break;
-					}
-				}
-			}
+			TrackIndex = BoneToTrack[BoneNameIndex];
 
 			if (TrackIndex != INDEX_NONE && (!bSkipRootBone || TrackIndex != 0))
 			{
@@ -198,7 +213,85 @@ bool UHandSocketComponent::GetAnimationSequenceAsPoseSnapShot(UAnimSequence* InA
 	return false;
 }
 
+uint32 UHandSocketComponent::GetPoseSourceHash() const
+{
+	uint32 SourceHash = GetTypeHash(HandTargetAnimation.Get());
+	SourceHash = HashCombine(SourceHash, GetTypeHash(bUseCustomPoseDeltas));
+
+	if (bUseCustomPoseDeltas)
+	{
+		for (const FBPVRHandPoseBonePair& HandPair : CustomPoseDeltas)
+		{
+			SourceHash = HashCombine(SourceHash, GetTypeHash(HandPair.BoneName));
+			SourceHash = FCrc::MemCrc32(&HandPair.DeltaPose, sizeof(FQuat), SourceHash);
+		}
+	}
+
+	return SourceHash;
+}
+
+void UHandSocketComponent::InvalidatePoseSnapShotCache()
+{
+	PoseSnapShotCache.Empty();
+}
+
 bool UHandSocketComponent::GetBlendedPoseSnapShot(FPoseSnapshot& PoseSnapShot, USkeletalMeshComponent* TargetMesh, bool bSkipRootBone, bool bFlipHand)
+{
+	// The animation and deltas are blueprint writable, so check them instead of relying on change notifications
+	const uint32 SourceHash = GetPoseSourceHash();
+	if (SourceHash != CachedPoseSourceHash)
+	{
+		PoseSnapShotCache.Empty();
+		CachedPoseSourceHash = SourceHash;
+	}
+
+	const USkinnedAsset* TargetAsset = (TargetMesh) ? TargetMesh->GetSkinnedAsset() : nullptr;
+
+	if (const FVRHandSocketPoseCacheEntry* CachedPose = FindCachedPoseSnapShot(TargetAsset, bSkipRootBone, bFlipHand))
+	{
+		PoseSnapShot = CachedPose->PoseSnapShot;
+		return true;
+	}
+
+	// Build both hands at once, the off hand is usually not far behind
+	for (int32 HandIndex = 0; HandIndex < 2; ++HandIndex)
+	{
+		const bool bFlipThisHand = (HandIndex == 0) ? bFlipHand : !bFlipHand;
+
+		if (FindCachedPoseSnapShot(TargetAsset, bSkipRootBone, bFlipThisHand))
+			continue;
+
+		FVRHandSocketPoseCacheEntry NewEntry;
+		if (!BuildBlendedPoseSnapShot(NewEntry.PoseSnapShot, TargetMesh, bSkipRootBone, bFlipThisHand))
+		{
+			return false;
+		}
+
+		NewEntry.TargetAsset = TargetAsset;
+		NewEntry.bSkipRootBone = bSkipRootBone;
+		NewEntry.bFlipHand = bFlipThisHand;
+		PoseSnapShotCache.Add(MoveTemp(NewEntry));
+	}
+
+	if (const FVRHandSocketPoseCacheEntry* CachedPose = FindCachedPoseSnapShot(TargetAsset, bSkipRootBone, bFlipHand))
+	{
+		PoseSnapShot = CachedPose->PoseSnapShot;
+		return true;
+	}
+
+	return false;
+}
+
+const FVRHandSocketPoseCacheEntry* UHandSocketComponent::FindCachedPoseSnapShot(const USkinnedAsset* TargetAsset, bool bSkipRootBone, bool bFlipHand) const
+{
+	return PoseSnapShotCache.FindByPredicate([&](const FVRHandSocketPoseCacheEntry& Entry)
+	{
+		// A stale weak pointer means the asset was collected, it won't match a live one
+		return Entry.bSkipRootBone == bSkipRootBone && Entry.bFlipHand == bFlipHand && Entry.TargetAsset.Get() == TargetAsset && (TargetAsset || Entry.TargetAsset.IsExplicitlyNull());
+	});
+}
+
+bool UHandSocketComponent::BuildBlendedPoseSnapShot(FPoseSnapshot& PoseSnapShot, USkeletalMeshComponent* TargetMesh, bool bSkipRootBone, bool bFlipHand) const
 {
 	if (HandTargetAnimation)// && bUseCustomPoseDeltas && CustomPoseDeltas.Num() > 0)
 	{
@@ -219,18 +312,7 @@ bool UHandSocketComponent::GetBlendedPoseSnapShot(FPoseSnapshot& PoseSnapShot, U
 				OrigBoneNames[i] = PoseSnapShot.BoneNames[i];
 				if (bFlipHand)
 				{
-					FString bName = PoseSnapShot.BoneNames[i].ToString();
-
-					if (bName.Contains("_r"))
-					{
-						bName = bName.Replace(TEXT("_r"), TEXT("_l"));
-					}
-					else
-					{
-						bName = bName.Replace(TEXT("_l"), TEXT("_r"));
-					}
-
-					PoseSnapShot.BoneNames[i] = FName(bName);
+					PoseSnapShot.BoneNames[i] = HandSocketPoseHelpers::GetMirroredBoneName(PoseSnapShot.BoneNames[i]);
 				}
 			}
 		}
@@ -245,26 +327,14 @@ bool UHandSocketComponent::GetBlendedPoseSnapShot(FPoseSnapshot& PoseSnapShot, U
 		const TArray<FTrackToSkeletonMap>& TrackMap = HandTargetAnimation->GetCompressedTrackToSkeletonMapTable();
 		int32 TrackIndex = INDEX_NONE;
 
+		TArray<int32> BoneToTrack;
+		HandSocketPoseHelpers::BuildBoneToTrackMap(TrackMap, PoseSnapShot.BoneNames.Num(), BoneToTrack);
+
+		PoseSnapShot.LocalTransforms.Reserve(PoseSnapShot.BoneNames.Num());
+
 		for (int32 BoneNameIndex = 0; BoneNameIndex < PoseSnapShot.BoneNames.Num(); ++BoneNameIndex)
 		{
-			TrackIndex = INDEX_NONE;
-			if (BoneNameIndex < TrackMap.Num() && TrackMap[BoneNameIndex].BoneTreeIndex == BoneNameIndex)
-			{
-				TrackIndex = BoneNameIndex;
-			}
-			else
-			{
-				// This shouldn't happen but I need a fallback
-				// Don't currently want to reconstruct the map inversely
-				for (int i = 0; i < TrackMap.Num(); ++i)
-				{
-					if (TrackMap[i].BoneTreeIndex == BoneNameIndex)
-					{
-						TrackIndex = i;
-						break;
-					}
-				}
-			}
+			TrackIndex = BoneToTrack[BoneNameIndex];
 
 			const FName& BoneName = PoseSnapShot.BoneNames[BoneNameIndex];
 
@@ -290,7 +360,7 @@ bool UHandSocketComponent::GetBlendedPoseSnapShot(FPoseSnapshot& PoseSnapShot, U
 			if (bUseCustomPoseDeltas)
 			{
 				FQuat DeltaQuat = FQuat::Identity;
-				if (FBPVRHandPoseBonePair* HandPair = CustomPoseDeltas.FindByKey(OrigBoneNames[BoneNameIndex]))
+				if (const FBPVRHandPoseBonePair* HandPair = CustomPoseDeltas.FindByKey(OrigBoneNames[BoneNameIndex]))
 				{
 					DeltaQuat = HandPair->DeltaPose;
 				}
@@ -327,22 +397,11 @@ bool UHandSocketComponent::GetBlendedPoseSnapShot(FPoseSnapshot& PoseSnapShot, U
 		FQuat DeltaQuat = FQuat::Identity;
 		FName TargetBoneName = NAME_None;
 
-		for (FBPVRHandPoseBonePair& HandPair : CustomPoseDeltas)
+		for (const FBPVRHandPoseBonePair& HandPair : CustomPoseDeltas)
 		{
 			if (bFlipHand)
 			{
-				FString bName = HandPair.BoneName.ToString();
-
-				if (bName.Contains("_r"))
-				{
-					bName = bName.Replace(TEXT("_r"), TEXT("_l"));
-				}
-				else
-				{
-					bName = bName.Replace(TEXT("_l"), TEXT("_r"));
-				}
-
-				TargetBoneName = FName(bName);
+				TargetBoneName = HandSocketPoseHelpers::GetMirroredBoneName(HandPair.BoneName);
 			}
 			else
 			{
@@ -797,6 +856,9 @@ void UHandSocketComponent::PostEditChangeProperty(FPropertyChangedEvent& Propert
 
 	FProperty* PropertyThatChanged = PropertyChangedEvent.Property;
 
+	// The animation itself may have been edited without the reference changing
+	InvalidatePoseSnapShotCache();
+
 	if (PropertyThatChanged != nullptr)
 	{
 #if WITH_EDITORONLY_DATA
@@ -3,6 +3,7 @@
 #include "Interactibles/VRButtonComponent.h"
 #include UE_INLINE_GENERATED_CPP_BY_NAME(VRButtonComponent)
 
+#include "Interactibles/VRInteractibleUpdateSubsystem.h"
 #include "Net/UnrealNetwork.h"
 //#include "VRGripInterface.h"
 #include "GripMotionControllerComponent.h"
@@ -71,6 +72,12 @@ void UVRButtonComponent::OnRegister()
 	ResetInitialButtonLocation();
 }
 
+void UVRButtonComponent::OnUnregister()
+{
+	UVRInteractibleUpdateSubsystem::RemoveInteractible(this);
+	Super::OnUnregister();
+}
+
 void UVRButtonComponent::BeginPlay()
 {
 	// Call the base class 
@@ -86,7 +93,11 @@ void UVRButtonComponent::TickComponent(float DeltaTime, enum ELevelTick TickType
 {
 	// Call supers tick (though I don't think any of the base classes to this actually implement it)
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	UpdateInteractible(DeltaTime);
+}
 
+void UVRButtonComponent::UpdateInteractible(float DeltaTime)
+{
 	const float WorldTime = GetWorld()->GetRealTimeSeconds();
 
 	if (IsValid(LocalInteractingComponent))
@@ -138,7 +149,7 @@ void UVRButtonComponent::TickComponent(float DeltaTime, enum ELevelTick TickType
 		// Std precision tolerance should be fine
 		if (this->GetRelativeLocation().Equals(GetTargetRelativeLocation()))
 		{
-			this->SetComponentTickEnabled(false);
+			UVRInteractibleUpdateSubsystem::SetInteractibleUpdateEnabled(this, false);
 
 			OnButtonEndInteraction.Broadcast(LocalLastInteractingActor.Get(), LocalLastInteractingComponent.Get());
 			ReceiveButtonEndInteraction(LocalLastInteractingActor.Get(), LocalLastInteractingComponent.Get());
@@ -293,7 +304,7 @@ void UVRButtonComponent::OnOverlapBegin(UPrimitiveComponent* OverlappedComp, AAc
 		InitialComponentLoc = OriginalBaseTransform.InverseTransformPosition(this->GetComponentLocation());
 		bToggledThisTouch = false;
 
-		this->SetComponentTickEnabled(true);
+		UVRInteractibleUpdateSubsystem::SetInteractibleUpdateEnabled(this, true);
 
 		if (LocalInteractingComponent != LocalLastInteractingComponent.Get())
 		{
@@ -349,7 +360,7 @@ void UVRButtonComponent::SetButtonToRestingPosition(bool bLerpToPosition)
 			this->SetRelativeLocation(InitialRelativeTransform.TransformPosition(SetAxisValue(NewDepth)), false);
 		}
 		else
-			this->SetComponentTickEnabled(true); // This will trigger the lerp to resting position
+			UVRInteractibleUpdateSubsystem::SetInteractibleUpdateEnabled(this, true); // This will trigger the lerp to resting position
 
 	}break;
 	default:break;
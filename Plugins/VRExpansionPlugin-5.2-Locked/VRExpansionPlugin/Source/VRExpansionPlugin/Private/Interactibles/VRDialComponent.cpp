@@ -3,6 +3,7 @@
 #include "Interactibles/VRDialComponent.h"
 #include UE_INLINE_GENERATED_CPP_BY_NAME(VRDialComponent)
 
+#include "Interactibles/VRInteractibleUpdateSubsystem.h"
 #include "VRExpansionFunctionLibrary.h"
 #include "GripMotionControllerComponent.h"
 #include "Net/UnrealNetwork.h"
@@ -89,6 +90,12 @@ void UVRDialComponent::OnRegister()
 	ResetInitialDialLocation(); // Load the original dial location
 }
 
+void UVRDialComponent::OnUnregister()
+{
+	UVRInteractibleUpdateSubsystem::RemoveInteractible(this);
+	Super::OnUnregister();
+}
+
 void UVRDialComponent::BeginPlay()
 {
 	// Call the base class 
@@ -99,6 +106,11 @@ void UVRDialComponent::BeginPlay()
 }
 
 void UVRDialComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
+{
+	UpdateInteractible(DeltaTime);
+}
+
+void UVRDialComponent::UpdateInteractible(float DeltaTime)
 {
 	if (bIsLerping)
 	{
@@ -117,7 +129,7 @@ void UVRDialComponent::TickComponent(float DeltaTime, enum ELevelTick TickType,
 
 		if (CurRotBackEnd == 0.f)
 		{
-			this->SetComponentTickEnabled(false);
+			UVRInteractibleUpdateSubsystem::SetInteractibleUpdateEnabled(this, false);
 			bIsLerping = false;
 			OnDialFinishedLerping.Broadcast();
 			ReceiveDialFinishedLerping();
@@ -125,7 +137,7 @@ void UVRDialComponent::TickComponent(float DeltaTime, enum ELevelTick TickType,
 	}
 	else
 	{
-		this->SetComponentTickEnabled(false); 
+		UVRInteractibleUpdateSubsystem::SetInteractibleUpdateEnabled(this, false); 
 	}
 }
 
@@ -280,10 +292,10 @@ void UVRDialComponent::OnGripRelease_Implementation(UGripMotionControllerCompone
 	if (bLerpBackOnRelease)
 	{
 		bIsLerping = true;
-		this->SetComponentTickEnabled(true);
+		UVRInteractibleUpdateSubsystem::SetInteractibleUpdateEnabled(this, true);
 	}
 	else
-		this->SetComponentTickEnabled(false);
+		UVRInteractibleUpdateSubsystem::SetInteractibleUpdateEnabled(this, false);
 
 	//OnDropped.Broadcast(ReleasingController, GripInformation, bWasSocketed);
 }
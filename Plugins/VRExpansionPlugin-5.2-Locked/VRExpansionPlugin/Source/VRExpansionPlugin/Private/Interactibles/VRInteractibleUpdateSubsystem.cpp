@@ -0,0 +1,172 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Interactibles/VRInteractibleUpdateSubsystem.h"
+#include UE_INLINE_GENERATED_CPP_BY_NAME(VRInteractibleUpdateSubsystem)
+
+#include "Interactibles/VRButtonComponent.h"
+#include "Interactibles/VRLeverComponent.h"
+#include "Interactibles/VRDialComponent.h"
+#include "Interactibles/VRSliderComponent.h"
+#include "VRGlobalSettings.h"
+
+DECLARE_CYCLE_STAT(TEXT("VRInteractibleUpdateSubsystem Tick"), STAT_VRInteractibleUpdateSubsystemTick, STATGROUP_Tickables);
+
+template<typename InteractibleType>
+void TVRInteractibleUpdateList<InteractibleType>::Update(float DeltaTime)
+{
+	bIsUpdating = true;
+
+	// Index based, events thrown during an update can start other interactibles of this type updating
+	for (int32 Index = 0; Index < Interactibles.Num(); ++Index)
+	{
+		InteractibleType* Interactible = Interactibles[Index];
+		if (Interactible && IsValid(Interactible))
+		{
+			Interactible->UpdateInteractible(DeltaTime);
+		}
+	}
+
+	bIsUpdating = false;
+
+	if (bHasPendingRemovals)
+	{
+		Interactibles.RemoveAllSwap([](const InteractibleType* Interactible) { return Interactible == nullptr; }, false);
+		bHasPendingRemovals = false;
+	}
+}
+
+UVRInteractibleUpdateSubsystem* UVRInteractibleUpdateSubsystem::GetSubsystemForInteractibles(const UWorld* World)
+{
+	if (!World || !GetDefault<UVRGlobalSettings>()->bUseInteractibleUpdateSubsystem)
+		return nullptr;
+
+	return World->GetSubsystem<UVRInteractibleUpdateSubsystem>();
+}
+
+template<typename InteractibleType>
+void UVRInteractibleUpdateSubsystem::SetUpdateEnabled(InteractibleType* Interactible, TVRInteractibleUpdateList<InteractibleType> UVRInteractibleUpdateSubsystem::* List, bool bEnabled)
+{
+	if (!Interactible)
+		return;
+
+	UWorld* World = Interactible->GetWorld();
+
+	if (bEnabled)
+	{
+		UVRInteractibleUpdateSubsystem* Subsystem = GetSubsystemForInteractibles(World);
+		if (Subsystem && Interactible->IsRegistered())
+		{
+			(Subsystem->*List).Add(Interactible);
+		}
+		else
+		{
+			Interactible->SetComponentTickEnabled(true);
+		}
+	}
+	else
+	{
+		Interactible->SetComponentTickEnabled(false);
+
+		// Not checking the setting here, it may have been changed while this interactible was registered
+		if (UVRInteractibleUpdateSubsystem* Subsystem = World ? World->GetSubsystem<UVRInteractibleUpdateSubsystem>() : nullptr)
+		{
+			(Subsystem->*List).Remove(Interactible);
+		}
+	}
+}
+
+void UVRInteractibleUpdateSubsystem::SetInteractibleUpdateEnabled(UVRButtonComponent* Interactible, bool bEnabled)
+{
+	SetUpdateEnabled(Interactible, &UVRInteractibleUpdateSubsystem::Buttons, bEnabled);
+}
+
+void UVRInteractibleUpdateSubsystem::SetInteractibleUpdateEnabled(UVRLeverComponent* Interactible, bool bEnabled)
+{
+	SetUpdateEnabled(Interactible, &UVRInteractibleUpdateSubsystem::Levers, bEnabled);
+}
+
+void UVRInteractibleUpdateSubsystem::SetInteractibleUpdateEnabled(UVRDialComponent* Interactible, bool bEnabled)
+{
+	SetUpdateEnabled(Interactible, &UVRInteractibleUpdateSubsystem::Dials, bEnabled);
+}
+
+void UVRInteractibleUpdateSubsystem::SetInteractibleUpdateEnabled(UVRSliderComponent* Interactible, bool bEnabled)
+{
+	SetUpdateEnabled(Interactible, &UVRInteractibleUpdateSubsystem::Sliders, bEnabled);
+}
+
+void UVRInteractibleUpdateSubsystem::RemoveInteractible(UActorComponent* Interactible)
+{
+	UWorld* World = Interactible ? Interactible->GetWorld() : nullptr;
+	UVRInteractibleUpdateSubsystem* Subsystem = World ? World->GetSubsystem<UVRInteractibleUpdateSubsystem>() : nullptr;
+
+	if (!Subsystem)
+		return;
+
+	if (UVRButtonComponent* Button = Cast<UVRButtonComponent>(Interactible))
+		Subsystem->Buttons.Remove(Button);
+	else if (UVRLeverComponent* Lever = Cast<UVRLeverComponent>(Interactible))
+		Subsystem->Levers.Remove(Lever);
+	else if (UVRDialComponent* Dial = Cast<UVRDialComponent>(Interactible))
+		Subsystem->Dials.Remove(Dial);
+	else if (UVRSliderComponent* Slider = Cast<UVRSliderComponent>(Interactible))
+		Subsystem->Sliders.Remove(Slider);
+}
+
+int32 UVRInteractibleUpdateSubsystem::GetNumUpdatingInteractibles() const
+{
+	return Buttons.Interactibles.Num() + Levers.Interactibles.Num() + Dials.Interactibles.Num() + Sliders.Interactibles.Num();
+}
+
+void UVRInteractibleUpdateSubsystem::Deinitialize()
+{
+	Buttons.Interactibles.Empty();
+	Levers.Interactibles.Empty();
+	Dials.Interactibles.Empty();
+	Sliders.Interactibles.Empty();
+
+	Super::Deinitialize();
+}
+
+void UVRInteractibleUpdateSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_VRInteractibleUpdateSubsystemTick);
+
+	Buttons.Update(DeltaTime);
+	Levers.Update(DeltaTime);
+	Dials.Update(DeltaTime);
+	Sliders.Update(DeltaTime);
+}
+
+bool UVRInteractibleUpdateSubsystem::IsTickable() const
+{
+	return GetNumUpdatingInteractibles() > 0;
+}
+
+UWorld* UVRInteractibleUpdateSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+bool UVRInteractibleUpdateSubsystem::IsTickableInEditor() const
+{
+	return false;
+}
+
+bool UVRInteractibleUpdateSubsystem::IsTickableWhenPaused() const
+{
+	return false;
+}
+
+ETickableTickType UVRInteractibleUpdateSubsystem::GetTickableTickType() const
+{
+	if (IsTemplate(RF_ClassDefaultObject))
+		return ETickableTickType::Never;
+
+	return ETickableTickType::Conditional;
+}
+
+TStatId UVRInteractibleUpdateSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UVRInteractibleUpdateSubsystem, STATGROUP_Tickables);
+}
@@ -3,6 +3,7 @@
 #include "Interactibles/VRLeverComponent.h"
 #include UE_INLINE_GENERATED_CPP_BY_NAME(VRLeverComponent)
 
+#include "Interactibles/VRInteractibleUpdateSubsystem.h"
 #include "GripMotionControllerComponent.h"
 #include "VRExpansionFunctionLibrary.h"
 #include "Net/UnrealNetwork.h"
@@ -126,7 +127,11 @@ void UVRLeverComponent::TickComponent(float DeltaTime, enum ELevelTick TickType,
 {
 	// Call supers tick (though I don't think any of the base classes to this actually implement it)
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	UpdateInteractible(DeltaTime);
+}
 
+void UVRLeverComponent::UpdateInteractible(float DeltaTime)
+{
 	bool bWasLerping = bIsLerping;
 
 	// If we are locked then end the lerp, no point
@@ -165,7 +170,7 @@ void UVRLeverComponent::TickComponent(float DeltaTime, enum ELevelTick TickType,
 
 			if (LerpedQuat.IsIdentity())
 			{
-				this->SetComponentTickEnabled(false);
+				UVRInteractibleUpdateSubsystem::SetInteractibleUpdateEnabled(this, false);
 				bIsLerping = false;
 				bReplicateMovement = bOriginalReplicatesMovement;
 				this->SetRelativeRotation(InitialRelativeTransform.Rotator());
@@ -237,6 +242,7 @@ void UVRLeverComponent::ProccessCurrentState(bool bWasLerping, bool bThrowEvents
 
 void UVRLeverComponent::OnUnregister()
 {
+	UVRInteractibleUpdateSubsystem::RemoveInteractible(this);
 	Super::OnUnregister();
 }
 
@@ -432,7 +438,7 @@ void UVRLeverComponent::OnGrip_Implementation(UGripMotionControllerComponent * G
 	bIsInFirstTick = true;
 	MomentumAtDrop = 0.0f;
 
-	this->SetComponentTickEnabled(true);
+	UVRInteractibleUpdateSubsystem::SetInteractibleUpdateEnabled(this, true);
 
 	//OnGripped.Broadcast(GrippingController, GripInformation);
 }
@@ -442,13 +448,13 @@ void UVRLeverComponent::OnGripRelease_Implementation(UGripMotionControllerCompon
 	if (LeverReturnTypeWhenReleased != EVRInteractibleLeverReturnType::Stay)
 	{		
 		bIsLerping = true;
-		this->SetComponentTickEnabled(true);
+		UVRInteractibleUpdateSubsystem::SetInteractibleUpdateEnabled(this, true);
 		if (MovementReplicationSetting != EGripMovementReplicationSettings::ForceServerSideMovement)
 			bReplicateMovement = false;
 	}
 	else
 	{
-		this->SetComponentTickEnabled(false);
+		UVRInteractibleUpdateSubsystem::SetInteractibleUpdateEnabled(this, false);
 		bReplicateMovement = bOriginalReplicatesMovement;
 	}
 
@@ -740,7 +746,7 @@ void UVRLeverComponent::LerpAxis(float CurrentAngle, float DeltaTime)
 		if (FMath::IsNearlyZero(MomentumAtDrop * DeltaTime, 0.1f))
 		{
 			MomentumAtDrop = 0.0f;
-			this->SetComponentTickEnabled(false);
+			UVRInteractibleUpdateSubsystem::SetInteractibleUpdateEnabled(this, false);
 			bIsLerping = false;
 			bReplicateMovement = bOriginalReplicatesMovement;
 			return;
@@ -776,7 +782,7 @@ void UVRLeverComponent::LerpAxis(float CurrentAngle, float DeltaTime)
 		}
 		else
 		{
-			this->SetComponentTickEnabled(false);
+			UVRInteractibleUpdateSubsystem::SetInteractibleUpdateEnabled(this, false);
 			bIsLerping = false;
 			bReplicateMovement = bOriginalReplicatesMovement;
 			FTransform CalcTransform = (FTransform(UVRInteractibleFunctionLibrary::SetAxisValueRot((EVRInteractibleAxis)LeverRotationAxis, TargetAngle, FRotator::ZeroRotator)) * InitialRelativeTransform);
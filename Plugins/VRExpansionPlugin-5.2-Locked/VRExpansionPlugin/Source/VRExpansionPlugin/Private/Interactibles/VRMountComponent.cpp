@@ -3,6 +3,7 @@
 #include "Interactibles/VRMountComponent.h"
 #include UE_INLINE_GENERATED_CPP_BY_NAME(VRMountComponent)
 
+#include "Interactibles/VRInteractibleUpdateSubsystem.h"
 #include "VRExpansionFunctionLibrary.h"
 #include "GripMotionControllerComponent.h"
 //#include "PhysicsPublic.h"
@@ -425,7 +426,9 @@ void UVRMountComponent::OnGrip_Implementation(UGripMotionControllerComponent * G
 		
 
 
-	this->SetComponentTickEnabled(true);
+	// Mounts have no per frame logic of their own, with the interactible update subsystem on we don't wake up an empty tick
+	if (!UVRInteractibleUpdateSubsystem::GetSubsystemForInteractibles(GetWorld()))
+		this->SetComponentTickEnabled(true);
 }
 
 void UVRMountComponent::OnGripRelease_Implementation(UGripMotionControllerComponent * ReleasingController, const FBPActorGripInformation & GripInformation, bool bWasSocketed)
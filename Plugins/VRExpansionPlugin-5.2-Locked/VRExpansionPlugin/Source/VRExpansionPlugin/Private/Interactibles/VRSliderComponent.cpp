@@ -3,6 +3,7 @@
 #include "Interactibles/VRSliderComponent.h"
 #include UE_INLINE_GENERATED_CPP_BY_NAME(VRSliderComponent)
 
+#include "Interactibles/VRInteractibleUpdateSubsystem.h"
 #include "VRExpansionFunctionLibrary.h"
 #include "Components/SplineComponent.h"
 #include "GripMotionControllerComponent.h"
@@ -124,6 +125,12 @@ void UVRSliderComponent::OnRegister()
 	}
 }
 
+void UVRSliderComponent::OnUnregister()
+{
+	UVRInteractibleUpdateSubsystem::RemoveInteractible(this);
+	Super::OnUnregister();
+}
+
 void UVRSliderComponent::BeginPlay()
 {
 	// Call the base class 
@@ -138,7 +145,11 @@ void UVRSliderComponent::TickComponent(float DeltaTime, enum ELevelTick TickType
 {
 	// Call supers tick (though I don't think any of the base classes to this actually implement it)
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	UpdateInteractible(DeltaTime);
+}
 
+void UVRSliderComponent::UpdateInteractible(float DeltaTime)
+{
 	if (bIsHeld && bUpdateInTick && HoldingGrip.HoldingController)
 	{
 		FBPActorGripInformation GripInfo;
@@ -161,7 +172,7 @@ void UVRSliderComponent::TickComponent(float DeltaTime, enum ELevelTick TickType
 		OnSliderFinishedLerping.Broadcast(CurrentSliderProgress);
 		ReceiveSliderFinishedLerping(CurrentSliderProgress);
 
-		this->SetComponentTickEnabled(false);
+		UVRInteractibleUpdateSubsystem::SetInteractibleUpdateEnabled(this, false);
 		bReplicateMovement = bOriginalReplicatesMovement;
 
 		return;
@@ -260,7 +271,7 @@ void UVRSliderComponent::TickComponent(float DeltaTime, enum ELevelTick TickType
 			OnSliderFinishedLerping.Broadcast(CurrentSliderProgress);
 			ReceiveSliderFinishedLerping(CurrentSliderProgress);
 
-			this->SetComponentTickEnabled(false);
+			UVRInteractibleUpdateSubsystem::SetInteractibleUpdateEnabled(this, false);
 			bReplicateMovement = bOriginalReplicatesMovement;
 		}
 		
@@ -299,14 +310,15 @@ void UVRSliderComponent::TickGrip_Implementation(UGripMotionControllerComponent
 	if (SplineComponentToFollow != nullptr)
 	{
 		FVector WorldCalculatedLocation = CurrentRelativeTransform.TransformPosition(CalculatedLocation);
-		float ClosestKey = SplineComponentToFollow->FindInputKeyClosestToWorldLocation(WorldCalculatedLocation);
+
+		// Warm started from the last key, a full search happens on the first frame of the grip when LastInputKey is -1
+		float ProjectedProgress = 0.0f;
+		float ClosestKey = FindSplineInputKeyClosestToWorldLocation(WorldCalculatedLocation, LastInputKey, ProjectedProgress);
 
 		if (bSliderUsesSnapPoints)
 		{
 			float SplineLength = SplineComponentToFollow->GetSplineLength();
-			SplineProgress = GetCurrentSliderProgress(WorldCalculatedLocation, true, ClosestKey);
-
-			SplineProgress = UVRInteractibleFunctionLibrary::Interactible_GetThresholdSnappedValue(SplineProgress, SnapIncrement, SnapThreshold);
+			SplineProgress = UVRInteractibleFunctionLibrary::Interactible_GetThresholdSnappedValue(ProjectedProgress, SnapIncrement, SnapThreshold);
 
 			const int32 NumPoints = SplineComponentToFollow->SplineCurves.Position.Points.Num();
 
@@ -344,7 +356,7 @@ void UVRSliderComponent::TickGrip_Implementation(UGripMotionControllerComponent
 			}
 			else if (bLerpToNewKey)
 			{
-				trans = SplineComponentToFollow->FindTransformClosestToWorldLocation(WorldCalculatedLocation, ESplineCoordinateSpace::World, true);
+				trans = SplineComponentToFollow->GetTransformAtSplineInputKey(ClosestKey, ESplineCoordinateSpace::World, true);
 				bChangedLocation = true;
 			}
 
@@ -366,7 +378,7 @@ void UVRSliderComponent::TickGrip_Implementation(UGripMotionControllerComponent
 			}
 			else if (bLerpToNewKey)
 			{
-				WorldLocation = SplineComponentToFollow->FindLocationClosestToWorldLocation(WorldCalculatedLocation, ESplineCoordinateSpace::World);
+				WorldLocation = SplineComponentToFollow->GetLocationAtSplineInputKey(ClosestKey, ESplineCoordinateSpace::World);
 				bChangedLocation = true;
 			}
 
@@ -374,7 +386,14 @@ void UVRSliderComponent::TickGrip_Implementation(UGripMotionControllerComponent
 				this->SetRelativeLocation(ParentTransform.InverseTransformPosition(WorldLocation));
 		}
 
-		CurrentSliderProgress = GetCurrentSliderProgress(WorldCalculatedLocation, true, bLerpToNewKey ? LerpedKey : ClosestKey);
+		const float FinalKey = bLerpToNewKey ? LerpedKey : ClosestKey;
+
+		// Unsnapped and not lerping, the projection already gave us the distance along the spline
+		if (!bSliderUsesSnapPoints && FinalKey == ClosestKey)
+			CurrentSliderProgress = ProjectedProgress;
+		else
+			CurrentSliderProgress = GetCurrentSliderProgress(WorldCalculatedLocation, true, FinalKey);
+
 		if (bLerpToNewKey)
 		{
 			LastInputKey = LerpedKey;
@@ -508,7 +527,7 @@ void UVRSliderComponent::OnGrip_Implementation(UGripMotionControllerComponent *
 	}
 
 	if (bUpdateInTick)
-		SetComponentTickEnabled(true);
+		UVRInteractibleUpdateSubsystem::SetInteractibleUpdateEnabled(this, true);
 
 	//OnGripped.Broadcast(GrippingController, GripInformation);
 
@@ -521,7 +540,7 @@ void UVRSliderComponent::OnGripRelease_Implementation(UGripMotionControllerCompo
 	if (SliderBehaviorWhenReleased != EVRInteractibleSliderDropBehavior::Stay)
 	{
 		bIsLerping = true;
-		this->SetComponentTickEnabled(true);
+		UVRInteractibleUpdateSubsystem::SetInteractibleUpdateEnabled(this, true);
 
 		FVector Len = (MinSlideDistance.GetAbs() + MaxSlideDistance.GetAbs());
 		if(bSlideDistanceIsInParentSpace)
@@ -542,7 +561,7 @@ void UVRSliderComponent::OnGripRelease_Implementation(UGripMotionControllerCompo
 	}
 	else
 	{
-		this->SetComponentTickEnabled(false);
+		UVRInteractibleUpdateSubsystem::SetInteractibleUpdateEnabled(this, false);
 		bReplicateMovement = bOriginalReplicatesMovement;
 	}
 
@@ -779,6 +798,171 @@ float UVRSliderComponent::GetDistanceAlongSplineAtSplineInputKey(float InKey) co
 	return 0.0f;
 }
 
+bool FVRSliderSplineLUT::UpdateFromSpline(USplineComponent* InSpline)
+{
+	if (!InSpline)
+	{
+		Reset();
+		return false;
+	}
+
+	const FSplineCurves& SplineCurves = InSpline->SplineCurves;
+	const TArray<FInterpCurvePoint<float>>& ReparamPoints = SplineCurves.ReparamTable.Points;
+
+	if (Spline.Get() == InSpline &&
+		SplineVersion == SplineCurves.Version &&
+		StepsPerSegment == InSpline->ReparamStepsPerSegment &&
+		bClosedLoop == InSpline->IsClosedLoop() &&
+		Positions.Num() == ReparamPoints.Num()
+		)
+	{
+		return IsValid();
+	}
+
+	Reset();
+	Spline = InSpline;
+	SplineVersion = SplineCurves.Version;
+	StepsPerSegment = InSpline->ReparamStepsPerSegment;
+	bClosedLoop = InSpline->IsClosedLoop();
+
+	if (SplineCurves.Position.Points.Num() < 2 || ReparamPoints.Num() < 2 || StepsPerSegment < 1)
+	{
+		return false;
+	}
+
+	Positions.Reserve(ReparamPoints.Num());
+	Keys.Reserve(ReparamPoints.Num());
+	Distances.Reserve(ReparamPoints.Num());
+
+	// The reparam table already maps distance to key, we only need the positions to go with it
+	for (const FInterpCurvePoint<float>& ReparamPoint : ReparamPoints)
+	{
+		Distances.Add(ReparamPoint.InVal);
+		Keys.Add(ReparamPoint.OutVal);
+		Positions.Add(SplineCurves.Position.Eval(ReparamPoint.OutVal, FVector::ZeroVector));
+	}
+
+	SplineLength = SplineCurves.GetSplineLength();
+	return true;
+}
+
+void FVRSliderSplineLUT::Reset()
+{
+	Spline.Reset();
+	SplineVersion = 0;
+	StepsPerSegment = 0;
+	bClosedLoop = false;
+	SplineLength = 0.0f;
+	Positions.Reset();
+	Keys.Reset();
+	Distances.Reset();
+}
+
+int32 FVRSliderSplineLUT::WrapSegmentIndex(int32 SegmentIndex) const
+{
+	const int32 NumSegs = NumSegments();
+
+	if (bClosedLoop)
+	{
+		SegmentIndex %= NumSegs;
+		return SegmentIndex < 0 ? SegmentIndex + NumSegs : SegmentIndex;
+	}
+
+	return FMath::Clamp(SegmentIndex, 0, NumSegs - 1);
+}
+
+float FVRSliderSplineLUT::ProjectOntoSegment(int32 SegmentIndex, const FVector& LocalLocation, float& OutAlpha) const
+{
+	const FVector& SegmentStart = Positions[SegmentIndex];
+	const FVector SegmentDir = Positions[SegmentIndex + 1] - SegmentStart;
+	const float SegmentLengthSq = (float)SegmentDir.SizeSquared();
+
+	OutAlpha = SegmentLengthSq > UE_KINDA_SMALL_NUMBER ? FMath::Clamp((float)FVector::DotProduct(LocalLocation - SegmentStart, SegmentDir) / SegmentLengthSq, 0.0f, 1.0f) : 0.0f;
+	return (float)FVector::DistSquared(LocalLocation, SegmentStart + (SegmentDir * OutAlpha));
+}
+
+float FVRSliderSplineLUT::FindInputKeyClosestToLocalLocation(const FVector& LocalLocation, float WarmStartKey, float& OutDistanceAlongSpline) const
+{
+	const int32 NumSegs = NumSegments();
+	int32 BestSegment = 0;
+	float BestAlpha = 0.0f;
+	float BestDistSq = MAX_flt;
+
+	if (WarmStartKey < 0.0f)
+	{
+		for (int32 Segment = 0; Segment < NumSegs; ++Segment)
+		{
+			float Alpha = 0.0f;
+			const float DistSq = ProjectOntoSegment(Segment, LocalLocation, Alpha);
+			if (DistSq < BestDistSq)
+			{
+				BestDistSq = DistSq;
+				BestSegment = Segment;
+				BestAlpha = Alpha;
+			}
+		}
+	}
+	else
+	{
+		// Reparam points are evenly spaced in key, so the starting segment is a direct lookup
+		const int32 StartSegment = WrapSegmentIndex(FMath::FloorToInt(WarmStartKey * StepsPerSegment));
+		BestSegment = StartSegment;
+		BestDistSq = ProjectOntoSegment(StartSegment, LocalLocation, BestAlpha);
+
+		// Walk outwards in both directions until it stops improving, allowing a couple of misses to step over small bends
+		const int32 MaxMisses = 2;
+		for (int32 Direction = -1; Direction <= 1; Direction += 2)
+		{
+			int32 Misses = 0;
+			for (int32 Step = 1; Step < NumSegs && Misses < MaxMisses; ++Step)
+			{
+				int32 Segment = StartSegment + (Step * Direction);
+
+				if (bClosedLoop)
+					Segment = WrapSegmentIndex(Segment);
+				else if (Segment < 0 || Segment >= NumSegs)
+					break;
+
+				float Alpha = 0.0f;
+				const float DistSq = ProjectOntoSegment(Segment, LocalLocation, Alpha);
+				if (DistSq < BestDistSq)
+				{
+					BestDistSq = DistSq;
+					BestSegment = Segment;
+					BestAlpha = Alpha;
+					Misses = 0;
+				}
+				else
+				{
+					++Misses;
+				}
+			}
+		}
+	}
+
+	OutDistanceAlongSpline = FMath::Lerp(Distances[BestSegment], Distances[BestSegment + 1], BestAlpha);
+	return FMath::Lerp(Keys[BestSegment], Keys[BestSegment + 1], BestAlpha);
+}
+
+float UVRSliderComponent::FindSplineInputKeyClosestToWorldLocation(const FVector& WorldLocation, float WarmStartKey, float& OutSliderProgress)
+{
+	if (!SplineLUT.UpdateFromSpline(SplineComponentToFollow))
+	{
+		// Degenerate spline, let it handle itself
+		const float ClosestKey = SplineComponentToFollow->FindInputKeyClosestToWorldLocation(WorldLocation);
+		OutSliderProgress = GetCurrentSliderProgress(WorldLocation, true, ClosestKey);
+		return ClosestKey;
+	}
+
+	// Same space that the spline does its own search in
+	const FVector LocalLocation = SplineComponentToFollow->GetComponentTransform().InverseTransformPosition(WorldLocation);
+
+	float DistanceAlongSpline = 0.0f;
+	const float ClosestKey = SplineLUT.FindInputKeyClosestToLocalLocation(LocalLocation, WarmStartKey, DistanceAlongSpline);
+	OutSliderProgress = SplineLUT.SplineLength > 0.0f ? FMath::Clamp(DistanceAlongSpline / SplineLUT.SplineLength, 0.0f, 1.0f) : 0.0f;
+	return ClosestKey;
+}
+
 float UVRSliderComponent::GetCurrentSliderProgress(FVector CurLocation, bool bUseKeyInstead, float CurKey)
 {
 	if (SplineComponentToFollow != nullptr)
@@ -787,7 +971,11 @@ float UVRSliderComponent::GetCurrentSliderProgress(FVector CurLocation, bool bUs
 		float ClosestKey = CurKey;
 
 		if (!bUseKeyInstead)
-			ClosestKey = SplineComponentToFollow->FindInputKeyClosestToWorldLocation(CurLocation);
+		{
+			float Progress = 0.0f;
+			FindSplineInputKeyClosestToWorldLocation(CurLocation, -1.0f, Progress);
+			return Progress;
+		}
 
 		/*int32 primaryKey = FMath::TruncToInt(ClosestKey);
 
@@ -3,6 +3,10 @@
 #include "Misc/BucketUpdateSubsystem.h"
 #include UE_INLINE_GENERATED_CPP_BY_NAME(BucketUpdateSubsystem)
 
+#include "VRPlayerController.h"
+#include "VRGlobalSettings.h"
+#include "Misc/VRNetProfiler.h"
+
 	bool UBucketUpdateSubsystem::AddObjectToBucket(int32 UpdateHTZ, UObject* InObject, FName FunctionName)
 	{
 		if (!InObject || UpdateHTZ < 1)
@@ -65,14 +69,138 @@
 		return BucketContainer.bNeedsUpdate;
 	}
 
+	bool UBucketUpdateSubsystem::QueueThrownObjectMovement(AActor* ThrownActor, const FRepMovementVR& Movement)
+	{
+		if (!ThrownActor || !GetDefault<UVRGlobalSettings>()->bBatchClientAuthThrowing)
+			return false;
+
+		AVRBasePlayerController* OwningController = AVRBasePlayerController::GetThrowingController(ThrownActor);
+		if (!OwningController)
+			return false;
+
+		const int32 KeyframeInterval = FMath::Max(GetDefault<UVRGlobalSettings>()->ThrownObjectKeyframeInterval, 1);
+
+		FVRThrownObjectSample NewSample;
+		NewSample.ThrownActor = ThrownActor;
+		NewSample.Movement = Movement;
+
+		const FVector QuantizedLocation = FVRThrownObjectBaseline::QuantizeLocation(Movement.Location);
+		FVRThrownObjectBaseline* Baseline = ThrownObjectBaselines.Find(ThrownActor);
+
+		if (!Baseline)
+		{
+			Baseline = &ThrownObjectBaselines.Add(ThrownActor, FVRThrownObjectBaseline());
+			NewSample.bIsKeyframe = true;
+		}
+		else
+		{
+			const FVector Delta = QuantizedLocation - Baseline->LastLocation;
+
+			// The delta serialization is limited to 20 bits a component, fall back to a keyframe if we exceed it (or are due for one)
+			NewSample.bIsKeyframe = Baseline->SamplesSinceKeyframe >= KeyframeInterval || Delta.GetAbsMax() >= 5000.0f;
+
+			if (!NewSample.bIsKeyframe)
+			{
+				NewSample.Movement.Location = Delta;
+			}
+		}
+
+		Baseline->LastLocation = QuantizedLocation;
+		Baseline->SamplesSinceKeyframe = NewSample.bIsKeyframe ? 0 : Baseline->SamplesSinceKeyframe + 1;
+		NewSample.Sequence = ++Baseline->Sequence;
+
+		PendingThrownObjectBatches.FindOrAdd(OwningController).Samples.Add(NewSample);
+
+		// A sleeping body is the last sample we send, the next throw starts from a new keyframe
+		if (Movement.bSimulatedPhysicSleep)
+		{
+			ThrownObjectBaselines.Remove(ThrownActor);
+		}
+
+		return true;
+	}
+
+	void UBucketUpdateSubsystem::RemoveThrownObject(AActor* ThrownActor)
+	{
+		ThrownObjectBaselines.Remove(ThrownActor);
+
+		// Flush the connections whole batch, it keeps the other objects samples in order as well
+		for (auto Itr = PendingThrownObjectBatches.CreateIterator(); Itr; ++Itr)
+		{
+			const bool bHasSample = Itr.Value().Samples.ContainsByPredicate([ThrownActor](const FVRThrownObjectSample& Sample)
+			{
+				return Sample.ThrownActor == ThrownActor;
+			});
+
+			if (bHasSample)
+			{
+				if (AVRBasePlayerController* OwningController = Itr.Key().Get())
+				{
+					SendThrownObjectBatch(OwningController, Itr.Value());
+				}
+				Itr.RemoveCurrent();
+			}
+		}
+	}
+
+	void UBucketUpdateSubsystem::SendThrownObjectBatch(AVRBasePlayerController* OwningController, FVRThrownObjectBatch& Batch)
+	{
+		VR_NET_PROFILE_SCOPE(TEXT("Server_SendThrownObjectMovement"), OwningController);
+		TArray<FVRThrownObjectSample>& Samples = Batch.Samples;
+
+		if (Samples.Num() <= FVRThrownObjectBatch::MaxSamplesPerBatch)
+		{
+			OwningController->Server_SendThrownObjectMovement(Batch);
+			return;
+		}
+
+		// Split up extremely large throws so that we stay within the per RPC cap
+		FVRThrownObjectBatch SplitBatch;
+		for (int32 StartIndex = 0; StartIndex < Samples.Num(); StartIndex += FVRThrownObjectBatch::MaxSamplesPerBatch)
+		{
+			const int32 Count = FMath::Min(FVRThrownObjectBatch::MaxSamplesPerBatch, Samples.Num() - StartIndex);
+			SplitBatch.Samples.Reset();
+			SplitBatch.Samples.Append(Samples.GetData() + StartIndex, Count);
+			OwningController->Server_SendThrownObjectMovement(SplitBatch);
+		}
+	}
+
+	void UBucketUpdateSubsystem::FlushThrownObjectBatches()
+	{
+		if (PendingThrownObjectBatches.Num() < 1)
+			return;
+
+		for (TPair<TWeakObjectPtr<AVRBasePlayerController>, FVRThrownObjectBatch>& PendingBatch : PendingThrownObjectBatches)
+		{
+			if (AVRBasePlayerController* OwningController = PendingBatch.Key.Get())
+			{
+				SendThrownObjectBatch(OwningController, PendingBatch.Value);
+			}
+		}
+
+		PendingThrownObjectBatches.Reset();
+
+		// Clean out any baselines for objects that were destroyed mid throw
+		for (auto Itr = ThrownObjectBaselines.CreateIterator(); Itr; ++Itr)
+		{
+			if (!Itr.Key().IsValid())
+			{
+				Itr.RemoveCurrent();
+			}
+		}
+	}
+
 	void UBucketUpdateSubsystem::Tick(float DeltaTime)
 	{
 		BucketContainer.UpdateBuckets(DeltaTime);
+
+		// The buckets will have queued their thrown object samples, send them in one go per connection
+		FlushThrownObjectBatches();
 	}
 
 	bool UBucketUpdateSubsystem::IsTickable() const
 	{
-		return BucketContainer.bNeedsUpdate;
+		return BucketContainer.bNeedsUpdate || PendingThrownObjectBatches.Num() > 0;
 	}
 
 	UWorld* UBucketUpdateSubsystem::GetTickableGameObjectWorld() const
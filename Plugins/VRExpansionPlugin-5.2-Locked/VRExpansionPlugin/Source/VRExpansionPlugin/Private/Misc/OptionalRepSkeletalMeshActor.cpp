@@ -7,6 +7,7 @@
 #include "Net/UnrealNetwork.h"
 #include "PhysicsReplication.h"
 #include "PhysicsEngine/PhysicsAsset.h"
+#include "Engine/SkinnedAsset.h"
 #if WITH_PUSH_MODEL
 #include "Net/Core/PushModel/PushModel.h"
 #endif
@@ -83,6 +84,8 @@ UInversePhysicsSkeletalMeshComponent::UInversePhysicsSkeletalMeshComponent(const
 	EndPhysicsTickFunctionVR.TickGroup = TG_EndPhysics;
 	EndPhysicsTickFunctionVR.bCanEverTick = true;
 	EndPhysicsTickFunctionVR.bStartWithTickEnabled = true;
+
+	BlendMapNumBodySetupsVR = INDEX_NONE;
 }
 
 void UInversePhysicsSkeletalMeshComponent::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
@@ -245,7 +248,7 @@ struct FAssetWorldBoneTM
 
 typedef TArray<FAssetWorldBoneTM, TMemStackAllocator<alignof(FAssetWorldBoneTM)>> TAssetWorldBoneTMArray;
 
-void UpdateWorldBoneTMVR(TAssetWorldBoneTMArray& WorldBoneTMs, const TArray<FTransform>& InBoneSpaceTransforms, int32 BoneIndex, USkeletalMeshComponent* SkelComp, const FTransform& LocalToWorldTM, const FVector& Scale3D)
+void UpdateWorldBoneTMVR(TAssetWorldBoneTMArray& WorldBoneTMs, const TArray<FTransform>& InBoneSpaceTransforms, int32 BoneIndex, const FReferenceSkeleton& RefSkeleton, const FTransform& LocalToWorldTM, const FVector& Scale3D)
 {
 	// If its already up to date - do nothing
 	if (WorldBoneTMs[BoneIndex].bUpToDate)
@@ -262,8 +265,8 @@ void UpdateWorldBoneTMVR(TAssetWorldBoneTMArray& WorldBoneTMs, const TArray<FTra
 	else
 	{
 		// If not root, use our cached world-space bone transforms.
-		int32 ParentIndex = SkelComp->GetSkeletalMeshAsset()->GetRefSkeleton().GetParentIndex(BoneIndex);
-		UpdateWorldBoneTMVR(WorldBoneTMs, InBoneSpaceTransforms, ParentIndex, SkelComp, LocalToWorldTM, Scale3D);
+		int32 ParentIndex = RefSkeleton.GetParentIndex(BoneIndex);
+		UpdateWorldBoneTMVR(WorldBoneTMs, InBoneSpaceTransforms, ParentIndex, RefSkeleton, LocalToWorldTM, Scale3D);
 		ParentTM = WorldBoneTMs[ParentIndex].TM;
 	}
 
@@ -277,6 +280,30 @@ void UpdateWorldBoneTMVR(TAssetWorldBoneTMArray& WorldBoneTMs, const TArray<FTra
 	}
 }
 
+void UInversePhysicsSkeletalMeshComponent::UpdateBlendBoneToBodyIndexVR(const UPhysicsAsset* PhysicsAsset)
+{
+	const USkinnedAsset* SkinnedAsset = GetSkinnedAsset();
+	const int32 NumBones = SkinnedAsset ? SkinnedAsset->GetRefSkeleton().GetNum() : 0;
+
+	if (BlendMapPhysicsAssetVR.Get() == PhysicsAsset &&
+		BlendMapSkinnedAssetVR.Get() == SkinnedAsset &&
+		BlendMapNumBodySetupsVR == PhysicsAsset->SkeletalBodySetups.Num() &&
+		BlendBoneToBodyIndexVR.Num() == NumBones)
+	{
+		return;
+	}
+
+	BlendMapPhysicsAssetVR = PhysicsAsset;
+	BlendMapSkinnedAssetVR = SkinnedAsset;
+	BlendMapNumBodySetupsVR = PhysicsAsset->SkeletalBodySetups.Num();
+
+	BlendBoneToBodyIndexVR.SetNumUninitialized(NumBones);
+	for (int32 BoneIndex = 0; BoneIndex < NumBones; BoneIndex++)
+	{
+		BlendBoneToBodyIndexVR[BoneIndex] = PhysicsAsset->FindBodyIndex(SkinnedAsset->GetRefSkeleton().GetBoneName(BoneIndex));
+	}
+}
+
 void UInversePhysicsSkeletalMeshComponent::PerformBlendPhysicsBonesVR(const TArray<FBoneIndexType>& InRequiredBones, TArray<FTransform>& InOutComponentSpaceTransforms, TArray<FTransform>& InOutBoneSpaceTransforms)
 {
 	//SCOPE_CYCLE_COUNTER(STAT_BlendInPhysics);
@@ -287,7 +314,7 @@ void UInversePhysicsSkeletalMeshComponent::PerformBlendPhysicsBonesVR(const TArr
 	UPhysicsAsset* const PhysicsAsset = GetPhysicsAsset();
 	check(PhysicsAsset);
 
-	if (InOutComponentSpaceTransforms.Num() == 0)
+	if (InOutComponentSpaceTransforms.Num() == 0 || !GetSkinnedAsset())
 	{
 		return;
 	}
@@ -304,6 +331,9 @@ void UInversePhysicsSkeletalMeshComponent::PerformBlendPhysicsBonesVR(const TArr
 		return;
 	}
 
+	UpdateBlendBoneToBodyIndexVR(PhysicsAsset);
+	const FReferenceSkeleton& RefSkeleton = GetSkinnedAsset()->GetRefSkeleton();
+
 	FMemMark Mark(FMemStack::Get());
 	// Make sure scratch space is big enough.
 	TAssetWorldBoneTMArray WorldBoneTMs;
@@ -315,149 +345,188 @@ void UInversePhysicsSkeletalMeshComponent::PerformBlendPhysicsBonesVR(const TArr
 	LocalToWorldTM.SetScale3D(LocalToWorldTM.GetScale3D().GetSignVector());
 	LocalToWorldTM.NormalizeRotation();
 	//LocalToWorldTM.RemoveScaling();
-	struct FBodyTMPair
+
+	// Body state for each required bone, gathered in one pass so the physics read lock isn't held for the blend math
+	struct FBlendBodyDataVR
 	{
-		FBodyInstance* BI;
-		FTransform TM;
+		FTransform PhysTM;
+		float PhysWeight;
+		bool bHasBody;
+		bool bSimulating;
+		bool bSkipBone;
 	};
 
+	TArray<FBlendBodyDataVR, TMemStackAllocator<alignof(FBlendBodyDataVR)>> BlendBodies;
+	BlendBodies.SetNumUninitialized(InRequiredBones.Num());
+
+	bool bSimulatedRootBody = false;
+	FTransform NewComponentToWorld = FTransform::Identity;
+
 	FPhysicsCommand::ExecuteRead(this, [&]()
 		{
-			bool bSetParentScale = false;
-			const bool bSimulatedRootBody = Bodies.IsValidIndex(RootBodyData.BodyIndex) && Bodies[RootBodyData.BodyIndex]->IsInstanceSimulatingPhysics();
-			const FTransform NewComponentToWorld = bSimulatedRootBody ? GetComponentTransformFromBodyInstance(Bodies[RootBodyData.BodyIndex]) : FTransform::Identity;
+			bSimulatedRootBody = Bodies.IsValidIndex(RootBodyData.BodyIndex) && Bodies[RootBodyData.BodyIndex]->IsInstanceSimulatingPhysics();
+			NewComponentToWorld = bSimulatedRootBody ? GetComponentTransformFromBodyInstance(Bodies[RootBodyData.BodyIndex]) : FTransform::Identity;
 
-			// For each bone - see if we need to provide some data for it.
 			for (int32 i = 0; i < InRequiredBones.Num(); i++)
 			{
-				int32 BoneIndex = InRequiredBones[i];
+				const int32 BoneIndex = InRequiredBones[i];
+				FBlendBodyDataVR& BodyData = BlendBodies[i];
+				BodyData.PhysWeight = 0.f;
+				BodyData.bHasBody = false;
+				BodyData.bSimulating = false;
+				BodyData.bSkipBone = false;
 
 				// See if this is a physics bone..
-				int32 BodyIndex = PhysicsAsset->FindBodyIndex(GetSkeletalMeshAsset()->GetRefSkeleton().GetBoneName(BoneIndex));
-				// need to update back to physics so that physics knows where it was after blending
-				FBodyInstance* PhysicsAssetBodyInstance = nullptr;
+				const int32 BodyIndex = BlendBoneToBodyIndexVR.IsValidIndex(BoneIndex) ? BlendBoneToBodyIndexVR[BoneIndex] : INDEX_NONE;
 
-				// If so - get its world space matrix and its parents world space matrix and calc relative atom.
-				if (BodyIndex != INDEX_NONE)
+				if (BodyIndex == INDEX_NONE)
 				{
+					continue;
+				}
+
 #if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
-					// tracking down TTP 280421. Remove this if this doesn't happen. 
-					if (!ensure(Bodies.IsValidIndex(BodyIndex)))
-					{
-						UE_LOG(LogPhysics, Warning, TEXT("%s(Mesh %s, PhysicsAsset %s)"),
-							*GetName(), *GetNameSafe(GetSkeletalMeshAsset()), *GetNameSafe(PhysicsAsset));
-						UE_LOG(LogPhysics, Warning, TEXT(" - # of BodySetup (%d), # of Bodies (%d), Invalid BodyIndex(%d)"),
-							PhysicsAsset->SkeletalBodySetups.Num(), Bodies.Num(), BodyIndex);
-						continue;
-					}
+				// tracking down TTP 280421. Remove this if this doesn't happen. 
+				if (!ensure(Bodies.IsValidIndex(BodyIndex)))
+				{
+					UE_LOG(LogPhysics, Warning, TEXT("%s(Mesh %s, PhysicsAsset %s)"),
+						*GetName(), *GetNameSafe(GetSkeletalMeshAsset()), *GetNameSafe(PhysicsAsset));
+					UE_LOG(LogPhysics, Warning, TEXT(" - # of BodySetup (%d), # of Bodies (%d), Invalid BodyIndex(%d)"),
+						PhysicsAsset->SkeletalBodySetups.Num(), Bodies.Num(), BodyIndex);
+					BodyData.bSkipBone = true;
+					continue;
+				}
 #endif
-					PhysicsAssetBodyInstance = Bodies[BodyIndex];
 
-					//if simulated body copy back and blend with animation
-					if (PhysicsAssetBodyInstance->IsInstanceSimulatingPhysics())
+				FBodyInstance* PhysicsAssetBodyInstance = Bodies[BodyIndex];
+				BodyData.bHasBody = true;
+				BodyData.bSimulating = PhysicsAssetBodyInstance->IsInstanceSimulatingPhysics();
+
+				//if simulated body copy back and blend with animation
+				if (BodyData.bSimulating)
+				{
+					BodyData.PhysTM = PhysicsAssetBodyInstance->GetUnrealWorldTransform_AssumesLocked();
+					BodyData.PhysWeight = (bBlendPhysics) ? 1.f : PhysicsAssetBodyInstance->PhysicsBlendWeight;
+
+					// if the body instance is disabled, then we want to use the animation transform and ignore the physics one
+					if (PhysicsAssetBodyInstance->IsPhysicsDisabled())
 					{
-						FTransform PhysTM = PhysicsAssetBodyInstance->GetUnrealWorldTransform_AssumesLocked();
-
-						// Store this world-space transform in cache.
-						WorldBoneTMs[BoneIndex].TM = PhysTM;
-						WorldBoneTMs[BoneIndex].bUpToDate = true;
-
-						float UsePhysWeight = (bBlendPhysics) ? 1.f : PhysicsAssetBodyInstance->PhysicsBlendWeight;
-
-						// if the body instance is disabled, then we want to use the animation transform and ignore the physics one
-						if (PhysicsAssetBodyInstance->IsPhysicsDisabled())
-						{
-							UsePhysWeight = 0.0f;
-						}
-
-						// Find this bones parent matrix.
-						FTransform ParentWorldTM;
-
-						// if we wan't 'full weight' we just find 
-						if (UsePhysWeight > 0.f)
-						{
-							if (!(ensure(InOutBoneSpaceTransforms.Num())))
-							{
-								continue;
-							}
-
-							if (BoneIndex == 0)
-							{
-								ParentWorldTM = LocalToWorldTM;
-							}
-							else
-							{
-								// If not root, get parent TM from cache (making sure its up-to-date).
-								int32 ParentIndex = GetSkeletalMeshAsset()->GetRefSkeleton().GetParentIndex(BoneIndex);
-								UpdateWorldBoneTMVR(WorldBoneTMs, InOutBoneSpaceTransforms, ParentIndex, this, LocalToWorldTM, TotalScale3D);
-								ParentWorldTM = WorldBoneTMs[ParentIndex].TM;
-							}
-
-
-							// Then calc rel TM and convert to atom.
-							FTransform RelTM = PhysTM.GetRelativeTransform(ParentWorldTM);
-							RelTM.RemoveScaling();
-							FQuat RelRot(RelTM.GetRotation());
-							FVector RelPos = RecipScale3D * RelTM.GetLocation();
-							FTransform PhysAtom = FTransform(RelRot, RelPos, InOutBoneSpaceTransforms[BoneIndex].GetScale3D());
-
-							// Now blend in this atom. See if we are forcing this bone to always be blended in
-							InOutBoneSpaceTransforms[BoneIndex].Blend(InOutBoneSpaceTransforms[BoneIndex], PhysAtom, UsePhysWeight);
-
-							if (!bSetParentScale)
-							{
-								//We must update RecipScale3D based on the atom scale of the root
-								TotalScale3D *= InOutBoneSpaceTransforms[0].GetScale3D();
-								RecipScale3D = TotalScale3D.Reciprocal();
-								bSetParentScale = true;
-							}
-
-						}
+						BodyData.PhysWeight = 0.0f;
 					}
 				}
+				else if (bSimulatedRootBody && !bLocalSpaceKinematics)
+				{
+					// Kinematic bodies follow the simulated root
+					BodyData.PhysTM = PhysicsAssetBodyInstance->GetUnrealWorldTransform_AssumesLocked();
+				}
+			}
+		});	//end scope for read lock
+
+	// Blend outside of the lock, FTransform math here runs on the vectorized register path
+	bool bSetParentScale = false;
+
+	// For each bone - see if we need to provide some data for it.
+	for (int32 i = 0; i < InRequiredBones.Num(); i++)
+	{
+		const int32 BoneIndex = InRequiredBones[i];
+		const FBlendBodyDataVR& BodyData = BlendBodies[i];
+
+		if (BodyData.bSkipBone)
+		{
+			continue;
+		}
 
-				if (!(ensure(BoneIndex < InOutComponentSpaceTransforms.Num())))
+		// If so - get its world space matrix and its parents world space matrix and calc relative atom.
+		if (BodyData.bSimulating)
+		{
+			const FTransform& PhysTM = BodyData.PhysTM;
+
+			// Store this world-space transform in cache.
+			WorldBoneTMs[BoneIndex].TM = PhysTM;
+			WorldBoneTMs[BoneIndex].bUpToDate = true;
+
+			// if we wan't 'full weight' we just find 
+			if (BodyData.PhysWeight > 0.f)
+			{
+				if (!(ensure(InOutBoneSpaceTransforms.Num())))
 				{
 					continue;
 				}
 
-				// Update SpaceBases entry for this bone now
+				// Find this bones parent matrix.
+				FTransform ParentWorldTM;
+
 				if (BoneIndex == 0)
 				{
-					if (!(ensure(InOutBoneSpaceTransforms.Num())))
-					{
-						continue;
-					}
-					InOutComponentSpaceTransforms[0] = InOutBoneSpaceTransforms[0];
+					ParentWorldTM = LocalToWorldTM;
 				}
 				else
 				{
-					if (bLocalSpaceKinematics || BodyIndex == INDEX_NONE || Bodies[BodyIndex]->IsInstanceSimulatingPhysics())
-					{
-						if (!(ensure(BoneIndex < InOutBoneSpaceTransforms.Num())))
-						{
-							continue;
-						}
-						const int32 ParentIndex = GetSkeletalMeshAsset()->GetRefSkeleton().GetParentIndex(BoneIndex);
-						InOutComponentSpaceTransforms[BoneIndex] = InOutBoneSpaceTransforms[BoneIndex] * InOutComponentSpaceTransforms[ParentIndex];
-
-						/**
-						* Normalize rotations.
-						* We want to remove any loss of precision due to accumulation of error.
-						* i.e. A componentSpace transform is the accumulation of all of its local space parents. The further down the chain, the greater the error.
-						* SpaceBases are used by external systems, we feed this to Physics, send this to gameplay through bone and socket queries, etc.
-						* So this is a good place to make sure all transforms are normalized.
-						*/
-						InOutComponentSpaceTransforms[BoneIndex].NormalizeRotation();
-					}
-					else if (bSimulatedRootBody)
-					{
-						InOutComponentSpaceTransforms[BoneIndex] = Bodies[BodyIndex]->GetUnrealWorldTransform_AssumesLocked().GetRelativeTransform(NewComponentToWorld);
-					}
+					// If not root, get parent TM from cache (making sure its up-to-date).
+					int32 ParentIndex = RefSkeleton.GetParentIndex(BoneIndex);
+					UpdateWorldBoneTMVR(WorldBoneTMs, InOutBoneSpaceTransforms, ParentIndex, RefSkeleton, LocalToWorldTM, TotalScale3D);
+					ParentWorldTM = WorldBoneTMs[ParentIndex].TM;
+				}
+
+				// Then calc rel TM and convert to atom.
+				FTransform RelTM = PhysTM.GetRelativeTransform(ParentWorldTM);
+				RelTM.RemoveScaling();
+				FQuat RelRot(RelTM.GetRotation());
+				FVector RelPos = RecipScale3D * RelTM.GetLocation();
+				FTransform PhysAtom = FTransform(RelRot, RelPos, InOutBoneSpaceTransforms[BoneIndex].GetScale3D());
+
+				// Now blend in this atom. See if we are forcing this bone to always be blended in
+				InOutBoneSpaceTransforms[BoneIndex].Blend(InOutBoneSpaceTransforms[BoneIndex], PhysAtom, BodyData.PhysWeight);
+
+				if (!bSetParentScale)
+				{
+					//We must update RecipScale3D based on the atom scale of the root
+					TotalScale3D *= InOutBoneSpaceTransforms[0].GetScale3D();
+					RecipScale3D = TotalScale3D.Reciprocal();
+					bSetParentScale = true;
 				}
 			}
-		});	//end scope for read lock
+		}
 
+		if (!(ensure(BoneIndex < InOutComponentSpaceTransforms.Num())))
+		{
+			continue;
+		}
+
+		// Update SpaceBases entry for this bone now
+		if (BoneIndex == 0)
+		{
+			if (!(ensure(InOutBoneSpaceTransforms.Num())))
+			{
+				continue;
+			}
+			InOutComponentSpaceTransforms[0] = InOutBoneSpaceTransforms[0];
+		}
+		else
+		{
+			if (bLocalSpaceKinematics || !BodyData.bHasBody || BodyData.bSimulating)
+			{
+				if (!(ensure(BoneIndex < InOutBoneSpaceTransforms.Num())))
+				{
+					continue;
+				}
+				const int32 ParentIndex = RefSkeleton.GetParentIndex(BoneIndex);
+				InOutComponentSpaceTransforms[BoneIndex] = InOutBoneSpaceTransforms[BoneIndex] * InOutComponentSpaceTransforms[ParentIndex];
+
+				/**
+				* Normalize rotations.
+				* We want to remove any loss of precision due to accumulation of error.
+				* i.e. A componentSpace transform is the accumulation of all of its local space parents. The further down the chain, the greater the error.
+				* SpaceBases are used by external systems, we feed this to Physics, send this to gameplay through bone and socket queries, etc.
+				* So this is a good place to make sure all transforms are normalized.
+				*/
+				InOutComponentSpaceTransforms[BoneIndex].NormalizeRotation();
+			}
+			else if (bSimulatedRootBody)
+			{
+				InOutComponentSpaceTransforms[BoneIndex] = BodyData.PhysTM.GetRelativeTransform(NewComponentToWorld);
+			}
+		}
+	}
 }
 
 void UInversePhysicsSkeletalMeshComponent::RegisterEndPhysicsTick(bool bRegister)
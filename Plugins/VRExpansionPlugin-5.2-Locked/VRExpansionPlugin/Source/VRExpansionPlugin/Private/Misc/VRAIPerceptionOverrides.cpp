@@ -14,6 +14,7 @@
 #include "Perception/AISightTargetInterface.h"
 #include "Perception/AISenseConfig_Sight.h"
 #include "Perception/AIPerceptionSystem.h"
+#include "GripMotionControllerComponent.h"
 
 #if WITH_GAMEPLAY_DEBUGGER
 #include "GameplayDebuggerTypes.h"
@@ -42,6 +43,7 @@ DECLARE_CYCLE_STAT(TEXT("Perception Sense: Sight, Register Target"), STAT_AI_Sen
 DECLARE_CYCLE_STAT(TEXT("Perception Sense: Sight, Remove By Listener"), STAT_AI_Sense_Sight_RemoveByListener, STATGROUP_AI);
 DECLARE_CYCLE_STAT(TEXT("Perception Sense: Sight, Remove To Target"), STAT_AI_Sense_Sight_RemoveToTarget, STATGROUP_AI);
 DECLARE_CYCLE_STAT(TEXT("Perception Sense: Sight, Process pending result"), STAT_AI_Sense_Sight_ProcessPendingQuery, STATGROUP_AI);
+DECLARE_CYCLE_STAT(TEXT("Perception Sense: Sight, Spatial grid update"), STAT_AI_Sense_Sight_SpatialGrid, STATGROUP_AI);
 
 
 
@@ -51,6 +53,9 @@ static const int32 DefaultMinQueriesPerTimeSliceCheck = 40;
 static const float DefaultPendingQueriesBudgetReductionRatio = 0.5f;
 static const bool bDefaultUseAsynchronousTraceForDefaultSightQueries = false;
 static const float DefaultStimulusStrength = 1.f;
+static const float DefaultSpatialGridCellSize = 1000.f;
+static const float DefaultVisibilityCacheDuration = 0.2f;
+static const float DefaultVisibilityCacheInvalidationDistance = 20.f;
 
 enum class EForEachResult : uint8
 {
@@ -105,6 +110,12 @@ FORCEINLINE_DEBUGGABLE bool CheckIsTargetInSightPie(const FPerceptionListener& L
 	return false;
 }
 
+// Furthest a listener with these properties can see from its cached location
+FORCEINLINE float GetSpatialGridSightRange(const UAISense_Sight_VR::FDigestedSightProperties& DigestedProps)
+{
+	return static_cast<float>(FMath::Sqrt(FMath::Max3(DigestedProps.SightRadiusSq, DigestedProps.LoseSightRadiusSq, 0.f))) + DigestedProps.PointOfViewBackwardOffset;
+}
+
 //----------------------------------------------------------------------//
 // FAISightTargetVR
 //----------------------------------------------------------------------//
@@ -123,6 +134,146 @@ FAISightTargetVR::FAISightTargetVR(AActor* InTarget, FGenericTeamId InTeamId)
 	}
 }
 
+//----------------------------------------------------------------------//
+// FAISightSpatialGridVR
+//----------------------------------------------------------------------//
+bool FAISightSpatialGridVR::UpdateListener(const FPerceptionListenerID ListenerId, const FVector& Location, const float SightRange)
+{
+	const FIntPoint NewCell = GetCell(Location);
+	const int32 NewCellRadius = FMath::Max(0, FMath::CeilToInt32(SightRange / CellSize));
+
+	FListenerEntry* Entry = Listeners.Find(ListenerId);
+	if (Entry && Entry->Cell == NewCell && Entry->CellRadius == NewCellRadius)
+	{
+		return false;
+	}
+
+	if (Entry)
+	{
+		if (Entry->Cell != NewCell)
+		{
+			TArray<FPerceptionListenerID>& OldCellListeners = ListenersByCell.FindChecked(Entry->Cell);
+			OldCellListeners.RemoveSingleSwap(ListenerId, false);
+			if (OldCellListeners.Num() == 0)
+			{
+				ListenersByCell.Remove(Entry->Cell);
+			}
+
+			ListenersByCell.FindOrAdd(NewCell).Add(ListenerId);
+		}
+
+		const bool bRadiusShrunk = NewCellRadius < Entry->CellRadius;
+		Entry->Cell = NewCell;
+		Entry->CellRadius = NewCellRadius;
+
+		if (bRadiusShrunk)
+		{
+			RecalcMaxListenerCellRadius();
+		}
+	}
+	else
+	{
+		Listeners.Add(ListenerId, { NewCell, NewCellRadius });
+		ListenersByCell.FindOrAdd(NewCell).Add(ListenerId);
+	}
+
+	MaxListenerCellRadius = FMath::Max(MaxListenerCellRadius, NewCellRadius);
+	return true;
+}
+
+void FAISightSpatialGridVR::RemoveListener(const FPerceptionListenerID ListenerId)
+{
+	FListenerEntry Entry;
+	if (!Listeners.RemoveAndCopyValue(ListenerId, Entry))
+	{
+		return;
+	}
+
+	if (TArray<FPerceptionListenerID>* CellListeners = ListenersByCell.Find(Entry.Cell))
+	{
+		CellListeners->RemoveSingleSwap(ListenerId, false);
+		if (CellListeners->Num() == 0)
+		{
+			ListenersByCell.Remove(Entry.Cell);
+		}
+	}
+
+	if (Entry.CellRadius >= MaxListenerCellRadius)
+	{
+		RecalcMaxListenerCellRadius();
+	}
+}
+
+bool FAISightSpatialGridVR::UpdateTarget(const FAISightTargetVR::FTargetId TargetId, const FVector& Location)
+{
+	const FIntPoint NewCell = GetCell(Location);
+
+	FIntPoint* Cell = Targets.Find(TargetId);
+	if (Cell && *Cell == NewCell)
+	{
+		return false;
+	}
+
+	if (Cell)
+	{
+		TArray<FAISightTargetVR::FTargetId>& OldCellTargets = TargetsByCell.FindChecked(*Cell);
+		OldCellTargets.RemoveSingleSwap(TargetId, false);
+		if (OldCellTargets.Num() == 0)
+		{
+			TargetsByCell.Remove(*Cell);
+		}
+
+		*Cell = NewCell;
+	}
+	else
+	{
+		Targets.Add(TargetId, NewCell);
+	}
+
+	TargetsByCell.FindOrAdd(NewCell).Add(TargetId);
+	return true;
+}
+
+void FAISightSpatialGridVR::RemoveTarget(const FAISightTargetVR::FTargetId TargetId)
+{
+	FIntPoint Cell;
+	if (!Targets.RemoveAndCopyValue(TargetId, Cell))
+	{
+		return;
+	}
+
+	if (TArray<FAISightTargetVR::FTargetId>* CellTargets = TargetsByCell.Find(Cell))
+	{
+		CellTargets->RemoveSingleSwap(TargetId, false);
+		if (CellTargets->Num() == 0)
+		{
+			TargetsByCell.Remove(Cell);
+		}
+	}
+}
+
+bool FAISightSpatialGridVR::IsPairNear(const FPerceptionListenerID ListenerId, const FAISightTargetVR::FTargetId TargetId) const
+{
+	const FListenerEntry* ListenerEntry = Listeners.Find(ListenerId);
+	const FIntPoint* TargetCell = Targets.Find(TargetId);
+
+	if (!ListenerEntry || !TargetCell)
+	{
+		return true;
+	}
+
+	return FMath::Abs(TargetCell->X - ListenerEntry->Cell.X) <= ListenerEntry->CellRadius && FMath::Abs(TargetCell->Y - ListenerEntry->Cell.Y) <= ListenerEntry->CellRadius;
+}
+
+void FAISightSpatialGridVR::RecalcMaxListenerCellRadius()
+{
+	MaxListenerCellRadius = 0;
+	for (const TPair<FPerceptionListenerID, FListenerEntry>& ListenerPair : Listeners)
+	{
+		MaxListenerCellRadius = FMath::Max(MaxListenerCellRadius, ListenerPair.Value.CellRadius);
+	}
+}
+
 //----------------------------------------------------------------------//
 // FDigestedSightProperties
 //----------------------------------------------------------------------//
@@ -157,6 +308,11 @@ UAISense_Sight_VR::UAISense_Sight_VR(const FObjectInitializer& ObjectInitializer
 	, SightLimitQueryImportance(10.f)
 	, PendingQueriesBudgetReductionRatio(DefaultPendingQueriesBudgetReductionRatio)
 	, bUseAsynchronousTraceForDefaultSightQueries(bDefaultUseAsynchronousTraceForDefaultSightQueries)
+	, SpatialGridCellSize(DefaultSpatialGridCellSize)
+	, bTraceVRCharacterHeadAndHands(true)
+	, VisibilityCacheDuration(DefaultVisibilityCacheDuration)
+	, VisibilityCacheInvalidationDistance(DefaultVisibilityCacheInvalidationDistance)
+	, LastVisibilityCachePruneTime(0.0)
 {
 	if (HasAnyFlags(RF_ClassDefaultObject) == false)
 	{
@@ -190,6 +346,8 @@ void UAISense_Sight_VR::PostInitProperties()
 {
 	Super::PostInitProperties();
 	HighImportanceDistanceSquare = FMath::Square(HighImportanceQueryDistanceThreshold);
+	SpatialGrid.CellSize = SpatialGridCellSize;
+	VisibilityCacheInvalidationDistanceSq = FMath::Square(VisibilityCacheInvalidationDistance);
 }
 
 #if WITH_EDITOR
@@ -307,6 +465,21 @@ float UAISense_Sight_VR::Update()
 
 	UE_MT_SCOPED_WRITE_ACCESS(QueriesListAccessDetector);
 
+	if (IsSpatialGridEnabled())
+	{
+		UpdateSpatialGrid();
+	}
+
+	if (VisibilityCacheDuration > 0.f && World->GetTimeSeconds() - LastVisibilityCachePruneTime > VisibilityCacheDuration)
+	{
+		PruneVisibilityCache(World->GetTimeSeconds());
+	}
+
+	const auto InRangeHeapPredicate = [this](const int32 A, const int32 B)->bool
+	{
+		return FAISightQueryVR::FSortPredicate()(SightQueriesInRange[A], SightQueriesInRange[B]);
+	};
+
 	// sort Sight Queries
 	{
 		auto RecalcScore = [](FAISightQueryVR& SightQuery)->EForEachResult
@@ -325,14 +498,22 @@ float UAISense_Sight_VR::Update()
 			bSightQueriesOutOfRangeDirty = false;
 		}
 
-		// Sort in range queries
+		// Heap the in range queries, the update budget only ever consumes the top few of them so a full sort is wasted
 		ForEach(SightQueriesInRange, RecalcScore);
-		SightQueriesInRange.Sort(FAISightQueryVR::FSortPredicate());
+		InRangeQueryHeap.Reset(SightQueriesInRange.Num());
+		for (int32 Index = 0; Index < SightQueriesInRange.Num(); ++Index)
+		{
+			InRangeQueryHeap.Add(Index);
+		}
+		InRangeQueryHeap.Heapify(InRangeHeapPredicate);
 	}
 
 	int32 TracesCount = 0;
 	int32 AsyncTracesCount = FMath::Max(0, static_cast<int32>(PendingQueriesBudgetReductionRatio * SightQueriesPending.Num()));	// pending queries should be requesting async collisions traces at this frame, so we might want to restrain ourself in this update
 	int32 NumQueriesProcessed = 0;
+
+	// A default query requests a trace per candidate point (head and both hands), keep room for all of them once this update has started tracing
+	const int32 MaxTracesPerQuery = bTraceVRCharacterHeadAndHands ? 3 : 1;
 	const double TimeSliceEnd = FPlatformTime::Seconds() + MaxTimeSlicePerTick;
 	bool bHitTimeSliceLimit = false;
 #if AISENSE_SIGHT_TIMESLICING_DEBUG
@@ -359,7 +540,6 @@ float UAISense_Sight_VR::Update()
 
 	AIPerception::FListenerMap& ListenersMap = *GetListeners();
 
-	int32 InRangeItr = 0;
 	int32 OutOfRangeItr = 0;
 	for (int32 QueryIndex = 0; QueryIndex < SightQueriesInRange.Num() + SightQueriesOutOfRange.Num(); ++QueryIndex)
 	{
@@ -375,8 +555,14 @@ float UAISense_Sight_VR::Update()
 			break;
 		}
 
+		if ((AsyncTracesCount > 0 && AsyncTracesCount + MaxTracesPerQuery > MaxAsyncTracesPerTick) ||
+			(TracesCount > 0 && TracesCount + MaxTracesPerQuery > MaxTracesPerTick))
+		{
+			break;
+		}
+
 		// Calculate next in range query
-		int32 InRangeIndex = SightQueriesInRange.IsValidIndex(InRangeItr) ? InRangeItr : INDEX_NONE;
+		int32 InRangeIndex = InRangeQueryHeap.Num() > 0 ? InRangeQueryHeap.HeapTop() : INDEX_NONE;
 		FAISightQueryVR* InRangeQuery = InRangeIndex != INDEX_NONE ? &SightQueriesInRange[InRangeIndex] : nullptr;
 
 		// Calculate next out of range query
@@ -396,7 +582,14 @@ float UAISense_Sight_VR::Update()
 		SlicingInfo.PushQueryInfo(bIsInRangeQuery, SightQuery->GetAge());
 #endif //AISENSE_SIGHT_TIMESLICING_DEBUG
 
-		bIsInRangeQuery ? ++InRangeItr : ++OutOfRangeItr;
+		if (bIsInRangeQuery)
+		{
+			InRangeQueryHeap.HeapPopDiscard(InRangeHeapPredicate, /*bAllowShrinking*/false);
+		}
+		else
+		{
+			++OutOfRangeItr;
+		}
 
 		FPerceptionListener& Listener = ListenersMap[SightQuery->ObserverId];
 		FAISightTargetVR& Target = ObservedTargets[SightQuery->TargetId];
@@ -510,7 +703,9 @@ float UAISense_Sight_VR::Update()
 			}break;
 
 			case EOperationType::Remove:
-				break;
+			{
+				QueryPairs.Remove(MakeQueryPairKey(Operation.bInRange ? SightQueriesInRange[Operation.Index] : SightQueriesOutOfRange[Operation.Index]));
+			}break;
 
 			default:
 				check(false);
@@ -519,7 +714,7 @@ float UAISense_Sight_VR::Update()
 
 			if (Operation.bInRange)
 			{
-				// In range queries are always sorted at the beginning of the update
+				// In range queries are always heaped at the beginning of the update
 				SightQueriesInRange.RemoveAtSwap(Operation.Index, 1, /*bAllowShrinking*/false);
 			}
 			else
@@ -550,6 +745,7 @@ float UAISense_Sight_VR::Update()
 				RemoveAllQueriesToTarget(TargetId);
 				// remove target itself
 				ObservedTargets.Remove(TargetId);
+				SpatialGrid.RemoveTarget(TargetId);
 			}
 
 			// remove holes
@@ -557,11 +753,14 @@ float UAISense_Sight_VR::Update()
 		}
 	}
 
+	// Queries are all in the pending list now, send their traces off together
+	SubmitSightTraceBatch(World);
+
 	//return SightQueryQueue.Num() > 0 ? 1.f/6 : FLT_MAX;
 	return 0.f;
 }
 
-UAISense_Sight::EVisibilityResult UAISense_Sight_VR::ComputeVisibility(UWorld* World, FAISightQueryVR& SightQuery, FPerceptionListener& Listener, const AActor* ListenerActor, FAISightTargetVR& Target, AActor* TargetActor, const FDigestedSightProperties& PropDigest, float& OutStimulusStrength, FVector& OutSeenLocation, int32& OutNumberOfLoSChecksPerformed, int32& OutNumberOfAsyncLosCheckRequested) const
+UAISense_Sight::EVisibilityResult UAISense_Sight_VR::ComputeVisibility(UWorld* World, FAISightQueryVR& SightQuery, FPerceptionListener& Listener, const AActor* ListenerActor, FAISightTargetVR& Target, AActor* TargetActor, const FDigestedSightProperties& PropDigest, float& OutStimulusStrength, FVector& OutSeenLocation, int32& OutNumberOfLoSChecksPerformed, int32& OutNumberOfAsyncLosCheckRequested)
 {
 	SCOPE_CYCLE_COUNTER(STAT_AI_Sense_Sight_ComputeVisibility);
 
@@ -626,43 +825,179 @@ UAISense_Sight::EVisibilityResult UAISense_Sight_VR::ComputeVisibility(UWorld* W
 	else
 	{
 		// we need to do tests ourselves
+		const uint64 PairKey = MakeQueryPairKey(SightQuery);
+		const double CurrentTime = World->GetTimeSeconds();
+
+		TArray<FVector, TInlineAllocator<3>> CandidatePoints;
+		GetSightCandidatePoints(TargetActor, TargetLocation, CandidatePoints);
 
-		const FCollisionQueryParams QueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(AILineOfSight), true, ListenerActor);
+		if (const FAISightVisibilityCacheEntryVR* CachedVisibility = FindCachedVisibility(PairKey, Listener.CachedLocation, CandidatePoints, CurrentTime))
+		{
+			if (CachedVisibility->bVisible)
+			{
+				OutSeenLocation = CachedVisibility->SeenLocation;
+				return UAISense_Sight::EVisibilityResult::Visible;
+			}
+
+			return UAISense_Sight::EVisibilityResult::NotVisible;
+		}
 
 		if (bUseAsynchronousTraceForDefaultSightQueries)
 		{
-			const FTraceHandle TraceHandle = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Listener.CachedLocation, TargetLocation, DefaultSightCollisionChannel, QueryParams, FCollisionResponseParams::DefaultResponseParam, &OnPendingTraceQueryProcessedDelegate);
-			if (!TraceHandle.IsValid())
+			// Traces are gathered and submitted together at the end of the update, the query resolves once all of its points report back
+			FAISightPendingTracesVR& PendingTraces = PendingSightTraces.FindOrAdd(PairKey);
+			PendingTraces.ObserverId = SightQuery.ObserverId;
+			PendingTraces.TargetId = SightQuery.TargetId;
+			PendingTraces.RequestTime = CurrentTime;
+			PendingTraces.ListenerLocation = Listener.CachedLocation;
+			PendingTraces.TargetPoints = CandidatePoints;
+
+			for (const FVector& CandidatePoint : CandidatePoints)
 			{
-				return UAISense_Sight::EVisibilityResult::NotVisible;
+				SightTraceBatch.Add({ PairKey, Listener.CachedLocation, CandidatePoint, ListenerActor });
+				++PendingTraces.NumPendingTraces;
 			}
 
-			++OutNumberOfAsyncLosCheckRequested;
+			OutNumberOfAsyncLosCheckRequested += CandidatePoints.Num();
 
-			// store the trace handle information here so that we can identify the associated query when we'll receive the delegate callback
-			SightQuery.SetTraceInfo(TraceHandle);
+			// batched traces find their query by pair, clear the trace info so engine processed queries can't match it
+			SightQuery.SetTraceInfo(FTraceHandle());
 			return UAISense_Sight::EVisibilityResult::Pending;
 		}
 		else
 		{
-			FHitResult HitResult;
-			const bool bHit = World->LineTraceSingleByChannel(HitResult, Listener.CachedLocation, TargetLocation, DefaultSightCollisionChannel, QueryParams, FCollisionResponseParams::DefaultResponseParam);
-
-			++OutNumberOfLoSChecksPerformed;
+			const FCollisionQueryParams QueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(AILineOfSight), true, ListenerActor);
 
-			if (UE::AISense_SightVR::IsTraceConsideredVisible(bHit ? &HitResult : nullptr, TargetActor))
-			{
-				OutSeenLocation = TargetLocation;
-				return UAISense_Sight::EVisibilityResult::Visible;
-			}
-			else
+			bool bIsVisible = false;
+			for (const FVector& CandidatePoint : CandidatePoints)
 			{
-				return UAISense_Sight::EVisibilityResult::NotVisible;
+				FHitResult HitResult;
+				const bool bHit = World->LineTraceSingleByChannel(HitResult, Listener.CachedLocation, CandidatePoint, DefaultSightCollisionChannel, QueryParams, FCollisionResponseParams::DefaultResponseParam);
+
+				++OutNumberOfLoSChecksPerformed;
+
+				if (UE::AISense_SightVR::IsTraceConsideredVisible(bHit ? &HitResult : nullptr, TargetActor))
+				{
+					OutSeenLocation = CandidatePoint;
+					bIsVisible = true;
+					break;
+				}
 			}
+
+			CacheVisibility(PairKey, Listener.CachedLocation, CandidatePoints, bIsVisible, OutSeenLocation, CurrentTime);
+			return bIsVisible ? UAISense_Sight::EVisibilityResult::Visible : UAISense_Sight::EVisibilityResult::NotVisible;
 		}
 	}
 }
 
+void UAISense_Sight_VR::GetSightCandidatePoints(const AActor* TargetActor, const FVector& TargetLocation, TArray<FVector, TInlineAllocator<3>>& OutPoints) const
+{
+	const AVRBaseCharacter* VRChar = bTraceVRCharacterHeadAndHands ? Cast<const AVRBaseCharacter>(TargetActor) : nullptr;
+	if (!VRChar)
+	{
+		OutPoints.Add(TargetLocation);
+		return;
+	}
+
+	OutPoints.Add(VRChar->GetVRHeadLocation());
+
+	if (VRChar->LeftMotionController)
+	{
+		OutPoints.Add(VRChar->LeftMotionController->GetComponentLocation());
+	}
+
+	if (VRChar->RightMotionController)
+	{
+		OutPoints.Add(VRChar->RightMotionController->GetComponentLocation());
+	}
+}
+
+const FAISightVisibilityCacheEntryVR* UAISense_Sight_VR::FindCachedVisibility(const uint64 PairKey, const FVector& ListenerLocation, const TArray<FVector, TInlineAllocator<3>>& TargetPoints, const double CurrentTime) const
+{
+	if (VisibilityCacheDuration <= 0.f)
+	{
+		return nullptr;
+	}
+
+	const FAISightVisibilityCacheEntryVR* CacheEntry = VisibilityCache.Find(PairKey);
+	if (!CacheEntry || CurrentTime - CacheEntry->Time > VisibilityCacheDuration)
+	{
+		return nullptr;
+	}
+
+	if (FVector::DistSquared(CacheEntry->ListenerLocation, ListenerLocation) > VisibilityCacheInvalidationDistanceSq ||
+		CacheEntry->TargetPoints.Num() != TargetPoints.Num())
+	{
+		return nullptr;
+	}
+
+	// A hand coming out from behind cover changes the result as much as the head does
+	for (int32 PointIndex = 0; PointIndex < TargetPoints.Num(); ++PointIndex)
+	{
+		if (FVector::DistSquared(CacheEntry->TargetPoints[PointIndex], TargetPoints[PointIndex]) > VisibilityCacheInvalidationDistanceSq)
+		{
+			return nullptr;
+		}
+	}
+
+	return CacheEntry;
+}
+
+void UAISense_Sight_VR::CacheVisibility(const uint64 PairKey, const FVector& ListenerLocation, const TArray<FVector, TInlineAllocator<3>>& TargetPoints, const bool bVisible, const FVector& SeenLocation, const double CurrentTime)
+{
+	if (VisibilityCacheDuration <= 0.f)
+	{
+		return;
+	}
+
+	FAISightVisibilityCacheEntryVR& CacheEntry = VisibilityCache.FindOrAdd(PairKey);
+	CacheEntry.Time = CurrentTime;
+	CacheEntry.ListenerLocation = ListenerLocation;
+	CacheEntry.TargetPoints = TargetPoints;
+	CacheEntry.SeenLocation = SeenLocation;
+	CacheEntry.bVisible = bVisible;
+}
+
+void UAISense_Sight_VR::PruneVisibilityCache(const double CurrentTime)
+{
+	LastVisibilityCachePruneTime = CurrentTime;
+
+	for (TMap<uint64, FAISightVisibilityCacheEntryVR>::TIterator It(VisibilityCache); It; ++It)
+	{
+		if (CurrentTime - It->Value.Time > VisibilityCacheDuration)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UAISense_Sight_VR::SubmitSightTraceBatch(UWorld* World)
+{
+	if (SightTraceBatch.Num() == 0)
+	{
+		return;
+	}
+
+	// Sent back to back so they all land in the same async trace buffer and get run together
+	for (const FAISightTraceRequestVR& TraceRequest : SightTraceBatch)
+	{
+		const FCollisionQueryParams QueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(AILineOfSight), true, TraceRequest.IgnoreActor);
+		const FTraceHandle TraceHandle = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, TraceRequest.Start, TraceRequest.End, DefaultSightCollisionChannel, QueryParams, FCollisionResponseParams::DefaultResponseParam, &OnPendingTraceQueryProcessedDelegate);
+
+		if (TraceHandle.IsValid())
+		{
+			SightTraceHandleToPair.Add(TraceHandle._Handle, TraceRequest.PairKey);
+		}
+		else
+		{
+			// Couldn't trace to this point, count it as blocked
+			OnBatchedSightTraceProcessed(TraceRequest.PairKey, false, TraceRequest.End);
+		}
+	}
+
+	SightTraceBatch.Reset();
+}
+
 void UAISense_Sight_VR::UpdateQueryVisibilityStatus(FAISightQueryVR& SightQuery, FPerceptionListener& Listener, const bool bIsVisible, const FVector& SeenLocation, const float StimulusStrength, AActor* TargetActor, const FVector& TargetLocation) const
 {
 	if (bIsVisible)
@@ -718,26 +1053,64 @@ void UAISense_Sight_VR::OnPendingTraceQueryProcessed(const FTraceHandle& TraceHa
 	SCOPE_CYCLE_COUNTER(STAT_AI_Sense_Sight_ProcessPendingQuery);
 	UE_MT_SCOPED_WRITE_ACCESS(QueriesListAccessDetector);
 
-	const int32 QueryIdx = SightQueriesPending.IndexOfByPredicate([&TraceHandle](const FAISightQueryVR& Element)
+	uint64 PairKey = 0;
+	if (!SightTraceHandleToPair.RemoveAndCopyValue(TraceHandle._Handle, PairKey))
+	{
+		// not one of our batched traces
+		return;
+	}
+
+	AActor* TargetActor = nullptr;
+	if (const FAISightPendingTracesVR* PendingTraces = PendingSightTraces.Find(PairKey))
+	{
+		if (const FAISightTargetVR* Target = ObservedTargets.Find(PendingTraces->TargetId))
 		{
-			return Element.TraceInfo.FrameNumber == TraceHandle._Data.FrameNumber
-				&& Element.TraceInfo.Index == TraceHandle._Data.Index;
-		});
+			TargetActor = Target->Target.Get();
+		}
+	}
 
-	if (QueryIdx == INDEX_NONE)
+	const bool bIsVisible = TargetActor && UE::AISense_SightVR::IsTraceConsideredVisible(TraceDatum.OutHits.Num() > 0 ? &TraceDatum.OutHits[0] : nullptr, TargetActor);
+
+	OnBatchedSightTraceProcessed(PairKey, bIsVisible, TraceDatum.End);
+}
+
+void UAISense_Sight_VR::OnBatchedSightTraceProcessed(const uint64 PairKey, const bool bIsVisible, const FVector& TracedLocation)
+{
+	FAISightPendingTracesVR* PendingTraces = PendingSightTraces.Find(PairKey);
+	if (PendingTraces == nullptr)
 	{
-		// the query is not pending. It must have been removed because the source or the target have been removed
 		return;
 	}
 
-	AActor* TargetActor = nullptr;
-	if (const FAISightTargetVR* Target = ObservedTargets.Find(SightQueriesPending[QueryIdx].TargetId))
+	if (bIsVisible && !PendingTraces->bAnyVisible)
+	{
+		PendingTraces->bAnyVisible = true;
+		PendingTraces->SeenLocation = TracedLocation;
+	}
+
+	if (--PendingTraces->NumPendingTraces > 0)
+	{
+		return;
+	}
+
+	const FAISightPendingTracesVR CompletedTraces = MoveTemp(*PendingTraces);
+	PendingSightTraces.Remove(PairKey);
+
+	CacheVisibility(PairKey, CompletedTraces.ListenerLocation, CompletedTraces.TargetPoints, CompletedTraces.bAnyVisible, CompletedTraces.SeenLocation, CompletedTraces.RequestTime);
+
+	const int32 QueryIdx = SightQueriesPending.IndexOfByPredicate([&CompletedTraces](const FAISightQueryVR& Element)
+		{
+			return Element.ObserverId == CompletedTraces.ObserverId
+				&& Element.TargetId == CompletedTraces.TargetId;
+		});
+
+	if (QueryIdx == INDEX_NONE)
 	{
-		TargetActor = Target->Target.Get();
+		// the query is not pending. It must have been removed because the source or the target have been removed
+		return;
 	}
-	const bool bIsVisible = UE::AISense_SightVR::IsTraceConsideredVisible(TraceDatum.OutHits.Num() > 0 ? &TraceDatum.OutHits[0] : nullptr, TargetActor);
 
-	OnPendingQueryProcessed(QueryIdx, bIsVisible, DefaultStimulusStrength, TraceDatum.End, NullOpt, TargetActor);
+	OnPendingQueryProcessed(QueryIdx, CompletedTraces.bAnyVisible, DefaultStimulusStrength, CompletedTraces.SeenLocation, NullOpt);
 }
 
 void UAISense_Sight_VR::OnPendingQueryProcessed(const int32 SightQueryIndex, const bool bIsVisible, const float StimulusStrength, const FVector& SeenLocation, const TOptional<int32>& UserData, const TOptional<AActor*> InTargetActor)
@@ -749,6 +1122,7 @@ void UAISense_Sight_VR::OnPendingQueryProcessed(const int32 SightQueryIndex, con
 	FPerceptionListener* Listener = ListenersMap.Find(SightQuery.ObserverId);
 	if (Listener == nullptr)
 	{
+		QueryPairs.Remove(MakeQueryPairKey(SightQuery));
 		return;
 	}
 
@@ -765,6 +1139,7 @@ void UAISense_Sight_VR::OnPendingQueryProcessed(const int32 SightQueryIndex, con
 
 	if (TargetActor == nullptr)
 	{
+		QueryPairs.Remove(MakeQueryPairKey(SightQuery));
 		return;
 	}
 
@@ -823,6 +1198,8 @@ void UAISense_Sight_VR::UnregisterSource(AActor& SourceActor)
 	const FAISightTargetVR::FTargetId AsTargetId = SourceActor.GetUniqueID();
 	FAISightTargetVR AsTarget;
 
+	SpatialGrid.RemoveTarget(AsTargetId);
+
 
 	if (ObservedTargets.RemoveAndCopyValue(AsTargetId, AsTarget)
 		&& (SightQueriesInRange.Num() + SightQueriesOutOfRange.Num()) > 0)
@@ -847,6 +1224,7 @@ void UAISense_Sight_VR::UnregisterSource(AActor& SourceActor)
 						Listener.RegisterStimulus(TargetActor, FAIStimulus(*this, 0.f, SightQuery->LastSeenLocation, Listener.CachedLocation, FAIStimulus::SensingFailed));
 					}
 
+					QueryPairs.Remove(MakeQueryPairKey(*SightQuery));
 					SightQueries.RemoveAtSwap(QueryIndex, 1, /*bAllowShrinking=*/false);
 					return EReverseForEachResult::Modified;
 				}
@@ -898,6 +1276,11 @@ bool UAISense_Sight_VR::RegisterTarget(AActor& TargetActor, const TFunction<void
 	const AVRBaseCharacter * VRChar = Cast<const AVRBaseCharacter>(&TargetActor);
 	const FVector TargetLocation = VRChar != nullptr ? VRChar->GetVRLocation_Inline() : TargetActor.GetActorLocation();
 
+	if (IsSpatialGridEnabled())
+	{
+		SpatialGrid.UpdateTarget(SightTarget->TargetId, TargetLocation);
+	}
+
 	for (AIPerception::FListenerMap::TConstIterator ItListener(ListenersMap); ItListener; ++ItListener)
 	{
 		const FPerceptionListener& Listener = ItListener->Value;
@@ -907,6 +1290,12 @@ bool UAISense_Sight_VR::RegisterTarget(AActor& TargetActor, const TFunction<void
 			continue;
 		}
 
+		// Listeners too far away pick this target up from the grid update once they get close enough
+		if (IsSpatialGridEnabled() && !SpatialGrid.IsPairNear(Listener.GetListenerID(), SightTarget->TargetId))
+		{
+			continue;
+		}
+
 		const FDigestedSightProperties& PropDigest = DigestedProperties[Listener.GetListenerID()];
 		const IGenericTeamAgentInterface* ListenersTeamAgent = Listener.GetTeamAgent();
 		if (RegisterNewQuery(Listener, ListenersTeamAgent, TargetActor, SightTarget->TargetId, TargetLocation, PropDigest, OnAddedFunc))
@@ -943,6 +1332,12 @@ void UAISense_Sight_VR::GenerateQueriesForListener(const FPerceptionListener& Li
 	const IGenericTeamAgentInterface* ListenersTeamAgent = Listener.GetTeamAgent();
 	const AActor* Avatar = Listener.GetBodyActor();
 
+	const bool bUseSpatialGrid = IsSpatialGridEnabled();
+	if (bUseSpatialGrid)
+	{
+		UpdateSpatialGridListener(Listener, PropertyDigest);
+	}
+
 	// create sight queries with all legal targets
 	for (FTargetsContainer::TConstIterator ItTarget(ObservedTargets); ItTarget; ++ItTarget)
 	{
@@ -952,6 +1347,11 @@ void UAISense_Sight_VR::GenerateQueriesForListener(const FPerceptionListener& Li
 			continue;
 		}
 
+		if (bUseSpatialGrid && !SpatialGrid.IsPairNear(Listener.GetListenerID(), ItTarget->Key))
+		{
+			continue;
+		}
+
 		// Changed this up to support my VR Characters
 		const AVRBaseCharacter* VRChar = Cast<const AVRBaseCharacter>(TargetActor);
 		const FVector TargetLocation = VRChar != nullptr ? VRChar->GetVRLocation_Inline() : TargetActor->GetActorLocation();
@@ -975,6 +1375,14 @@ bool UAISense_Sight_VR::RegisterNewQuery(const FPerceptionListener& Listener, co
 		return false;
 	}
 
+	// Only ever one query per observer-target pair
+	bool bAlreadyHasQuery = false;
+	QueryPairs.Add(MakeQueryPairKey(Listener.GetListenerID(), TargetId), &bAlreadyHasQuery);
+	if (bAlreadyHasQuery)
+	{
+		return false;
+	}
+
 	// create a sight query
 	const float Importance = CalcQueryImportance(Listener, TargetLocation, PropDigest.SightRadiusSq);
 	const bool bInRange = Importance > 0.0f;
@@ -996,6 +1404,132 @@ bool UAISense_Sight_VR::RegisterNewQuery(const FPerceptionListener& Listener, co
 	return true;
 }
 
+void UAISense_Sight_VR::UpdateSpatialGridListener(const FPerceptionListener& Listener, const FDigestedSightProperties& PropDigest)
+{
+	SpatialGrid.UpdateListener(Listener.GetListenerID(), Listener.CachedLocation, GetSpatialGridSightRange(PropDigest));
+}
+
+void UAISense_Sight_VR::UpdateSpatialGrid()
+{
+	SCOPE_CYCLE_COUNTER(STAT_AI_Sense_Sight_SpatialGrid);
+
+	AIPerception::FListenerMap& ListenersMap = *GetListeners();
+
+	TSet<FPerceptionListenerID> MovedListeners;
+	TSet<FAISightTargetVR::FTargetId> MovedTargets;
+
+	for (const TPair<FPerceptionListenerID, FDigestedSightProperties>& DigestPair : DigestedProperties)
+	{
+		const FPerceptionListener* Listener = ListenersMap.Find(DigestPair.Key);
+		if (Listener && SpatialGrid.UpdateListener(DigestPair.Key, Listener->CachedLocation, GetSpatialGridSightRange(DigestPair.Value)))
+		{
+			MovedListeners.Add(DigestPair.Key);
+		}
+	}
+
+	for (const TPair<FAISightTargetVR::FTargetId, FAISightTargetVR>& TargetPair : ObservedTargets)
+	{
+		if (TargetPair.Value.Target.IsValid() && SpatialGrid.UpdateTarget(TargetPair.Key, TargetPair.Value.GetLocationSimple()))
+		{
+			MovedTargets.Add(TargetPair.Key);
+		}
+	}
+
+	if (MovedListeners.Num() == 0 && MovedTargets.Num() == 0)
+	{
+		return;
+	}
+
+	// Drop queries between pairs that moved out of range of each other
+	// Visible ones are kept so that losing sight and auto success still resolve through the normal update, pending ones resolve on their own
+	auto ShouldDropQuery = [this, &MovedListeners, &MovedTargets](const FAISightQueryVR& SightQuery)->bool
+	{
+		if (SightQuery.GetLastResult() || (!MovedListeners.Contains(SightQuery.ObserverId) && !MovedTargets.Contains(SightQuery.TargetId)))
+		{
+			return false;
+		}
+
+		if (SpatialGrid.IsPairNear(SightQuery.ObserverId, SightQuery.TargetId))
+		{
+			return false;
+		}
+
+		QueryPairs.Remove(MakeQueryPairKey(SightQuery));
+		return true;
+	};
+
+	SightQueriesInRange.RemoveAllSwap(ShouldDropQuery, /*bAllowShrinking*/false);
+
+	// Compact the out of range queries in place to keep them ordered
+	const int32 PreviousNextOutOfRangeIndex = NextOutOfRangeIndex;
+	int32 WriteIndex = 0;
+	for (int32 ReadIndex = 0; ReadIndex < SightQueriesOutOfRange.Num(); ++ReadIndex)
+	{
+		if (ShouldDropQuery(SightQueriesOutOfRange[ReadIndex]))
+		{
+			if (ReadIndex < PreviousNextOutOfRangeIndex)
+			{
+				--NextOutOfRangeIndex;
+			}
+			continue;
+		}
+
+		if (WriteIndex != ReadIndex)
+		{
+			SightQueriesOutOfRange[WriteIndex] = SightQueriesOutOfRange[ReadIndex];
+		}
+		++WriteIndex;
+	}
+	SightQueriesOutOfRange.SetNum(WriteIndex, /*bAllowShrinking*/false);
+
+	if (NextOutOfRangeIndex >= SightQueriesOutOfRange.Num())
+	{
+		NextOutOfRangeIndex = 0;
+	}
+
+	// Generate queries for pairs that came into range, RegisterNewQuery skips the ones that already have a query
+	auto TryRegisterQuery = [this, &ListenersMap](const FPerceptionListenerID ListenerId, const FAISightTargetVR::FTargetId TargetId)
+	{
+		const FPerceptionListener* Listener = ListenersMap.Find(ListenerId);
+		const FAISightTargetVR* Target = ObservedTargets.Find(TargetId);
+		const AActor* TargetActor = Target ? Target->GetTargetActor() : nullptr;
+
+		if (!Listener || !TargetActor || Listener->GetBodyActor() == TargetActor || !Listener->HasSense(GetSenseID()))
+		{
+			return;
+		}
+
+		if (QueryPairs.Contains(MakeQueryPairKey(ListenerId, TargetId)))
+		{
+			return;
+		}
+
+		RegisterNewQuery(*Listener, Listener->GetTeamAgent(), *TargetActor, TargetId, Target->GetLocationSimple(), DigestedProperties[ListenerId], nullptr);
+	};
+
+	for (const FPerceptionListenerID& ListenerId : MovedListeners)
+	{
+		const FAISightSpatialGridVR::FListenerEntry& Entry = SpatialGrid.Listeners.FindChecked(ListenerId);
+		FAISightSpatialGridVR::ForEachInCells(SpatialGrid.TargetsByCell, Entry.Cell, Entry.CellRadius, [&](const FAISightTargetVR::FTargetId TargetId)
+		{
+			TryRegisterQuery(ListenerId, TargetId);
+		});
+	}
+
+	for (const FAISightTargetVR::FTargetId& TargetId : MovedTargets)
+	{
+		const FIntPoint& TargetCell = SpatialGrid.Targets.FindChecked(TargetId);
+		FAISightSpatialGridVR::ForEachInCells(SpatialGrid.ListenersByCell, TargetCell, SpatialGrid.MaxListenerCellRadius, [&](const FPerceptionListenerID ListenerId)
+		{
+			// Moved listeners already covered their own neighbourhood
+			if (!MovedListeners.Contains(ListenerId) && SpatialGrid.IsPairNear(ListenerId, TargetId))
+			{
+				TryRegisterQuery(ListenerId, TargetId);
+			}
+		});
+	}
+}
+
 void UAISense_Sight_VR::OnListenerUpdateImpl(const FPerceptionListener& UpdatedListener)
 {
 	SCOPE_CYCLE_COUNTER(STAT_AI_Sense_Sight_ListenerUpdate);
@@ -1062,6 +1596,7 @@ void UAISense_Sight_VR::OnListenerUpdateImpl(const FPerceptionListener& UpdatedL
 		// remove all queries
 		RemoveAllQueriesByListener(UpdatedListener);
 		DigestedProperties.Remove(ListenerID);
+		SpatialGrid.RemoveListener(ListenerID);
 	}
 }
 
@@ -1094,6 +1629,7 @@ void UAISense_Sight_VR::OnListenerRemovedImpl(const FPerceptionListener& Removed
 	RemoveAllQueriesByListener(RemovedListener);
 
 	DigestedProperties.FindAndRemoveChecked(RemovedListener.GetListenerID());
+	SpatialGrid.RemoveListener(RemovedListener.GetListenerID());
 
 	// note: there use to be code to remove all queries _to_ listener here as well
 	// but that was wrong - the fact that a listener gets unregistered doesn't have to
@@ -1108,7 +1644,7 @@ void UAISense_Sight_VR::RemoveAllQueriesByListener(const FPerceptionListener& Li
 
 	const uint32 ListenerId = Listener.GetListenerID();
 
-	auto RemoveQuery = [&ListenerId, &OnRemoveFunc](TArray<FAISightQueryVR>& SightQueries, const int32 QueryIndex)->EReverseForEachResult
+	auto RemoveQuery = [this, &ListenerId, &OnRemoveFunc](TArray<FAISightQueryVR>& SightQueries, const int32 QueryIndex)->EReverseForEachResult
 	{
 		const FAISightQueryVR& SightQuery = SightQueries[QueryIndex];
 
@@ -1118,6 +1654,7 @@ void UAISense_Sight_VR::RemoveAllQueriesByListener(const FPerceptionListener& Li
 			{
 				OnRemoveFunc(SightQuery);
 			}
+			QueryPairs.Remove(MakeQueryPairKey(SightQuery));
 			SightQueries.RemoveAtSwap(QueryIndex, 1, /*bAllowShrinking=*/false);
 
 			return EReverseForEachResult::Modified;
@@ -1141,7 +1678,7 @@ void UAISense_Sight_VR::RemoveAllQueriesToTarget(const FAISightTargetVR::FTarget
 	SCOPE_CYCLE_COUNTER(STAT_AI_Sense_Sight_RemoveToTarget);
 	UE_MT_SCOPED_WRITE_ACCESS(QueriesListAccessDetector);
 
-	auto RemoveQuery = [&TargetId, &OnRemoveFunc](TArray<FAISightQueryVR>& SightQueries, const int32 QueryIndex)->EReverseForEachResult
+	auto RemoveQuery = [this, &TargetId, &OnRemoveFunc](TArray<FAISightQueryVR>& SightQueries, const int32 QueryIndex)->EReverseForEachResult
 	{
 		const FAISightQueryVR& SightQuery = SightQueries[QueryIndex];
 
@@ -1151,6 +1688,7 @@ void UAISense_Sight_VR::RemoveAllQueriesToTarget(const FAISightTargetVR::FTarget
 			{
 				OnRemoveFunc(SightQuery);
 			}
+			QueryPairs.Remove(MakeQueryPairKey(SightQuery));
 			SightQueries.RemoveAtSwap(QueryIndex, 1, /*bAllowShrinking=*/false);
 
 			return EReverseForEachResult::Modified;
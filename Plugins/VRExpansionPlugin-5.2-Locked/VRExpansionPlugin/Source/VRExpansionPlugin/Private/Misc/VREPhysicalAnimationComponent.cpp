@@ -101,6 +101,7 @@ void UVREPhysicalAnimationComponent::SetupWeldedBoneDriver_Implementation(bool b
 	}
 
 	BoneDriverMap.Empty();
+	BoneDriverGroups.Empty();
 
 	USkeletalMeshComponent* SkeleMesh = GetSkeletalMesh();
 
@@ -125,14 +126,21 @@ void UVREPhysicalAnimationComponent::SetupWeldedBoneDriver_Implementation(bool b
 
 				if (FPhysicsInterface::IsValid(ActorHandle) /*&& FPhysicsInterface::IsRigidBody(ActorHandle)*/)
 				{
+					FWeldedBoneDriverGroup& DriverGroup = BoneDriverGroups.AddDefaulted_GetRef();
+					DriverGroup.BaseBoneName = BaseWeldedBoneDriverName;
+					DriverGroup.BodyIndex = ParentBodyIdx;
+					DriverGroup.FirstDriver = BoneDriverMap.Num();
+
 					FPhysicsCommand::ExecuteWrite(ActorHandle, [&](FPhysicsActorHandle& Actor)
 					{
 						//TArray<FPhysicsShapeHandle> Shapes;
 						PhysicsInterfaceTypes::FInlineShapeArray Shapes;
 						FPhysicsInterface::GetAllShapes_AssumedLocked(Actor, Shapes);
 
-						for (FPhysicsShapeHandle& Shape : Shapes)
+						for (int32 ShapeIndex = 0; ShapeIndex < Shapes.Num(); ++ShapeIndex)
 						{
+							FPhysicsShapeHandle& Shape = Shapes[ShapeIndex];
+
 							if (ParentBody->WeldParent)
 							{
 								const FBodyInstance* OriginalBI = ParentBody->WeldParent->GetOriginalBodyInstance(Shape);
@@ -154,6 +162,9 @@ void UVREPhysicalAnimationComponent::SetupWeldedBoneDriver_Implementation(bool b
 								{
 									FWeldedBoneDriverData DriverData;
 									DriverData.BoneName = TargetBoneName;
+									DriverData.BoneIndex = BoneIdx;
+									DriverData.ShapeIndex = ShapeIndex;
+									DriverData.ShapeElem = ShapeElem;
 									//DriverData.ShapeHandle = Shape;
 
 									if (bReInit && OriginalData.Num() - 1 >= BoneDriverMap.Num())
@@ -181,6 +192,8 @@ void UVREPhysicalAnimationComponent::SetupWeldedBoneDriver_Implementation(bool b
 							}
 						}
 
+						DriverGroup.NumDrivers = BoneDriverMap.Num() - DriverGroup.FirstDriver;
+
 						if (bAutoSetPhysicsSleepSensitivity && !ParentBody->WeldParent && BoneDriverMap.Num() > 0)
 						{
 							ParentBody->SleepFamily = ESleepFamily::Custom;
@@ -216,11 +229,27 @@ void UVREPhysicalAnimationComponent::UpdateWeldedBoneDriver(float DeltaTime)
 	UPhysicsAsset* PhysAsset = SkeleMesh ? SkeleMesh->GetPhysicsAsset() : nullptr;
 	if(PhysAsset && SkeleMesh->GetSkinnedAsset())
 	{
-		for (FName BaseWeldedBoneDriverName : BaseWeldedBoneDriverNames)
+		// Gather every target from the bone buffer up front so the physics lock is only held to write the shapes
+		const FTransform& ComponentToWorld = SkeleMesh->GetComponentTransform();
+		BoneDriverTargets.SetNumUninitialized(BoneDriverMap.Num(), false);
+
+		for (int32 DriverIndex = 0; DriverIndex < BoneDriverMap.Num(); ++DriverIndex)
 		{
-			int32 ParentBodyIdx = PhysAsset->FindBodyIndex(BaseWeldedBoneDriverName);
+			const FWeldedBoneDriverData& WeldedData = BoneDriverMap[DriverIndex];
 
-			if (FBodyInstance* ParentBody = (ParentBodyIdx == INDEX_NONE ? nullptr : SkeleMesh->Bodies[ParentBodyIdx]))
+			// This fixes a bug with simulating inverse scaled meshes
+			//Trans.SetScale3D(FVector(1.f) * Trans.GetScale3D().GetSignVector());
+			BoneDriverTargets[DriverIndex] = WeldedData.RelativeTransform * SkeleMesh->GetBoneTransform(WeldedData.BoneIndex, ComponentToWorld);
+		}
+
+		bool bNeedsRefresh = false;
+
+		for (const FWeldedBoneDriverGroup& DriverGroup : BoneDriverGroups)
+		{
+			if (!DriverGroup.NumDrivers && !bDebugDrawCollision)
+				continue;
+
+			if (FBodyInstance* ParentBody = (SkeleMesh->Bodies.IsValidIndex(DriverGroup.BodyIndex) ? SkeleMesh->Bodies[DriverGroup.BodyIndex] : nullptr))
 			{
 				// Allow it to run even when not simulating physics, if we have a welded root then it needs to animate anyway
 				//if (!ParentBody->IsInstanceSimulatingPhysics() && !ParentBody->WeldParent)
@@ -241,7 +270,6 @@ void UVREPhysicalAnimationComponent::UpdateWeldedBoneDriver(float DeltaTime)
 					}
 #endif
 
-					bool bModifiedBody = false;
 					FPhysicsCommand::ExecuteWrite(ActorHandle, [&](FPhysicsActorHandle& Actor)
 					{
 						PhysicsInterfaceTypes::FInlineShapeArray Shapes;
@@ -259,52 +287,39 @@ void UVREPhysicalAnimationComponent::UpdateWeldedBoneDriver(float DeltaTime)
 
 #endif
 
-						for (FPhysicsShapeHandle& Shape : Shapes)
+						const int32 LastDriver = DriverGroup.FirstDriver + DriverGroup.NumDrivers;
+						for (int32 DriverIndex = DriverGroup.FirstDriver; DriverIndex < LastDriver; ++DriverIndex)
 						{
-							if (ParentBody->WeldParent)
-							{
-								const FBodyInstance* OriginalBI = ParentBody->WeldParent->GetOriginalBodyInstance(Shape);
+							FWeldedBoneDriverData& WeldedData = BoneDriverMap[DriverIndex];
 
-								if (OriginalBI != ParentBody)
-								{
-									// Not originally our shape
-									continue;
-								}
-							}
-
-							// Log the shapes name to match to the bone
-							FName TargetBoneName = NAME_None;
-							if (FKShapeElem* ShapeElem = FChaosUserData::Get<FKShapeElem>(FPhysicsInterface::GetUserData(Shape)))
+							// The shape list changed under us (re-weld or body re-creation), rebuild the index after we release the lock
+							if (!Shapes.IsValidIndex(WeldedData.ShapeIndex) ||
+								FChaosUserData::Get<FKShapeElem>(FPhysicsInterface::GetUserData(Shapes[WeldedData.ShapeIndex])) != WeldedData.ShapeElem)
 							{
-								TargetBoneName = ShapeElem->GetName();
+								bNeedsRefresh = true;
+								break;
 							}
-							else
+
+							FTransform RelativeTM = BoneDriverTargets[DriverIndex] * GlobalPoseInv;
+
+							if (!WeldedData.LastLocal.Equals(RelativeTM))
 							{
-								// Cant find the matching shape
-								continue;
+								FPhysicsInterface::SetLocalTransform(Shapes[WeldedData.ShapeIndex], RelativeTM);
+								WeldedData.LastLocal = RelativeTM;
 							}
+						}
 
-							if (FWeldedBoneDriverData* WeldedData = BoneDriverMap.FindByKey(TargetBoneName/*Shape*/))
+#if ENABLE_DRAW_DEBUG
+						if (bDebugDrawCollision)
+						{
+							for (FPhysicsShapeHandle& Shape : Shapes)
 							{
-								bModifiedBody = true;
-
-								FTransform Trans = SkeleMesh->GetSocketTransform(WeldedData->BoneName, ERelativeTransformSpace::RTS_World);
-
-								// This fixes a bug with simulating inverse scaled meshes
-								//Trans.SetScale3D(FVector(1.f) * Trans.GetScale3D().GetSignVector());
-								FTransform GlobalTransform = WeldedData->RelativeTransform * Trans;
-								FTransform RelativeTM = GlobalTransform * GlobalPoseInv;
-
-								if (!WeldedData->LastLocal.Equals(RelativeTM))
+								if (ParentBody->WeldParent && ParentBody->WeldParent->GetOriginalBodyInstance(Shape) != ParentBody)
 								{
-									FPhysicsInterface::SetLocalTransform(Shape, RelativeTM);
-									WeldedData->LastLocal = RelativeTM;
+									// Not originally our shape
+									continue;
 								}
-							}
 
-#if ENABLE_DRAW_DEBUG
-							if (bDebugDrawCollision)
-							{
 								const Chaos::FImplicitObject* ShapeImplicit = Shape.Shape->GetGeometry().Get();
 								Chaos::EImplicitObjectType Type = ShapeImplicit->GetType();
 
@@ -313,8 +328,8 @@ void UVREPhysicalAnimationComponent::UpdateWeldedBoneDriver(float DeltaTime)
 								Chaos::FRigidTransform3 RigTransform(FinalTransform);
 								Chaos::DebugDraw::DrawShape(RigTransform, ShapeImplicit, Chaos::FShapeOrShapesArray(), FColor::White);
 							}
-#endif
 						}
+#endif
 					});
 
 #if ENABLE_DRAW_DEBUG
@@ -335,6 +350,12 @@ void UVREPhysicalAnimationComponent::UpdateWeldedBoneDriver(float DeltaTime)
 
 			}
 		}
+
+		if (bNeedsRefresh)
+		{
+			// Keeps the relative transforms we already calculated
+			RefreshWeldedBoneDriver();
+		}
 	}
 }
 
@@ -0,0 +1,307 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/VRNetProfiler.h"
+#include "Misc/VRNetProfilerPackageMap.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+
+DEFINE_LOG_CATEGORY(LogVRNetProfiler);
+
+namespace VRNetProfilerCVARs
+{
+	static int32 EnableNetProfiler = 0;
+	FAutoConsoleVariableRef CVarEnableNetProfiler(
+		TEXT("vrexp.NetProfiler"),
+		EnableNetProfiler,
+		TEXT("When on, counts the bits sent by the plugins custom NetSerialize structs, per struct, RPC and actor class.\n")
+		TEXT("Costs an extra serialization per measured struct, print results with vrexp.NetProfiler.Dump.\n")
+		TEXT("0: Disable, 1: Enable"),
+		ECVF_Default);
+
+	FAutoConsoleCommand CmdDumpNetProfiler(
+		TEXT("vrexp.NetProfiler.Dump"),
+		TEXT("Logs bits per second and quantization error since the last dump."),
+		FConsoleCommandDelegate::CreateLambda([]() { FVRNetProfiler::Get().Dump(); }));
+
+	FAutoConsoleCommand CmdResetNetProfiler(
+		TEXT("vrexp.NetProfiler.Reset"),
+		TEXT("Clears all net profiler counters."),
+		FConsoleCommandDelegate::CreateLambda([]() { FVRNetProfiler::Get().Reset(); }));
+
+	FAutoConsoleCommand CmdRecordNetTrace(
+		TEXT("vrexp.NetProfiler.RecordTrace"),
+		TEXT("Starts recording the transforms sent by the measured structs, for the VRExpansion.Net.ReplayTraces automation test."),
+		FConsoleCommandDelegate::CreateLambda([]() { FVRNetProfiler::Get().StartTrace(); }));
+
+	FAutoConsoleCommand CmdSaveNetTrace(
+		TEXT("vrexp.NetProfiler.SaveTrace"),
+		TEXT("Stops recording and saves the trace to Saved/VRNetTraces. Optional argument: trace name."),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			FVRNetProfiler::Get().SaveTrace(Args.Num() > 0 ? Args[0] : FString());
+		}));
+}
+
+FVRNetProfileScope::FVRNetProfileScope(FName InRPCName, const UObject* InOwner)
+	: RPCName(InRPCName)
+	, ClassName(InOwner ? InOwner->GetClass()->GetFName() : NAME_None)
+	, PreviousScope(nullptr)
+	, bPushed(IsInGameThread())
+{
+	if (bPushed)
+	{
+		FVRNetProfiler& Profiler = FVRNetProfiler::Get();
+		PreviousScope = Profiler.CurrentScope;
+		Profiler.CurrentScope = this;
+	}
+}
+
+FVRNetProfileScope::~FVRNetProfileScope()
+{
+	if (bPushed)
+	{
+		FVRNetProfiler::Get().CurrentScope = PreviousScope;
+	}
+}
+
+FVRNetProfiler::FVRNetProfiler()
+	: WindowStartTime(FPlatformTime::Seconds())
+	, bIsMeasuring(false)
+	, TraceStartTime(0.0)
+	, bIsRecordingTrace(false)
+	, ScratchMap(nullptr)
+	, CurrentScope(nullptr)
+{
+}
+
+FVRNetProfiler& FVRNetProfiler::Get()
+{
+	static FVRNetProfiler Profiler;
+	return Profiler;
+}
+
+bool FVRNetProfiler::IsEnabled()
+{
+	// Net serialization only happens on the game thread
+	return VRNetProfilerCVARs::EnableNetProfiler > 0 && IsInGameThread();
+}
+
+void FVRNetProfiler::AddToCounter(FVRNetProfileCounter& Counter, int64 NumBits, const FVRNetQuantizationError* Error)
+{
+	Counter.TotalBits += NumBits;
+	Counter.TotalCount++;
+	Counter.WindowBits += NumBits;
+	Counter.WindowCount++;
+
+	if (Error)
+	{
+		Counter.MaxLocationError = FMath::Max(Counter.MaxLocationError, Error->Location);
+		Counter.MaxRotationError = FMath::Max(Counter.MaxRotationError, Error->Rotation);
+		Counter.SumLocationError += Error->Location;
+		Counter.SumRotationError += Error->Rotation;
+		Counter.ErrorSamples++;
+	}
+}
+
+UPackageMap* FVRNetProfiler::GetScratchMap(UPackageMap* LiveMap)
+{
+	if (!ScratchMap)
+	{
+		ScratchMap = NewObject<UVRNetProfilerPackageMap>(GetTransientPackage());
+		ScratchMap->AddToRoot();
+	}
+
+	ScratchMap->BeginPass(LiveMap);
+	return ScratchMap;
+}
+
+void FVRNetProfiler::MeasureBits(FName StructName, UPackageMap* Map, TFunctionRef<void(FArchive&, UPackageMap*)> SerializeFunc)
+{
+	if (bIsMeasuring)
+	{
+		return;
+	}
+
+	TGuardValue<bool> MeasureGuard(bIsMeasuring, true);
+
+	UPackageMap* MeasureMap = GetScratchMap(Map);
+	FNetBitWriter Writer(MeasureMap, 0);
+	SerializeFunc(Writer, MeasureMap);
+	RecordBits(StructName, Writer.GetNumBits(), nullptr);
+}
+
+void FVRNetProfiler::RecordBits(FName StructName, int64 NumBits, const FVRNetQuantizationError* Error)
+{
+	AddToCounter(StructCounters.FindOrAdd(StructName), NumBits, Error);
+
+	if (CurrentScope)
+	{
+		AddToCounter(RPCCounters.FindOrAdd(CurrentScope->RPCName), NumBits, nullptr);
+
+		if (!CurrentScope->ClassName.IsNone())
+		{
+			AddToCounter(ClassCounters.FindOrAdd(CurrentScope->ClassName), NumBits, nullptr);
+		}
+	}
+}
+
+void FVRNetProfiler::DumpCounters(const TCHAR* Category, TMap<FName, FVRNetProfileCounter>& Counters, double WindowSeconds)
+{
+	Counters.ValueSort([](const FVRNetProfileCounter& A, const FVRNetProfileCounter& B)
+	{
+		return A.WindowBits > B.WindowBits;
+	});
+
+	UE_LOG(LogVRNetProfiler, Log, TEXT("--- %s ---"), Category);
+
+	for (TPair<FName, FVRNetProfileCounter>& CounterPair : Counters)
+	{
+		FVRNetProfileCounter& Counter = CounterPair.Value;
+		const double BitsPerSecond = WindowSeconds > 0.0 ? Counter.WindowBits / WindowSeconds : 0.0;
+		const double AverageBits = Counter.WindowCount > 0 ? (double)Counter.WindowBits / Counter.WindowCount : 0.0;
+
+		if (Counter.ErrorSamples > 0)
+		{
+			UE_LOG(LogVRNetProfiler, Log, TEXT("%s: %.1f bits/s, %.1f bits avg, %lld sends, %lld total bits, loc error avg %.4f max %.4f, rot error avg %.4f max %.4f"),
+				*CounterPair.Key.ToString(), BitsPerSecond, AverageBits, Counter.WindowCount, Counter.TotalBits,
+				Counter.SumLocationError / Counter.ErrorSamples, Counter.MaxLocationError, Counter.SumRotationError / Counter.ErrorSamples, Counter.MaxRotationError);
+		}
+		else
+		{
+			UE_LOG(LogVRNetProfiler, Log, TEXT("%s: %.1f bits/s, %.1f bits avg, %lld sends, %lld total bits"),
+				*CounterPair.Key.ToString(), BitsPerSecond, AverageBits, Counter.WindowCount, Counter.TotalBits);
+		}
+
+		Counter.WindowBits = 0;
+		Counter.WindowCount = 0;
+	}
+}
+
+void FVRNetProfiler::Dump()
+{
+	const double CurrentTime = FPlatformTime::Seconds();
+	const double WindowSeconds = CurrentTime - WindowStartTime;
+
+	UE_LOG(LogVRNetProfiler, Log, TEXT("VR net profile over the last %.2f seconds"), WindowSeconds);
+	DumpCounters(TEXT("Structs"), StructCounters, WindowSeconds);
+	DumpCounters(TEXT("RPCs"), RPCCounters, WindowSeconds);
+	DumpCounters(TEXT("Actor Classes"), ClassCounters, WindowSeconds);
+
+	WindowStartTime = CurrentTime;
+}
+
+void FVRNetProfiler::Reset()
+{
+	StructCounters.Empty();
+	RPCCounters.Empty();
+	ClassCounters.Empty();
+	WindowStartTime = FPlatformTime::Seconds();
+}
+
+bool FVRNetProfiler::IsRecordingTrace()
+{
+	if (!IsInGameThread())
+	{
+		return false;
+	}
+
+	// The measurement passes re-serialize what was already recorded
+	const FVRNetProfiler& Profiler = Get();
+	return Profiler.bIsRecordingTrace && !Profiler.bIsMeasuring;
+}
+
+void FVRNetProfiler::StartTrace()
+{
+	TraceSamples.Reset();
+	TraceStartTime = FPlatformTime::Seconds();
+	bIsRecordingTrace = true;
+
+	UE_LOG(LogVRNetProfiler, Log, TEXT("Recording net trace"));
+}
+
+void FVRNetProfiler::RecordTraceSample(FName StructName, const FTransform& Transform)
+{
+	FVRNetTraceSample& Sample = TraceSamples.AddDefaulted_GetRef();
+	Sample.StructName = StructName;
+	Sample.Time = FPlatformTime::Seconds() - TraceStartTime;
+	Sample.Transform = Transform;
+}
+
+FString FVRNetProfiler::GetTraceDirectory()
+{
+	return FPaths::ProjectSavedDir() / TEXT("VRNetTraces");
+}
+
+bool FVRNetProfiler::SaveTrace(const FString& TraceName)
+{
+	bIsRecordingTrace = false;
+
+	if (TraceSamples.Num() == 0)
+	{
+		UE_LOG(LogVRNetProfiler, Warning, TEXT("No net trace samples recorded, nothing saved"));
+		return false;
+	}
+
+	const FString FileName = (TraceName.IsEmpty() ? FDateTime::Now().ToString() : TraceName) + TEXT(".vrtrace");
+	const FString FilePath = GetTraceDirectory() / FileName;
+
+	// One sample per line: Struct,Time,PosX,PosY,PosZ,QuatX,QuatY,QuatZ,QuatW,ScaleX,ScaleY,ScaleZ
+	TArray<FString> Lines;
+	Lines.Reserve(TraceSamples.Num());
+	for (const FVRNetTraceSample& Sample : TraceSamples)
+	{
+		const FVector Location = Sample.Transform.GetTranslation();
+		const FQuat Rotation = Sample.Transform.GetRotation();
+		const FVector Scale = Sample.Transform.GetScale3D();
+
+		Lines.Add(FString::Printf(TEXT("%s,%.6f,%.6f,%.6f,%.6f,%.9f,%.9f,%.9f,%.9f,%.6f,%.6f,%.6f"),
+			*Sample.StructName.ToString(), Sample.Time,
+			Location.X, Location.Y, Location.Z,
+			Rotation.X, Rotation.Y, Rotation.Z, Rotation.W,
+			Scale.X, Scale.Y, Scale.Z));
+	}
+
+	if (!FFileHelper::SaveStringArrayToFile(Lines, *FilePath))
+	{
+		UE_LOG(LogVRNetProfiler, Error, TEXT("Failed to save net trace to %s"), *FilePath);
+		return false;
+	}
+
+	UE_LOG(LogVRNetProfiler, Log, TEXT("Saved %d net trace samples to %s"), TraceSamples.Num(), *FilePath);
+	TraceSamples.Empty();
+	return true;
+}
+
+bool FVRNetProfiler::LoadTrace(const FString& FilePath, TArray<FVRNetTraceSample>& OutSamples)
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *FilePath))
+	{
+		return false;
+	}
+
+	TArray<FString> Values;
+	for (const FString& Line : Lines)
+	{
+		Values.Reset();
+		if (Line.ParseIntoArray(Values, TEXT(",")) != 12)
+		{
+			continue;
+		}
+
+		FVRNetTraceSample& Sample = OutSamples.AddDefaulted_GetRef();
+		Sample.StructName = FName(*Values[0]);
+		Sample.Time = FCString::Atod(*Values[1]);
+
+		const FVector Location(FCString::Atod(*Values[2]), FCString::Atod(*Values[3]), FCString::Atod(*Values[4]));
+		FQuat Rotation(FCString::Atod(*Values[5]), FCString::Atod(*Values[6]), FCString::Atod(*Values[7]), FCString::Atod(*Values[8]));
+		Rotation.Normalize();
+		const FVector Scale(FCString::Atod(*Values[9]), FCString::Atod(*Values[10]), FCString::Atod(*Values[11]));
+
+		Sample.Transform = FTransform(Rotation, Location, Scale);
+	}
+
+	return true;
+}
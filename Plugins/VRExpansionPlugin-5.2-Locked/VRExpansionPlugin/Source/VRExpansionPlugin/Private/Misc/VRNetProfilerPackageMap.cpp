@@ -0,0 +1,43 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/VRNetProfilerPackageMap.h"
+#include UE_INLINE_GENERATED_CPP_BY_NAME(VRNetProfilerPackageMap)
+
+void UVRNetProfilerPackageMap::BeginPass(UPackageMap* InLiveMap)
+{
+	LiveMap = InLiveMap;
+	PassObjects.Reset();
+	ReadIndex = 0;
+}
+
+FNetworkGUID UVRNetProfilerPackageMap::GetNetGUIDFromObject(const UObject* InObject) const
+{
+	// Only looks up, an object without a GUID yet is measured as an unassigned one
+	const UPackageMap* Map = LiveMap.Get();
+	return Map ? Map->GetNetGUIDFromObject(InObject) : FNetworkGUID();
+}
+
+bool UVRNetProfilerPackageMap::SerializeObject(FArchive& Ar, UClass* InClass, UObject*& Obj, FNetworkGUID* OutNetGUID)
+{
+	FNetworkGUID NetGUID;
+
+	if (Ar.IsSaving())
+	{
+		NetGUID = GetNetGUIDFromObject(Obj);
+		Ar << NetGUID;
+		PassObjects.Add(Obj);
+	}
+	else
+	{
+		Ar << NetGUID;
+		Obj = PassObjects.IsValidIndex(ReadIndex) ? PassObjects[ReadIndex].Get() : nullptr;
+		ReadIndex++;
+	}
+
+	if (OutNetGUID)
+	{
+		*OutNetGUID = NetGUID;
+	}
+
+	return true;
+}
@@ -13,6 +13,7 @@
 #include "Engine/Canvas.h"
 #include "GeomTools.h"
 #include "Serialization/ArchiveSaveCompressedProxy.h"
+#include "Misc/VRNetProfiler.h"
 #include "Serialization/ArchiveLoadCompressedProxy.h"
 #include "Materials/Material.h"
 #include "Net/UnrealNetwork.h"
@@ -1191,6 +1192,8 @@ void FBPVRReplicatedTextureStore::UnPackData()
 // Doing a custom NetSerialize here because this is sent via RPCs and should change on every update
 bool FBPVRReplicatedTextureStore::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
 {
+	VR_NET_PROFILE_STRUCT(FBPVRReplicatedTextureStore, Ar, Map);
+
 	bOutSuccess = true;
 
 	//Ar.SerializeBits(&bIsJPG, 1);
@@ -42,6 +42,10 @@ UParentRelativeAttachmentComponent::UParentRelativeAttachmentComponent(const FOb
 
 	CustomOffset = FVector::ZeroVector;
 
+	LastTrackingFrameChange = MAX_uint32;
+	LastTrackingFrameCustomOffset = FVector::ZeroVector;
+	LastTrackingFrameHalfHeight = 0.0f;
+
 	//YawRotationMethod = EVR_PRC_RotationMethod::PRC_ROT_HMD;
 }
 
@@ -86,6 +90,9 @@ void UParentRelativeAttachmentComponent::SetPaused(bool bNewPaused, bool bZeroOu
 	{
 		bIsPaused = bNewPaused;
 
+		// Make sure we move back to the tracked transform on resume even if the HMD hasn't moved since
+		LastTrackingFrameChange = MAX_uint32;
+
 		if (bIsPaused && (bZeroOutLocation || bZeroOutRotation))
 		{
 			FVector NewLoc = this->GetRelativeLocation();
@@ -176,7 +183,27 @@ void UParentRelativeAttachmentComponent::UpdateTracking(float DeltaTime)
 	}
 	else if (IsValid(AttachChar)) // New case to early out and with less calculations
 	{
-		if (AttachChar->bRetainRoomscale)
+		if (AttachChar->HasCurrentTrackingFrame())
+		{
+			// Use the values the root already calculated this frame, and skip re-applying the same transform
+			if (!NeedsTrackingFrameUpdate())
+				return;
+
+			const FVRTrackingFrame& TrackingFrame = AttachChar->TrackingFrame;
+			LastTrackingFrameChange = TrackingFrame.ChangeCounter;
+			LastTrackingFrameCustomOffset = CustomOffset;
+			LastTrackingFrameHalfHeight = AttachChar->VRRootReference->GetUnscaledCapsuleHalfHeight();
+
+			if (AttachChar->bRetainRoomscale)
+			{
+				SetRelativeRotAndLoc(TrackingFrame.CameraLocation, TrackingFrame.PureYaw, DeltaTime);
+			}
+			else
+			{
+				SetRelativeRotAndLoc(FVector(0.0f, 0.0f, TrackingFrame.CameraLocation.Z) + TrackingFrame.CapsuleOffset, TrackingFrame.PureYaw, DeltaTime);
+			}
+		}
+		else if (AttachChar->bRetainRoomscale)
 		{
 			SetRelativeRotAndLoc(AttachChar->VRRootReference->curCameraLoc, AttachChar->VRRootReference->StoredCameraRotOffset, DeltaTime);
 		}
@@ -236,6 +263,24 @@ void UParentRelativeAttachmentComponent::UpdateTracking(float DeltaTime)
 	}
 }
 
+bool UParentRelativeAttachmentComponent::NeedsTrackingFrameUpdate() const
+{
+	if (AttachChar->TrackingFrame.ChangeCounter != LastTrackingFrameChange)
+		return true;
+
+	// Still turning towards a yaw target, GetCalculatedRotation moves every update
+	if (!bIgnoreRotationFromParent && bLerpTransition && !FMath::IsNearlyEqual(LastLerpVal, LerpTarget))
+		return true;
+
+	if (!CustomOffset.Equals(LastTrackingFrameCustomOffset))
+		return true;
+
+	if (bUseFeetLocation && bUseCenterAsFeetLocation && !FMath::IsNearlyEqual(AttachChar->VRRootReference->GetUnscaledCapsuleHalfHeight(), LastTrackingFrameHalfHeight))
+		return true;
+
+	return false;
+}
+
 void UParentRelativeAttachmentComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
 {
 	if (!bUpdateInCharacterMovement || !IsValid(AttachChar))
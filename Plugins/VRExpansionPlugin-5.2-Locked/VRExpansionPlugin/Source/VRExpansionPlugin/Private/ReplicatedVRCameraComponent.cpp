@@ -414,6 +414,7 @@ void UReplicatedVRCameraComponent::TickComponent(float DeltaTime, enum ELevelTic
 						{
 							// Don't bother with any of this if not replicating transform
 							//if (bHasAuthority && bReplicateTransform)
+							VR_NET_PROFILE_SCOPE(TEXT("Server_SendCameraTransform"), GetOwner());
 							Server_SendCameraTransform(ReplicatedCameraTransform);
 						}
 					}
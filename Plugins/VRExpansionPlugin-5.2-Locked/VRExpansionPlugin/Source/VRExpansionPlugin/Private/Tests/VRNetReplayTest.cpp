@@ -0,0 +1,184 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "Misc/VRNetProfiler.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "VRBPDatatypes.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace VRNetReplayTest
+{
+	struct FReplayStats
+	{
+		int64 Samples = 0;
+		int64 TotalBits = 0;
+		double FirstTime = 0.0;
+		double LastTime = 0.0;
+		float MaxLocationError = 0.0f;
+		float MaxRotationError = 0.0f;
+		double SumLocationError = 0.0;
+		double SumRotationError = 0.0;
+
+		void Add(double Time, int64 NumBits, const FVRNetQuantizationError& Error)
+		{
+			if (Samples == 0)
+			{
+				FirstTime = Time;
+			}
+			LastTime = Time;
+
+			Samples++;
+			TotalBits += NumBits;
+			MaxLocationError = FMath::Max(MaxLocationError, Error.Location);
+			MaxRotationError = FMath::Max(MaxRotationError, Error.Rotation);
+			SumLocationError += Error.Location;
+			SumRotationError += Error.Rotation;
+		}
+	};
+
+	// Sent and received through the same calls an RPC would use, neither struct writes object references
+	template<typename T>
+	bool RoundTrip(T& Sent, T& Received, int64& OutNumBits)
+	{
+		FNetBitWriter Writer(nullptr, 0);
+		bool bWriteSuccess = true;
+		Sent.NetSerialize(Writer, nullptr, bWriteSuccess);
+
+		FNetBitReader Reader(nullptr, Writer.GetData(), Writer.GetNumBits());
+		bool bReadSuccess = true;
+		Received.NetSerialize(Reader, nullptr, bReadSuccess);
+
+		OutNumBits = Writer.GetNumBits();
+		return bWriteSuccess && bReadSuccess && !Writer.IsError() && !Reader.IsError() && Reader.AtEnd();
+	}
+
+	// Controller like motion, only used when no trace was recorded yet
+	void MakeSyntheticTrace(TArray<FVRNetTraceSample>& OutSamples)
+	{
+		const int32 NumSamples = 900; // 10 seconds at 90hz
+		for (int32 Index = 0; Index < NumSamples; ++Index)
+		{
+			const double Time = Index / 90.0;
+			const FVector Location(
+				40.0 * FMath::Sin(Time * 1.3),
+				30.0 * FMath::Cos(Time * 0.7),
+				110.0 + 20.0 * FMath::Sin(Time * 2.1));
+			const FRotator Rotation(
+				60.0 * FMath::Sin(Time * 0.9),
+				FMath::Fmod(Time * 45.0, 360.0) - 180.0,
+				30.0 * FMath::Cos(Time * 1.7));
+
+			FVRNetTraceSample& TrackedSample = OutSamples.AddDefaulted_GetRef();
+			TrackedSample.StructName = TEXT("FBPVRComponentPosRep");
+			TrackedSample.Time = Time;
+			TrackedSample.Transform = FTransform(Rotation, Location);
+
+			FVRNetTraceSample& GripSample = OutSamples.AddDefaulted_GetRef();
+			GripSample.StructName = TEXT("FTransform_NetQuantize");
+			GripSample.Time = Time;
+			GripSample.Transform = FTransform(Rotation, Location * 0.5f, FVector(1.0f));
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVRNetReplayTracesTest, "VRExpansion.Net.ReplayTraces", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+// Replays recorded net traces (vrexp.NetProfiler.RecordTrace / SaveTrace) through the quantized structs and reports
+// the bits and quantization error of each struct and quantization level
+bool FVRNetReplayTracesTest::RunTest(const FString& Parameters)
+{
+	using namespace VRNetReplayTest;
+
+	TArray<FString> TraceFiles;
+	IFileManager::Get().FindFiles(TraceFiles, *(FVRNetProfiler::GetTraceDirectory() / TEXT("*.vrtrace")), true, false);
+
+	TMap<FString, TArray<FVRNetTraceSample>> Traces;
+	for (const FString& TraceFile : TraceFiles)
+	{
+		TArray<FVRNetTraceSample>& Samples = Traces.Add(FPaths::GetBaseFilename(TraceFile));
+		if (!FVRNetProfiler::LoadTrace(FVRNetProfiler::GetTraceDirectory() / TraceFile, Samples))
+		{
+			AddError(FString::Printf(TEXT("Failed to load net trace %s"), *TraceFile));
+		}
+	}
+
+	if (Traces.Num() == 0)
+	{
+		AddWarning(FString::Printf(TEXT("No recorded net traces in %s, replaying a synthetic trace instead"), *FVRNetProfiler::GetTraceDirectory()));
+		MakeSyntheticTrace(Traces.Add(TEXT("Synthetic")));
+	}
+
+	const FName PosRepName(TEXT("FBPVRComponentPosRep"));
+	const FName TransformName(TEXT("FTransform_NetQuantize"));
+
+	for (const TPair<FString, TArray<FVRNetTraceSample>>& Trace : Traces)
+	{
+		// Every quantization level of the tracked structs is replayed, whatever the recording used
+		TMap<FString, FReplayStats> Stats;
+
+		for (const FVRNetTraceSample& Sample : Trace.Value)
+		{
+			if (Sample.StructName == PosRepName)
+			{
+				for (uint8 PosLevel = 0; PosLevel < 2; ++PosLevel)
+				{
+					for (uint8 RotLevel = 0; RotLevel < 2; ++RotLevel)
+					{
+						FBPVRComponentPosRep Sent;
+						Sent.Position = Sample.Transform.GetTranslation();
+						Sent.Rotation = Sample.Transform.Rotator();
+						Sent.QuantizationLevel = (EVRVectorQuantization)PosLevel;
+						Sent.RotationQuantizationLevel = (EVRRotationQuantization)RotLevel;
+
+						FBPVRComponentPosRep Received;
+						int64 NumBits = 0;
+						if (!RoundTrip(Sent, Received, NumBits))
+						{
+							AddError(FString::Printf(TEXT("%s: FBPVRComponentPosRep failed its round trip at %.3fs"), *Trace.Key, Sample.Time));
+							continue;
+						}
+
+						const FString StatName = FString::Printf(TEXT("FBPVRComponentPosRep (%s, %s)"),
+							PosLevel == (uint8)EVRVectorQuantization::RoundOneDecimal ? TEXT("RoundOneDecimal") : TEXT("RoundTwoDecimals"),
+							RotLevel == (uint8)EVRRotationQuantization::RoundTo10Bits ? TEXT("RoundTo10Bits") : TEXT("RoundToShort"));
+
+						Stats.FindOrAdd(StatName).Add(Sample.Time, NumBits,
+							FVRNetQuantizationError(Sent.Position, Received.Position, Sent.Rotation.Quaternion(), Received.Rotation.Quaternion()));
+					}
+				}
+			}
+			else if (Sample.StructName == TransformName)
+			{
+				FTransform_NetQuantize Sent(Sample.Transform);
+				FTransform_NetQuantize Received;
+				int64 NumBits = 0;
+				if (!RoundTrip(Sent, Received, NumBits))
+				{
+					AddError(FString::Printf(TEXT("%s: FTransform_NetQuantize failed its round trip at %.3fs"), *Trace.Key, Sample.Time));
+					continue;
+				}
+
+				Stats.FindOrAdd(TEXT("FTransform_NetQuantize")).Add(Sample.Time, NumBits,
+					FVRNetQuantizationError(Sent.GetTranslation(), Received.GetTranslation(), Sent.GetRotation(), Received.GetRotation()));
+			}
+		}
+
+		AddInfo(FString::Printf(TEXT("Net trace %s, %d samples"), *Trace.Key, Trace.Value.Num()));
+
+		for (const TPair<FString, FReplayStats>& StatPair : Stats)
+		{
+			const FReplayStats& Stat = StatPair.Value;
+			const double Duration = Stat.LastTime - Stat.FirstTime;
+
+			AddInfo(FString::Printf(TEXT("%s: %lld sends, %.1f bits avg, %lld total bits, %.1f bits/s, loc error avg %.4f max %.4f, rot error avg %.4f max %.4f"),
+				*StatPair.Key, Stat.Samples, (double)Stat.TotalBits / Stat.Samples, Stat.TotalBits, Duration > 0.0 ? Stat.TotalBits / Duration : 0.0,
+				Stat.SumLocationError / Stat.Samples, Stat.MaxLocationError, Stat.SumRotationError / Stat.Samples, Stat.MaxRotationError));
+		}
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
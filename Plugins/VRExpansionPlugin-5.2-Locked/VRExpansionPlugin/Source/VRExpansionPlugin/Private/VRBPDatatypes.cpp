@@ -20,6 +20,12 @@ namespace VRDataTypeCVARs
 
 bool FTransform_NetQuantize::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
 {
+	VR_NET_PROFILE_STRUCT_ERROR(FTransform_NetQuantize, Ar, Map, [](const FTransform_NetQuantize& Sent, const FTransform_NetQuantize& Received)
+	{
+		return FVRNetQuantizationError(Sent.GetTranslation(), Received.GetTranslation(), Sent.GetRotation(), Received.GetRotation());
+	});
+	VR_NET_TRACE_SAMPLE(FTransform_NetQuantize, Ar, *this);
+
 	bOutSuccess = true;
 
 	FVector rTranslation;
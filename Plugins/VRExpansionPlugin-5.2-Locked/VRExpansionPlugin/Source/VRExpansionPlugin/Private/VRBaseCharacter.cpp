@@ -152,6 +152,35 @@ AVRBaseCharacter::AVRBaseCharacter(const FObjectInitializer& ObjectInitializer)
 	bTrackingPaused = false;
 	PausedTrackingLoc = FVector::ZeroVector;
 	PausedTrackingRot = 0.f;
+
+	TrackingFrameLocationTolerance = 0.01f;
+	TrackingFrameRotationTolerance = 0.01f;
+}
+
+bool AVRBaseCharacter::UpdateTrackingFrame(const FVector& CameraLocation, const FRotator& CameraRotation, const FRotator& PureYaw, const FVector& VRCapsuleOffset)
+{
+	// First write always counts as a change so that everything gets an initial position
+	const bool bChanged = TrackingFrame.FrameNumber == 0 ||
+		!CameraLocation.Equals(TrackingFrame.ChangedCameraLocation, TrackingFrameLocationTolerance) ||
+		!CameraRotation.Equals(TrackingFrame.ChangedCameraRotation, TrackingFrameRotationTolerance) ||
+		!VRCapsuleOffset.Equals(TrackingFrame.ChangedVRCapsuleOffset, TrackingFrameLocationTolerance);
+
+	TrackingFrame.FrameNumber = GFrameCounter;
+	TrackingFrame.CameraLocation = CameraLocation;
+	TrackingFrame.CameraRotation = CameraRotation;
+	TrackingFrame.PureYaw = PureYaw;
+	TrackingFrame.CapsuleOffset = PureYaw.RotateVector(FVector(-VRCapsuleOffset.X, -VRCapsuleOffset.Y, 0.0f));
+	TrackingFrame.bChangedThisFrame = bChanged;
+
+	if (bChanged)
+	{
+		TrackingFrame.ChangedCameraLocation = CameraLocation;
+		TrackingFrame.ChangedCameraRotation = CameraRotation;
+		TrackingFrame.ChangedVRCapsuleOffset = VRCapsuleOffset;
+		++TrackingFrame.ChangeCounter;
+	}
+
+	return bChanged;
 }
 
  void AVRBaseCharacter::PossessedBy(AController* NewController)
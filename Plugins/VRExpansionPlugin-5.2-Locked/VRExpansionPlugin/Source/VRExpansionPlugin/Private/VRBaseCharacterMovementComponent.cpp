@@ -19,10 +19,14 @@
 #include "Navigation/PathFollowingComponent.h"
 #include "VRPlayerController.h"
 #include "GameFramework/PhysicsVolume.h"
+#include "VRGlobalSettings.h"
 
 
 DEFINE_LOG_CATEGORY(LogVRBaseCharacterMovement);
 
+DECLARE_CYCLE_STAT(TEXT("VRCharacterMovement UpdateMovementSignificance"), STAT_VRCharacterMovementUpdateSignificance, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("VRCharacterMovement Reduced Significance Proxies"), STAT_VRCharacterMovementReducedProxies, STATGROUP_Character);
+
 UVRBaseCharacterMovementComponent::UVRBaseCharacterMovementComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
@@ -83,6 +87,12 @@ UVRBaseCharacterMovementComponent::UVRBaseCharacterMovementComponent(const FObje
 	bDisableSimulatedTickWhenSmoothingMovement = true;
 	bCapHMDMovementToMaxMovementSpeed = false;
 
+	bAllowMovementSignificance = true;
+	MovementSignificanceTier = INDEX_NONE;
+	MovementSignificanceUpdateTimer = 0.0f;
+	SimulatedTickAccumulator = 0.0f;
+	TrackingUpdateAccumulator = 0.0f;
+
 	SetNetworkMoveDataContainer(VRNetworkMoveDataContainer);
 	SetMoveResponseDataContainer(VRMoveResponseDataContainer);
 }
@@ -284,6 +294,7 @@ bool UVRBaseCharacterMovementComponent::ClientUpdatePositionAfterServerUpdate()
 
 void UVRBaseCharacterMovementComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
 {
+	UpdateMovementSignificance(DeltaTime);
 
 	// Skip calling into BP if we aren't locally controlled
 	if (CharacterOwner->IsLocallyControlled() && GetReplicatedMovementMode() == EVRConjoinedMovementModes::C_VRMOVE_Climbing)
@@ -422,14 +433,20 @@ void UVRBaseCharacterMovementComponent::TickComponent(float DeltaTime, enum ELev
 			}
 
 			// If some of our important components run inside the cmc updates then lets update them now
-			if (OuterScopeCamera)
+			// Remote characters with a reduced significance run them at their tiers rate instead
+			const FBPVRMovementSignificanceTier* SignificanceTier = GetMovementSignificanceTierSettings();
+			float TrackingDeltaTime = DeltaTime;
+			if (ConsumeSignificanceInterval(SignificanceTier ? SignificanceTier->TrackingUpdateInterval : 0.0f, DeltaTime, TrackingUpdateAccumulator, TrackingDeltaTime))
 			{
-				OuterScopeCamera->UpdateTracking(DeltaTime);
-			}
+				if (OuterScopeCamera)
+				{
+					OuterScopeCamera->UpdateTracking(TrackingDeltaTime);
+				}
 
-			if (OuterScopePRC)
-			{
-				OuterScopePRC->UpdateTracking(DeltaTime);
+				if (OuterScopePRC)
+				{
+					OuterScopePRC->UpdateTracking(TrackingDeltaTime);
+				}
 			}
 		}
 	}
@@ -1503,6 +1520,23 @@ void UVRBaseCharacterMovementComponent::SimulatedTick(float DeltaSeconds)
 	QUICK_SCOPE_CYCLE_COUNTER(STAT_Character_CharacterMovementSimulated);
 	checkSlow(CharacterOwner != nullptr);
 
+	// Reduced significance proxies only simulate at their tiers rate, root motion is always run at full rate to keep the pose in sync
+	// Any time saved up while reduced is consumed by the next simulation so no movement is lost
+	const float FrameDeltaSeconds = DeltaSeconds;
+	const FBPVRMovementSignificanceTier* SignificanceTier = GetMovementSignificanceTierSettings();
+	const bool bCanReduceSimulation = SignificanceTier && !CharacterOwner->IsPlayingNetworkedRootMotionMontage() && !CurrentRootMotion.HasActiveRootMotionSources() && !bWasSimulatingRootMotion;
+
+	if (!ConsumeSignificanceInterval(bCanReduceSimulation ? SignificanceTier->SimulatedMovementInterval : 0.0f, FrameDeltaSeconds, SimulatedTickAccumulator, DeltaSeconds))
+	{
+		// Keep smoothing towards the last correction so the avatar doesn't visibly step at the reduced rate
+		if (!bNetworkSmoothingComplete)
+		{
+			RunVRNetworkSmoothing(FrameDeltaSeconds);
+		}
+
+		return;
+	}
+
 	// If we are playing a RootMotion AnimMontage.
 	if (CharacterOwner->IsPlayingNetworkedRootMotionMontage())
 	{
@@ -1698,10 +1732,10 @@ void UVRBaseCharacterMovementComponent::SimulatedTick(float DeltaSeconds)
 	}
 
 	// Smooth mesh location after moving the capsule above.
+	// Smoothing always steps by the frame time, the accumulated simulation time was already consumed by the movement
 	if (!bNetworkSmoothingComplete)
 	{
-		QUICK_SCOPE_CYCLE_COUNTER(STAT_Character_CharacterMovementSmoothClientPosition);
-		SmoothClientPosition(DeltaSeconds);
+		RunVRNetworkSmoothing(FrameDeltaSeconds);
 	}
 	else
 	{
@@ -1995,6 +2029,146 @@ void UVRBaseCharacterMovementComponent::SmoothClientPosition(float DeltaSeconds)
 	SmoothClientPosition_UpdateVRVisuals();
 }
 
+void UVRBaseCharacterMovementComponent::RunVRNetworkSmoothing(float DeltaSeconds)
+{
+	const FBPVRMovementSignificanceTier* SignificanceTier = GetMovementSignificanceTierSettings();
+	if (SignificanceTier && SignificanceTier->bSkipNetworkSmoothing)
+	{
+		SkipVRNetworkSmoothing();
+	}
+	else
+	{
+		QUICK_SCOPE_CYCLE_COUNTER(STAT_Character_CharacterMovementSmoothClientPosition);
+		SmoothClientPosition(DeltaSeconds);
+	}
+}
+
+void UVRBaseCharacterMovementComponent::SkipVRNetworkSmoothing()
+{
+	if (NetworkSmoothingMode != ENetworkSmoothingMode::Disabled && HasValidData())
+	{
+		if (FNetworkPredictionData_Client_Character* ClientData = GetPredictionData_Client_Character())
+		{
+			ClientData->MeshTranslationOffset = FVector::ZeroVector;
+			ClientData->MeshRotationOffset = ClientData->MeshRotationTarget;
+			ClientData->SmoothingClientTimeStamp = ClientData->SmoothingServerTimeStamp;
+			SmoothClientPosition_UpdateVRVisuals();
+		}
+	}
+
+	bNetworkSmoothingComplete = true;
+}
+
+void UVRBaseCharacterMovementComponent::ForceUpdateMovementSignificance()
+{
+	MovementSignificanceUpdateTimer = 0.0f;
+	UpdateMovementSignificance(0.0f);
+}
+
+const FBPVRMovementSignificanceTier* UVRBaseCharacterMovementComponent::GetMovementSignificanceTierSettings() const
+{
+	if (MovementSignificanceTier == INDEX_NONE)
+		return nullptr;
+
+	const UVRGlobalSettings* VRSettings = GetDefault<UVRGlobalSettings>();
+
+	if (VRSettings->VRMovementSignificanceTiers.IsValidIndex(MovementSignificanceTier))
+	{
+		return &VRSettings->VRMovementSignificanceTiers[MovementSignificanceTier];
+	}
+	else if (MovementSignificanceTier == VRSettings->VRMovementSignificanceTiers.Num())
+	{
+		return &VRSettings->OffScreenVRMovementSignificanceTier;
+	}
+
+	return nullptr;
+}
+
+bool UVRBaseCharacterMovementComponent::ConsumeSignificanceInterval(float Interval, float DeltaTime, float& InOutAccumulator, float& OutDeltaTime)
+{
+	InOutAccumulator += DeltaTime;
+
+	if (InOutAccumulator < Interval)
+		return false;
+
+	OutDeltaTime = InOutAccumulator;
+	InOutAccumulator = 0.0f;
+	return true;
+}
+
+void UVRBaseCharacterMovementComponent::UpdateMovementSignificance(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_VRCharacterMovementUpdateSignificance);
+
+	const UVRGlobalSettings* VRSettings = GetDefault<UVRGlobalSettings>();
+
+	// Only remote proxies on clients are reduced, the server and owning client always need full rate movement
+	if (!VRSettings->bUseVRMovementSignificance || !bAllowMovementSignificance || !CharacterOwner ||
+		CharacterOwner->GetLocalRole() != ROLE_SimulatedProxy || GetNetMode() != NM_Client)
+	{
+		MovementSignificanceTier = INDEX_NONE;
+	}
+	else
+	{
+		MovementSignificanceUpdateTimer -= DeltaTime;
+		if (MovementSignificanceUpdateTimer > 0.0f)
+		{
+			if (MovementSignificanceTier != INDEX_NONE)
+			{
+				INC_DWORD_STAT(STAT_VRCharacterMovementReducedProxies);
+			}
+			return;
+		}
+
+		// Stagger the next update a little so that proxies spawned together don't all evaluate on the same frame
+		MovementSignificanceUpdateTimer = VRSettings->VRMovementSignificanceUpdateInterval * FMath::FRandRange(0.9f, 1.1f);
+
+		int32 NewTier = INDEX_NONE;
+		APlayerController* LocalPC = GetWorld() ? GetWorld()->GetFirstPlayerController() : nullptr;
+
+		if (!CharacterOwner->WasRecentlyRendered(VRSettings->VRMovementSignificanceOffScreenTime))
+		{
+			NewTier = VRSettings->VRMovementSignificanceTiers.Num();
+		}
+		else if (LocalPC && VRSettings->VRMovementSignificanceTiers.Num() > 0)
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			LocalPC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+			const double DistSq = FVector::DistSquared(ViewLocation, CharacterOwner->GetActorLocation());
+
+			// Past every limited tier falls back to the last one
+			NewTier = VRSettings->VRMovementSignificanceTiers.Num() - 1;
+			for (int32 TierIndex = 0; TierIndex < VRSettings->VRMovementSignificanceTiers.Num(); ++TierIndex)
+			{
+				const float MaxDistance = VRSettings->VRMovementSignificanceTiers[TierIndex].MaxDistance;
+				if (MaxDistance <= 0.0f || DistSq <= FMath::Square(MaxDistance))
+				{
+					NewTier = TierIndex;
+					break;
+				}
+			}
+		}
+
+		MovementSignificanceTier = NewTier;
+
+		// A tier that runs everything at full rate is the same as no tier, skip the interval checks entirely
+		if (const FBPVRMovementSignificanceTier* Tier = GetMovementSignificanceTierSettings())
+		{
+			if (Tier->SimulatedMovementInterval <= 0.0f && Tier->TrackingUpdateInterval <= 0.0f && !Tier->bSkipNetworkSmoothing)
+			{
+				MovementSignificanceTier = INDEX_NONE;
+			}
+		}
+	}
+
+	if (MovementSignificanceTier != INDEX_NONE)
+	{
+		INC_DWORD_STAT(STAT_VRCharacterMovementReducedProxies);
+	}
+}
+
 void UVRBaseCharacterMovementComponent::SmoothClientPosition_UpdateVRVisuals()
 {
 	//SCOPE_CYCLE_COUNTER(STAT_CharacterMovementSmoothClientPosition_Visual);
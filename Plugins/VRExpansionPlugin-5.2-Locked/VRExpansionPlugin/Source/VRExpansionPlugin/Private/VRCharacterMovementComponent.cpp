@@ -13,6 +13,7 @@
 #include "GameFramework/Character.h"
 #include "GameFramework/GameState.h"
 #include "GameFramework/WorldSettings.h"
+#include "GameFramework/PlayerState.h"
 #include "Components/PrimitiveComponent.h"
 #include "Animation/AnimMontage.h"
 #include "DrawDebugHelpers.h"
@@ -45,6 +46,8 @@ DEFINE_LOG_CATEGORY(LogVRCharacterMovement);
  */
 DECLARE_CYCLE_STAT(TEXT("Char StepUp"), STAT_CharStepUp, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char FindFloor"), STAT_CharFindFloor, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char FindFloor Cache Hits"), STAT_CharFindFloorCacheHits, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char FindFloor Cache Misses"), STAT_CharFindFloorCacheMisses, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char ReplicateMoveToServer"), STAT_CharacterMovementReplicateMoveToServer, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char CallServerMove"), STAT_CharacterMovementCallServerMove, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char CombineNetMove"), STAT_CharacterMovementCombineNetMove, STATGROUP_Character);
@@ -1402,7 +1405,19 @@ UVRCharacterMovementComponent::UVRCharacterMovementComponent(const FObjectInitia
 	bUseClientControlRotation = false;
 	bAllowMovementMerging = true;
 	bRunClientCorrectionToHMD = false;
+
+	bUseServerMoveHistory = true;
+	ServerMoveHistorySize = 32;
+	ServerMoveHistoryCorrectionGraceTime = 0.1f;
+	ServerMoveHistoryErrorTolerance = 2.0f;
+	MaxCompactCorrectionDelta = 100.0f;
 	bRequestedMoveUseAcceleration = false;
+
+	bUseFloorCache = true;
+	FloorCacheLocationTolerance = 0.5f;
+	FloorCacheMaxAge = 0.5f;
+	FloorCacheHits = 0;
+	FloorCacheMisses = 0;
 }
 
 void UVRCharacterMovementComponent::OnRegister()
@@ -2357,6 +2372,24 @@ void UVRCharacterMovementComponent::FindFloor(const FVector& CapsuleLocation, FF
 	float FloorLineTraceDist = FloorSweepTraceDist;
 	bool bNeedToValidateFloor = true;
 
+	// Roomscale players standing still only jitter by their HMD offset, reuse the last floor instead of sweeping again
+	// Downward sweep results, teleports and forced checks always go through the full check
+	UVRCharacterMovementComponent* MutableVRThis = const_cast<UVRCharacterMovementComponent*>(this);
+	const bool bCanUseFloorCache = bUseFloorCache && DownwardSweepResult == nullptr && !bJustTeleported && !bForceNextFloorCheck;
+
+	if (bCanUseFloorCache)
+	{
+		if (GetCachedFloor(UseCapsuleLocation, FloorSweepTraceDist, OutFloorResult))
+		{
+			INC_DWORD_STAT(STAT_CharFindFloorCacheHits);
+			MutableVRThis->FloorCacheHits++;
+			return;
+		}
+
+		INC_DWORD_STAT(STAT_CharFindFloorCacheMisses);
+		MutableVRThis->FloorCacheMisses++;
+	}
+
 	// For reverting
 	FFindFloorResult LastFloor = CurrentFloor;
 
@@ -2458,6 +2491,90 @@ void UVRCharacterMovementComponent::FindFloor(const FVector& CapsuleLocation, FF
 			}
 		}
 	}
+
+	if (bCanUseFloorCache)
+	{
+		MutableVRThis->StoreCachedFloor(UseCapsuleLocation, FloorSweepTraceDist, OutFloorResult);
+	}
+}
+
+bool UVRCharacterMovementComponent::GetCachedFloor(const FVector& CapsuleLocation, float FloorTraceDist, FFindFloorResult& OutFloorResult) const
+{
+	if (!FloorCache.bIsValid || !CharacterOwner)
+		return false;
+
+	if (GetWorld()->GetTimeSeconds() - FloorCache.Time > FloorCacheMaxAge)
+		return false;
+
+	if (FloorCache.FloorTraceDist != FloorTraceDist)
+		return false;
+
+	const UCapsuleComponent* Capsule = CharacterOwner->GetCapsuleComponent();
+	if (FloorCache.CapsuleRadius != Capsule->GetScaledCapsuleRadius() || FloorCache.CapsuleHalfHeight != Capsule->GetScaledCapsuleHalfHeight())
+		return false;
+
+	if (FVector::DistSquared(FloorCache.CapsuleLocation, CapsuleLocation) > FMath::Square(FloorCacheLocationTolerance))
+		return false;
+
+	// Any movement of the base at all needs a new floor
+	const UPrimitiveComponent* MovementBase = CharacterOwner->GetMovementBase();
+	if (FloorCache.MovementBase.Get() != MovementBase || FloorCache.MovementBaseBoneName != CharacterOwner->GetBasedMovement().BoneName)
+		return false;
+
+	if (MovementBase && !FloorCache.MovementBaseTransform.Equals(MovementBase->GetSocketTransform(FloorCache.MovementBaseBoneName), UE_KINDA_SMALL_NUMBER))
+		return false;
+
+	OutFloorResult = FloorCache.FloorResult;
+
+	// Keep the floor distance correct for the small vertical drift that was allowed
+	const float HeightDelta = CapsuleLocation.Z - FloorCache.CapsuleLocation.Z;
+	if (HeightDelta != 0.f && OutFloorResult.bBlockingHit)
+	{
+		OutFloorResult.FloorDist += HeightDelta;
+		if (OutFloorResult.bLineTrace)
+		{
+			OutFloorResult.LineDist += HeightDelta;
+		}
+	}
+
+	return true;
+}
+
+void UVRCharacterMovementComponent::StoreCachedFloor(const FVector& CapsuleLocation, float FloorTraceDist, const FFindFloorResult& FloorResult)
+{
+	if (!CharacterOwner)
+		return;
+
+	const UCapsuleComponent* Capsule = CharacterOwner->GetCapsuleComponent();
+	const UPrimitiveComponent* MovementBase = CharacterOwner->GetMovementBase();
+
+	FloorCache.FloorResult = FloorResult;
+	FloorCache.CapsuleLocation = CapsuleLocation;
+	FloorCache.MovementBase = MovementBase;
+	FloorCache.MovementBaseBoneName = CharacterOwner->GetBasedMovement().BoneName;
+	FloorCache.MovementBaseTransform = MovementBase ? MovementBase->GetSocketTransform(FloorCache.MovementBaseBoneName) : FTransform::Identity;
+	FloorCache.CapsuleRadius = Capsule->GetScaledCapsuleRadius();
+	FloorCache.CapsuleHalfHeight = Capsule->GetScaledCapsuleHalfHeight();
+	FloorCache.FloorTraceDist = FloorTraceDist;
+	FloorCache.Time = GetWorld()->GetTimeSeconds();
+	FloorCache.bIsValid = true;
+}
+
+void UVRCharacterMovementComponent::InvalidateFloorCache()
+{
+	FloorCache.bIsValid = false;
+}
+
+float UVRCharacterMovementComponent::GetFloorCacheHitRate() const
+{
+	const int32 TotalChecks = FloorCacheHits + FloorCacheMisses;
+	return TotalChecks > 0 ? (float)FloorCacheHits / (float)TotalChecks : 0.f;
+}
+
+void UVRCharacterMovementComponent::ResetFloorCacheCounters()
+{
+	FloorCacheHits = 0;
+	FloorCacheMisses = 0;
 }
 
 float UVRCharacterMovementComponent::ImmersionDepth() const
@@ -3794,9 +3911,19 @@ void UVRCharacterMovementComponent::ClientHandleMoveResponse(const FCharacterMov
 		}
 		else
 		{
+			FVector NewLocation = MoveResponse.ClientAdjustment.NewLoc;
+
+			// Compact corrections only carry the delta from the location we sent for that move
+			const FVRCharacterMoveResponseDataContainer& VRMoveResponse = static_cast<const FVRCharacterMoveResponseDataContainer&>(MoveResponse);
+			if (VRMoveResponse.bHasCompactCorrection && !ClientResolveCompactCorrectionVR(MoveResponse.ClientAdjustment.TimeStamp, VRMoveResponse.CorrectionDelta, NewLocation))
+			{
+				UE_LOG(LogNetPlayerMovement, Log, TEXT("ClientHandleMoveResponse could not resolve compact correction for TimeStamp: %f"), MoveResponse.ClientAdjustment.TimeStamp);
+				return;
+			}
+
 			ClientAdjustPositionVR_Implementation(
 				MoveResponse.ClientAdjustment.TimeStamp,
-				MoveResponse.ClientAdjustment.NewLoc,
+				NewLocation,
 				FRotator::CompressAxisToShort(MoveResponse.ClientAdjustment.NewRot.Yaw),
 				MoveResponse.ClientAdjustment.NewVel,
 				MoveResponse.ClientAdjustment.NewBase,
@@ -4003,6 +4130,123 @@ void UVRCharacterMovementComponent::ClientAdjustPositionVR_Implementation
 	ClientData->bUpdatePosition = true;
 }
 
+bool UVRCharacterMovementComponent::ClientResolveCompactCorrectionVR(float TimeStamp, const FVector& CorrectionDelta, FVector& OutNewLocation) const
+{
+	const FNetworkPredictionData_Client_Character* ClientData = GetPredictionData_Client_Character();
+	if (!ClientData)
+	{
+		return false;
+	}
+
+	const int32 MoveIndex = ClientData->GetSavedMoveIndex(TimeStamp);
+	if (MoveIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	// Same location that FCharacterNetworkMoveData sent for this move
+	OutNewLocation = FRepMovement::RebaseOntoZeroOrigin(ClientData->SavedMoves[MoveIndex]->SavedLocation, this) + CorrectionDelta;
+	return true;
+}
+
+FVector UVRCharacterMovementComponent::ServerGetBaseRelativeErrorVR(const FVector& ClientWorldLocation, const UPrimitiveComponent* MovementBase, FName BaseBoneName) const
+{
+	const FVector ServerWorldLocation = UpdatedComponent->GetComponentLocation();
+
+	if (MovementBaseUtility::UseRelativeLocation(MovementBase))
+	{
+		FVector ServerLocalLocation;
+		FVector ClientLocalLocation;
+		if (MovementBaseUtility::TransformLocationToLocal(MovementBase, BaseBoneName, ServerWorldLocation, ServerLocalLocation) &&
+			MovementBaseUtility::TransformLocationToLocal(MovementBase, BaseBoneName, ClientWorldLocation, ClientLocalLocation))
+		{
+			return ServerLocalLocation - ClientLocalLocation;
+		}
+	}
+
+	return ServerWorldLocation - ClientWorldLocation;
+}
+
+bool UVRCharacterMovementComponent::ServerIsErrorPendingCorrectionVR(float ClientTimeStamp, const FVector& ClientWorldLocation, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName) const
+{
+	const FNetworkPredictionData_Server_VRCharacter* ServerData = static_cast<const FNetworkPredictionData_Server_VRCharacter*>(GetPredictionData_Server_Character());
+	if (!bUseServerMoveHistory || !ServerData)
+	{
+		return false;
+	}
+
+	const FVRServerMoveState* CorrectionState = ServerData->MoveHistory.FindLastCorrection();
+	if (!CorrectionState || CorrectionState->TimeStamp >= ClientTimeStamp)
+	{
+		return false;
+	}
+
+	// Give the client a round trip to receive and apply the correction before we send another one
+	float RoundTripTime = 0.0f;
+	if (const APlayerController* PC = Cast<APlayerController>(CharacterOwner->GetController()))
+	{
+		if (PC->PlayerState)
+		{
+			RoundTripTime = PC->PlayerState->GetPingInMilliseconds() * 0.001f;
+		}
+	}
+
+	if (ClientTimeStamp - CorrectionState->TimeStamp > RoundTripTime + ServerMoveHistoryCorrectionGraceTime)
+	{
+		return false;
+	}
+
+	// Server state the client continued its prediction from for this move
+	const FVRServerMoveState* PreviousState = ServerData->MoveHistory.FindStateAtTime(ClientTimeStamp);
+	if (!PreviousState)
+	{
+		return false;
+	}
+
+	// A base change since either state can't be compared in the same space
+	const bool bClientBaseRelative = MovementBaseUtility::UseRelativeLocation(ClientMovementBase);
+	if ((CorrectionState->MovementBase.Get() != ClientMovementBase && (bClientBaseRelative || MovementBaseUtility::UseRelativeLocation(CorrectionState->MovementBase.Get()))) ||
+		(PreviousState->MovementBase.Get() != ClientMovementBase && (bClientBaseRelative || MovementBaseUtility::UseRelativeLocation(PreviousState->MovementBase.Get()))))
+	{
+		return false;
+	}
+
+	// Still the corrected error, and it hasn't grown since the previous move, so the client is only replaying moves it made before the correction
+	const FVector ClientError = ServerGetBaseRelativeErrorVR(ClientWorldLocation, ClientMovementBase, ClientBaseBoneName);
+	const float ToleranceSquared = FMath::Square(ServerMoveHistoryErrorTolerance);
+	return (ClientError - CorrectionState->ClientError).SizeSquared() <= ToleranceSquared && (ClientError - PreviousState->ClientError).SizeSquared() <= ToleranceSquared;
+}
+
+void UVRCharacterMovementComponent::ServerRecordMoveStateVR(float ClientTimeStamp, const FVector& ClientWorldLocation, bool bSentCorrection)
+{
+	FNetworkPredictionData_Server_VRCharacter* ServerData = static_cast<FNetworkPredictionData_Server_VRCharacter*>(GetPredictionData_Server_Character());
+	if (!bUseServerMoveHistory || !ServerData || !UpdatedComponent)
+	{
+		return;
+	}
+
+	if (ServerData->MoveHistory.Capacity() != ServerMoveHistorySize)
+	{
+		ServerData->MoveHistory.Init(ServerMoveHistorySize);
+	}
+	else if (const FVRServerMoveState* LastState = ServerData->MoveHistory.GetNewest())
+	{
+		// Client timestamps were reset, older states can't be compared against anymore
+		if (LastState->TimeStamp > ClientTimeStamp)
+		{
+			ServerData->MoveHistory.Reset();
+		}
+	}
+
+	FVRServerMoveState NewState;
+	NewState.TimeStamp = ClientTimeStamp;
+	NewState.MovementBase = CharacterOwner->GetMovementBase();
+	NewState.ClientError = ServerGetBaseRelativeErrorVR(ClientWorldLocation, NewState.MovementBase.Get(), CharacterOwner->GetBasedMovement().BoneName);
+	NewState.bSentCorrection = bSentCorrection;
+
+	ServerData->MoveHistory.Add(NewState);
+}
+
 bool UVRCharacterMovementComponent::ServerCheckClientErrorVR(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientWorldLocation, float ClientYaw, const FVector& RelativeClientLocation, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode)
 {
 	// Check location difference against global setting
@@ -4022,7 +4266,11 @@ bool UVRCharacterMovementComponent::ServerCheckClientErrorVR(float ClientTimeSta
 
 		if (ServerExceedsAllowablePositionError(ClientTimeStamp, DeltaTime, Accel, ClientWorldLocation, RelativeClientLocation, ClientMovementBase, ClientBaseBoneName, ClientMovementMode))
 		{
-			return true;
+			// Don't stack corrections while the client is still replaying moves from before the last one
+			if (!ServerIsErrorPendingCorrectionVR(ClientTimeStamp, ClientWorldLocation, ClientMovementBase, ClientBaseBoneName))
+			{
+				return true;
+			}
 		}
 
 #if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
@@ -4095,6 +4343,9 @@ void UVRCharacterMovementComponent::ServerMoveHandleClientErrorVR(float ClientTi
 
 	FVector ServerLoc = UpdatedComponent->GetComponentLocation();
 
+	// Checked before the base is swapped below, compact corrections need the location the client actually sent
+	const bool bClientSentAbsoluteLocation = !MovementBaseUtility::UseRelativeLocation(ClientMovementBase);
+
 	// Client may send a null movement base when walking on bases with no relative location (to save bandwidth).
 	// In this case don't check movement base in error conditions, use the server one (which avoids an error based on differing bases). Position will still be validated.
 	if (ClientMovementBase == nullptr)
@@ -4377,6 +4628,12 @@ void UVRCharacterMovementComponent::ServerMoveHandleClientErrorVR(float ClientTi
 		ServerData->PendingAdjustment.bAckGoodMove = false;
 		ServerData->PendingAdjustment.MovementMode = PackNetworkMovementMode();
 
+		ServerData->bPendingAdjustmentHasClientLocation = bClientSentAbsoluteLocation;
+		ServerData->PendingAdjustmentClientTimeStamp = ClientTimeStamp;
+		ServerData->PendingAdjustmentClientLocation = RelativeClientLoc;
+
+		ServerRecordMoveStateVR(ClientTimeStamp, ClientLoc, true);
+
 		//PerfCountersIncrement(PerfCounter_NumServerMoveCorrections);
 	}
 	else
@@ -4408,6 +4665,9 @@ void UVRCharacterMovementComponent::ServerMoveHandleClientErrorVR(float ClientTi
 		// acknowledge receipt of this successful servermove()
 		ServerData->PendingAdjustment.TimeStamp = ClientTimeStamp;
 		ServerData->PendingAdjustment.bAckGoodMove = true;
+		ServerData->bPendingAdjustmentHasClientLocation = false;
+
+		ServerRecordMoveStateVR(ClientTimeStamp, ClientLoc, false);
 	}
 
 	//PerfCountersIncrement(PerfCounter_NumServerMoves);
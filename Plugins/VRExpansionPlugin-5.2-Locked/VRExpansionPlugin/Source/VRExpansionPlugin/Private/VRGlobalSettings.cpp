@@ -32,6 +32,18 @@ UVRGlobalSettings::UVRGlobalSettings(const FObjectInitializer& ObjectInitializer
 		bUseCollisionModificationForCollisionIgnore = false;
 		CollisionIgnoreSubsystemUpdateRate = 1.f;
 
+		bBatchClientAuthThrowing = true;
+		ThrownObjectKeyframeInterval = 5;
+		bUseInteractibleUpdateSubsystem = false;
+
+		bUseVRMovementSignificance = false;
+		VRMovementSignificanceTiers.Add(FBPVRMovementSignificanceTier(1000.0f, 0.0f, 0.0f, false));
+		VRMovementSignificanceTiers.Add(FBPVRMovementSignificanceTier(2500.0f, 1.0f / 30.0f, 1.0f / 30.0f, false));
+		VRMovementSignificanceTiers.Add(FBPVRMovementSignificanceTier(0.0f, 1.0f / 15.0f, 1.0f / 10.0f, true));
+		OffScreenVRMovementSignificanceTier = FBPVRMovementSignificanceTier(0.0f, 1.0f / 10.0f, 1.0f / 5.0f, true);
+		VRMovementSignificanceOffScreenTime = 0.5f;
+		VRMovementSignificanceUpdateInterval = 0.25f;
+
 		bUseChaosTranslationScalers = false;
 		bSetEngineChaosScalers = false;
 		LinearDriveStiffnessScale = 1.0f;// Chaos::ConstraintSettings::LinearDriveStiffnessScale();
@@ -8,9 +8,106 @@
 #include "VRPathFollowingComponent.h"
 //#include "VRBPDatatypes.h"
 #include "Engine/Player.h"
+#include "Grippables/GrippableActor.h"
+#include "Grippables/GrippableStaticMeshActor.h"
+#include "Grippables/GrippableSkeletalMeshActor.h"
 //#include "Runtime/Engine/Private/EnginePrivate.h"
 
 
+AVRBasePlayerController* AVRBasePlayerController::GetThrowingController(AActor* ThrownActor)
+{
+	if (!ThrownActor)
+		return nullptr;
+
+	AActor* TopOwner = ThrownActor->GetOwner();
+	if (TopOwner != nullptr)
+	{
+		AActor* tempOwner = TopOwner->GetOwner();
+
+		// I have an owner so search that for the top owner
+		while (tempOwner)
+		{
+			TopOwner = tempOwner;
+			tempOwner = TopOwner->GetOwner();
+		}
+	}
+
+	return Cast<AVRBasePlayerController>(TopOwner);
+}
+
+void AVRBasePlayerController::EndThrownObject(AActor* ThrownActor)
+{
+	if (AVRBasePlayerController* OwningController = GetThrowingController(ThrownActor))
+	{
+		OwningController->ThrownObjectBaselines.Remove(ThrownActor);
+	}
+}
+
+bool AVRBasePlayerController::Server_SendThrownObjectMovement_Validate(const FVRThrownObjectBatch& ThrownObjectBatch)
+{
+	return true;
+}
+
+void AVRBasePlayerController::Server_SendThrownObjectMovement_Implementation(const FVRThrownObjectBatch& ThrownObjectBatch)
+{
+	for (const FVRThrownObjectSample& Sample : ThrownObjectBatch.Samples)
+	{
+		AActor* ThrownActor = Sample.ThrownActor;
+
+		// Only accept samples for objects that this connection actually owns
+		if (!ThrownActor || GetThrowingController(ThrownActor) != this)
+			continue;
+
+		FRepMovementVR NewMovement = Sample.Movement;
+
+		if (Sample.bIsKeyframe)
+		{
+			FVRThrownObjectBaseline& Baseline = ThrownObjectBaselines.FindOrAdd(ThrownActor);
+			Baseline.LastLocation = FVRThrownObjectBaseline::QuantizeLocation(NewMovement.Location);
+			Baseline.Sequence = Sample.Sequence;
+		}
+		else
+		{
+			// Deltas are only valid on top of the sample directly before it, if we lost one then wait for the next keyframe
+			FVRThrownObjectBaseline* Baseline = ThrownObjectBaselines.Find(ThrownActor);
+			if (!Baseline || Sample.Sequence != (uint8)(Baseline->Sequence + 1))
+				continue;
+
+			NewMovement.Location = FVRThrownObjectBaseline::QuantizeLocation(Baseline->LastLocation + NewMovement.Location);
+			Baseline->LastLocation = NewMovement.Location;
+			Baseline->Sequence = Sample.Sequence;
+		}
+
+		if (NewMovement.bSimulatedPhysicSleep)
+		{
+			ThrownObjectBaselines.Remove(ThrownActor);
+		}
+
+		// Same logic as the per object RPCs so that all of the grippable actors act alike
+		if (AGrippableStaticMeshActor* StaticMeshActor = Cast<AGrippableStaticMeshActor>(ThrownActor))
+		{
+			StaticMeshActor->Server_GetClientAuthReplication_Implementation(NewMovement);
+		}
+		else if (AGrippableActor* GrippableActor = Cast<AGrippableActor>(ThrownActor))
+		{
+			GrippableActor->Server_GetClientAuthReplication_Implementation(NewMovement);
+		}
+		else if (AGrippableSkeletalMeshActor* SkeletalMeshActor = Cast<AGrippableSkeletalMeshActor>(ThrownActor))
+		{
+			SkeletalMeshActor->Server_GetClientAuthReplication_Implementation(NewMovement);
+		}
+	}
+
+	// Clean out any baselines for objects that were destroyed mid throw
+	for (auto Itr = ThrownObjectBaselines.CreateIterator(); Itr; ++Itr)
+	{
+		if (!Itr.Key().IsValid())
+		{
+			Itr.RemoveCurrent();
+		}
+	}
+}
+
 AVRPlayerController::AVRPlayerController(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
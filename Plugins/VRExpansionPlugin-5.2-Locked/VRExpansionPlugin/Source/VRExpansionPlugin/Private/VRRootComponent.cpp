@@ -547,8 +547,10 @@ void UVRRootComponent::TickComponent(float DeltaTime, enum ELevelTick TickType,
 		}
 		
 
-		// Can adjust the relative tolerances to remove jitter and some update processing
-		if (!owningVRChar->bRetainRoomscale || (!curCameraLoc.Equals(lastCameraLoc, 0.01f) || !curCameraRot.Equals(lastCameraRot, 0.01f)))
+		// Publish the pose for the attachments that follow it, the character tolerances remove jitter and some update processing
+		const bool bTrackingChanged = owningVRChar->UpdateTrackingFrame(curCameraLoc, curCameraRot, StoredCameraRotOffset, VRCapsuleOffset);
+
+		if (bTrackingChanged)
 		{
 			// Also calculate vector of movement for the movement component
 			FVector LastPosition = OffsetComponentToWorld.GetLocation();
@@ -657,8 +659,14 @@ void UVRRootComponent::TickComponent(float DeltaTime, enum ELevelTick TickType,
 		{
 			bHadRelativeMovement = false;
 			DifferenceFromLastFrame = FVector::ZeroVector;
-			lastCameraLoc = curCameraLoc;
-			lastCameraRot = curCameraRot;
+
+			// Without roomscale lastCameraLoc is the offset location the last delta was routed from
+			// Leave it alone so that the skipped drift is routed once it passes the tolerance
+			if (owningVRChar->bRetainRoomscale)
+			{
+				lastCameraLoc = curCameraLoc;
+				lastCameraRot = curCameraRot;
+			}
 		}
 
 		//lastCameraLoc = curCameraLoc;
@@ -685,8 +693,12 @@ void UVRRootComponent::TickComponent(float DeltaTime, enum ELevelTick TickType,
 		// Store a leveled yaw value here so it is only calculated once
 		StoredCameraRotOffset = UVRExpansionFunctionLibrary::GetHMDPureYaw_I(curCameraRot);
 
-		// Can adjust the relative tolerances to remove jitter and some update processing
-		if (!curCameraLoc.Equals(lastCameraLoc, 0.01f) || !curCameraRot.Equals(lastCameraRot, 0.01f))
+		// Publish the pose for the attachments that follow it, the character tolerances remove jitter and some update processing
+		const bool bTrackingChanged = owningVRChar ?
+			owningVRChar->UpdateTrackingFrame(curCameraLoc, curCameraRot, StoredCameraRotOffset, VRCapsuleOffset) :
+			(!curCameraLoc.Equals(lastCameraLoc, 0.01f) || !curCameraRot.Equals(lastCameraRot, 0.01f));
+
+		if (bTrackingChanged)
 		{
 			bCalledUpdateTransform = false;
 
@@ -109,6 +109,13 @@ public:
 	/** Network serialization */
 	// Doing a custom NetSerialize here because this is sent via RPCs and should change on every update
 	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+	{
+		return NetSerialize(Ar, Map, bOutSuccess, FVector::ZeroVector, false);
+	}
+
+	// Teleport locations are sent relative to ReferenceLocation, which both sides need to have at the same precision
+	// If bFlagsShared then MoveActionFlags and VelRetentionSetting are serialized once by the owning array instead
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess, const FVector& ReferenceLocation, bool bFlagsShared)
 	{
 		bOutSuccess = true;
 
@@ -120,153 +127,98 @@ public:
 		case EVRMoveAction::VRMOVEACTION_SetRotation:
 		case EVRMoveAction::VRMOVEACTION_SnapTurn:
 		{
-			uint16 Yaw = 0;
-			uint16 Pitch = 0;
-
-			if (Ar.IsSaving())
+			if (!bFlagsShared)
 			{
-				bool bUseLocOnly = MoveActionFlags & 0x04;
-				Ar.SerializeBits(&bUseLocOnly, 1);
-
-				if (!bUseLocOnly)
-				{
-					Yaw = FRotator::CompressAxisToShort(MoveActionRot.Yaw);
-					Ar << Yaw;
-				}
-				else
-				{
-					Ar << MoveActionLoc;
-				}
-
-				bool bTeleportGrips = MoveActionFlags & 0x01;// MoveActionRot.Roll > 0.0f && MoveActionRot.Roll < 1.5f;
-				Ar.SerializeBits(&bTeleportGrips, 1);
-
-				if (!bTeleportGrips)
-				{
-					bool bTeleportCharacter = MoveActionFlags & 0x02;// MoveActionRot.Roll > 1.5f;
-					Ar.SerializeBits(&bTeleportCharacter, 1);
-				}
+				SerializeFlag(Ar, 0x04); // Use loc only
+			}
 
-				Ar.SerializeBits(&VelRetentionSetting, 2);
+			if (!(MoveActionFlags & 0x04))
+			{
+				uint16 Yaw = Ar.IsSaving() ? FRotator::CompressAxisToShort(MoveActionRot.Yaw) : 0;
+				Ar << Yaw;
 
-				if (VelRetentionSetting == EVRMoveActionVelocityRetention::VRMOVEACTION_Velocity_Turn)
+				if (Ar.IsLoading())
 				{
-					bOutSuccess &= SerializePackedVector<100, 30>(MoveActionVel, Ar);
-					//Pitch = FRotator::CompressAxisToShort(MoveActionRot.Pitch);
-					//Ar << Pitch;
+					MoveActionRot.Yaw = FRotator::DecompressAxisFromShort(Yaw);
 				}
-
-				bool bRotateAroundCapsule = MoveActionFlags & 0x08;
-				Ar.SerializeBits(&bRotateAroundCapsule, 1);
 			}
 			else
 			{
+				// Offset from rotating around the HMD, always small
+				bOutSuccess &= SerializePackedVector<100, 30>(MoveActionLoc, Ar);
+			}
 
-				bool bUseLocOnly = false;
-				Ar.SerializeBits(&bUseLocOnly, 1);
-				MoveActionFlags |= (bUseLocOnly << 2);
-
-				if (!bUseLocOnly)
-				{
-					Ar << Yaw;
-					MoveActionRot.Yaw = FRotator::DecompressAxisFromShort(Yaw);
-				}
-				else
-				{
-					Ar << MoveActionLoc;
-				}
-
-				bool bTeleportGrips = false;
-				Ar.SerializeBits(&bTeleportGrips, 1);
-				MoveActionFlags |= (uint8)bTeleportGrips; //.Roll = bTeleportGrips ? 1.0f : 0.0f;
+			if (!bFlagsShared)
+			{
+				SerializeFlag(Ar, 0x01); // Teleport grips
 
-				if (!bTeleportGrips)
+				if (!(MoveActionFlags & 0x01))
 				{
-					bool bTeleportCharacter = false;
-					Ar.SerializeBits(&bTeleportCharacter, 1);
-					MoveActionFlags |= ((uint8)bTeleportCharacter << 1);
-						//MoveActionRot.Roll = 2.0f;
+					SerializeFlag(Ar, 0x02); // Teleport character
 				}
 
 				Ar.SerializeBits(&VelRetentionSetting, 2);
+			}
 
-				if (VelRetentionSetting == EVRMoveActionVelocityRetention::VRMOVEACTION_Velocity_Turn)
-				{
-					bOutSuccess &= SerializePackedVector<100, 30>(MoveActionVel, Ar);
-					//Ar << Pitch;
-					//MoveActionRot.Pitch = FRotator::DecompressAxisFromShort(Pitch);
-				}
-
-				bool bRotateAroundCapsule = false;
-				Ar.SerializeBits(&bRotateAroundCapsule, 1);
-				MoveActionFlags |= (uint8)(bRotateAroundCapsule << 3);
+			if (VelRetentionSetting == EVRMoveActionVelocityRetention::VRMOVEACTION_Velocity_Turn)
+			{
+				bOutSuccess &= SerializePackedVector<100, 30>(MoveActionVel, Ar);
 			}
 
-			//bOutSuccess &= SerializePackedVector<100, 30>(MoveActionLoc, Ar);
+			if (!bFlagsShared)
+			{
+				SerializeFlag(Ar, 0x08); // Rotate around capsule
+			}
 		}break;
 		case EVRMoveAction::VRMOVEACTION_Teleport: // Not replicating rot as Control rot does that already
 		{
-			uint16 Yaw = 0;
-			uint16 Pitch = 0;
+			uint16 Yaw = Ar.IsSaving() ? FRotator::CompressAxisToShort(MoveActionRot.Yaw) : 0;
+			Ar << Yaw;
 
-			if (Ar.IsSaving())
+			if (Ar.IsLoading())
 			{
-				Yaw = FRotator::CompressAxisToShort(MoveActionRot.Yaw);
-				Ar << Yaw;
+				MoveActionRot.Yaw = FRotator::DecompressAxisFromShort(Yaw);
+			}
 
-				bool bSkipEncroachment = MoveActionFlags & 0x01;// MoveActionRot.Roll > 0.0f;
-				Ar.SerializeBits(&bSkipEncroachment, 1);
+			if (!bFlagsShared)
+			{
+				SerializeFlag(Ar, 0x01); // Skip encroachment
 				Ar.SerializeBits(&VelRetentionSetting, 2);
-
-				if (VelRetentionSetting == EVRMoveActionVelocityRetention::VRMOVEACTION_Velocity_Turn)
-				{
-					bOutSuccess &= SerializePackedVector<100, 30>(MoveActionVel, Ar);
-					//Pitch = FRotator::CompressAxisToShort(MoveActionRot.Pitch);
-					//Ar << Pitch;
-				}
 			}
-			else
+
+			if (VelRetentionSetting == EVRMoveActionVelocityRetention::VRMOVEACTION_Velocity_Turn)
 			{
-				Ar << Yaw;
-				MoveActionRot.Yaw = FRotator::DecompressAxisFromShort(Yaw);
+				bOutSuccess &= SerializePackedVector<100, 30>(MoveActionVel, Ar);
+			}
 
-				bool bSkipEncroachment = false;
-				Ar.SerializeBits(&bSkipEncroachment, 1);
-				MoveActionFlags |= (uint8)bSkipEncroachment;
-				//MoveActionRot.Roll = bSkipEncroachment ? 1.0f : 0.0f;
-				Ar.SerializeBits(&VelRetentionSetting, 2);
+			// Relative to the reference, a world location packs to far more bits than the distance teleported
+			FVector RelativeLoc = Ar.IsSaving() ? MoveActionLoc - ReferenceLocation : FVector::ZeroVector;
+			bOutSuccess &= SerializePackedVector<100, 30>(RelativeLoc, Ar);
 
-				if (VelRetentionSetting == EVRMoveActionVelocityRetention::VRMOVEACTION_Velocity_Turn)
-				{
-					bOutSuccess &= SerializePackedVector<100, 30>(MoveActionVel, Ar);
-					//Ar << Pitch;
-					//MoveActionRot.Pitch = FRotator::DecompressAxisFromShort(Pitch);
-				}
+			if (Ar.IsLoading())
+			{
+				MoveActionLoc = ReferenceLocation + RelativeLoc;
 			}
-
-			bOutSuccess &= SerializePackedVector<100, 30>(MoveActionLoc, Ar);
 		}break;
 		case EVRMoveAction::VRMOVEACTION_StopAllMovement:
 		{}break;
 		case EVRMoveAction::VRMOVEACTION_PauseTracking:
 		{
+			if (!bFlagsShared)
+			{
+				Ar.SerializeBits(&MoveActionFlags, 1);
+			}
 
-			Ar.SerializeBits(&MoveActionFlags, 1);
 			bOutSuccess &= SerializePackedVector<100, 30>(MoveActionLoc, Ar);
 			
-			uint16 Yaw = 0;
 			// Loc and rot for capsule should also be sent here
-			if (Ar.IsSaving())
-			{
-				Yaw = FRotator::CompressAxisToShort(MoveActionRot.Yaw);
-				Ar << Yaw;
-			}
-			else
+			uint16 Yaw = Ar.IsSaving() ? FRotator::CompressAxisToShort(MoveActionRot.Yaw) : 0;
+			Ar << Yaw;
+
+			if (Ar.IsLoading())
 			{
-				Ar << Yaw;
 				MoveActionRot.Yaw = FRotator::DecompressAxisFromShort(Yaw);
 			}
-
 		}break;
 		default: // Everything else
 		{
@@ -286,11 +238,14 @@ public:
 				Ar << MoveActionObjectReferences;
 			}
 
-			bool bSerializeFlags = MoveActionFlags != 0x00;
-			Ar.SerializeBits(&bSerializeFlags, 1);
-			if (bSerializeFlags)
+			if (!bFlagsShared)
 			{
-				Ar << MoveActionFlags;
+				bool bSerializeFlags = MoveActionFlags != 0x00;
+				Ar.SerializeBits(&bSerializeFlags, 1);
+				if (bSerializeFlags)
+				{
+					Ar << MoveActionFlags;
+				}
 			}
 
 		}break;
@@ -298,6 +253,20 @@ public:
 
 		return bOutSuccess;
 	}
+
+private:
+
+	// Single bit for one of the MoveActionFlags, loading only ever adds flags
+	void SerializeFlag(FArchive& Ar, uint8 Flag)
+	{
+		bool bIsSet = (MoveActionFlags & Flag) != 0;
+		Ar.SerializeBits(&bIsSet, 1);
+
+		if (Ar.IsLoading() && bIsSet)
+		{
+			MoveActionFlags |= Flag;
+		}
+	}
 };
 template<>
 struct TStructOpsTypeTraits< FVRMoveActionContainer > : public TStructOpsTypeTraitsBase2<FVRMoveActionContainer>
@@ -316,6 +285,9 @@ public:
 	UPROPERTY()
 		TArray<FVRMoveActionContainer> MoveActions;
 
+	// Wire copy of MoveActions with stacked rotations combined, kept so saving doesn't allocate on every send
+	TArray<FVRMoveActionContainer> CombinedMoveActions;
+
 	void Clear()
 	{
 		MoveActions.Empty();
@@ -324,9 +296,28 @@ public:
 	/** Network serialization */
 	// Doing a custom NetSerialize here because this is sent via RPCs and should change on every update
 	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+	{
+		return NetSerialize(Ar, Map, bOutSuccess, FVector::ZeroVector);
+	}
+
+	// Stacked rotations are combined before sending and flags shared by every action are only sent once
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess, const FVector& ReferenceLocation)
 	{
 		bOutSuccess = true;
-		uint8 MoveActionCount = (uint8)MoveActions.Num();
+
+		// Only the wire copy is combined, the local array still runs each action for server authed actions
+		TArray<FVRMoveActionContainer>* ActionsToSend = &MoveActions;
+		if (Ar.IsSaving() && MoveActions.Num() > 1)
+		{
+			CombineMoveActions(MoveActions, CombinedMoveActions);
+			ActionsToSend = &CombinedMoveActions;
+		}
+		else if (Ar.IsLoading())
+		{
+			MoveActions.Reset();
+		}
+
+		uint8 MoveActionCount = (uint8)ActionsToSend->Num();
 		bool bHasAMoveAction = MoveActionCount > 0;
 		Ar.SerializeBits(&bHasAMoveAction, 1);
 
@@ -335,35 +326,64 @@ public:
 			bool bHasMoreThanOneMoveAction = MoveActionCount > 1;
 			Ar.SerializeBits(&bHasMoreThanOneMoveAction, 1);
 
-			if (Ar.IsSaving())
+			bool bFlagsShared = false;
+			uint8 SharedFlags = 0;
+			EVRMoveActionVelocityRetention SharedVelRetention = EVRMoveActionVelocityRetention::VRMOVEACTION_Velocity_None;
+
+			if (bHasMoreThanOneMoveAction)
 			{
-				if (bHasMoreThanOneMoveAction)
+				Ar << MoveActionCount;
+
+				if (Ar.IsSaving())
 				{
-					Ar << MoveActionCount;
+					const FVRMoveActionContainer& FirstAction = (*ActionsToSend)[0];
+					SharedFlags = FirstAction.MoveActionFlags;
+					SharedVelRetention = FirstAction.VelRetentionSetting;
+					bFlagsShared = true;
 
-					for (int i = 0; i < MoveActionCount; i++)
+					for (const FVRMoveActionContainer& Action : *ActionsToSend)
 					{
-						bOutSuccess &= MoveActions[i].NetSerialize(Ar, Map, bOutSuccess);
+						if (Action.MoveActionFlags != SharedFlags || Action.VelRetentionSetting != SharedVelRetention)
+						{
+							bFlagsShared = false;
+							break;
+						}
 					}
 				}
-				else
+
+				Ar.SerializeBits(&bFlagsShared, 1);
+
+				if (bFlagsShared)
 				{
-					bOutSuccess &= MoveActions[0].NetSerialize(Ar, Map, bOutSuccess);
+					Ar << SharedFlags;
+					Ar.SerializeBits(&SharedVelRetention, 2);
 				}
 			}
-			else
+			else if (Ar.IsLoading())
+			{
+				MoveActionCount = 1;
+			}
+
+			if (Ar.IsSaving())
 			{
-				if (bHasMoreThanOneMoveAction)
+				for (int i = 0; i < MoveActionCount; i++)
 				{
-					Ar << MoveActionCount;
+					bOutSuccess &= (*ActionsToSend)[i].NetSerialize(Ar, Map, bOutSuccess, ReferenceLocation, bFlagsShared);
 				}
-				else
-					MoveActionCount = 1;
-
+			}
+			else
+			{
 				for (int i = 0; i < MoveActionCount; i++)
 				{
 					FVRMoveActionContainer MoveAction;
-					bOutSuccess &= MoveAction.NetSerialize(Ar, Map, bOutSuccess);
+
+					if (bFlagsShared)
+					{
+						MoveAction.MoveActionFlags = SharedFlags;
+						MoveAction.VelRetentionSetting = SharedVelRetention;
+					}
+
+					bOutSuccess &= MoveAction.NetSerialize(Ar, Map, bOutSuccess, ReferenceLocation, bFlagsShared);
 					MoveActions.Add(MoveAction);
 				}
 			}
@@ -371,6 +391,9 @@ public:
 
 		return bOutSuccess;
 	}
+
+	// Folds runs of snap turns / set rotations with matching flags into a single action with the accumulated result
+	static void CombineMoveActions(const TArray<FVRMoveActionContainer>& InMoveActions, TArray<FVRMoveActionContainer>& OutMoveActions);
 };
 template<>
 struct TStructOpsTypeTraits< FVRMoveActionArray > : public TStructOpsTypeTraitsBase2<FVRMoveActionArray>
@@ -405,6 +428,12 @@ public:
 	/** Network serialization */
 	// Doing a custom NetSerialize here because this is sent via RPCs and should change on every update
 	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+	{
+		return NetSerialize(Ar, Map, bOutSuccess, FVector::ZeroVector);
+	}
+
+	// ReferenceLocation is passed on to the move actions, see FVRMoveActionArray
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess, const FVector& ReferenceLocation)
 	{
 		bOutSuccess = true;
 
@@ -442,7 +471,7 @@ public:
 			}
 
 			//if (bHasMoveAction)
-			MoveActionArray.NetSerialize(Ar, Map, bOutSuccess);
+			MoveActionArray.NetSerialize(Ar, Map, bOutSuccess, ReferenceLocation);
 		}
 		else if (bIsLoading)
 		{
@@ -700,4 +729,59 @@ public:
 
 	//bool bHasRotation; // By default ClientAdjustment.NewRot is not serialized. Set this to true after base ServerFillResponseData if you want Rotation to be serialized.
 
+	/**
+	 * Serializes a compact correction when one was filled, otherwise passes through to the engine serialization.
+	 */
+	virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap) override;
+
+	// If true the correction location is sent as CorrectionDelta from the location the client reported for the corrected move
+	bool bHasCompactCorrection = false;
+	FVector CorrectionDelta = FVector::ZeroVector;
+};
+
+// State of the server character after processing a client move
+struct VREXPANSIONPLUGIN_API FVRServerMoveState
+{
+	float TimeStamp = 0.0f;
+	TWeakObjectPtr<UPrimitiveComponent> MovementBase;
+
+	// Server location minus client location for this move, in the space of MovementBase when it uses relative location
+	FVector ClientError = FVector::ZeroVector;
+	bool bSentCorrection = false;
+};
+
+// Fixed size ring buffer of server move states, oldest entries are overwritten
+struct VREXPANSIONPLUGIN_API FVRServerMoveHistory
+{
+public:
+
+	void Init(int32 InCapacity);
+	void Reset();
+	void Add(const FVRServerMoveState& NewState);
+
+	int32 Capacity() const { return States.Num(); }
+	int32 Num() const { return NumStates; }
+
+	// Returns the most recently added state
+	const FVRServerMoveState* GetNewest() const
+	{
+		return NumStates > 0 ? &GetFromNewest(0) : nullptr;
+	}
+
+	// Returns the newest state with a timestamp at or before TimeStamp
+	const FVRServerMoveState* FindStateAtTime(float TimeStamp) const;
+
+	// Returns the newest state that sent a correction to the client
+	const FVRServerMoveState* FindLastCorrection() const;
+
+private:
+
+	const FVRServerMoveState& GetFromNewest(int32 Offset) const
+	{
+		return States[(Head - 1 - Offset + States.Num()) % States.Num()];
+	}
+
+	TArray<FVRServerMoveState> States;
+	int32 Head = 0;
+	int32 NumStates = 0;
 };
\ No newline at end of file
@@ -25,6 +25,29 @@
 //#if PHYSICS_INTERFACE_PHYSX
 struct FAsyncPhysicsRepCallbackDataVR;
 class FPhysicsReplicationAsyncCallbackVR;
+class UPlayer;
+
+// A single client authed body that the server is replicating towards its target
+// Handles are resolved when the target is set so that the per tick pass doesn't need to
+struct FReplicatedBodyVR
+{
+	TWeakObjectPtr<UPrimitiveComponent> Component;
+	TWeakObjectPtr<UPlayer> OwningPlayer;
+	FBodyInstance* BodyInstance;
+	FReplicatedPhysicsTarget PhysicsTarget;
+	FRigidBodyErrorCorrection ErrorCorrection;
+
+	// Skeletal and welded bodies can have their body instance re-created from under us, re-resolve those on tick
+	bool bResolveBodyOnTick;
+	bool bIsSkeletal;
+
+	FReplicatedBodyVR() :
+		BodyInstance(nullptr),
+		bResolveBodyOnTick(false),
+		bIsSkeletal(false)
+	{
+	}
+};
 
 class FPhysicsReplicationVR : public FPhysicsReplication
 {
@@ -36,6 +59,10 @@ public:
 	~FPhysicsReplicationVR();
 	static bool IsInitialized();
 
+	// Server side these are stored in ReplicatedBodies instead of the engine map, clients use the default path
+	virtual void SetReplicatedTarget(UPrimitiveComponent* Component, FName BoneName, const FRigidBodyState& ReplicatedTarget, int32 ServerFrame) override;
+	virtual void RemoveReplicatedTarget(UPrimitiveComponent* Component) override;
+
 	virtual void OnTick(float DeltaSeconds, TMap<TWeakObjectPtr<UPrimitiveComponent>, FReplicatedPhysicsTarget>& ComponentsToTargets) override;
 	
 	virtual bool ApplyRigidBodyState(float DeltaSeconds, FBodyInstance* BI, FReplicatedPhysicsTarget& PhysicsTarget, const FRigidBodyErrorCorrection& ErrorCorrection, const float PingSecondsOneWay, int32 LocalFrame, int32 NumPredictedFrames) override;
@@ -48,6 +75,21 @@ public:
 	void PrepareAsyncData_ExternalVR(const FRigidBodyErrorCorrection& ErrorCorrection);	//prepare async data for writing. Call on external thread (i.e. game thread)
 	FAsyncPhysicsRepCallbackDataVR* CurAsyncDataVR;	//async data being written into before we push into callback
 	friend FPhysicsReplicationAsyncCallback;
+
+private:
+
+	bool IsServerReplication() const;
+	FReplicatedBodyVR& FindOrAddReplicatedBody(UPrimitiveComponent* Component, const FVector& InitialPosition);
+	void ResolveReplicatedBody(FReplicatedBodyVR& Body, UPrimitiveComponent* Component);
+	void RemoveReplicatedBodyAt(int32 Index);
+	void OnTickServer(float DeltaSeconds, TMap<TWeakObjectPtr<UPrimitiveComponent>, FReplicatedPhysicsTarget>& ComponentsToTargets);
+
+	// Sparse so that indices stay stable while removing during the tick pass, free slots get re-used on add
+	TSparseArray<FReplicatedBodyVR> ReplicatedBodies;
+	TMap<TWeakObjectPtr<UPrimitiveComponent>, int32> ReplicatedBodyIndices;
+
+	// Scratch list of bodies to remove after the batched pass
+	TArray<int32> PendingBodyRemovals;
 };
 
 class IPhysicsReplicationFactoryVR : public IPhysicsReplicationFactory
@@ -91,6 +133,87 @@ struct TStructOpsTypeTraits<FRepMovementVR> : public TStructOpsTypeTraitsBase2<F
 	};
 };
 
+// A single thrown object sample inside of a batched client auth throwing update
+// If not a keyframe then the location is a delta from the previous sample of the same object
+USTRUCT()
+struct VREXPANSIONPLUGIN_API FVRThrownObjectSample
+{
+	GENERATED_BODY()
+public:
+
+	UPROPERTY()
+		TObjectPtr<AActor> ThrownActor;
+
+	// Incremented per sample of this object, deltas are only applied on top of the directly preceding sample
+	uint8 Sequence;
+	bool bIsKeyframe;
+	FRepMovementVR Movement;
+
+	FVRThrownObjectSample() :
+		ThrownActor(nullptr),
+		Sequence(0),
+		bIsKeyframe(true)
+	{
+	}
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FVRThrownObjectSample> : public TStructOpsTypeTraitsBase2<FVRThrownObjectSample>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+// All of the thrown objects for a single connection for one update
+USTRUCT()
+struct VREXPANSIONPLUGIN_API FVRThrownObjectBatch
+{
+	GENERATED_BODY()
+public:
+
+	// Hard cap per RPC, more than this is split into multiple batches
+	static const int32 MaxSamplesPerBatch = 32;
+
+	UPROPERTY()
+		TArray<FVRThrownObjectSample> Samples;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FVRThrownObjectBatch> : public TStructOpsTypeTraitsBase2<FVRThrownObjectBatch>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+// Last known location for a thrown object, kept on both sides so that samples can be delta encoded
+struct FVRThrownObjectBaseline
+{
+	FVector LastLocation;
+	uint8 Sequence;
+	uint8 SamplesSinceKeyframe;
+
+	FVRThrownObjectBaseline() :
+		LastLocation(FVector::ZeroVector),
+		Sequence(0),
+		SamplesSinceKeyframe(0)
+	{
+	}
+
+	// Matches the rounding of the sample serialization so that both ends accumulate the same values
+	static FVector QuantizeLocation(const FVector& InLocation)
+	{
+		return FVector(FMath::RoundToDouble(InLocation.X * 100.0) / 100.0, FMath::RoundToDouble(InLocation.Y * 100.0) / 100.0, FMath::RoundToDouble(InLocation.Z * 100.0) / 100.0);
+	}
+};
+
 USTRUCT(BlueprintType)
 struct VREXPANSIONPLUGIN_API FVRClientAuthReplicationData
 {
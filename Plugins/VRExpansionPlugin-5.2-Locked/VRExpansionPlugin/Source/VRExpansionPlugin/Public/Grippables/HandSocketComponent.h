@@ -8,6 +8,7 @@
 #include "Components/SceneComponent.h"
 #include "Animation/AnimInstance.h"
 #include "Misc/Guid.h"
+#include "Animation/PoseSnapshot.h"
 #include "HandSocketComponent.generated.h"
 
 class USkeletalMeshComponent;
@@ -15,7 +16,7 @@ class UPoseableMeshComponent;
 class USkeletalMesh;
 class UGripMotionControllerComponent;
 class UAnimSequence;
-struct FPoseSnapshot;
+class USkinnedAsset;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogVRHandSocketComponent, Log, All);
 
@@ -87,6 +88,16 @@ public:
 	}
 };
 
+// A finished pose for one target mesh asset, kept so that repeated grips don't rebuild it
+struct FVRHandSocketPoseCacheEntry
+{
+	// Null when the pose was built without a target mesh
+	TWeakObjectPtr<const USkinnedAsset> TargetAsset;
+	bool bSkipRootBone = false;
+	bool bFlipHand = false;
+	FPoseSnapshot PoseSnapShot;
+};
+
 UCLASS(Blueprintable, ClassGroup = (VRExpansionPlugin), hideCategories = ("Component Tick", Events, Physics, Lod, "Asset User Data", Collision))
 class VREXPANSIONPLUGIN_API UHandSocketComponent : public USceneComponent, public IGameplayTagAssetInterface
 {
@@ -202,6 +213,11 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Hand Socket Data")
 		bool GetBlendedPoseSnapShot(FPoseSnapshot& PoseSnapShot, USkeletalMeshComponent* TargetMesh = nullptr, bool bSkipRootBone = false, bool bFlipHand = false);
 
+	// Clears the cached blended poses, call this if you modify the target animation asset itself at runtime
+	// Changes to HandTargetAnimation or CustomPoseDeltas are detected automatically
+	UFUNCTION(BlueprintCallable, Category = "Hand Socket Data")
+		void InvalidatePoseSnapShotCache();
+
 	/**
 	* Converts an animation sequence into a pose snapshot
 	* @param InAnimationSequence - Sequence to convert to a pose snapshot
@@ -343,6 +359,19 @@ public:
 
 	virtual FTransform GetHandSocketTransform(UGripMotionControllerComponent* QueryController, bool bIgnoreOnlySnapMesh = false);
 
+protected:
+
+	// Blended poses per target asset, hand and root bone setting, cleared when the pose source changes
+	TArray<FVRHandSocketPoseCacheEntry> PoseSnapShotCache;
+	uint32 CachedPoseSourceHash = 0;
+
+	// Hash of the animation and custom deltas that the cached poses were built from
+	uint32 GetPoseSourceHash() const;
+	const FVRHandSocketPoseCacheEntry* FindCachedPoseSnapShot(const USkinnedAsset* TargetAsset, bool bSkipRootBone, bool bFlipHand) const;
+	bool BuildBlendedPoseSnapShot(FPoseSnapshot& PoseSnapShot, USkeletalMeshComponent* TargetMesh, bool bSkipRootBone, bool bFlipHand) const;
+
+public:
+
 #if WITH_EDITOR
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
 #endif
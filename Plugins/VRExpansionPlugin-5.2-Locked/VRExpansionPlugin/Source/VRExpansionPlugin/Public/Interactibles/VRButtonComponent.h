@@ -56,6 +56,9 @@ public:
 	void OnOverlapEnd(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
 
 	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
+
+	// Per frame interaction and return logic, run from TickComponent or from the interactible update subsystem
+	void UpdateInteractible(float DeltaTime);
 	virtual void BeginPlay() override;
 
 	UFUNCTION(BlueprintPure, Category = "VRButtonComponent")
@@ -163,6 +166,7 @@ public:
 
 	// Resetting the initial transform here so that it comes in prior to BeginPlay and save loading.
 	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
 
 	// Now replicating this so that it works correctly over the network
 	UPROPERTY(BlueprintReadOnly, ReplicatedUsing = OnRep_InitialRelativeTransform, Category = "VRButtonComponent")
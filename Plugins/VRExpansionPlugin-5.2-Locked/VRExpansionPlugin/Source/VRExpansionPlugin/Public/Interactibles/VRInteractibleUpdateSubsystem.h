@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "VRInteractibleUpdateSubsystem.generated.h"
+
+class UVRButtonComponent;
+class UVRLeverComponent;
+class UVRDialComponent;
+class UVRSliderComponent;
+
+// Interactibles of a single type that currently need updating
+// Kept as raw pointers, interactibles remove themselves when they stop updating or are unregistered
+template<typename InteractibleType>
+struct TVRInteractibleUpdateList
+{
+	TArray<InteractibleType*> Interactibles;
+
+	// Removals during an update null the entry instead and are compacted afterwards
+	bool bIsUpdating = false;
+	bool bHasPendingRemovals = false;
+
+	void Add(InteractibleType* Interactible)
+	{
+		Interactibles.AddUnique(Interactible);
+	}
+
+	void Remove(InteractibleType* Interactible)
+	{
+		const int32 Index = Interactibles.Find(Interactible);
+		if (Index == INDEX_NONE)
+			return;
+
+		if (bIsUpdating)
+		{
+			Interactibles[Index] = nullptr;
+			bHasPendingRemovals = true;
+		}
+		else
+		{
+			Interactibles.RemoveAtSwap(Index, 1, false);
+		}
+	}
+
+	void Update(float DeltaTime);
+};
+
+/*
+* Drives buttons, levers, dials and sliders from a single tick instead of each of them scheduling their own component tick.
+* Only used when bUseInteractibleUpdateSubsystem is enabled in the VR global settings, interactibles fall back to their own ticks otherwise.
+*/
+UCLASS()
+class VREXPANSIONPLUGIN_API UVRInteractibleUpdateSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UVRInteractibleUpdateSubsystem() :
+		Super()
+	{
+
+	}
+
+	virtual bool DoesSupportWorldType(EWorldType::Type WorldType) const override
+	{
+		return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+		// Editor worlds keep using component ticks
+	}
+
+	// Returns the subsystem to register with if interactibles in this world should use it
+	static UVRInteractibleUpdateSubsystem* GetSubsystemForInteractibles(const UWorld* World);
+
+	// Starts or stops updating an interactible, either through this subsystem or through its own component tick
+	static void SetInteractibleUpdateEnabled(UVRButtonComponent* Interactible, bool bEnabled);
+	static void SetInteractibleUpdateEnabled(UVRLeverComponent* Interactible, bool bEnabled);
+	static void SetInteractibleUpdateEnabled(UVRDialComponent* Interactible, bool bEnabled);
+	static void SetInteractibleUpdateEnabled(UVRSliderComponent* Interactible, bool bEnabled);
+
+	// Drops an interactible from the subsystem without touching its component tick, for when it is unregistered
+	static void RemoveInteractible(UActorComponent* Interactible);
+
+	// Total interactibles currently being updated by the subsystem
+	UFUNCTION(BlueprintPure, Category = "VRInteractibleUpdateSubsystem")
+		int32 GetNumUpdatingInteractibles() const;
+
+	TVRInteractibleUpdateList<UVRButtonComponent> Buttons;
+	TVRInteractibleUpdateList<UVRLeverComponent> Levers;
+	TVRInteractibleUpdateList<UVRDialComponent> Dials;
+	TVRInteractibleUpdateList<UVRSliderComponent> Sliders;
+
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject functions
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	virtual bool IsTickableInEditor() const;
+	virtual bool IsTickableWhenPaused() const override;
+	virtual ETickableTickType GetTickableTickType() const;
+	virtual TStatId GetStatId() const override;
+
+	// End tickable object information
+
+private:
+
+	template<typename InteractibleType>
+	static void SetUpdateEnabled(InteractibleType* Interactible, TVRInteractibleUpdateList<InteractibleType> UVRInteractibleUpdateSubsystem::* List, bool bEnabled);
+};
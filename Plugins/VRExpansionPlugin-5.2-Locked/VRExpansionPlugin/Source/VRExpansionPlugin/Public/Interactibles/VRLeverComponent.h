@@ -252,6 +252,9 @@ public:
 		bool bReplicateMovement;
 
 	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
+
+	// Per frame interaction and return logic, run from TickComponent or from the interactible update subsystem
+	void UpdateInteractible(float DeltaTime);
 	virtual void BeginPlay() override;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VRGripInterface")
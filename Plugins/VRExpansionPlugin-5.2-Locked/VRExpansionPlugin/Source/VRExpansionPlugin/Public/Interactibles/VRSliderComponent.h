@@ -32,6 +32,45 @@ enum class EVRInteractibleSliderDropBehavior : uint8
 	RetainMomentum
 };
 
+// Arc length lookup table for a followed spline, sampled at the splines reparam steps in spline local space
+// Lets the slider project the hand with a local search from its last key instead of searching every segment each tick
+struct VREXPANSIONPLUGIN_API FVRSliderSplineLUT
+{
+	TWeakObjectPtr<USplineComponent> Spline;
+	uint32 SplineVersion;
+	int32 StepsPerSegment;
+	bool bClosedLoop;
+	float SplineLength;
+
+	// One entry per reparam point, the last entry is the end of the spline
+	TArray<FVector> Positions;
+	TArray<float> Keys;
+	TArray<float> Distances;
+
+	FVRSliderSplineLUT() :
+		SplineVersion(0),
+		StepsPerSegment(0),
+		bClosedLoop(false),
+		SplineLength(0.0f)
+	{}
+
+	// Rebuilds the table if the spline is different or has changed since it was built, returns false if the spline can't be used
+	bool UpdateFromSpline(USplineComponent* InSpline);
+	void Reset();
+
+	bool IsValid() const { return Positions.Num() > 1; }
+	int32 NumSegments() const { return Positions.Num() - 1; }
+
+	// Finds the closest point on the sampled spline to a spline local location
+	// WarmStartKey < 0.0f searches the entire table, otherwise it only walks outwards from that key until the distance stops improving
+	float FindInputKeyClosestToLocalLocation(const FVector& LocalLocation, float WarmStartKey, float& OutDistanceAlongSpline) const;
+
+private:
+
+	float ProjectOntoSegment(int32 SegmentIndex, const FVector& LocalLocation, float& OutAlpha) const;
+	int32 WrapSegmentIndex(int32 SegmentIndex) const;
+};
+
 /** Delegate for notification when the slider state changes. */
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FVRSliderHitPointSignature, float, SliderProgressPoint);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FVRSliderFinishedLerpingSignature, float, FinalProgress);
@@ -167,6 +206,13 @@ public:
 	float LastInputKey;
 	float LerpedKey;
 
+	// Arc length table of SplineComponentToFollow, rebuilt when the spline changes
+	FVRSliderSplineLUT SplineLUT;
+
+	// Projects a world location onto the followed spline using the lookup table, warm started from WarmStartKey if it is >= 0.0f
+	// Fills in the slider progress of the projected point
+	float FindSplineInputKeyClosestToWorldLocation(const FVector& WorldLocation, float WarmStartKey, float& OutSliderProgress);
+
 	// Type of lerp to use when following a spline
 	// For lerping I would suggest using ConstantTo in general as it will be the smoothest.
 	// Normal Interp will change speed based on distance, that may also have its uses.
@@ -197,6 +243,7 @@ public:
 
 	// Resetting the initial transform here so that it comes in prior to BeginPlay and save loading.
 	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
 
 	// Now replicating this so that it works correctly over the network
 	UPROPERTY(BlueprintReadOnly, ReplicatedUsing = OnRep_InitialRelativeTransform, Category = "VRSliderComponent")
@@ -275,6 +322,9 @@ public:
 		bool bReplicateMovement;
 
 	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
+
+	// Per frame interaction and return logic, run from TickComponent or from the interactible update subsystem
+	void UpdateInteractible(float DeltaTime);
 	virtual void BeginPlay() override;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VRGripInterface")
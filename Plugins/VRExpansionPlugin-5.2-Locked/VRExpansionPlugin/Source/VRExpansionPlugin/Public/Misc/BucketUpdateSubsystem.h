@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Subsystems/WorldSubsystem.h"
 #include "Tickable.h"
+#include "Grippables/GrippablePhysicsReplication.h"
 #include "BucketUpdateSubsystem.generated.h"
 //#include "GrippablePhysicsReplication.generated.h"
 
@@ -12,6 +13,8 @@
 //DECLARE_DYNAMIC_MULTICAST_DELEGATE(FVRPhysicsReplicationDelegate, void, Return);
 
 
+class AVRBasePlayerController;
+
 DECLARE_DELEGATE_RetVal(bool, FBucketUpdateTickSignature);
 DECLARE_DYNAMIC_DELEGATE(FDynamicBucketUpdateTickSignature);
 
@@ -148,6 +151,24 @@ public:
 	UFUNCTION(BlueprintPure, Category = "BucketUpdateSubsystem")
 		bool IsActive();
 
+	// Queues a client auth throwing sample to be sent with all other thrown objects of the same owning connection
+	// Samples are sent in one RPC per connection after the buckets have updated this frame
+	// Returns false if the object can't be batched (no VRBasePlayerController owner or batching disabled), send it directly in that case
+	bool QueueThrownObjectMovement(AActor* ThrownActor, const FRepMovementVR& Movement);
+
+	// Sends any samples still queued for a thrown object and clears its delta baseline, the next sample for it will be a keyframe
+	// Call before ending the objects client auth so the final sample reaches the server ahead of the end
+	void RemoveThrownObject(AActor* ThrownActor);
+
+	// Client side delta baselines for objects currently being thrown
+	TMap<TWeakObjectPtr<AActor>, FVRThrownObjectBaseline> ThrownObjectBaselines;
+
+	// Samples waiting to be sent this frame, per owning connection
+	TMap<TWeakObjectPtr<AVRBasePlayerController>, FVRThrownObjectBatch> PendingThrownObjectBatches;
+
+	void FlushThrownObjectBatches();
+	void SendThrownObjectBatch(AVRBasePlayerController* OwningController, FVRThrownObjectBatch& Batch);
+
 	// FTickableGameObject functions
 	/**
 	 * Function called every frame on this GripScript. Override this function to implement custom logic to be executed every frame.
@@ -93,6 +93,17 @@ public:
 	}
 
 	void PerformBlendPhysicsBonesVR(const TArray<FBoneIndexType>& InRequiredBones, TArray<FTransform>& InOutComponentSpaceTransforms, TArray<FTransform>& InOutBoneSpaceTransforms);
+
+	// Ref skeleton bone index -> physics asset body index, rebuilt when the mesh, physics asset or body count changes
+	// Saves a name lookup into the physics asset per required bone every blend
+	TArray<int32> BlendBoneToBodyIndexVR;
+	TWeakObjectPtr<const UPhysicsAsset> BlendMapPhysicsAssetVR;
+	TWeakObjectPtr<const USkinnedAsset> BlendMapSkinnedAssetVR;
+	int32 BlendMapNumBodySetupsVR;
+
+	// Rebuilds BlendBoneToBodyIndexVR if it no longer matches the current assets
+	void UpdateBlendBoneToBodyIndexVR(const UPhysicsAsset* PhysicsAsset);
+
 	virtual void RegisterEndPhysicsTick(bool bRegister) override;
 	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 	// END INVERSED MESH FIX
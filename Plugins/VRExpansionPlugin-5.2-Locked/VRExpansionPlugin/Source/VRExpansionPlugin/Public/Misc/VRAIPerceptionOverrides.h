@@ -256,6 +256,115 @@ struct FAISightQueryIDVR
 	}
 };
 
+/**
+ * Uniform XY grid of sight listeners and targets.
+ * Lets the sense only keep queries between pairs that are close enough to possibly see each other instead of every listener / target pair.
+ * Height is ignored so the grid never rejects a pair that the sight cone would accept.
+ */
+struct VREXPANSIONPLUGIN_API FAISightSpatialGridVR
+{
+	struct FListenerEntry
+	{
+		FIntPoint Cell;
+		int32 CellRadius;
+	};
+
+	float CellSize = 0.f;
+	int32 MaxListenerCellRadius = 0;
+
+	TMap<FPerceptionListenerID, FListenerEntry> Listeners;
+	TMap<FAISightTargetVR::FTargetId, FIntPoint> Targets;
+	TMap<FIntPoint, TArray<FPerceptionListenerID>> ListenersByCell;
+	TMap<FIntPoint, TArray<FAISightTargetVR::FTargetId>> TargetsByCell;
+
+	FORCEINLINE FIntPoint GetCell(const FVector& Location) const
+	{
+		return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+	}
+
+	/** Returns true if the listener was added, changed cells or changed sight range */
+	bool UpdateListener(const FPerceptionListenerID ListenerId, const FVector& Location, const float SightRange);
+	void RemoveListener(const FPerceptionListenerID ListenerId);
+
+	/** Returns true if the target was added or changed cells */
+	bool UpdateTarget(const FAISightTargetVR::FTargetId TargetId, const FVector& Location);
+	void RemoveTarget(const FAISightTargetVR::FTargetId TargetId);
+
+	/** True if the target is within the listeners sight range in cells, pairs that aren't in the grid yet are always considered near */
+	bool IsPairNear(const FPerceptionListenerID ListenerId, const FAISightTargetVR::FTargetId TargetId) const;
+
+	template<typename ElementType, typename FuncType>
+	static void ForEachInCells(const TMap<FIntPoint, TArray<ElementType>>& CellMap, const FIntPoint& Cell, const int32 CellRadius, FuncType&& Func)
+	{
+		const int64 CellsToCheck = FMath::Square(2 * (int64)CellRadius + 1);
+
+		// Large sight ranges over sparse grids are cheaper to filter than to probe cell by cell
+		if (CellsToCheck > CellMap.Num())
+		{
+			for (const TPair<FIntPoint, TArray<ElementType>>& CellPair : CellMap)
+			{
+				if (FMath::Abs(CellPair.Key.X - Cell.X) <= CellRadius && FMath::Abs(CellPair.Key.Y - Cell.Y) <= CellRadius)
+				{
+					for (const ElementType& Element : CellPair.Value)
+					{
+						Func(Element);
+					}
+				}
+			}
+			return;
+		}
+
+		for (int32 X = Cell.X - CellRadius; X <= Cell.X + CellRadius; ++X)
+		{
+			for (int32 Y = Cell.Y - CellRadius; Y <= Cell.Y + CellRadius; ++Y)
+			{
+				if (const TArray<ElementType>* Elements = CellMap.Find(FIntPoint(X, Y)))
+				{
+					for (const ElementType& Element : *Elements)
+					{
+						Func(Element);
+					}
+				}
+			}
+		}
+	}
+
+private:
+	void RecalcMaxListenerCellRadius();
+};
+
+/** Line of sight result between a listener and a target that can be reused until the listener or any traced point of the target moves */
+struct FAISightVisibilityCacheEntryVR
+{
+	double Time;
+	FVector ListenerLocation;
+	TArray<FVector, TInlineAllocator<3>> TargetPoints;
+	FVector SeenLocation;
+	bool bVisible;
+};
+
+/** A line of sight trace waiting to be submitted with the rest of an updates batch */
+struct FAISightTraceRequestVR
+{
+	uint64 PairKey;
+	FVector Start;
+	FVector End;
+	const AActor* IgnoreActor;
+};
+
+/** Batched traces still in flight for a pending query, the query resolves once all of them have reported back */
+struct FAISightPendingTracesVR
+{
+	FPerceptionListenerID ObserverId;
+	FAISightTargetVR::FTargetId TargetId = FAISightTargetVR::InvalidTargetId;
+	double RequestTime = 0.0;
+	FVector ListenerLocation = FVector::ZeroVector;
+	TArray<FVector, TInlineAllocator<3>> TargetPoints;
+	FVector SeenLocation = FAISystem::InvalidLocation;
+	int32 NumPendingTraces = 0;
+	bool bAnyVisible = false;
+};
+
 DECLARE_DELEGATE_FiveParams(FOnPendingVisibilityQueryProcessedDelegateVR, const FAISightQueryID&, const bool, const float, const FVector&, const TOptional<int32>&);
 
 
@@ -292,7 +401,21 @@ public:
 	TArray<FAISightQueryVR> SightQueriesInRange;
 	TArray<FAISightQueryVR> SightQueriesPending;
 
+	/** Every listener / target pair that currently has a query in one of the lists above */
+	TSet<uint64> QueryPairs;
+
+	static FORCEINLINE uint64 MakeQueryPairKey(const FPerceptionListenerID ObserverId, const FAISightTargetVR::FTargetId TargetId)
+	{
+		return (static_cast<uint64>(static_cast<uint32>(static_cast<int32>(ObserverId))) << 32) | static_cast<uint64>(TargetId);
+	}
+
+	static FORCEINLINE uint64 MakeQueryPairKey(const FAISightQueryVR& SightQuery)
+	{
+		return MakeQueryPairKey(SightQuery.ObserverId, SightQuery.TargetId);
+	}
+
 protected:
+
 	UPROPERTY(EditDefaultsOnly, Category = "AI Perception", config)
 		int32 MaxTracesPerTick;
 
@@ -328,6 +451,38 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = "AI Perception", config)
 		bool bUseAsynchronousTraceForDefaultSightQueries;
 
+	/** Cell size of the grid used to only generate queries between listeners and targets that are close enough to see each other.
+	 *  0 disables the grid and pairs every listener with every target like the engine sense does. */
+	UPROPERTY(EditDefaultsOnly, Category = "AI Perception", config, meta = (UIMin = 0.0, ClampMin = 0.0))
+		float SpatialGridCellSize;
+
+	FAISightSpatialGridVR SpatialGrid;
+
+	/** For VR characters without a sight target interface, trace to the head and both hands instead of only the VR location.
+	 *  The target is seen if any of them is. */
+	UPROPERTY(EditDefaultsOnly, Category = "AI Perception", config)
+		bool bTraceVRCharacterHeadAndHands;
+
+	/** How long in seconds a line of sight result between a listener and a target is reused for, 0 disables the cache */
+	UPROPERTY(EditDefaultsOnly, Category = "AI Perception", config, meta = (UIMin = 0.0, ClampMin = 0.0))
+		float VisibilityCacheDuration;
+
+	/** Moving the listener or the target further than this invalidates their cached line of sight result */
+	UPROPERTY(EditDefaultsOnly, Category = "AI Perception", config, meta = (UIMin = 0.0, ClampMin = 0.0))
+		float VisibilityCacheInvalidationDistance;
+
+	float VisibilityCacheInvalidationDistanceSq;
+	double LastVisibilityCachePruneTime;
+	TMap<uint64, FAISightVisibilityCacheEntryVR> VisibilityCache;
+
+	/** Async line of sight traces gathered during an update, submitted together at the end of it */
+	TArray<FAISightTraceRequestVR> SightTraceBatch;
+	TMap<uint64, FAISightPendingTracesVR> PendingSightTraces;
+	TMap<uint64, uint64> SightTraceHandleToPair;
+
+	/** Scratch max heap of in range query indices, only the top of it gets processed within an updates budget so it replaces a full sort */
+	TArray<int32> InRangeQueryHeap;
+
 	ECollisionChannel DefaultSightCollisionChannel;
 
 	FOnPendingVisibilityQueryProcessedDelegateVR OnPendingCanBeSeenQueryProcessedDelegate;
@@ -350,12 +505,22 @@ public:
 protected:
 	virtual float Update() override;
 
-	UAISense_Sight::EVisibilityResult ComputeVisibility(UWorld* World, FAISightQueryVR& SightQuery, FPerceptionListener& Listener, const AActor* ListenerActor, FAISightTargetVR& Target, AActor* TargetActor, const FDigestedSightProperties& PropDigest, float& OutStimulusStrength, FVector& OutSeenLocation, int32& OutNumberOfLoSChecksPerformed, int32& OutNumberOfAsyncLosCheckRequested) const;
+	UAISense_Sight::EVisibilityResult ComputeVisibility(UWorld* World, FAISightQueryVR& SightQuery, FPerceptionListener& Listener, const AActor* ListenerActor, FAISightTargetVR& Target, AActor* TargetActor, const FDigestedSightProperties& PropDigest, float& OutStimulusStrength, FVector& OutSeenLocation, int32& OutNumberOfLoSChecksPerformed, int32& OutNumberOfAsyncLosCheckRequested);
 	virtual bool ShouldAutomaticallySeeTarget(const FDigestedSightProperties& PropDigest, FAISightQueryVR* SightQuery, FPerceptionListener& Listener, AActor* TargetActor, float& OutStimulusStrength) const;
 	void UpdateQueryVisibilityStatus(FAISightQueryVR& SightQuery, FPerceptionListener& Listener, const bool bIsVisible, const FVector& SeenLocation, const float StimulusStrength, AActor* TargetActor, const FVector& TargetLocation) const;
 
 	void OnPendingCanBeSeenQueryProcessed(const FAISightQueryID& QueryID, const bool bIsVisible, const float StimulusStrength, const FVector& SeenLocation, const TOptional<int32>& UserData);
 	void OnPendingTraceQueryProcessed(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+	void OnBatchedSightTraceProcessed(const uint64 PairKey, const bool bIsVisible, const FVector& TracedLocation);
+	void SubmitSightTraceBatch(UWorld* World);
+
+	/** Points to trace to when checking line of sight to a target, head first then hands for VR characters */
+	void GetSightCandidatePoints(const AActor* TargetActor, const FVector& TargetLocation, TArray<FVector, TInlineAllocator<3>>& OutPoints) const;
+
+	const FAISightVisibilityCacheEntryVR* FindCachedVisibility(const uint64 PairKey, const FVector& ListenerLocation, const TArray<FVector, TInlineAllocator<3>>& TargetPoints, const double CurrentTime) const;
+	void CacheVisibility(const uint64 PairKey, const FVector& ListenerLocation, const TArray<FVector, TInlineAllocator<3>>& TargetPoints, const bool bVisible, const FVector& SeenLocation, const double CurrentTime);
+	void PruneVisibilityCache(const double CurrentTime);
+
 	void OnPendingQueryProcessed(const int32 SightQueryIndex, const bool bIsVisible, const float StimulusStrength, const FVector& SeenLocation, const TOptional<int32>& UserData, const TOptional<AActor*> InTargetActor = NullOpt);
 
 
@@ -373,6 +538,12 @@ protected:
 	/** returns information whether new LoS queries have been added */
 	bool RegisterTarget(AActor& TargetActor, const TFunction<void(FAISightQueryVR&)>& OnAddedFunc = nullptr);
 
+	FORCEINLINE bool IsSpatialGridEnabled() const { return SpatialGridCellSize > 0.f; }
+
+	/** Moves listeners and targets between grid cells, generating queries for pairs that came into range and dropping the ones that left it */
+	void UpdateSpatialGrid();
+	void UpdateSpatialGridListener(const FPerceptionListener& Listener, const FDigestedSightProperties& PropDigest);
+
 	float CalcQueryImportance(const FPerceptionListener& Listener, const FVector& TargetLocation, const float SightRadiusSq) const;
 	bool RegisterNewQuery(const FPerceptionListener& Listener, const IGenericTeamAgentInterface* ListenersTeamAgent, const AActor& TargetActor, const FAISightTargetVR::FTargetId& TargetId, const FVector& TargetLocation, const FDigestedSightProperties& PropDigest, const TFunction<void(FAISightQueryVR&)>& OnAddedFunc);
 
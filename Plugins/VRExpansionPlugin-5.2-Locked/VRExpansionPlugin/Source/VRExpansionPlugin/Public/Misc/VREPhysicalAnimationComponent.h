@@ -11,6 +11,7 @@
 #include "VREPhysicalAnimationComponent.generated.h"
 
 struct FReferenceSkeleton;
+struct FKShapeElem;
 
 USTRUCT()
 struct VREXPANSIONPLUGIN_API FWeldedBoneDriverData
@@ -23,9 +24,17 @@ public:
 
 	FTransform LastLocal;
 
+	// Resolved during setup so that updates don't have to look anything up
+	int32 BoneIndex;
+	int32 ShapeIndex;
+	const FKShapeElem* ShapeElem;
+
 	FWeldedBoneDriverData() :
 		RelativeTransform(FTransform::Identity),
-		BoneName(NAME_None)
+		BoneName(NAME_None),
+		BoneIndex(INDEX_NONE),
+		ShapeIndex(INDEX_NONE),
+		ShapeElem(nullptr)
 	{
 	}
 
@@ -40,6 +49,23 @@ public:
 	}
 };
 
+// The drivers in BoneDriverMap that belong to one base bone body
+struct FWeldedBoneDriverGroup
+{
+	FName BaseBoneName;
+	int32 BodyIndex;
+	int32 FirstDriver;
+	int32 NumDrivers;
+
+	FWeldedBoneDriverGroup() :
+		BaseBoneName(NAME_None),
+		BodyIndex(INDEX_NONE),
+		FirstDriver(0),
+		NumDrivers(0)
+	{
+	}
+};
+
 UCLASS(meta = (BlueprintSpawnableComponent), ClassGroup = Physics)
 class VREXPANSIONPLUGIN_API UVREPhysicalAnimationComponent : public UPhysicalAnimationComponent
 {
@@ -66,6 +92,12 @@ public:
 	UPROPERTY()
 		TArray<FWeldedBoneDriverData> BoneDriverMap;
 
+	// Ranges of BoneDriverMap per base bone, built in SetupWeldedBoneDriver
+	TArray<FWeldedBoneDriverGroup> BoneDriverGroups;
+
+	// World targets for each driver, filled before taking the physics lock
+	TArray<FTransform> BoneDriverTargets;
+
 	// Call to setup the welded body driver, initializes all mappings and caches shape contexts
 	// Requires that SetSkeletalMesh be called first
 	UFUNCTION(BlueprintCallable, Category = PhysicalAnimation)
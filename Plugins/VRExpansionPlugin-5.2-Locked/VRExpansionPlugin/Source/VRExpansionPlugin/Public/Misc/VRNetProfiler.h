@@ -0,0 +1,190 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/CoreNet.h"
+
+class UVRNetProfilerPackageMap;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogVRNetProfiler, Log, All);
+
+// Bit counting of our custom NetSerialize structs, compiled out of shipping builds
+// Enable at runtime with vrexp.NetProfiler 1, then print with vrexp.NetProfiler.Dump
+// Measured through a stand in package map, object references count as their GUID and never export anything on the live map
+// vrexp.NetProfiler.RecordTrace / SaveTrace record sent transforms for the offline replay test (VRExpansion.Net.ReplayTraces)
+#ifndef VR_NET_PROFILER_ENABLED
+#define VR_NET_PROFILER_ENABLED !UE_BUILD_SHIPPING
+#endif
+
+// Error between a sent value and the value after a serialization round trip
+struct VREXPANSIONPLUGIN_API FVRNetQuantizationError
+{
+	float Location = 0.0f;
+	float Rotation = 0.0f; // Degrees
+
+	FVRNetQuantizationError() {}
+
+	FVRNetQuantizationError(const FVector& SentLoc, const FVector& ReceivedLoc, const FQuat& SentRot, const FQuat& ReceivedRot)
+	{
+		Location = (float)FVector::Dist(SentLoc, ReceivedLoc);
+		Rotation = FMath::RadiansToDegrees((float)SentRot.AngularDistance(ReceivedRot));
+	}
+};
+
+struct FVRNetProfileCounter
+{
+	int64 TotalBits = 0;
+	int64 TotalCount = 0;
+
+	// Since the last dump, for bits per second
+	int64 WindowBits = 0;
+	int64 WindowCount = 0;
+
+	float MaxLocationError = 0.0f;
+	float MaxRotationError = 0.0f;
+	double SumLocationError = 0.0;
+	double SumRotationError = 0.0;
+	int64 ErrorSamples = 0;
+};
+
+// Attributes everything measured inside of it to an RPC and the class of the object sending it
+// RPC parameters are serialized during the call, so wrap the call site
+struct VREXPANSIONPLUGIN_API FVRNetProfileScope
+{
+	FVRNetProfileScope(FName InRPCName, const UObject* InOwner);
+	~FVRNetProfileScope();
+
+	FName RPCName;
+	FName ClassName;
+
+private:
+
+	FVRNetProfileScope* PreviousScope;
+
+	// Only scopes opened on the game thread are attributed, the profiler state isn't shared across threads
+	bool bPushed;
+};
+
+// A transform sent through one of the measured structs, Time is seconds since the recording started
+struct VREXPANSIONPLUGIN_API FVRNetTraceSample
+{
+	FName StructName;
+	double Time = 0.0;
+	FTransform Transform;
+};
+
+class VREXPANSIONPLUGIN_API FVRNetProfiler
+{
+public:
+
+	static FVRNetProfiler& Get();
+	static bool IsEnabled();
+
+	// Re-serializes Value into a scratch writer to count its bits
+	template<typename T>
+	void MeasureStruct(FName StructName, const T& Value, UPackageMap* Map)
+	{
+		if (bIsMeasuring)
+		{
+			return;
+		}
+
+		TGuardValue<bool> MeasureGuard(bIsMeasuring, true);
+
+		UPackageMap* ScratchMap = GetScratchMap(Map);
+		FNetBitWriter Writer(ScratchMap, 0);
+		bool bSuccess = true;
+		T SentCopy = Value;
+		SentCopy.NetSerialize(Writer, ScratchMap, bSuccess);
+
+		RecordBits(StructName, Writer.GetNumBits(), nullptr);
+	}
+
+	// Same as above but also reads the bits back and passes both values to ErrorFunc to measure quantization error
+	template<typename T, typename ErrorFuncType>
+	void MeasureStruct(FName StructName, const T& Value, UPackageMap* Map, ErrorFuncType&& ErrorFunc)
+	{
+		if (bIsMeasuring)
+		{
+			return;
+		}
+
+		TGuardValue<bool> MeasureGuard(bIsMeasuring, true);
+
+		UPackageMap* ScratchMap = GetScratchMap(Map);
+		FNetBitWriter Writer(ScratchMap, 0);
+		bool bSuccess = true;
+		T SentCopy = Value;
+		SentCopy.NetSerialize(Writer, ScratchMap, bSuccess);
+
+		FNetBitReader Reader(ScratchMap, Writer.GetData(), Writer.GetNumBits());
+		T ReceivedCopy;
+		ReceivedCopy.NetSerialize(Reader, ScratchMap, bSuccess);
+
+		const FVRNetQuantizationError Error = ErrorFunc(Value, ReceivedCopy);
+		RecordBits(StructName, Writer.GetNumBits(), &Error);
+	}
+
+	// For data that needs extra context to serialize, SerializeFunc writes it into the scratch archive using the scratch map
+	void MeasureBits(FName StructName, UPackageMap* Map, TFunctionRef<void(FArchive&, UPackageMap*)> SerializeFunc);
+
+	void RecordBits(FName StructName, int64 NumBits, const FVRNetQuantizationError* Error);
+
+	// Logs bits per second since the last dump and starts a new window
+	void Dump();
+	void Reset();
+
+	static bool IsRecordingTrace();
+	void StartTrace();
+
+	// Stops recording and writes the trace to GetTraceDirectory(), returns false if there was nothing to write
+	bool SaveTrace(const FString& TraceName);
+	void RecordTraceSample(FName StructName, const FTransform& Transform);
+
+	static FString GetTraceDirectory();
+	static bool LoadTrace(const FString& FilePath, TArray<FVRNetTraceSample>& OutSamples);
+
+private:
+
+	FVRNetProfiler();
+
+	// Stand in for the live package map during a measurement, see UVRNetProfilerPackageMap
+	UPackageMap* GetScratchMap(UPackageMap* LiveMap);
+
+	static void AddToCounter(FVRNetProfileCounter& Counter, int64 NumBits, const FVRNetQuantizationError* Error);
+	static void DumpCounters(const TCHAR* Category, TMap<FName, FVRNetProfileCounter>& Counters, double WindowSeconds);
+
+	TMap<FName, FVRNetProfileCounter> StructCounters;
+	TMap<FName, FVRNetProfileCounter> RPCCounters;
+	TMap<FName, FVRNetProfileCounter> ClassCounters;
+
+	double WindowStartTime;
+	bool bIsMeasuring;
+
+	TArray<FVRNetTraceSample> TraceSamples;
+	double TraceStartTime;
+	bool bIsRecordingTrace;
+
+	// Rooted for the lifetime of the process, created on the first measurement
+	UVRNetProfilerPackageMap* ScratchMap;
+
+	friend struct FVRNetProfileScope;
+	FVRNetProfileScope* CurrentScope;
+};
+
+#if VR_NET_PROFILER_ENABLED
+#define VR_NET_PROFILE_STRUCT(StructType, Ar, Map) \
+	if ((Ar).IsSaving() && FVRNetProfiler::IsEnabled()) { FVRNetProfiler::Get().MeasureStruct(TEXT(#StructType), *this, Map); }
+#define VR_NET_PROFILE_STRUCT_ERROR(StructType, Ar, Map, ...) \
+	if ((Ar).IsSaving() && FVRNetProfiler::IsEnabled()) { FVRNetProfiler::Get().MeasureStruct(TEXT(#StructType), *this, Map, __VA_ARGS__); }
+#define VR_NET_PROFILE_SCOPE(RPCName, Owner) \
+	FVRNetProfileScope ANONYMOUS_VARIABLE(VRNetProfileScope_)(RPCName, Owner)
+#define VR_NET_TRACE_SAMPLE(StructType, Ar, Transform) \
+	if ((Ar).IsSaving() && FVRNetProfiler::IsRecordingTrace()) { FVRNetProfiler::Get().RecordTraceSample(TEXT(#StructType), Transform); }
+#else
+#define VR_NET_PROFILE_STRUCT(StructType, Ar, Map)
+#define VR_NET_PROFILE_STRUCT_ERROR(StructType, Ar, Map, ...)
+#define VR_NET_PROFILE_SCOPE(RPCName, Owner)
+#define VR_NET_TRACE_SAMPLE(StructType, Ar, Transform)
+#endif
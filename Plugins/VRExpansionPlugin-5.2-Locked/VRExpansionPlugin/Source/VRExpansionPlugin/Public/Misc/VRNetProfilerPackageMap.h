@@ -0,0 +1,31 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/CoreNet.h"
+#include "VRNetProfilerPackageMap.generated.h"
+
+// Stand in package map for the net profilers scratch serialization
+// Object references are written as the GUID the live package map already has for them, without assigning or exporting
+// anything, so measuring a struct never changes the connections package map state. Reading back hands out the written
+// objects in order.
+UCLASS(Transient)
+class VREXPANSIONPLUGIN_API UVRNetProfilerPackageMap : public UPackageMap
+{
+	GENERATED_BODY()
+
+public:
+
+	// Clears the objects of the last pass, LiveMap can be null
+	void BeginPass(UPackageMap* InLiveMap);
+
+	virtual bool SerializeObject(FArchive& Ar, UClass* InClass, UObject*& Obj, FNetworkGUID* OutNetGUID = nullptr) override;
+	virtual FNetworkGUID GetNetGUIDFromObject(const UObject* InObject) const override;
+
+private:
+
+	TWeakObjectPtr<UPackageMap> LiveMap;
+	TArray<TWeakObjectPtr<UObject>> PassObjects;
+	int32 ReadIndex = 0;
+};
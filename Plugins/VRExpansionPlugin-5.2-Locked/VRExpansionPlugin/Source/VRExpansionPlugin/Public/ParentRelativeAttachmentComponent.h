@@ -122,6 +122,15 @@ public:
 	virtual void OnAttachmentChanged() override;
 	void UpdateTracking(float DeltaTime);
 
+	// Tracking frame change we last moved to, along with the other inputs to that transform
+	// Lets us skip setting (and propagating to children) the same transform when the HMD hasn't moved past the characters tolerances
+	uint32 LastTrackingFrameChange;
+	FVector LastTrackingFrameCustomOffset;
+	float LastTrackingFrameHalfHeight;
+
+	// Returns true if the character tracking frame has moved or something else changed our target transform since our last update
+	bool NeedsTrackingFrameUpdate() const;
+
 	bool IsLocallyControlled() const
 	{
 		// I like epics implementation better than my own
@@ -10,6 +10,7 @@
 #include "PhysicsEngine/ConstraintTypes.h"
 #include "PhysicsEngine/ConstraintDrives.h"
 #include "Physics/PhysicsInterfaceCore.h"
+#include "Misc/VRNetProfiler.h"
 #include "VRBPDatatypes.generated.h"
 
 class UGripMotionControllerComponent;
@@ -795,6 +796,12 @@ public:
 	// Doing a custom NetSerialize here because this is sent via RPCs and should change on every update
 	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
 	{
+		VR_NET_PROFILE_STRUCT_ERROR(FBPVRComponentPosRep, Ar, Map, [](const FBPVRComponentPosRep& Sent, const FBPVRComponentPosRep& Received)
+		{
+			return FVRNetQuantizationError(Sent.Position, Received.Position, Sent.Rotation.Quaternion(), Received.Rotation.Quaternion());
+		});
+		VR_NET_TRACE_SAMPLE(FBPVRComponentPosRep, Ar, FTransform(Rotation, Position));
+
 		bOutSuccess = true;
 
 		// Defines the level of Quantization
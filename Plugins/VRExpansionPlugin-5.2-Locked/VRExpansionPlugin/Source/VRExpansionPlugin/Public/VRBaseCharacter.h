@@ -265,6 +265,29 @@ struct TStructOpsTypeTraits< FVRReplicatedCapsuleHeight > : public TStructOpsTyp
 	};
 };
 
+// Tracking values computed once a frame by the VR root component and shared with the components that follow the HMD
+struct VREXPANSIONPLUGIN_API FVRTrackingFrame
+{
+	// GFrameCounter when this was last written, consumers fall back to their own logic if it is stale
+	uint64 FrameNumber = 0;
+
+	// Bumped every time the pose moves past the characters tracking tolerances
+	uint32 ChangeCounter = 0;
+
+	// Relative HMD pose, its leveled yaw and the yaw rotated (negated) capsule offset
+	FVector CameraLocation = FVector::ZeroVector;
+	FRotator CameraRotation = FRotator::ZeroRotator;
+	FRotator PureYaw = FRotator::ZeroRotator;
+	FVector CapsuleOffset = FVector::ZeroVector;
+
+	// Values at the last change, drift below the tolerances accumulates against these instead of being lost
+	FVector ChangedCameraLocation = FVector::ZeroVector;
+	FRotator ChangedCameraRotation = FRotator::ZeroRotator;
+	FVector ChangedVRCapsuleOffset = FVector::ZeroVector;
+
+	bool bChangedThisFrame = false;
+};
+
 UCLASS()
 class VREXPANSIONPLUGIN_API AVRBaseCharacter : public ACharacter
 {
@@ -298,6 +321,26 @@ public:
 	bool bTrackingPaused;
 	FVector PausedTrackingLoc;
 	float PausedTrackingRot;
+
+	// This frames tracking values, written by the VR root component and read by the parent relative attachment
+	FVRTrackingFrame TrackingFrame;
+
+	// HMD movement smaller than this (from the last movement that passed it) is not routed into the root offset and attachments
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VRBaseCharacter|Tracking", meta = (ClampMin = "0.0", UIMin = "0.0"))
+		float TrackingFrameLocationTolerance;
+
+	// HMD rotation smaller than this in degrees (from the last rotation that passed it) is not routed into the root offset and attachments
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VRBaseCharacter|Tracking", meta = (ClampMin = "0.0", UIMin = "0.0"))
+		float TrackingFrameRotationTolerance;
+
+	// Stores this frames tracking values, returns true if they moved past the tolerances since the last change
+	bool UpdateTrackingFrame(const FVector& CameraLocation, const FRotator& CameraRotation, const FRotator& PureYaw, const FVector& VRCapsuleOffset);
+
+	// True if the tracking frame was written during the current frame
+	FORCEINLINE bool HasCurrentTrackingFrame() const
+	{
+		return TrackingFrame.FrameNumber == GFrameCounter;
+	}
 	
 
 	// Injecting our custom teleport notification
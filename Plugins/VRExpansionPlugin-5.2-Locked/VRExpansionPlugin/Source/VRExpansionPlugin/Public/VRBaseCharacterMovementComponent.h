@@ -11,6 +11,7 @@ class AVRBaseCharacter;
 class AVRCharacter;
 struct FAIRequestID;
 struct FPathFollowingResult;
+struct FBPVRMovementSignificanceTier;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogVRBaseCharacterMovement, Log, All);
 
@@ -61,6 +62,38 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VRBaseCharacterMovementComponent|Smoothing")
 		bool bDisableSimulatedTickWhenSmoothingMovement;
 
+	// When false this character ignores the VR movement significance settings and always updates at full rate as a remote proxy
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VRBaseCharacterMovementComponent|Smoothing")
+		bool bAllowMovementSignificance;
+
+	// Current movement significance tier index into the global settings tiers, INDEX_NONE is full rate
+	// A value equal to the number of tiers is the off screen tier
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "VRBaseCharacterMovementComponent|Smoothing")
+		int32 MovementSignificanceTier;
+
+	// Re-evaluates the movement significance tier right away instead of waiting for the next timed update
+	UFUNCTION(BlueprintCallable, Category = "VRBaseCharacterMovementComponent|Smoothing")
+		void ForceUpdateMovementSignificance();
+
+	// Returns the settings for the current tier, or nullptr when running at full rate
+	const FBPVRMovementSignificanceTier* GetMovementSignificanceTierSettings() const;
+
+	// Picks the tier for this character, only remote proxies on clients are ever reduced
+	void UpdateMovementSignificance(float DeltaTime);
+
+	// Accumulates frame time and returns true when an update with the given interval is due, OutDeltaTime is the time since the last one
+	static bool ConsumeSignificanceInterval(float Interval, float DeltaTime, float& InOutAccumulator, float& OutDeltaTime);
+
+	// Snaps the NetSmoother to the capsule and ends the current smoothing, used by tiers that skip network smoothing
+	void SkipVRNetworkSmoothing();
+
+	// Runs SmoothClientPosition or SkipVRNetworkSmoothing depending on the current tier
+	void RunVRNetworkSmoothing(float DeltaSeconds);
+
+	float MovementSignificanceUpdateTimer;
+	float SimulatedTickAccumulator;
+	float TrackingUpdateAccumulator;
+
 	// When true the hmd movement injection speed is capped to the maximum movement speed
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VRMovement")
 		bool bCapHMDMovementToMaxMovementSpeed;
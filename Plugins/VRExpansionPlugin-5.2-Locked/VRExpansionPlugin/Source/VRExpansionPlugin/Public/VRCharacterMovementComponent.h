@@ -39,6 +39,31 @@ DECLARE_LOG_CATEGORY_EXTERN(LogVRCharacterMovement, Log, All);
 
 //DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FAIMoveCompletedSignature, FAIRequestID, RequestID, EPathFollowingResult::Type, Result);
 
+// Last floor result and what it was computed against, reused while a roomscale player stands still
+struct FVRFloorCacheEntry
+{
+	FFindFloorResult FloorResult;
+	FVector CapsuleLocation;
+	TWeakObjectPtr<const UPrimitiveComponent> MovementBase;
+	FName MovementBaseBoneName;
+	FTransform MovementBaseTransform;
+	float CapsuleRadius;
+	float CapsuleHalfHeight;
+	float FloorTraceDist;
+	double Time;
+	bool bIsValid;
+
+	FVRFloorCacheEntry() :
+		CapsuleLocation(FVector::ZeroVector),
+		MovementBaseTransform(FTransform::Identity),
+		CapsuleRadius(0.f),
+		CapsuleHalfHeight(0.f),
+		FloorTraceDist(0.f),
+		Time(0.0),
+		bIsValid(false)
+	{}
+};
+
 UCLASS()
 class VREXPANSIONPLUGIN_API UVRCharacterMovementComponent : public UVRBaseCharacterMovementComponent
 {
@@ -65,6 +90,64 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "VRCharacterMovementComponent")
 	bool bRunClientCorrectionToHMD;
 
+	// If true the server keeps a history of processed client moves, it will not re-send a correction the client hasn't had time to receive yet
+	// and will send small corrections as a delta from the location the client reported instead of a full location
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "VRCharacterMovementComponent|Networking")
+	bool bUseServerMoveHistory;
+
+	// Number of processed client moves to keep in the server move history
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "VRCharacterMovementComponent|Networking", meta = (ClampMin = "2", UIMin = "2", EditCondition = "bUseServerMoveHistory"))
+	int32 ServerMoveHistorySize;
+
+	// Time on top of the clients round trip time that a sent correction is considered to still be in flight
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "VRCharacterMovementComponent|Networking", meta = (ClampMin = "0.0", UIMin = "0.0", EditCondition = "bUseServerMoveHistory"))
+	float ServerMoveHistoryCorrectionGraceTime;
+
+	// How far the clients error can drift from the error of an in flight correction and still be considered the same error
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "VRCharacterMovementComponent|Networking", meta = (ClampMin = "0.0", UIMin = "0.0", EditCondition = "bUseServerMoveHistory"))
+	float ServerMoveHistoryErrorTolerance;
+
+	// Largest per axis correction that will be sent as a delta, anything larger sends the full location
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "VRCharacterMovementComponent|Networking", meta = (ClampMin = "0.0", UIMin = "0.0", ClampMax = "5000.0", UIMax = "5000.0", EditCondition = "bUseServerMoveHistory"))
+	float MaxCompactCorrectionDelta;
+
+	// If true FindFloor reuses its last result while the capsule, movement base and base transform haven't changed
+	// Saves the floor sweeps of roomscale players standing still while only their HMD jitters
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "VRCharacterMovementComponent|FloorCache")
+	bool bUseFloorCache;
+
+	// How far the capsule can drift from where the floor was found and still reuse it
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "VRCharacterMovementComponent|FloorCache", meta = (ClampMin = "0.0", UIMin = "0.0", ClampMax = "5.0", UIMax = "5.0", EditCondition = "bUseFloorCache"))
+	float FloorCacheLocationTolerance;
+
+	// Longest time in seconds a cached floor is reused for, catches geometry changing under a player that isn't moving
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "VRCharacterMovementComponent|FloorCache", meta = (ClampMin = "0.0", UIMin = "0.0", EditCondition = "bUseFloorCache"))
+	float FloorCacheMaxAge;
+
+	// Floor cache counters since the last reset
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "VRCharacterMovementComponent|FloorCache")
+	int32 FloorCacheHits;
+
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "VRCharacterMovementComponent|FloorCache")
+	int32 FloorCacheMisses;
+
+	// Fraction of floor checks that were served from the cache
+	UFUNCTION(BlueprintPure, Category = "VRCharacterMovementComponent|FloorCache")
+	float GetFloorCacheHitRate() const;
+
+	UFUNCTION(BlueprintCallable, Category = "VRCharacterMovementComponent|FloorCache")
+	void ResetFloorCacheCounters();
+
+	// Forces the next floor check to sweep, call after changing collision under a player that is standing still
+	UFUNCTION(BlueprintCallable, Category = "VRCharacterMovementComponent|FloorCache")
+	void InvalidateFloorCache();
+
+	FVRFloorCacheEntry FloorCache;
+
+	// Returns true and fills OutFloorResult if the cached floor is still valid for this capsule location
+	bool GetCachedFloor(const FVector& CapsuleLocation, float FloorTraceDist, FFindFloorResult& OutFloorResult) const;
+	void StoreCachedFloor(const FVector& CapsuleLocation, float FloorTraceDist, const FFindFloorResult& FloorResult);
+
 	// Higher values will cause more slide but better step up
 	//UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VRCharacterMovementComponent", meta = (ClampMin = "0.01", UIMin = "0", ClampMax = "1.0", UIMax = "1"))
 	//float WallRepulsionMultiplier;
@@ -141,6 +224,18 @@ public:
 	*/
 	virtual bool ServerCheckClientErrorVR(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientWorldLocation, float ClientYaw, const FVector& RelativeClientLocation, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode);
 
+	// Returns true if the clients error at ClientTimeStamp is the same error as a correction that is still in flight to them
+	virtual bool ServerIsErrorPendingCorrectionVR(float ClientTimeStamp, const FVector& ClientWorldLocation, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName) const;
+
+	// Records the server state after handling the client move at ClientTimeStamp
+	void ServerRecordMoveStateVR(float ClientTimeStamp, const FVector& ClientWorldLocation, bool bSentCorrection);
+
+	// Server location minus ClientWorldLocation, in the space of MovementBase if it uses relative location so moving bases don't read as error
+	FVector ServerGetBaseRelativeErrorVR(const FVector& ClientWorldLocation, const UPrimitiveComponent* MovementBase, FName BaseBoneName) const;
+
+	// Resolves a compact correction against the location that was sent for the saved move at TimeStamp, returns false if the move is gone
+	bool ClientResolveCompactCorrectionVR(float TimeStamp, const FVector& CorrectionDelta, FVector& OutNewLocation) const;
+
 	/** Replicate position correction to client, associated with a timestamped servermove.  Client will replay subsequent moves after applying adjustment.  */
 	virtual void ClientAdjustPositionVR_Implementation(float TimeStamp, FVector NewLoc, uint16 NewYaw, FVector NewVel, UPrimitiveComponent* NewBase, FName NewBaseBoneName, bool bHasBase, bool bBaseRelativePosition, uint8 ServerMovementMode, TOptional<FRotator> OptionalRotation = TOptional<FRotator>());
 
@@ -325,8 +420,19 @@ public:
 	FNetworkPredictionData_Server_VRCharacter(const UCharacterMovementComponent& ClientMovement)
 		: FNetworkPredictionData_Server_Character(ClientMovement)
 	{
+		bPendingAdjustmentHasClientLocation = false;
+		PendingAdjustmentClientTimeStamp = 0.0f;
+		PendingAdjustmentClientLocation = FVector::ZeroVector;
 	}
 
+	// Recent server states for validating client moves against
+	FVRServerMoveHistory MoveHistory;
+
+	// Absolute location the client reported for the move in PendingAdjustment, used to send compact corrections
+	bool bPendingAdjustmentHasClientLocation;
+	float PendingAdjustmentClientTimeStamp;
+	FVector PendingAdjustmentClientLocation;
+
 	FSavedMovePtr AllocateNewMove()
 	{
 		return FSavedMovePtr(new FSavedMove_VRCharacter());
@@ -67,6 +67,45 @@ public:
 	}
 };
 
+// A level of update detail for remote (simulated proxy) VR characters
+// Tiers are picked by distance from the local view, the first tier that the character is within is used
+USTRUCT(BlueprintType, Category = "VRMovementSignificance")
+struct VREXPANSIONPLUGIN_API FBPVRMovementSignificanceTier
+{
+	GENERATED_BODY()
+public:
+
+	// Characters further than this from the local view fall through to the next tier, 0 means no limit
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VRMovementSignificance", meta = (ClampMin = "0.0", UIMin = "0.0"))
+		float MaxDistance;
+
+	// Minimum time between simulated movement updates (SimulatedTick), 0 runs every frame
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VRMovementSignificance", meta = (ClampMin = "0.0", UIMin = "0.0"))
+		float SimulatedMovementInterval;
+
+	// Minimum time between replicated camera and parent relative attachment updates run by the movement component, 0 runs every frame
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VRMovementSignificance", meta = (ClampMin = "0.0", UIMin = "0.0"))
+		float TrackingUpdateInterval;
+
+	// If true the network smoothing is skipped and the NetSmoother is snapped to the capsule on corrections
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VRMovementSignificance")
+		bool bSkipNetworkSmoothing;
+
+	FBPVRMovementSignificanceTier() :
+		MaxDistance(0.0f),
+		SimulatedMovementInterval(0.0f),
+		TrackingUpdateInterval(0.0f),
+		bSkipNetworkSmoothing(false)
+	{}
+
+	FBPVRMovementSignificanceTier(float MaxDistanceIn, float SimulatedMovementIntervalIn, float TrackingUpdateIntervalIn, bool bSkipNetworkSmoothingIn) :
+		MaxDistance(MaxDistanceIn),
+		SimulatedMovementInterval(SimulatedMovementIntervalIn),
+		TrackingUpdateInterval(TrackingUpdateIntervalIn),
+		bSkipNetworkSmoothing(bSkipNetworkSmoothingIn)
+	{}
+};
+
 UCLASS(config = Engine, defaultconfig)
 class VREXPANSIONPLUGIN_API UVRGlobalSettings : public UObject
 {
@@ -100,6 +139,43 @@ public:
 	UPROPERTY(config, BlueprintReadWrite, EditAnywhere, Category = "ChaosPhysics|CollisionIgnore")
 		float CollisionIgnoreSubsystemUpdateRate;
 
+	// If true, client auth throws of grippable actors owned by a VRBasePlayerController are packed into one RPC per connection each update
+	// instead of sending one RPC stream per thrown object
+	UPROPERTY(config, BlueprintReadWrite, EditAnywhere, Category = "Replication|ClientAuthThrowing")
+		bool bBatchClientAuthThrowing;
+
+	// Number of delta encoded samples to send for a thrown object before sending its full location again
+	// Lower values recover faster from dropped packets at the cost of bandwidth
+	UPROPERTY(config, BlueprintReadWrite, EditAnywhere, Category = "Replication|ClientAuthThrowing", meta = (ClampMin = "1", UIMin = "1", ClampMax = "60", UIMax = "60"))
+		int32 ThrownObjectKeyframeInterval;
+
+	// If true, buttons, levers, dials and sliders are updated from a single world subsystem tick while they are interacted with or returning
+	// instead of enabling their own component ticks. Blueprint tick events on those components will not fire while this is on.
+	UPROPERTY(config, BlueprintReadWrite, EditAnywhere, Category = "Interactibles")
+		bool bUseInteractibleUpdateSubsystem;
+
+	// If true, remote VR characters on clients lower their simulated movement, smoothing and tracking update rates
+	// based on their distance from the local view and whether they have been rendered recently
+	UPROPERTY(config, BlueprintReadWrite, EditAnywhere, Category = "Networking|MovementSignificance")
+		bool bUseVRMovementSignificance;
+
+	// Distance tiers for remote VR characters, sorted by MaxDistance with the unlimited (0) tier last
+	// Characters past the last limited tier use the last tier
+	UPROPERTY(config, BlueprintReadWrite, EditAnywhere, Category = "Networking|MovementSignificance", meta = (editcondition = "bUseVRMovementSignificance"))
+		TArray<FBPVRMovementSignificanceTier> VRMovementSignificanceTiers;
+
+	// Tier used for remote VR characters that have not been rendered recently, MaxDistance is ignored
+	UPROPERTY(config, BlueprintReadWrite, EditAnywhere, Category = "Networking|MovementSignificance", meta = (editcondition = "bUseVRMovementSignificance"))
+		FBPVRMovementSignificanceTier OffScreenVRMovementSignificanceTier;
+
+	// How long a character can go without being rendered before it counts as off screen
+	UPROPERTY(config, BlueprintReadWrite, EditAnywhere, Category = "Networking|MovementSignificance", meta = (editcondition = "bUseVRMovementSignificance", ClampMin = "0.0", UIMin = "0.0"))
+		float VRMovementSignificanceOffScreenTime;
+
+	// How often each remote character re-evaluates its tier
+	UPROPERTY(config, BlueprintReadWrite, EditAnywhere, Category = "Networking|MovementSignificance", meta = (editcondition = "bUseVRMovementSignificance", ClampMin = "0.0", UIMin = "0.0"))
+		float VRMovementSignificanceUpdateInterval;
+
 	// Whether we should use the physx to chaos translation scalers or not
 	// This should be off on native chaos projects that have been set with the correct stiffness and damping settings already
 	UPROPERTY(config, BlueprintReadWrite, EditAnywhere, Category = "ChaosPhysics")
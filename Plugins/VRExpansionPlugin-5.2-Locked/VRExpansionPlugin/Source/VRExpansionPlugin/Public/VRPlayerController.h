@@ -4,6 +4,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/PlayerController.h"
 #include "Engine/LocalPlayer.h"
+#include "Grippables/GrippablePhysicsReplication.h"
 #include "VRPlayerController.generated.h"
 
 // A base player controller specifically for handling OnCameraManagerCreated.
@@ -29,6 +30,24 @@ public:
 		}
 	}
 
+	// ------------------------------------------------
+	// Batched client auth throwing
+	// ------------------------------------------------
+
+	// Returns the VR player controller at the top of the thrown actors owner chain, if there is one
+	static AVRBasePlayerController* GetThrowingController(AActor* ThrownActor);
+
+	// All of this connections thrown objects for an update, queued through the BucketUpdateSubsystem
+	UFUNCTION(UnReliable, Server, WithValidation, Category = "Networking")
+		void Server_SendThrownObjectMovement(const FVRThrownObjectBatch& ThrownObjectBatch);
+
+	// Server side delta baselines for this connections thrown objects
+	TMap<TWeakObjectPtr<AActor>, FVRThrownObjectBaseline> ThrownObjectBaselines;
+
+	// Server side, drops the delta baseline of an object whose client auth throwing ended
+	static void EndThrownObject(AActor* ThrownActor);
+
+	// End batched client auth throwing //
 };
 
 
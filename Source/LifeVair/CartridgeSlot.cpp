@@ -2,13 +2,19 @@
 
 
 #include "CartridgeSlot.h"
+#include "GameplayTagAssetInterface.h"
+#include "GripMotionControllerComponent.h"
+#include "TimerManager.h"
+#include "VRGripInterface.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
 
 // Sets default values for this component's properties
 UCartridgeSlot::UCartridgeSlot()
 {
-	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
-	// off to improve performance if you don't need them.
-	PrimaryComponentTick.bCanEverTick = true;
+	// Overlap events drive the slot, it never needs to tick
+	PrimaryComponentTick.bCanEverTick = false;
+	SetGenerateOverlapEvents(true);
 
 	// ...
 	isFull = true;
@@ -22,12 +28,92 @@ void UCartridgeSlot::BeginPlay()
 	Super::BeginPlay();
 
 	// ...
-//	OnComponentBeginOverlap.AddDynamic(this, &UCartridgeSlot::OnOverlapBegin);
+	OnComponentBeginOverlap.AddDynamic(this, &UCartridgeSlot::OnOverlapBegin);
+	OnComponentEndOverlap.AddDynamic(this, &UCartridgeSlot::OnOverlapEnd);
+
+	if (isFull && !Cartridge.IsValid())
+	{
+		AdoptCartridge();
+	}
+}
+
+void UCartridgeSlot::AdoptCartridge()
+{
+	for (USceneComponent* Child : GetAttachChildren())
+	{
+		AActor* ChildOwner = Child ? Child->GetOwner() : nullptr;
+		if (ChildOwner && Child == ChildOwner->GetRootComponent() && IsCartridge(ChildOwner))
+		{
+			Cartridge = ChildOwner;
+			return;
+		}
+	}
+
+	TArray<AActor*> OverlappingActors;
+	GetOverlappingActors(OverlappingActors);
+	for (AActor* OverlappingActor : OverlappingActors)
+	{
+		if (IsCartridge(OverlappingActor))
+		{
+			Cartridge = OverlappingActor;
+			return;
+		}
+	}
+}
+
+bool UCartridgeSlot::IsAttachedCartridge(const AActor* Actor) const
+{
+	return Actor && Actor->GetRootComponent() && Actor->GetRootComponent()->GetAttachParent() == this;
+}
+
+bool UCartridgeSlot::HasSnapAuthority() const
+{
+	const AActor* Owner = GetOwner();
+	return Owner && Owner->HasAuthority();
+}
+
+void UCartridgeSlot::OnChildAttached(USceneComponent* ChildComponent)
+{
+	Super::OnChildAttached(ChildComponent);
+
+	// Runs wherever the attachment happens or replicates to, socketing and Blueprint attachments alike
+	AActor* ChildOwner = ChildComponent ? ChildComponent->GetOwner() : nullptr;
+	if (ChildOwner && ChildComponent == ChildOwner->GetRootComponent() && IsCartridge(ChildOwner))
+	{
+		FillWith(ChildOwner);
+	}
+}
+
+void UCartridgeSlot::OnChildDetached(USceneComponent* ChildComponent)
+{
+	Super::OnChildDetached(ChildComponent);
+
+	AActor* ChildOwner = ChildComponent ? ChildComponent->GetOwner() : nullptr;
+	if (isFull && ChildOwner && ChildOwner == Cartridge.Get() && ChildComponent == ChildOwner->GetRootComponent())
+	{
+		SetSlotIsFull(false);
+	}
 }
 
 void UCartridgeSlot::SetSlotEnabled(bool EnableValue)
 {
+	const bool bWasEnabled = isEnabled;
 	isEnabled = EnableValue;
+
+	// A cartridge already waiting in the box won't send a new overlap
+	if (!bWasEnabled && isEnabled && HasBegunPlay() && HasSnapAuthority())
+	{
+		TArray<AActor*> OverlappingActors;
+		GetOverlappingActors(OverlappingActors);
+		for (AActor* OverlappingActor : OverlappingActors)
+		{
+			if (CanAcceptCartridge(OverlappingActor))
+			{
+				SnapCartridge(OverlappingActor);
+				break;
+			}
+		}
+	}
 }
 
 bool UCartridgeSlot::GetSlotEnabled() const
@@ -39,10 +125,15 @@ void UCartridgeSlot::SetSlotIsFull(bool isFullValue)
 {
 	if (isFullValue)
 	{
+		if (!Cartridge.IsValid())
+		{
+			AdoptCartridge();
+		}
 		CartridgeFilled();
 	}
 	else
 	{
+		Cartridge.Reset();
 		CartridgeEmptied();
 	}
 	isFull = isFullValue;
@@ -53,6 +144,151 @@ bool UCartridgeSlot::GetSlotIsFull() const
 	return isFull;
 }
 
+bool UCartridgeSlot::CanAcceptCartridge(const AActor* Actor) const
+{
+	return isEnabled && !isFull && IsCartridge(Actor);
+}
+
+bool UCartridgeSlot::IsCartridge(const AActor* Actor) const
+{
+	if (!Actor || Actor == GetOwner())
+	{
+		return false;
+	}
+
+	if (CartridgeInterface && Actor->GetClass()->ImplementsInterface(CartridgeInterface))
+	{
+		return true;
+	}
+
+	if (CartridgeTag.IsValid())
+	{
+		const IGameplayTagAssetInterface* TagInterface = Cast<IGameplayTagAssetInterface>(Actor);
+		return TagInterface && TagInterface->HasMatchingGameplayTag(CartridgeTag);
+	}
+
+	return !CartridgeInterface && Actor->GetClass()->ImplementsInterface(UVRGripInterface::StaticClass());
+}
+
+bool UCartridgeSlot::RequestCartridgeSocketing(AActor* CartridgeActor, USceneComponent*& ParentToSocketTo, FName& OptionalSocketName, FTransform_NetQuantize& RelativeTransform)
+{
+	if (!CartridgeActor)
+	{
+		return false;
+	}
+
+	TArray<UPrimitiveComponent*> OverlappingComponents;
+	CartridgeActor->GetOverlappingComponents(OverlappingComponents);
+	for (UPrimitiveComponent* OverlappingComponent : OverlappingComponents)
+	{
+		UCartridgeSlot* Slot = Cast<UCartridgeSlot>(OverlappingComponent);
+		if (Slot && Slot->CanAcceptCartridge(CartridgeActor))
+		{
+			ParentToSocketTo = Slot;
+			OptionalSocketName = Slot->SnapSocketName;
+			RelativeTransform = Slot->SnapTransform;
+
+			// VRExpansion sockets the cartridge right after a request is granted, the attachment fills the slot
+			return true;
+		}
+	}
+	return false;
+}
+
+void UCartridgeSlot::OnOverlapBegin(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComponent, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	// Clients follow the replicated attachment
+	if (!HasSnapAuthority() || !CanAcceptCartridge(OtherActor))
+	{
+		return;
+	}
+
+	TArray<FBPGripPair> HoldingControllers;
+	bool bIsHeld = false;
+	if (OtherActor->GetClass()->ImplementsInterface(UVRGripInterface::StaticClass()))
+	{
+		IVRGripInterface::Execute_IsHeld(OtherActor, HoldingControllers, bIsHeld);
+	}
+	if (bIsHeld && !bSnapWhileHeld)
+	{
+		// Released later, the cartridge RequestsSocketing calls RequestCartridgeSocketing
+		return;
+	}
+
+	TWeakObjectPtr<UCartridgeSlot> WeakThis(this);
+	TWeakObjectPtr<AActor> WeakCartridge(OtherActor);
+	GetWorld()->GetTimerManager().SetTimerForNextTick([WeakThis, WeakCartridge]()
+	{
+		if (WeakThis.IsValid() && WeakCartridge.IsValid())
+		{
+			WeakThis->SnapCartridge(WeakCartridge.Get());
+		}
+	});
+}
+
+void UCartridgeSlot::OnOverlapEnd(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComponent, int32 OtherBodyIndex)
+{
+	// Taken out of the slot, once the whole cartridge left the box. Attached cartridges are emptied when they detach
+	if (!isFull || !OtherActor || IsOverlappingActor(OtherActor) || IsAttachedCartridge(OtherActor))
+	{
+		return;
+	}
+
+	// A slot that started full, or was filled from Blueprint, may not know its cartridge
+	const AActor* CurrentCartridge = Cartridge.Get();
+	if (OtherActor == CurrentCartridge || (!CurrentCartridge && IsCartridge(OtherActor)))
+	{
+		SetSlotIsFull(false);
+	}
+}
+
+void UCartridgeSlot::SnapCartridge(AActor* CartridgeActor)
+{
+	if (!HasSnapAuthority() || !CanAcceptCartridge(CartridgeActor) || !IsOverlappingActor(CartridgeActor))
+	{
+		return;
+	}
+
+	TArray<FBPGripPair> HoldingControllers;
+	bool bIsHeld = false;
+	if (CartridgeActor->GetClass()->ImplementsInterface(UVRGripInterface::StaticClass()))
+	{
+		IVRGripInterface::Execute_IsHeld(CartridgeActor, HoldingControllers, bIsHeld);
+	}
+
+	if (bIsHeld && HoldingControllers.Num() > 0)
+	{
+		const FBPGripPair& Grip = HoldingControllers[0];
+		if (!Grip.HoldingController || !Grip.HoldingController->DropAndSocketObject(FTransform_NetQuantize(SnapTransform), CartridgeActor, Grip.GripID, this, SnapSocketName))
+		{
+			return;
+		}
+	}
+	else if (USceneComponent* Root = CartridgeActor->GetRootComponent())
+	{
+		if (UPrimitiveComponent* PrimitiveRoot = Cast<UPrimitiveComponent>(Root))
+		{
+			PrimitiveRoot->SetSimulatePhysics(false);
+		}
+		Root->AttachToComponent(this, FAttachmentTransformRules::SnapToTargetNotIncludingScale, SnapSocketName);
+		Root->SetRelativeLocationAndRotation(SnapTransform.GetLocation(), SnapTransform.GetRotation());
+	}
+
+	FillWith(CartridgeActor);
+}
+
+void UCartridgeSlot::FillWith(AActor* CartridgeActor)
+{
+	// Already filled by the attachment of the snap
+	if (isFull && Cartridge.Get() == CartridgeActor)
+	{
+		return;
+	}
+
+	Cartridge = CartridgeActor;
+	SetSlotIsFull(true);
+}
+
 void UCartridgeSlot::CartridgeFilled() const
 {
 	OnCartridgeFilled.Broadcast();
@@ -61,4 +297,4 @@ void UCartridgeSlot::CartridgeFilled() const
 void UCartridgeSlot::CartridgeEmptied() const
 {
 	OnCartridgeEmptied.Broadcast();
-}
\ No newline at end of file
+}
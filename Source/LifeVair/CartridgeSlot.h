@@ -4,10 +4,17 @@
 
 #include "CoreMinimal.h"
 #include "Components/BoxComponent.h"
+#include "GameplayTagContainer.h"
+#include "VRBPDatatypes.h"
 #include "CartridgeSlot.generated.h"
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FMyCustomDelegate);
-/*This class is used to create a custom collision box used to detect and snap the cartridge to*/
+/*
+ * This class is used to create a custom collision box used to detect and snap the cartridge to.
+ * Fully event driven, it doesn't tick : a cartridge entering the box is filtered by interface or gameplay tag, then socketed through
+ * VRExpansion (DropAndSocketObject when it is held, RequestsSocketing when it is released, attached directly when it is loose).
+ * Snapping only runs with authority, the slot is filled and emptied by the cartridge attaching to it so clients follow the replicated attachment.
+ */
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class LIFEVAIR_API UCartridgeSlot : public UBoxComponent
 {
@@ -21,7 +28,27 @@ public:
 
 	UPROPERTY(EditDefaultsOnly ,BlueprintSetter="SetSlotEnabled", BlueprintGetter="GetSlotEnabled",Category = "Cartridge Slot Settings")
 	bool isEnabled;
-	
+
+	/*Cartridges implement this interface, ignored when None*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Cartridge Slot Settings")
+	TSubclassOf<UInterface> CartridgeInterface;
+
+	/*Cartridges own this gameplay tag, ignored when empty. With neither filter set any grippable actor is a cartridge*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Cartridge Slot Settings")
+	FGameplayTag CartridgeTag;
+
+	/*Socket of this component the cartridge is snapped to*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Cartridge Slot Settings")
+	FName SnapSocketName;
+
+	/*Cartridge transform relative to the socket once snapped*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Cartridge Slot Settings")
+	FTransform SnapTransform;
+
+	/*Snaps a held cartridge as soon as it enters the slot, otherwise it is snapped when the player releases it*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Cartridge Slot Settings")
+	bool bSnapWhileHeld = true;
+
 	UPROPERTY(BlueprintAssignable, Category = "Cartridge Slot Manipulation")
 	FMyCustomDelegate OnCartridgeEmptied;
 	
@@ -42,6 +69,22 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Cartridge Slot Settings")
 	bool GetSlotIsFull() const;
 
+	/*Cartridge snapped in this slot, null when empty or when a full slot has no cartridge attached or overlapping*/
+	UFUNCTION(BlueprintPure, Category = "Cartridge Slot Manipulation")
+	AActor* GetCartridge() const { return Cartridge.Get(); }
+
+	/*Enabled, empty and Actor passes the cartridge filters*/
+	UFUNCTION(BlueprintPure, Category = "Cartridge Slot Manipulation")
+	bool CanAcceptCartridge(const AActor* Actor) const;
+
+	/*Actor passes the cartridge filters, whatever the slot state*/
+	UFUNCTION(BlueprintPure, Category = "Cartridge Slot Manipulation")
+	bool IsCartridge(const AActor* Actor) const;
+
+	/*Implementation of a cartridge RequestsSocketing : finds an empty slot overlapping the cartridge and fills it*/
+	UFUNCTION(BlueprintCallable, Category = "Cartridge Slot Manipulation")
+	static bool RequestCartridgeSocketing(AActor* CartridgeActor, USceneComponent*& ParentToSocketTo, FName& OptionalSocketName, FTransform_NetQuantize& RelativeTransform);
+
 	UFUNCTION(Category = "Cartridge Slot Settings")
 	void CartridgeFilled() const;
 
@@ -52,8 +95,10 @@ public:
 protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
-	
-/*
+
+	virtual void OnChildAttached(USceneComponent* ChildComponent) override;
+	virtual void OnChildDetached(USceneComponent* ChildComponent) override;
+
 	UFUNCTION()
 	void OnOverlapBegin(UPrimitiveComponent* OverlappedComponent,
 	                    AActor* OtherActor,
@@ -61,5 +106,22 @@ protected:
 	                    int32 OtherBodyIndex,
 	                    bool bFromSweep,
 	                    const FHitResult& SweepResult);
-*/
+
+	UFUNCTION()
+	void OnOverlapEnd(UPrimitiveComponent* OverlappedComponent,
+	                  AActor* OtherActor,
+	                  UPrimitiveComponent* OtherComponent,
+	                  int32 OtherBodyIndex);
+
+private:
+	// Snaps an overlapping cartridge, deferred out of the overlap callback since it moves and attaches the cartridge
+	void SnapCartridge(AActor* CartridgeActor);
+	void FillWith(AActor* CartridgeActor);
+
+	// A full slot without a known cartridge takes the attached or overlapping one, so taking it out empties the slot
+	void AdoptCartridge();
+	bool IsAttachedCartridge(const AActor* Actor) const;
+	bool HasSnapAuthority() const;
+
+	TWeakObjectPtr<AActor> Cartridge;
 };
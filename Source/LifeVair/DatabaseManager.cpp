@@ -1,44 +1,117 @@
 // Copyright : OK
 #include "DatabaseManager.h"
+#include "LifeVairDatabaseWorker.h"
+#include "Engine/Engine.h"
+#include "LatentActions.h"
 
-TArray<FString>& UDatabaseManager::getData(const FString Path)
+/*Waits for an async query and writes its rows into the Blueprint outputs, cancels the query if the node is aborted*/
+class FLifeVairQueryLatentAction : public FPendingLatentAction
 {
-	
-	FSQLiteDatabase* SQLiteDB = new FSQLiteDatabase();
-	SQLiteDB->Open(*Path, ESQLiteDatabaseOpenMode::ReadOnly);
-	static TArray<FString> ResultColumns;
-	UE_LOG(LogTemp, Warning, TEXT("Error while trying to access the DB"))
-
-	
-	if(SQLiteDB->IsValid())
-	{
-		GEngine->AddOnScreenDebugMessage(-1, 50.0f, FColor::Green, TEXT("COnnected to DB"));
-		const FString Query = TEXT("select * from Domains");
-		FSQLitePreparedStatement LoadStatement;
-		LoadStatement.Reset();
-		GEngine->AddOnScreenDebugMessage(-1, 50.0f, FColor::Blue, TEXT("Querying"));
-		
-		LoadStatement.Create(*SQLiteDB,*Query, ESQLitePreparedStatementFlags::Persistent);
-
-		//IsSuccessful = LoadStatement.IsValid();
-		
-		ResultColumns = LoadStatement.GetColumnNames();
-		
-		
-		for(FString Column : ResultColumns)
+public:
+	FLifeVairQueryLatentAction(ULifeVairDatabaseSubsystem* InDatabase, const FString& Sql, const TArray<FString>& Parameters, const FLatentActionInfo& LatentInfo,
+		FLifeVairQueryHandle& InOutHandle, TArray<FString>& InOutColumns, TArray<FLifeVairDatabaseRow>& InOutRows, bool& bInOutSuccess)
+		: Database(InDatabase)
+		, ExecutionFunction(LatentInfo.ExecutionFunction)
+		, OutputLink(LatentInfo.Linkage)
+		, CallbackTarget(LatentInfo.CallbackTarget)
+		, OutColumns(InOutColumns)
+		, OutRows(InOutRows)
+		, bOutSuccess(bInOutSuccess)
+	{
+		Future = InDatabase->QueryAsync(Sql, Parameters, &Handle);
+		InOutHandle = Handle;
+	}
+
+	virtual void UpdateOperation(FLatentResponse& Response) override
+	{
+		if (!Future.IsReady())
+		{
+			return;
+		}
+
+		FLifeVairQueryResult Result = Future.Consume();
+		OutColumns = MoveTemp(Result.Columns);
+		OutRows = MoveTemp(Result.Rows);
+		bOutSuccess = Result.bSuccess;
+
+		// A cancelled query doesn't continue the graph
+		if (Result.bCancelled)
+		{
+			Response.DoneIf(true);
+		}
+		else
+		{
+			Response.FinishAndTriggerIf(true, ExecutionFunction, OutputLink, CallbackTarget);
+		}
+	}
+
+	virtual void NotifyObjectDestroyed() override
+	{
+		Cancel();
+	}
+
+	virtual void NotifyActionAborted() override
+	{
+		Cancel();
+	}
+
+#if WITH_EDITOR
+	virtual FString GetDescription() const override
+	{
+		return FString::Printf(TEXT("Database query %lld"), Handle.Id);
+	}
+#endif
+
+private:
+	void Cancel()
+	{
+		if (ULifeVairDatabaseSubsystem* DatabasePtr = Database.Get())
 		{
-			//We build our table/JSON/whatever here using
+			DatabasePtr->CancelQuery(Handle);
 		}
+	}
+
+	TWeakObjectPtr<ULifeVairDatabaseSubsystem> Database;
+	FLifeVairQueryHandle Handle;
+	TFuture<FLifeVairQueryResult> Future;
+
+	FName ExecutionFunction;
+	int32 OutputLink;
+	FWeakObjectPtr CallbackTarget;
 
-		LoadStatement.ClearBindings();
-		LoadStatement.Destroy();
-		//TODO. Do some checks to avoid crash
-		SQLiteDB->Close();  
-		delete SQLiteDB;
-		
-		return ResultColumns;
+	TArray<FString>& OutColumns;
+	TArray<FLifeVairDatabaseRow>& OutRows;
+	bool& bOutSuccess;
+};
+
+TArray<FString> UDatabaseManager::getData(const UObject* WorldContextObject, const FString Path)
+{
+	ULifeVairDatabaseSubsystem* Database = ULifeVairDatabaseSubsystem::Get(WorldContextObject);
+
+	if (Database && (Path.IsEmpty() || Database->OpenDatabase(Path)))
+	{
+		return Database->GetColumnNames(TEXT("Domains"));
 	}
-	UE_LOG(LogTemp, Warning, TEXT("Error while trying to access the DB"))
 
-	return ResultColumns;
-}
\ No newline at end of file
+	UE_LOG(LogLifeVairDatabase, Warning, TEXT("Error while trying to access the DB"))
+	return TArray<FString>();
+}
+
+void UDatabaseManager::QueryRowsAsync(UObject* WorldContextObject, const FString& Sql, const TArray<FString>& Parameters, FLatentActionInfo LatentInfo,
+	FLifeVairQueryHandle& OutHandle, TArray<FString>& OutColumns, TArray<FLifeVairDatabaseRow>& OutRows, bool& bSuccess)
+{
+	UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+	ULifeVairDatabaseSubsystem* Database = ULifeVairDatabaseSubsystem::Get(WorldContextObject);
+	if (!World || !Database)
+	{
+		bSuccess = false;
+		return;
+	}
+
+	FLatentActionManager& LatentActionManager = World->GetLatentActionManager();
+	if (LatentActionManager.FindExistingAction<FLifeVairQueryLatentAction>(LatentInfo.CallbackTarget, LatentInfo.UUID) == nullptr)
+	{
+		LatentActionManager.AddNewAction(LatentInfo.CallbackTarget, LatentInfo.UUID,
+			new FLifeVairQueryLatentAction(Database, Sql, Parameters, LatentInfo, OutHandle, OutColumns, OutRows, bSuccess));
+	}
+}
@@ -2,8 +2,10 @@
 
 #pragma once
 
-#include "SQLiteDatabase.h"
 #include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "Engine/LatentActionManager.h"
+#include "LifeVairDatabaseSubsystem.h"
 #include "DatabaseManager.generated.h"
 
 UCLASS(Blueprintable, DisplayName="SQLite DB Manager")
@@ -12,6 +14,15 @@ class LIFEVAIR_API UDatabaseManager : public UBlueprintFunctionLibrary
 	GENERATED_BODY()
 	
 public:
-	UFUNCTION(BlueprintCallable, meta=(CompactNodeTitle=""), Category="SQLite DB Manager ")
-	static TArray<FString>& getData(const FString Path);
+	/*Column names of the Domains table. Goes through the game instance database subsystem, Path is only opened if it isn't the current database*/
+	UFUNCTION(BlueprintCallable, meta=(CompactNodeTitle="", WorldContext="WorldContextObject"), Category="SQLite DB Manager ")
+	static TArray<FString> getData(const UObject* WorldContextObject, const FString Path);
+
+	/*
+	 * Runs a query on the database worker thread and continues once every row is back. ?1..?N in the query are bound from Parameters.
+	 * The query is cancelled if the calling object is destroyed, or through CancelQuery with OutHandle.
+	 */
+	UFUNCTION(BlueprintCallable, meta=(Latent, LatentInfo="LatentInfo", WorldContext="WorldContextObject"), Category="SQLite DB Manager ")
+	static void QueryRowsAsync(UObject* WorldContextObject, const FString& Sql, const TArray<FString>& Parameters, FLatentActionInfo LatentInfo,
+		FLifeVairQueryHandle& OutHandle, TArray<FString>& OutColumns, TArray<FLifeVairDatabaseRow>& OutRows, bool& bSuccess);
 };
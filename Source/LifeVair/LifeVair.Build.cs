@@ -10,7 +10,7 @@ public class LifeVair : ModuleRules
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
 		PublicDependencyModuleNames.AddRange(new string[]
-			{ "Core", "CoreUObject", "Engine", "InputCore", "HTTP", "Json", "JsonUtilities","SQLiteCore","SQLiteSupport"});
+			{ "Core", "CoreUObject", "Engine", "InputCore", "HTTP", "Json", "JsonUtilities","SQLiteCore","SQLiteSupport","GameplayTags","VRExpansionPlugin"});
 
 		// Uncomment if you are using Slate UI
 		// PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
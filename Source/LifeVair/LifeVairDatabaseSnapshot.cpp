@@ -0,0 +1,577 @@
+// Copyright : OK
+
+#include "LifeVairDatabaseSnapshot.h"
+#include "LifeVairDatabaseSubsystem.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "SQLiteDatabase.h"
+
+namespace LifeVairSnapshot
+{
+	// The SQLite header stores these big endian
+	uint32 ReadBigEndian(const uint8* Bytes)
+	{
+		return (uint32(Bytes[0]) << 24) | (uint32(Bytes[1]) << 16) | (uint32(Bytes[2]) << 8) | uint32(Bytes[3]);
+	}
+
+	bool FSourceInfo::Read(const FString& DatabasePath, FSourceInfo& OutInfo)
+	{
+		TUniquePtr<IFileHandle> File(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*DatabasePath));
+		if (!File)
+		{
+			return false;
+		}
+
+		// Only the 100 byte header is read, the change counter moves on every write and the schema cookie on every schema change
+		uint8 Header[100];
+		if (File->Size() < int64(sizeof(Header)) || !File->Read(Header, sizeof(Header)) || FMemory::Memcmp(Header, "SQLite format 3", 16) != 0)
+		{
+			return false;
+		}
+
+		OutInfo.FileSize = File->Size();
+		OutInfo.ChangeCounter = ReadBigEndian(Header + 24);
+		OutInfo.SchemaCookie = ReadBigEndian(Header + 40);
+		OutInfo.ModifiedTicks = IFileManager::Get().GetTimeStamp(*DatabasePath).GetTicks();
+
+		// An empty log (after a truncating checkpoint) holds no commits
+		const FString WalPath = DatabasePath + TEXT("-wal");
+		const int64 WalSize = IFileManager::Get().FileSize(*WalPath);
+		OutInfo.WalSize = FMath::Max<int64>(WalSize, 0);
+		OutInfo.WalModifiedTicks = OutInfo.WalSize > 0 ? IFileManager::Get().GetTimeStamp(*WalPath).GetTicks() : 0;
+		return true;
+	}
+
+	struct FPendingColumn
+	{
+		FString Name;
+		bool bIsString = false;
+		TArray<double> Numbers;
+		TArray<FString> Strings;
+	};
+
+	struct FPendingTable
+	{
+		FString Name;
+		int32 NumRows = 0;
+		TArray<FPendingColumn> Columns;
+	};
+
+	bool HasTable(FSQLiteDatabase& Database, const FString& Table)
+	{
+		FSQLitePreparedStatement Statement;
+		if (!Statement.Create(Database, LifeVairDatabase::FindTableSql) || !LifeVairDatabase::BindParameters(Statement, { Table }))
+		{
+			return false;
+		}
+
+		bool bHasTable = false;
+		Statement.Execute([&bHasTable](const FSQLitePreparedStatement& Row)
+		{
+			bHasTable = true;
+			return ESQLitePreparedStatementExecuteRowResult::Stop;
+		});
+		return bHasTable;
+	}
+
+	bool ReadTable(FSQLiteDatabase& Database, const FString& Table, FPendingTable& OutTable)
+	{
+		if (!HasTable(Database, Table))
+		{
+			UE_LOG(LogLifeVairDatabase, Error, TEXT("Snapshot : there is no table %s"), *Table);
+			return false;
+		}
+
+		FSQLitePreparedStatement Statement;
+		if (!Statement.Create(Database, *FString::Printf(TEXT("select * from %s"), *LifeVairDatabase::QuoteIdentifier(Table))))
+		{
+			UE_LOG(LogLifeVairDatabase, Error, TEXT("Snapshot : can't read table %s : %s"), *Table, *Database.GetLastError());
+			return false;
+		}
+
+		OutTable.Name = Table;
+		for (const FString& ColumnName : Statement.GetColumnNames())
+		{
+			OutTable.Columns.AddDefaulted_GetRef().Name = ColumnName;
+		}
+
+		// Everything is kept as text until the whole table is read, a column is numeric only if none of its cells is text or blob
+		const int64 NumRows = Statement.Execute([&OutTable](const FSQLitePreparedStatement& Row)
+		{
+			for (int32 Column = 0; Column < OutTable.Columns.Num(); ++Column)
+			{
+				FPendingColumn& PendingColumn = OutTable.Columns[Column];
+
+				ESQLiteColumnType Type = ESQLiteColumnType::Null;
+				Row.GetColumnTypeByIndex(Column, Type);
+				PendingColumn.bIsString |= Type == ESQLiteColumnType::String || Type == ESQLiteColumnType::Blob;
+
+				double Number = 0.0;
+				Row.GetColumnValueByIndex(Column, Number);
+				PendingColumn.Numbers.Add(Number);
+
+				Row.GetColumnValueByIndex(Column, PendingColumn.Strings.AddDefaulted_GetRef());
+			}
+			return ESQLitePreparedStatementExecuteRowResult::Continue;
+		});
+
+		if (NumRows == INDEX_NONE)
+		{
+			UE_LOG(LogLifeVairDatabase, Error, TEXT("Snapshot : error while reading table %s : %s"), *Table, *Database.GetLastError());
+			return false;
+		}
+
+		OutTable.NumRows = int32(NumRows);
+		return true;
+	}
+
+	bool Export(const FString& DatabasePath, const TArray<FString>& Tables, const FString& SnapshotPath)
+	{
+		// Moves the commits still in the log into the database file, so the snapshot matches the file that gets staged
+		{
+			FSQLiteDatabase Database;
+			if (Database.Open(*DatabasePath, ESQLiteDatabaseOpenMode::ReadWrite))
+			{
+				if (!Database.Execute(TEXT("PRAGMA wal_checkpoint(TRUNCATE);")))
+				{
+					UE_LOG(LogLifeVairDatabase, Warning, TEXT("Snapshot : can't checkpoint %s : %s"), *DatabasePath, *Database.GetLastError());
+				}
+				Database.Close();
+			}
+		}
+
+		FSourceInfo Source;
+		if (!FSourceInfo::Read(DatabasePath, Source))
+		{
+			UE_LOG(LogLifeVairDatabase, Error, TEXT("Snapshot : %s is not a SQLite database"), *DatabasePath);
+			return false;
+		}
+
+		FSQLiteDatabase Database;
+		if (!Database.Open(*DatabasePath, ESQLiteDatabaseOpenMode::ReadOnly))
+		{
+			UE_LOG(LogLifeVairDatabase, Error, TEXT("Snapshot : can't open %s : %s"), *DatabasePath, *Database.GetLastError());
+			return false;
+		}
+
+		TArray<FPendingTable> PendingTables;
+		for (const FString& Table : Tables)
+		{
+			if (!ReadTable(Database, Table, PendingTables.AddDefaulted_GetRef()))
+			{
+				Database.Close();
+				return false;
+			}
+		}
+		Database.Close();
+
+		// Interned strings, table and column names included
+		TArray<FString> Strings;
+		TMap<FString, uint32> StringIds;
+		auto AddString = [&Strings, &StringIds](const FString& String) -> uint32
+		{
+			if (const uint32* Id = StringIds.Find(String))
+			{
+				return *Id;
+			}
+			const uint32 Id = Strings.Add(String);
+			StringIds.Add(String, Id);
+			return Id;
+		};
+
+		TArray<uint8> Blob;
+		auto PadTo8 = [&Blob]()
+		{
+			Blob.AddZeroed(::Align(Blob.Num(), 8) - Blob.Num());
+		};
+		auto Append = [&Blob](const void* Bytes, int32 NumBytes) -> uint32
+		{
+			const int32 Offset = Blob.Num();
+			Blob.Append(static_cast<const uint8*>(Bytes), NumBytes);
+			return uint32(Offset);
+		};
+
+		Blob.AddZeroed(sizeof(FHeader));
+		PadTo8();
+
+		// Table and column descriptors first, their data offsets are patched in once the data is written
+		const uint32 TablesOffset = uint32(Blob.Num());
+		Blob.AddZeroed(sizeof(FTable) * PendingTables.Num());
+		PadTo8();
+
+		TArray<uint32> ColumnsOffsets;
+		for (int32 TableIndex = 0; TableIndex < PendingTables.Num(); ++TableIndex)
+		{
+			const FPendingTable& PendingTable = PendingTables[TableIndex];
+
+			FTable TableEntry;
+			TableEntry.Name = AddString(PendingTable.Name);
+			TableEntry.NumRows = PendingTable.NumRows;
+			TableEntry.NumColumns = PendingTable.Columns.Num();
+			TableEntry.ColumnsOffset = uint32(Blob.Num());
+			FMemory::Memcpy(Blob.GetData() + TablesOffset + TableIndex * sizeof(FTable), &TableEntry, sizeof(FTable));
+
+			ColumnsOffsets.Add(TableEntry.ColumnsOffset);
+			Blob.AddZeroed(sizeof(FColumn) * PendingTable.Columns.Num());
+			PadTo8();
+		}
+
+		for (int32 TableIndex = 0; TableIndex < PendingTables.Num(); ++TableIndex)
+		{
+			const FPendingTable& PendingTable = PendingTables[TableIndex];
+			for (int32 Column = 0; Column < PendingTable.Columns.Num(); ++Column)
+			{
+				const FPendingColumn& PendingColumn = PendingTable.Columns[Column];
+
+				FColumn ColumnEntry;
+				ColumnEntry.Name = AddString(PendingColumn.Name);
+				ColumnEntry.Type = PendingColumn.bIsString ? EColumnType::String : EColumnType::Number;
+				ColumnEntry.Padding = 0;
+
+				if (PendingColumn.bIsString)
+				{
+					TArray<uint32> Ids;
+					Ids.Reserve(PendingColumn.Strings.Num());
+					for (const FString& String : PendingColumn.Strings)
+					{
+						Ids.Add(AddString(String));
+					}
+					ColumnEntry.DataOffset = Append(Ids.GetData(), Ids.Num() * int32(sizeof(uint32)));
+				}
+				else
+				{
+					ColumnEntry.DataOffset = Append(PendingColumn.Numbers.GetData(), PendingColumn.Numbers.Num() * int32(sizeof(double)));
+				}
+				PadTo8();
+
+				FMemory::Memcpy(Blob.GetData() + ColumnsOffsets[TableIndex] + Column * sizeof(FColumn), &ColumnEntry, sizeof(FColumn));
+			}
+		}
+
+		// String offsets are relative to the string data, the extra last one is its end
+		TArray<uint32> StringOffsets;
+		TArray<uint8> StringData;
+		StringOffsets.Reserve(Strings.Num() + 1);
+		for (const FString& String : Strings)
+		{
+			StringOffsets.Add(uint32(StringData.Num()));
+
+			const FTCHARToUTF8 Utf8(*String);
+			StringData.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+		}
+		StringOffsets.Add(uint32(StringData.Num()));
+
+		FHeader Header;
+		Header.Magic = Magic;
+		Header.Version = Version;
+		Header.Source = Source;
+		Header.NumTables = PendingTables.Num();
+		Header.TablesOffset = TablesOffset;
+		Header.NumStrings = Strings.Num();
+		Header.StringOffsetsOffset = Append(StringOffsets.GetData(), StringOffsets.Num() * int32(sizeof(uint32)));
+		PadTo8();
+		Header.StringDataOffset = Append(StringData.GetData(), StringData.Num());
+		Header.StringDataSize = StringData.Num();
+		FMemory::Memcpy(Blob.GetData(), &Header, sizeof(FHeader));
+
+		if (!FFileHelper::SaveArrayToFile(Blob, *SnapshotPath))
+		{
+			UE_LOG(LogLifeVairDatabase, Error, TEXT("Snapshot : can't write %s"), *SnapshotPath);
+			return false;
+		}
+
+		UE_LOG(LogLifeVairDatabase, Display, TEXT("Snapshot : wrote %d tables, %d strings, %d bytes to %s"), PendingTables.Num(), Strings.Num(), Blob.Num(), *SnapshotPath);
+		return true;
+	}
+}
+
+FLifeVairSnapshotTable::FLifeVairSnapshotTable(const FLifeVairDatabaseSnapshot* InSnapshot, const LifeVairSnapshot::FTable* InTable)
+	: Snapshot(InSnapshot)
+	, Table(InTable)
+{
+}
+
+const LifeVairSnapshot::FColumn* FLifeVairSnapshotTable::GetColumn(int32 Column) const
+{
+	if (!Table || Column < 0 || Column >= int32(Table->NumColumns))
+	{
+		return nullptr;
+	}
+	return Snapshot->GetData<LifeVairSnapshot::FColumn>(Table->ColumnsOffset) + Column;
+}
+
+FString FLifeVairSnapshotTable::GetColumnName(int32 Column) const
+{
+	const LifeVairSnapshot::FColumn* ColumnEntry = GetColumn(Column);
+	return ColumnEntry ? Snapshot->GetString(ColumnEntry->Name) : FString();
+}
+
+TArray<FString> FLifeVairSnapshotTable::GetColumnNames() const
+{
+	TArray<FString> Names;
+	Names.Reserve(GetNumColumns());
+	for (int32 Column = 0; Column < GetNumColumns(); ++Column)
+	{
+		Names.Add(GetColumnName(Column));
+	}
+	return Names;
+}
+
+int32 FLifeVairSnapshotTable::FindColumn(const FString& Name) const
+{
+	for (int32 Column = 0; Column < GetNumColumns(); ++Column)
+	{
+		if (GetColumnName(Column) == Name)
+		{
+			return Column;
+		}
+	}
+	return INDEX_NONE;
+}
+
+bool FLifeVairSnapshotTable::IsStringColumn(int32 Column) const
+{
+	const LifeVairSnapshot::FColumn* ColumnEntry = GetColumn(Column);
+	return ColumnEntry && ColumnEntry->Type == LifeVairSnapshot::EColumnType::String;
+}
+
+TArrayView<const double> FLifeVairSnapshotTable::GetNumbers(int32 Column) const
+{
+	const LifeVairSnapshot::FColumn* ColumnEntry = GetColumn(Column);
+	if (!ColumnEntry || ColumnEntry->Type != LifeVairSnapshot::EColumnType::Number)
+	{
+		return TArrayView<const double>();
+	}
+	return TArrayView<const double>(Snapshot->GetData<double>(ColumnEntry->DataOffset), Table->NumRows);
+}
+
+TArrayView<const uint32> FLifeVairSnapshotTable::GetStringIds(int32 Column) const
+{
+	const LifeVairSnapshot::FColumn* ColumnEntry = GetColumn(Column);
+	if (!ColumnEntry || ColumnEntry->Type != LifeVairSnapshot::EColumnType::String)
+	{
+		return TArrayView<const uint32>();
+	}
+	return TArrayView<const uint32>(Snapshot->GetData<uint32>(ColumnEntry->DataOffset), Table->NumRows);
+}
+
+FString FLifeVairSnapshotTable::GetValueAsString(int32 Column, int32 Row) const
+{
+	if (Row < 0 || Row >= GetNumRows())
+	{
+		return FString();
+	}
+
+	if (IsStringColumn(Column))
+	{
+		return Snapshot->GetString(GetStringIds(Column)[Row]);
+	}
+
+	const TArrayView<const double> Numbers = GetNumbers(Column);
+	if (Numbers.Num() == 0)
+	{
+		return FString();
+	}
+
+	// Integers were stored as doubles, give them back without a fraction like SQLite does
+	const double Value = Numbers[Row];
+	return Value == FMath::RoundToDouble(Value) && FMath::Abs(Value) < double(MAX_int64) ? LexToString(int64(Value)) : FString::SanitizeFloat(Value);
+}
+
+FName FLifeVairSnapshotTable::GetValueAsName(int32 Column, int32 Row) const
+{
+	if (IsStringColumn(Column) && Row >= 0 && Row < GetNumRows())
+	{
+		return Snapshot->GetName(GetStringIds(Column)[Row]);
+	}
+	return FName(*GetValueAsString(Column, Row));
+}
+
+FLifeVairDatabaseSnapshot::FLifeVairDatabaseSnapshot()
+{
+}
+
+FLifeVairDatabaseSnapshot::~FLifeVairDatabaseSnapshot()
+{
+	Close();
+}
+
+bool FLifeVairDatabaseSnapshot::Open(const FString& SnapshotPath, const FString& DatabasePath)
+{
+	Close();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.FileExists(*SnapshotPath))
+	{
+		return false;
+	}
+
+	MappedFile.Reset(PlatformFile.OpenMapped(*SnapshotPath));
+	if (MappedFile)
+	{
+		MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	}
+
+	if (MappedRegion)
+	{
+		Data = MappedRegion->GetMappedPtr();
+		DataSize = MappedRegion->GetMappedSize();
+	}
+	else
+	{
+		// Files inside a pak can't be mapped, read them whole instead
+		MappedFile.Reset();
+		if (!FFileHelper::LoadFileToArray(LoadedData, *SnapshotPath))
+		{
+			return false;
+		}
+		Data = LoadedData.GetData();
+		DataSize = LoadedData.Num();
+	}
+
+	if (!Validate(SnapshotPath, DatabasePath))
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void FLifeVairDatabaseSnapshot::Close()
+{
+	// The region has to go before its file
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	LoadedData.Empty();
+
+	Data = nullptr;
+	DataSize = 0;
+}
+
+bool FLifeVairDatabaseSnapshot::Validate(const FString& SnapshotPath, const FString& DatabasePath) const
+{
+	using namespace LifeVairSnapshot;
+
+	auto IsInRange = [this](uint64 Offset, uint64 Bytes)
+	{
+		return Offset + Bytes <= uint64(DataSize);
+	};
+
+	if (!IsInRange(0, sizeof(FHeader)) || GetHeader().Magic != Magic)
+	{
+		UE_LOG(LogLifeVairDatabase, Warning, TEXT("%s is not a database snapshot"), *SnapshotPath);
+		return false;
+	}
+
+	const FHeader& Header = GetHeader();
+	if (Header.Version != Version)
+	{
+		UE_LOG(LogLifeVairDatabase, Log, TEXT("Database snapshot %s is version %u, expected %u, falling back to SQLite"), *SnapshotPath, Header.Version, Version);
+		return false;
+	}
+
+	FSourceInfo Source;
+	if (FSourceInfo::Read(DatabasePath, Source) && !(Source == Header.Source))
+	{
+		UE_LOG(LogLifeVairDatabase, Log, TEXT("Database snapshot %s is older than %s, falling back to SQLite"), *SnapshotPath, *DatabasePath);
+		return false;
+	}
+
+	// Every offset is checked once here so that reads don't have to
+	if (!IsInRange(Header.StringOffsetsOffset, (uint64(Header.NumStrings) + 1) * sizeof(uint32)) || !IsInRange(Header.StringDataOffset, Header.StringDataSize)
+		|| GetData<uint32>(Header.StringOffsetsOffset)[Header.NumStrings] > Header.StringDataSize
+		|| !IsInRange(Header.TablesOffset, uint64(Header.NumTables) * sizeof(FTable)))
+	{
+		UE_LOG(LogLifeVairDatabase, Warning, TEXT("Database snapshot %s is truncated"), *SnapshotPath);
+		return false;
+	}
+
+	const FTable* Tables = GetData<FTable>(Header.TablesOffset);
+	for (uint32 TableIndex = 0; TableIndex < Header.NumTables; ++TableIndex)
+	{
+		const FTable& Table = Tables[TableIndex];
+		if (Table.Name >= Header.NumStrings || !IsInRange(Table.ColumnsOffset, uint64(Table.NumColumns) * sizeof(FColumn)))
+		{
+			UE_LOG(LogLifeVairDatabase, Warning, TEXT("Database snapshot %s is truncated"), *SnapshotPath);
+			return false;
+		}
+
+		const FColumn* Columns = GetData<FColumn>(Table.ColumnsOffset);
+		for (uint32 Column = 0; Column < Table.NumColumns; ++Column)
+		{
+			const uint64 ValueSize = Columns[Column].Type == EColumnType::String ? sizeof(uint32) : sizeof(double);
+			if (Columns[Column].Name >= Header.NumStrings || !IsInRange(Columns[Column].DataOffset, uint64(Table.NumRows) * ValueSize))
+			{
+				UE_LOG(LogLifeVairDatabase, Warning, TEXT("Database snapshot %s is truncated"), *SnapshotPath);
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+FLifeVairSnapshotTable FLifeVairDatabaseSnapshot::FindTable(const FString& Name) const
+{
+	if (!IsOpen())
+	{
+		return FLifeVairSnapshotTable();
+	}
+
+	const LifeVairSnapshot::FTable* Tables = GetData<LifeVairSnapshot::FTable>(GetHeader().TablesOffset);
+	for (uint32 TableIndex = 0; TableIndex < GetHeader().NumTables; ++TableIndex)
+	{
+		if (GetString(Tables[TableIndex].Name) == Name)
+		{
+			return FLifeVairSnapshotTable(this, &Tables[TableIndex]);
+		}
+	}
+	return FLifeVairSnapshotTable();
+}
+
+bool FLifeVairDatabaseSnapshot::GetStringBytes(uint32 Id, const ANSICHAR*& OutChars, int32& OutLength) const
+{
+	if (!IsOpen() || Id >= GetHeader().NumStrings)
+	{
+		return false;
+	}
+
+	const LifeVairSnapshot::FHeader& Header = GetHeader();
+	const uint32* Offsets = GetData<uint32>(Header.StringOffsetsOffset);
+	if (Offsets[Id] > Offsets[Id + 1] || Offsets[Id + 1] > Header.StringDataSize)
+	{
+		return false;
+	}
+
+	OutChars = GetData<ANSICHAR>(Header.StringDataOffset + Offsets[Id]);
+	OutLength = int32(Offsets[Id + 1] - Offsets[Id]);
+	return true;
+}
+
+FString FLifeVairDatabaseSnapshot::GetString(uint32 Id) const
+{
+	const ANSICHAR* Chars = nullptr;
+	int32 Length = 0;
+	if (!GetStringBytes(Id, Chars, Length))
+	{
+		return FString();
+	}
+
+	const FUTF8ToTCHAR Converted(Chars, Length);
+	return FString(Converted.Length(), Converted.Get());
+}
+
+FName FLifeVairDatabaseSnapshot::GetName(uint32 Id) const
+{
+	const ANSICHAR* Chars = nullptr;
+	int32 Length = 0;
+	if (!GetStringBytes(Id, Chars, Length))
+	{
+		return NAME_None;
+	}
+
+	const FUTF8ToTCHAR Converted(Chars, Length);
+	return FName(Converted.Length(), Converted.Get());
+}
@@ -0,0 +1,179 @@
+// Copyright : OK
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/*
+ * Binary snapshot of database tables, written by the LifeVairSnapshot commandlet and memory mapped at runtime.
+ *
+ * Layout (little endian, every section 8 byte aligned) :
+ * FHeader, FTable[NumTables], FColumn[] of every table, column data, uint32 string offsets[NumStrings + 1], UTF-8 string data.
+ * Numeric columns are NumRows doubles, text columns are NumRows string ids into the offset table.
+ */
+namespace LifeVairSnapshot
+{
+	static constexpr uint32 Magic = 0x4E53564C; // "LVSN"
+	static constexpr uint32 Version = 2;
+
+	enum class EColumnType : uint32
+	{
+		Number = 0,
+		String = 1
+	};
+
+	/*
+	 * Identifies the SQLite file a snapshot was exported from without reading more than its header.
+	 * Commits still in the write-ahead log don't move the header change counter, so the size and modification time of the -wal file are kept too.
+	 */
+	struct FSourceInfo
+	{
+		int64 FileSize = 0;
+		uint32 ChangeCounter = 0;
+		uint32 SchemaCookie = 0;
+		int64 ModifiedTicks = 0;
+
+		// 0 when there is no -wal file
+		int64 WalSize = 0;
+		int64 WalModifiedTicks = 0;
+
+		bool operator==(const FSourceInfo& Other) const
+		{
+			if (FileSize != Other.FileSize || ChangeCounter != Other.ChangeCounter || SchemaCookie != Other.SchemaCookie
+				|| WalSize != Other.WalSize || WalModifiedTicks != Other.WalModifiedTicks)
+			{
+				return false;
+			}
+#if WITH_EDITOR
+			// Staging doesn't keep modification times, only the editor can tell an edit that kept the size and header this way
+			return ModifiedTicks == Other.ModifiedTicks;
+#else
+			return true;
+#endif
+		}
+
+		/*Reads the size, modification time and change counter/schema cookie of the SQLite file and its -wal file, false if the file is missing or not a database*/
+		static bool Read(const FString& DatabasePath, FSourceInfo& OutInfo);
+	};
+
+	struct FHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		FSourceInfo Source;
+		uint32 NumTables;
+		uint32 TablesOffset;
+		uint32 NumStrings;
+		uint32 StringOffsetsOffset;
+		uint32 StringDataOffset;
+		uint32 StringDataSize;
+	};
+
+	struct FTable
+	{
+		uint32 Name;
+		uint32 NumRows;
+		uint32 NumColumns;
+		uint32 ColumnsOffset;
+	};
+
+	struct FColumn
+	{
+		uint32 Name;
+		EColumnType Type;
+		uint32 DataOffset;
+		uint32 Padding;
+	};
+
+	/*
+	 * Checkpoints the write-ahead log of the SQLite file, reads Tables from it and writes them as a snapshot.
+	 * Editor/commandlet only, not meant for the game thread
+	 */
+	LIFEVAIR_API bool Export(const FString& DatabasePath, const TArray<FString>& Tables, const FString& SnapshotPath);
+}
+
+class FLifeVairDatabaseSnapshot;
+
+/*View of one table of a snapshot, only valid while the snapshot stays open*/
+class LIFEVAIR_API FLifeVairSnapshotTable
+{
+public:
+	FLifeVairSnapshotTable() {}
+	FLifeVairSnapshotTable(const FLifeVairDatabaseSnapshot* InSnapshot, const LifeVairSnapshot::FTable* InTable);
+
+	bool IsValid() const { return Table != nullptr; }
+
+	int32 GetNumRows() const { return Table ? Table->NumRows : 0; }
+	int32 GetNumColumns() const { return Table ? Table->NumColumns : 0; }
+
+	FString GetColumnName(int32 Column) const;
+	TArray<FString> GetColumnNames() const;
+	int32 FindColumn(const FString& Name) const;
+
+	bool IsStringColumn(int32 Column) const;
+
+	/*Values of a numeric column straight from the mapped file, empty for text columns*/
+	TArrayView<const double> GetNumbers(int32 Column) const;
+
+	/*String ids of a text column, resolve them with GetString/GetName of the snapshot*/
+	TArrayView<const uint32> GetStringIds(int32 Column) const;
+
+	/*Cell as text, numbers are formatted the way SQLite would return them*/
+	FString GetValueAsString(int32 Column, int32 Row) const;
+	FName GetValueAsName(int32 Column, int32 Row) const;
+
+private:
+	const LifeVairSnapshot::FColumn* GetColumn(int32 Column) const;
+
+	const FLifeVairDatabaseSnapshot* Snapshot = nullptr;
+	const LifeVairSnapshot::FTable* Table = nullptr;
+};
+
+/*
+ * Runtime loader for a snapshot. The file is memory mapped (or read in one go where mapping isn't supported) and only its offsets are validated,
+ * values are read in place.
+ */
+class LIFEVAIR_API FLifeVairDatabaseSnapshot
+{
+public:
+	FLifeVairDatabaseSnapshot();
+	~FLifeVairDatabaseSnapshot();
+
+	/*
+	 * Maps the snapshot, fails if it is missing, from another format version or stale.
+	 * It is stale when DatabasePath exists and isn't the file it was exported from, a snapshot without its database is still used.
+	 */
+	bool Open(const FString& SnapshotPath, const FString& DatabasePath);
+	void Close();
+
+	bool IsOpen() const { return Data != nullptr; }
+
+	FLifeVairSnapshotTable FindTable(const FString& Name) const;
+
+	FString GetString(uint32 Id) const;
+	FName GetName(uint32 Id) const;
+
+	template<typename Type>
+	const Type* GetData(uint32 Offset) const
+	{
+		return reinterpret_cast<const Type*>(Data + Offset);
+	}
+
+private:
+	bool Validate(const FString& SnapshotPath, const FString& DatabasePath) const;
+	bool GetStringBytes(uint32 Id, const ANSICHAR*& OutChars, int32& OutLength) const;
+
+	const LifeVairSnapshot::FHeader& GetHeader() const { return *GetData<LifeVairSnapshot::FHeader>(0); }
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	// Used when the platform can't map the file
+	TArray<uint8> LoadedData;
+
+	const uint8* Data = nullptr;
+	int64 DataSize = 0;
+};
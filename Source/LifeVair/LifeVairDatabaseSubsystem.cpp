@@ -0,0 +1,457 @@
+// Copyright : OK
+
+#include "LifeVairDatabaseSubsystem.h"
+#include "LifeVairDatabaseWorker.h"
+#include "LifeVairDatabaseSnapshot.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Misc/Paths.h"
+#include "UObject/TextProperty.h"
+
+DEFINE_LOG_CATEGORY(LogLifeVairDatabase);
+
+namespace LifeVairDatabase
+{
+	bool BindParameters(FSQLitePreparedStatement& Statement, const TArray<FString>& Parameters)
+	{
+		for (int32 Index = 0; Index < Parameters.Num(); ++Index)
+		{
+			// SQLite bindings are 1 based
+			if (!Statement.SetBindingValueByIndex(Index + 1, Parameters[Index]))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void ReadRow(const FSQLitePreparedStatement& Statement, int32 NumColumns, FLifeVairDatabaseRow& OutRow)
+	{
+		OutRow.Values.SetNum(NumColumns);
+		for (int32 Column = 0; Column < NumColumns; ++Column)
+		{
+			Statement.GetColumnValueByIndex(Column, OutRow.Values[Column]);
+		}
+	}
+
+	FString QuoteIdentifier(const FString& Identifier)
+	{
+		return TEXT("\"") + Identifier.Replace(TEXT("\""), TEXT("\"\"")) + TEXT("\"");
+	}
+
+	void ReadColumnIntoProperty(const FSQLitePreparedStatement& Statement, int32 Column, const FProperty* Property, void* StructData)
+	{
+		void* Value = Property->ContainerPtrToValuePtr<void>(StructData);
+
+		if (const FBoolProperty* BoolProperty = CastField<FBoolProperty>(Property))
+		{
+			int64 IntValue = 0;
+			Statement.GetColumnValueByIndex(Column, IntValue);
+			BoolProperty->SetPropertyValue(Value, IntValue != 0);
+		}
+		else if (const FEnumProperty* EnumProperty = CastField<FEnumProperty>(Property))
+		{
+			int64 IntValue = 0;
+			Statement.GetColumnValueByIndex(Column, IntValue);
+			EnumProperty->GetUnderlyingProperty()->SetIntPropertyValue(Value, IntValue);
+		}
+		else if (const FNumericProperty* NumericProperty = CastField<FNumericProperty>(Property))
+		{
+			if (NumericProperty->IsFloatingPoint())
+			{
+				double DoubleValue = 0.0;
+				Statement.GetColumnValueByIndex(Column, DoubleValue);
+				NumericProperty->SetFloatingPointPropertyValue(Value, DoubleValue);
+			}
+			else
+			{
+				int64 IntValue = 0;
+				Statement.GetColumnValueByIndex(Column, IntValue);
+				NumericProperty->SetIntPropertyValue(Value, IntValue);
+			}
+		}
+		else if (const FStrProperty* StrProperty = CastField<FStrProperty>(Property))
+		{
+			Statement.GetColumnValueByIndex(Column, *StrProperty->GetPropertyValuePtr(Value));
+		}
+		else if (const FNameProperty* NameProperty = CastField<FNameProperty>(Property))
+		{
+			Statement.GetColumnValueByIndex(Column, *NameProperty->GetPropertyValuePtr(Value));
+		}
+		else if (const FTextProperty* TextProperty = CastField<FTextProperty>(Property))
+		{
+			Statement.GetColumnValueByIndex(Column, *TextProperty->GetPropertyValuePtr(Value));
+		}
+	}
+}
+
+ULifeVairDatabaseSubsystem::ULifeVairDatabaseSubsystem()
+{
+	SnapshotTables.Add(TEXT("Domains"));
+}
+
+// Out of line so the worker can stay forward declared in the header
+ULifeVairDatabaseSubsystem::~ULifeVairDatabaseSubsystem()
+{
+}
+
+void ULifeVairDatabaseSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (bUseSnapshot && !SnapshotFile.IsEmpty())
+	{
+		Snapshot = MakeUnique<FLifeVairDatabaseSnapshot>();
+		if (!Snapshot->Open(ResolveDatabasePath(SnapshotFile), ResolveDatabasePath(DatabaseFile)))
+		{
+			Snapshot.Reset();
+		}
+	}
+
+	// With a snapshot SQLite is only opened once something queries it
+	if (!Snapshot)
+	{
+		EnsureDatabaseOpen();
+	}
+}
+
+void ULifeVairDatabaseSubsystem::Deinitialize()
+{
+	CancelAllQueries();
+	Worker.Reset();
+
+	CloseDatabase();
+	Snapshot.Reset();
+
+	Super::Deinitialize();
+}
+
+ULifeVairDatabaseSubsystem* ULifeVairDatabaseSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<ULifeVairDatabaseSubsystem>() : nullptr;
+}
+
+FString ULifeVairDatabaseSubsystem::ResolveDatabasePath(const FString& Path)
+{
+	if (FPaths::IsRelative(Path))
+	{
+		return FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir(), Path);
+	}
+	return Path;
+}
+
+bool ULifeVairDatabaseSubsystem::OpenDatabase(const FString& Path)
+{
+	const FString FullPath = ResolveDatabasePath(Path);
+
+	if (Database.IsValid() && OpenedPath == FullPath)
+	{
+		return true;
+	}
+
+	CloseDatabase();
+
+	if (!Database.Open(*FullPath, ESQLiteDatabaseOpenMode::ReadOnly))
+	{
+		UE_LOG(LogLifeVairDatabase, Warning, TEXT("Error while trying to open the DB %s : %s"), *FullPath, *Database.GetLastError());
+		return false;
+	}
+
+	OpenedPath = FullPath;
+	return true;
+}
+
+void ULifeVairDatabaseSubsystem::CloseDatabase()
+{
+	// Statements have to be finalized before the connection can close
+	StatementCache.Reset();
+
+	if (Database.IsValid())
+	{
+		Database.Close();
+	}
+	OpenedPath.Reset();
+}
+
+bool ULifeVairDatabaseSubsystem::IsDatabaseOpen() const
+{
+	return Database.IsValid();
+}
+
+bool ULifeVairDatabaseSubsystem::EnsureDatabaseOpen()
+{
+	if (!Database.IsValid() && !bTriedDefaultDatabase && !DatabaseFile.IsEmpty())
+	{
+		bTriedDefaultDatabase = true;
+		OpenDatabase(DatabaseFile);
+	}
+	return Database.IsValid();
+}
+
+const FLifeVairDatabaseSnapshot* ULifeVairDatabaseSubsystem::GetSnapshot() const
+{
+	return Snapshot.Get();
+}
+
+FSQLitePreparedStatement* ULifeVairDatabaseSubsystem::GetStatement(const FString& Sql)
+{
+	if (!EnsureDatabaseOpen())
+	{
+		return nullptr;
+	}
+
+	if (TUniquePtr<FSQLitePreparedStatement>* Cached = StatementCache.Find(Sql))
+	{
+		FSQLitePreparedStatement* Statement = Cached->Get();
+		Statement->Reset();
+		Statement->ClearBindings();
+		return Statement;
+	}
+
+	TUniquePtr<FSQLitePreparedStatement> Statement = MakeUnique<FSQLitePreparedStatement>();
+	if (!Statement->Create(Database, *Sql, ESQLitePreparedStatementFlags::Persistent))
+	{
+		UE_LOG(LogLifeVairDatabase, Warning, TEXT("Error while compiling \"%s\" : %s"), *Sql, *Database.GetLastError());
+		return nullptr;
+	}
+
+	return StatementCache.Add(Sql, MoveTemp(Statement)).Get();
+}
+
+int64 ULifeVairDatabaseSubsystem::Execute(const FString& Sql, const TArray<FString>& Parameters, TFunctionRef<ESQLitePreparedStatementExecuteRowResult(const FSQLitePreparedStatement&)> OnRow)
+{
+	FSQLitePreparedStatement* Statement = GetStatement(Sql);
+	if (!Statement)
+	{
+		return INDEX_NONE;
+	}
+
+	if (!LifeVairDatabase::BindParameters(*Statement, Parameters))
+	{
+		UE_LOG(LogLifeVairDatabase, Warning, TEXT("Error while binding parameters for \"%s\" : %s"), *Sql, *Database.GetLastError());
+		return INDEX_NONE;
+	}
+
+	const int64 NumRows = Statement->Execute(OnRow);
+
+	// Don't hold read locks between queries
+	Statement->Reset();
+
+	if (NumRows == INDEX_NONE)
+	{
+		UE_LOG(LogLifeVairDatabase, Warning, TEXT("Error while running \"%s\" : %s"), *Sql, *Database.GetLastError());
+	}
+	return NumRows;
+}
+
+TArray<FString> ULifeVairDatabaseSubsystem::GetColumnNames(const FString& Table)
+{
+	if (Snapshot)
+	{
+		const FLifeVairSnapshotTable SnapshotTable = Snapshot->FindTable(Table);
+		if (SnapshotTable.IsValid())
+		{
+			return SnapshotTable.GetColumnNames();
+		}
+	}
+
+	// Only tables the database has get a cached statement
+	bool bHasTable = false;
+	Execute(LifeVairDatabase::FindTableSql, { Table }, [&bHasTable](const FSQLitePreparedStatement& Row)
+	{
+		bHasTable = true;
+		return ESQLitePreparedStatementExecuteRowResult::Stop;
+	});
+	if (!bHasTable)
+	{
+		return TArray<FString>();
+	}
+
+	const FSQLitePreparedStatement* Statement = GetStatement(FString::Printf(TEXT("select * from %s"), *LifeVairDatabase::QuoteIdentifier(Table)));
+	return Statement ? Statement->GetColumnNames() : TArray<FString>();
+}
+
+bool ULifeVairDatabaseSubsystem::QueryRows(const FString& Sql, const TArray<FString>& Parameters, TArray<FString>& OutColumns, TArray<FLifeVairDatabaseRow>& OutRows)
+{
+	OutColumns.Reset();
+	OutRows.Reset();
+
+	const FSQLitePreparedStatement* Statement = GetStatement(Sql);
+	if (!Statement)
+	{
+		return false;
+	}
+
+	OutColumns = Statement->GetColumnNames();
+	const int32 NumColumns = OutColumns.Num();
+
+	return Execute(Sql, Parameters, [&OutRows, NumColumns](const FSQLitePreparedStatement& Row)
+	{
+		LifeVairDatabase::ReadRow(Row, NumColumns, OutRows.AddDefaulted_GetRef());
+		return ESQLitePreparedStatementExecuteRowResult::Continue;
+	}) != INDEX_NONE;
+}
+
+bool ULifeVairDatabaseSubsystem::QueryStructsInternal(const FString& Sql, const TArray<FString>& Parameters, const UScriptStruct* Struct, TFunctionRef<void*()> AddRow)
+{
+	const FSQLitePreparedStatement* Statement = GetStatement(Sql);
+	if (!Statement || !Struct)
+	{
+		return false;
+	}
+
+	// Resolve the column to property mapping once for the whole result set
+	const TArray<FString> Columns = Statement->GetColumnNames();
+	TArray<const FProperty*, TInlineAllocator<32>> ColumnProperties;
+	ColumnProperties.Reserve(Columns.Num());
+	for (const FString& Column : Columns)
+	{
+		ColumnProperties.Add(Struct->FindPropertyByName(FName(*Column)));
+	}
+
+	return Execute(Sql, Parameters, [&ColumnProperties, &AddRow](const FSQLitePreparedStatement& Row)
+	{
+		void* StructData = AddRow();
+		for (int32 Column = 0; Column < ColumnProperties.Num(); ++Column)
+		{
+			if (const FProperty* Property = ColumnProperties[Column])
+			{
+				LifeVairDatabase::ReadColumnIntoProperty(Row, Column, Property, StructData);
+			}
+		}
+		return ESQLitePreparedStatementExecuteRowResult::Continue;
+	}) != INDEX_NONE;
+}
+
+FLifeVairQueryHandle ULifeVairDatabaseSubsystem::QueryAsync(const FString& Sql, const TArray<FString>& Parameters, TFunction<void(FLifeVairQueryBatch&& Batch)> OnBatch, TFunction<void(bool bSuccess)> OnComplete, TFunction<void()> OnCancelled, int32 BatchSize)
+{
+	check(IsInGameThread());
+
+	if (!Worker)
+	{
+		Worker = MakeUnique<FLifeVairDatabaseWorker>();
+	}
+
+	TSharedRef<FLifeVairQueryJob, ESPMode::ThreadSafe> Job = MakeShared<FLifeVairQueryJob, ESPMode::ThreadSafe>();
+	Job->Id = NextQueryId++;
+	Job->DatabasePath = OpenedPath.IsEmpty() ? ResolveDatabasePath(DatabaseFile) : OpenedPath;
+	Job->Sql = Sql;
+	Job->Parameters = Parameters;
+	Job->BatchSize = BatchSize > 0 ? BatchSize : AsyncBatchSize;
+	Job->OnBatch = MoveTemp(OnBatch);
+	Job->OnCancelled = MoveTemp(OnCancelled);
+
+	// Forget the query once it is delivered so the handle reads as finished
+	const int64 JobId = Job->Id;
+	TWeakObjectPtr<ULifeVairDatabaseSubsystem> WeakThis(this);
+	Job->OnComplete = [WeakThis, JobId, OnComplete = MoveTemp(OnComplete)](bool bSuccess)
+	{
+		if (ULifeVairDatabaseSubsystem* This = WeakThis.Get())
+		{
+			This->ActiveQueries.Remove(JobId);
+		}
+
+		if (OnComplete)
+		{
+			OnComplete(bSuccess);
+		}
+	};
+
+	ActiveQueries.Add(JobId, Job);
+	Worker->Enqueue(Job);
+
+	FLifeVairQueryHandle Handle;
+	Handle.Id = JobId;
+	return Handle;
+}
+
+TFuture<FLifeVairQueryResult> ULifeVairDatabaseSubsystem::QueryAsync(const FString& Sql, const TArray<FString>& Parameters, FLifeVairQueryHandle* OutHandle)
+{
+	// The promise is always set exactly once, either by completion or cancellation
+	TSharedRef<TPromise<FLifeVairQueryResult>, ESPMode::ThreadSafe> Promise = MakeShared<TPromise<FLifeVairQueryResult>, ESPMode::ThreadSafe>();
+	TSharedRef<FLifeVairQueryResult, ESPMode::ThreadSafe> Result = MakeShared<FLifeVairQueryResult, ESPMode::ThreadSafe>();
+	TFuture<FLifeVairQueryResult> Future = Promise->GetFuture();
+
+	const FLifeVairQueryHandle Handle = QueryAsync(Sql, Parameters,
+		[Result](FLifeVairQueryBatch&& Batch)
+		{
+			if (Result->Columns.Num() == 0)
+			{
+				Result->Columns = MoveTemp(Batch.Columns);
+			}
+			Result->Rows.Append(MoveTemp(Batch.Rows));
+		},
+		[Result, Promise](bool bSuccess)
+		{
+			Result->bSuccess = bSuccess;
+			Promise->SetValue(MoveTemp(*Result));
+		},
+		[Result, Promise]()
+		{
+			Result->bCancelled = true;
+			Promise->SetValue(MoveTemp(*Result));
+		});
+
+	if (OutHandle)
+	{
+		*OutHandle = Handle;
+	}
+	return Future;
+}
+
+void ULifeVairDatabaseSubsystem::CancelQuery(FLifeVairQueryHandle Handle)
+{
+	TSharedPtr<FLifeVairQueryJob, ESPMode::ThreadSafe> Job;
+	if (ActiveQueries.RemoveAndCopyValue(Handle.Id, Job))
+	{
+		Job->bCancelled = true;
+
+		if (Job->OnCancelled)
+		{
+			Job->OnCancelled();
+		}
+	}
+}
+
+bool ULifeVairDatabaseSubsystem::IsQueryRunning(FLifeVairQueryHandle Handle) const
+{
+	return ActiveQueries.Contains(Handle.Id);
+}
+
+void ULifeVairDatabaseSubsystem::CancelAllQueries()
+{
+	TArray<int64> QueryIds;
+	ActiveQueries.GetKeys(QueryIds);
+
+	for (const int64 QueryId : QueryIds)
+	{
+		FLifeVairQueryHandle Handle;
+		Handle.Id = QueryId;
+		CancelQuery(Handle);
+	}
+}
+
+void ULifeVairDatabaseSubsystem::Tick(float DeltaTime)
+{
+	if (Worker)
+	{
+		Worker->DeliverResults(AsyncResultBudgetMs / 1000.0);
+	}
+}
+
+bool ULifeVairDatabaseSubsystem::IsTickable() const
+{
+	return Worker && Worker->HasPendingResults();
+}
+
+ETickableTickType ULifeVairDatabaseSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+TStatId ULifeVairDatabaseSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULifeVairDatabaseSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,190 @@
+// Copyright : OK
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SQLiteDatabase.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Tickable.h"
+#include "Async/Future.h"
+#include "LifeVairDatabaseSubsystem.generated.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogLifeVairDatabase, Log, All);
+
+class FLifeVairDatabaseWorker;
+class FLifeVairDatabaseSnapshot;
+struct FLifeVairQueryBatch;
+struct FLifeVairQueryJob;
+struct FLifeVairQueryResult;
+
+/*A single result row, every column read back as text. Used by the Blueprint query functions*/
+USTRUCT(BlueprintType)
+struct LIFEVAIR_API FLifeVairDatabaseRow
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "LifeVair Database")
+	TArray<FString> Values;
+};
+
+/*Identifies a running async query so it can be cancelled*/
+USTRUCT(BlueprintType)
+struct LIFEVAIR_API FLifeVairQueryHandle
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int64 Id = 0;
+
+	bool IsValid() const { return Id != 0; }
+};
+
+namespace LifeVairDatabase
+{
+	/*Binds Parameters to ?1..?N of Statement*/
+	LIFEVAIR_API bool BindParameters(FSQLitePreparedStatement& Statement, const TArray<FString>& Parameters);
+
+	/*Reads the first NumColumns columns of the current row as text*/
+	LIFEVAIR_API void ReadRow(const FSQLitePreparedStatement& Statement, int32 NumColumns, FLifeVairDatabaseRow& OutRow);
+
+	/*Identifier as a quoted SQL name, identifiers can't be bound so this is the only safe way to put one in a statement*/
+	LIFEVAIR_API FString QuoteIdentifier(const FString& Identifier);
+
+	/*Query listing a table or view by name, bind the name to ?1*/
+	static const TCHAR* const FindTableSql = TEXT("select 1 from sqlite_master where type in ('table', 'view') and name = ?1");
+}
+
+/*
+ * Owns the territory/domain database connection for the whole game instance.
+ * The file is opened once and statements are compiled once per SQL text, then reset and rebound for each query.
+ * The synchronous functions are game thread only, the async ones run on a worker thread with its own read-only connection
+ * and hand their results back on the game thread within AsyncResultBudgetMs per frame.
+ */
+UCLASS(Config = Game)
+class LIFEVAIR_API ULifeVairDatabaseSubsystem : public UGameInstanceSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	ULifeVairDatabaseSubsystem();
+	virtual ~ULifeVairDatabaseSubsystem();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	static ULifeVairDatabaseSubsystem* Get(const UObject* WorldContextObject);
+
+	/*Database opened on initialize, or on first use when the snapshot is loaded. Relative paths are resolved against the project content directory*/
+	UPROPERTY(Config, EditAnywhere, Category = "LifeVair Database")
+	FString DatabaseFile = TEXT("Database/AtmoData.db");
+
+	/*Binary snapshot written by the LifeVairSnapshot commandlet, used instead of SQLite at startup when it matches DatabaseFile*/
+	UPROPERTY(Config, EditAnywhere, Category = "LifeVair Database|Snapshot")
+	FString SnapshotFile = TEXT("Database/LifeVair.lvsnap");
+
+	UPROPERTY(Config, EditAnywhere, Category = "LifeVair Database|Snapshot")
+	bool bUseSnapshot = true;
+
+	/*Tables the commandlet exports, the territory table is always added*/
+	UPROPERTY(Config, EditAnywhere, Category = "LifeVair Database|Snapshot")
+	TArray<FString> SnapshotTables;
+
+	/*Relative paths are resolved against the project content directory*/
+	static FString ResolveDatabasePath(const FString& Path);
+
+	/*Opens the given database file, closing the current one (and its cached statements) if it is a different file*/
+	UFUNCTION(BlueprintCallable, Category = "LifeVair Database")
+	bool OpenDatabase(const FString& Path);
+
+	UFUNCTION(BlueprintCallable, Category = "LifeVair Database")
+	void CloseDatabase();
+
+	UFUNCTION(BlueprintPure, Category = "LifeVair Database")
+	bool IsDatabaseOpen() const;
+
+	/*Opens DatabaseFile if no database is open yet, only tried once so a missing file doesn't get retried by every query*/
+	bool EnsureDatabaseOpen();
+
+	/*The loaded snapshot, null when there is none or it was stale*/
+	const FLifeVairDatabaseSnapshot* GetSnapshot() const;
+
+	/*Column names of a table, from the snapshot if it has the table or else from the cached "select * from <Table>" statement. Empty for a table the database doesn't have*/
+	UFUNCTION(BlueprintCallable, Category = "LifeVair Database")
+	TArray<FString> GetColumnNames(const FString& Table);
+
+	/*Runs a query with its ?1..?N parameters bound in order from Parameters. Returns false if the statement failed to compile or run*/
+	UFUNCTION(BlueprintCallable, Category = "LifeVair Database")
+	bool QueryRows(const FString& Sql, const TArray<FString>& Parameters, TArray<FString>& OutColumns, TArray<FLifeVairDatabaseRow>& OutRows);
+
+	/*
+	 * Runs a query and fills one StructType per row, columns are matched to struct properties by name.
+	 * Supports numeric, bool, enum, string, name and text properties, unmatched columns are ignored.
+	 */
+	template<typename StructType>
+	bool QueryStructs(const FString& Sql, const TArray<FString>& Parameters, TArray<StructType>& OutRows)
+	{
+		OutRows.Reset();
+		return QueryStructsInternal(Sql, Parameters, StructType::StaticStruct(), [&OutRows]() -> void* { return &OutRows.AddDefaulted_GetRef(); });
+	}
+
+	/*
+	 * Native access to a cached statement, already reset with its bindings cleared.
+	 * The statement stays owned by the cache, do not keep it past the current call.
+	 */
+	FSQLitePreparedStatement* GetStatement(const FString& Sql);
+
+	/*Binds Parameters to ?1..?N, runs the statement and calls OnRow for each result row. Returns the number of rows or INDEX_NONE on failure*/
+	int64 Execute(const FString& Sql, const TArray<FString>& Parameters, TFunctionRef<ESQLitePreparedStatementExecuteRowResult(const FSQLitePreparedStatement&)> OnRow);
+
+	int32 GetNumCachedStatements() const { return StatementCache.Num(); }
+
+	/*Rows per batch handed back to the game thread by async queries*/
+	UPROPERTY(Config, EditAnywhere, Category = "LifeVair Database|Async")
+	int32 AsyncBatchSize = 256;
+
+	/*Game thread time spent delivering async results each frame, the rest waits for the next frame*/
+	UPROPERTY(Config, EditAnywhere, Category = "LifeVair Database|Async")
+	float AsyncResultBudgetMs = 1.0f;
+
+	/*
+	 * Runs a query on the database worker. OnBatch receives the rows in batches of BatchSize (AsyncBatchSize if 0) and OnComplete follows the last one.
+	 * Both are called on the game thread and neither is called once the query is cancelled.
+	 */
+	FLifeVairQueryHandle QueryAsync(const FString& Sql, const TArray<FString>& Parameters, TFunction<void(FLifeVairQueryBatch&& Batch)> OnBatch, TFunction<void(bool bSuccess)> OnComplete, TFunction<void()> OnCancelled = nullptr, int32 BatchSize = 0);
+
+	/*Runs a query on the database worker and gathers every row, the future is set on the game thread (also when cancelled)*/
+	TFuture<FLifeVairQueryResult> QueryAsync(const FString& Sql, const TArray<FString>& Parameters, FLifeVairQueryHandle* OutHandle = nullptr);
+
+	/*Stops an async query, its remaining batches are dropped*/
+	UFUNCTION(BlueprintCallable, Category = "LifeVair Database|Async")
+	void CancelQuery(FLifeVairQueryHandle Handle);
+
+	UFUNCTION(BlueprintPure, Category = "LifeVair Database|Async")
+	bool IsQueryRunning(FLifeVairQueryHandle Handle) const;
+
+	// FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual bool IsTickableWhenPaused() const override { return true; }
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual TStatId GetStatId() const override;
+
+private:
+	bool QueryStructsInternal(const FString& Sql, const TArray<FString>& Parameters, const UScriptStruct* Struct, TFunctionRef<void*()> AddRow);
+
+	FSQLiteDatabase Database;
+	FString OpenedPath;
+	bool bTriedDefaultDatabase = false;
+
+	TUniquePtr<FLifeVairDatabaseSnapshot> Snapshot;
+
+	// Compiled statements keyed by their SQL text, persistent so SQLite keeps their plans around
+	TMap<FString, TUniquePtr<FSQLitePreparedStatement>> StatementCache;
+
+	// Created on the first async query
+	TUniquePtr<FLifeVairDatabaseWorker> Worker;
+	TMap<int64, TSharedPtr<FLifeVairQueryJob, ESPMode::ThreadSafe>> ActiveQueries;
+	int64 NextQueryId = 1;
+
+	void CancelAllQueries();
+};
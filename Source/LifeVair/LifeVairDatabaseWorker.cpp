@@ -0,0 +1,214 @@
+// Copyright : OK
+
+#include "LifeVairDatabaseWorker.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/RunnableThread.h"
+
+FLifeVairDatabaseWorker::FLifeVairDatabaseWorker()
+{
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	Thread = FRunnableThread::Create(this, TEXT("LifeVairDatabaseWorker"), 0, TPri_BelowNormal);
+}
+
+FLifeVairDatabaseWorker::~FLifeVairDatabaseWorker()
+{
+	if (Thread)
+	{
+		// Kill calls Stop and waits for the current job to notice
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+}
+
+void FLifeVairDatabaseWorker::Enqueue(TSharedRef<FLifeVairQueryJob, ESPMode::ThreadSafe> Job)
+{
+	PendingJobs.Enqueue(Job);
+	WakeEvent->Trigger();
+}
+
+void FLifeVairDatabaseWorker::Stop()
+{
+	bStopping = true;
+	WakeEvent->Trigger();
+}
+
+uint32 FLifeVairDatabaseWorker::Run()
+{
+	while (!bStopping)
+	{
+		TSharedPtr<FLifeVairQueryJob, ESPMode::ThreadSafe> Job;
+		while (!bStopping && PendingJobs.Dequeue(Job))
+		{
+			RunJob(Job.ToSharedRef());
+		}
+
+		WakeEvent->Wait();
+	}
+
+	CloseDatabase();
+	return 0;
+}
+
+bool FLifeVairDatabaseWorker::OpenDatabase(const FString& Path)
+{
+	if (Database.IsValid() && OpenedPath == Path)
+	{
+		return true;
+	}
+
+	CloseDatabase();
+
+	if (!Database.Open(*Path, ESQLiteDatabaseOpenMode::ReadOnly))
+	{
+		UE_LOG(LogLifeVairDatabase, Warning, TEXT("Database worker could not open %s : %s"), *Path, *Database.GetLastError());
+		return false;
+	}
+
+	OpenedPath = Path;
+	return true;
+}
+
+void FLifeVairDatabaseWorker::CloseDatabase()
+{
+	StatementCache.Reset();
+
+	if (Database.IsValid())
+	{
+		Database.Close();
+	}
+	OpenedPath.Reset();
+}
+
+void FLifeVairDatabaseWorker::RunJob(const TSharedRef<FLifeVairQueryJob, ESPMode::ThreadSafe>& Job)
+{
+	if (Job->bCancelled)
+	{
+		return;
+	}
+
+	if (!OpenDatabase(Job->DatabasePath))
+	{
+		PushComplete(Job, false);
+		return;
+	}
+
+	FSQLitePreparedStatement* Statement = nullptr;
+	if (TUniquePtr<FSQLitePreparedStatement>* Cached = StatementCache.Find(Job->Sql))
+	{
+		Statement = Cached->Get();
+		Statement->Reset();
+		Statement->ClearBindings();
+	}
+	else
+	{
+		TUniquePtr<FSQLitePreparedStatement> NewStatement = MakeUnique<FSQLitePreparedStatement>();
+		if (NewStatement->Create(Database, *Job->Sql, ESQLitePreparedStatementFlags::Persistent))
+		{
+			Statement = StatementCache.Add(Job->Sql, MoveTemp(NewStatement)).Get();
+		}
+	}
+
+	if (!Statement || !LifeVairDatabase::BindParameters(*Statement, Job->Parameters))
+	{
+		UE_LOG(LogLifeVairDatabase, Warning, TEXT("Database worker could not prepare \"%s\" : %s"), *Job->Sql, *Database.GetLastError());
+		PushComplete(Job, false);
+		return;
+	}
+
+	const int32 BatchSize = FMath::Max(1, Job->BatchSize);
+	FLifeVairQueryBatch Batch;
+	Batch.Columns = Statement->GetColumnNames();
+	Batch.Rows.Reserve(BatchSize);
+	const int32 NumColumns = Batch.Columns.Num();
+
+	const int64 NumRows = Statement->Execute([this, &Job, &Batch, BatchSize, NumColumns](const FSQLitePreparedStatement& Row)
+	{
+		if (Job->bCancelled || bStopping)
+		{
+			return ESQLitePreparedStatementExecuteRowResult::Stop;
+		}
+
+		LifeVairDatabase::ReadRow(Row, NumColumns, Batch.Rows.AddDefaulted_GetRef());
+
+		if (Batch.Rows.Num() >= BatchSize)
+		{
+			FLifeVairQueryBatch FullBatch;
+			FullBatch.Columns = Batch.Columns;
+			FullBatch.Rows = MoveTemp(Batch.Rows);
+			PushBatch(Job, MoveTemp(FullBatch));
+
+			Batch.Rows.Reset(BatchSize);
+		}
+		return ESQLitePreparedStatementExecuteRowResult::Continue;
+	});
+
+	Statement->Reset();
+
+	if (Job->bCancelled)
+	{
+		return;
+	}
+
+	// Empty results still send one batch so that the columns arrive
+	if (Batch.Rows.Num() > 0 || NumRows == 0)
+	{
+		PushBatch(Job, MoveTemp(Batch));
+	}
+
+	PushComplete(Job, NumRows != INDEX_NONE);
+}
+
+void FLifeVairDatabaseWorker::PushBatch(const TSharedRef<FLifeVairQueryJob, ESPMode::ThreadSafe>& Job, FLifeVairQueryBatch&& Batch)
+{
+	FLifeVairQueryMessage Message;
+	Message.Job = Job;
+	Message.Batch = MoveTemp(Batch);
+	Results.Enqueue(MoveTemp(Message));
+}
+
+void FLifeVairDatabaseWorker::PushComplete(const TSharedRef<FLifeVairQueryJob, ESPMode::ThreadSafe>& Job, bool bSuccess)
+{
+	FLifeVairQueryMessage Message;
+	Message.Job = Job;
+	Message.bIsComplete = true;
+	Message.bSuccess = bSuccess;
+	Results.Enqueue(MoveTemp(Message));
+}
+
+void FLifeVairDatabaseWorker::DeliverResults(double TimeBudgetSeconds)
+{
+	const double EndTime = FPlatformTime::Seconds() + TimeBudgetSeconds;
+
+	// Always deliver at least one message so a tiny budget can't stall a query forever
+	FLifeVairQueryMessage Message;
+	while (Results.Dequeue(Message))
+	{
+		FLifeVairQueryJob& Job = *Message.Job;
+
+		if (!Job.bCancelled)
+		{
+			if (Message.bIsComplete)
+			{
+				if (Job.OnComplete)
+				{
+					Job.OnComplete(Message.bSuccess);
+				}
+			}
+			else if (Job.OnBatch)
+			{
+				Job.OnBatch(MoveTemp(Message.Batch));
+			}
+		}
+
+		if (FPlatformTime::Seconds() >= EndTime)
+		{
+			break;
+		}
+	}
+}
@@ -0,0 +1,97 @@
+// Copyright : OK
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "Containers/Queue.h"
+#include "LifeVairDatabaseSubsystem.h"
+
+class FRunnableThread;
+class FEvent;
+
+/*Rows handed back to the game thread for one batch of an async query*/
+struct FLifeVairQueryBatch
+{
+	TArray<FString> Columns;
+	TArray<FLifeVairDatabaseRow> Rows;
+};
+
+/*One queued query, shared between the game thread and the worker. Cancelling it stops the worker at the next row and drops any batch not yet delivered*/
+struct FLifeVairQueryJob
+{
+	int64 Id = 0;
+	FString DatabasePath;
+	FString Sql;
+	TArray<FString> Parameters;
+	int32 BatchSize = 256;
+
+	// Game thread callbacks, OnCancelled is called instead of OnComplete when the job is cancelled
+	TFunction<void(FLifeVairQueryBatch&& Batch)> OnBatch;
+	TFunction<void(bool bSuccess)> OnComplete;
+	TFunction<void()> OnCancelled;
+
+	FThreadSafeBool bCancelled;
+};
+
+/*Whole result of a query for the TFuture variant*/
+struct FLifeVairQueryResult
+{
+	bool bSuccess = false;
+	bool bCancelled = false;
+	TArray<FString> Columns;
+	TArray<FLifeVairDatabaseRow> Rows;
+};
+
+/*A batch or completion waiting to be delivered on the game thread*/
+struct FLifeVairQueryMessage
+{
+	TSharedPtr<FLifeVairQueryJob, ESPMode::ThreadSafe> Job;
+	FLifeVairQueryBatch Batch;
+	bool bIsComplete = false;
+	bool bSuccess = false;
+};
+
+/*
+ * Runs queued queries on a dedicated thread with its own read-only connection, so the game thread never waits on SQLite.
+ * Owned by ULifeVairDatabaseSubsystem.
+ */
+class FLifeVairDatabaseWorker : public FRunnable
+{
+public:
+	FLifeVairDatabaseWorker();
+	virtual ~FLifeVairDatabaseWorker();
+
+	void Enqueue(TSharedRef<FLifeVairQueryJob, ESPMode::ThreadSafe> Job);
+
+	/*Game thread, calls the callbacks of finished batches until the time budget runs out, the rest waits for the next call*/
+	void DeliverResults(double TimeBudgetSeconds);
+
+	bool HasPendingResults() const { return !Results.IsEmpty(); }
+
+	// FRunnable interface
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	void RunJob(const TSharedRef<FLifeVairQueryJob, ESPMode::ThreadSafe>& Job);
+	bool OpenDatabase(const FString& Path);
+	void CloseDatabase();
+
+	void PushBatch(const TSharedRef<FLifeVairQueryJob, ESPMode::ThreadSafe>& Job, FLifeVairQueryBatch&& Batch);
+	void PushComplete(const TSharedRef<FLifeVairQueryJob, ESPMode::ThreadSafe>& Job, bool bSuccess);
+
+	TQueue<TSharedPtr<FLifeVairQueryJob, ESPMode::ThreadSafe>, EQueueMode::Mpsc> PendingJobs;
+
+	// Written by the worker, read by the game thread
+	TQueue<FLifeVairQueryMessage, EQueueMode::Spsc> Results;
+
+	FEvent* WakeEvent = nullptr;
+	FRunnableThread* Thread = nullptr;
+	FThreadSafeBool bStopping;
+
+	// Worker thread only
+	FSQLiteDatabase Database;
+	FString OpenedPath;
+	TMap<FString, TUniquePtr<FSQLitePreparedStatement>> StatementCache;
+};
@@ -0,0 +1,519 @@
+// Copyright : OK
+
+#include "LifeVairDispersion.h"
+#include "LifeVairScenario.h"
+#include "LifeVairTerritoryData.h"
+#include "Async/ParallelFor.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+DEFINE_LOG_CATEGORY(LogLifeVairDispersion);
+
+DECLARE_CYCLE_STAT(TEXT("LifeVair Dispersion Advance"), STAT_LifeVairDispersionAdvance, STATGROUP_Game);
+DECLARE_CYCLE_STAT(TEXT("LifeVair Dispersion Tick"), STAT_LifeVairDispersionTick, STATGROUP_Game);
+
+namespace LifeVairDispersion
+{
+	// Rows of one layer handled by one ParallelFor task
+	static constexpr int32 RowsPerTask = 8;
+
+	// Sub steps are added until the explicit scheme keeps every coefficient positive, up to this many
+	static constexpr int32 MaxSubSteps = 16;
+
+	void StepRows(const float* RESTRICT In, float* RESTRICT Out, int32 SizeX, int32 SizeY, int32 RowStart, int32 RowEnd,
+		float DiffusionNumber, float CourantX, float CourantY, float DecayFactor)
+	{
+		// Upwind weights, one of each pair is 0 depending on the wind direction so the inner loop has no branch
+		const float WestWeight = FMath::Max(CourantX, 0.0f);
+		const float EastWeight = FMath::Min(CourantX, 0.0f);
+		const float NorthWeight = FMath::Max(CourantY, 0.0f);
+		const float SouthWeight = FMath::Min(CourantY, 0.0f);
+
+		for (int32 Y = RowStart; Y < RowEnd; ++Y)
+		{
+			// Zero gradient borders, the outer rows and columns repeat themselves
+			const float* Row = In + Y * SizeX;
+			const float* North = In + FMath::Max(Y - 1, 0) * SizeX;
+			const float* South = In + FMath::Min(Y + 1, SizeY - 1) * SizeX;
+			float* OutRow = Out + Y * SizeX;
+
+			for (int32 X = 0; X < SizeX; ++X)
+			{
+				const float Center = Row[X];
+				const float West = Row[FMath::Max(X - 1, 0)];
+				const float East = Row[FMath::Min(X + 1, SizeX - 1)];
+
+				const float Laplacian = West + East + North[X] + South[X] - 4.0f * Center;
+				const float Advection = WestWeight * (Center - West) + EastWeight * (East - Center)
+					+ NorthWeight * (Center - North[X]) + SouthWeight * (South[X] - Center);
+
+				OutRow[X] = FMath::Max(0.0f, Center + DiffusionNumber * Laplacian - Advection - DecayFactor * Center);
+			}
+		}
+	}
+
+	void RunBenchmark(const TArray<FString>& Args)
+	{
+		FLifeVairDispersionSettings Settings;
+		Settings.SizeX = Args.IsValidIndex(0) ? FCString::Atoi(*Args[0]) : 256;
+		Settings.SizeY = Args.IsValidIndex(1) ? FCString::Atoi(*Args[1]) : 256;
+		const int32 NumSteps = FMath::Max(1, Args.IsValidIndex(2) ? FCString::Atoi(*Args[2]) : 100);
+		const int32 NumLayers = FMath::Max(1, Args.IsValidIndex(3) ? FCString::Atoi(*Args[3]) : 6);
+
+		for (int32 Layer = 0; Layer < NumLayers; ++Layer)
+		{
+			Settings.Pollutants.Add(FName(TEXT("Layer"), Layer));
+		}
+
+		FLifeVairDispersionSolver Solver;
+		Solver.Init(Settings);
+		const FLifeVairDispersionSettings& Used = Solver.GetSettings();
+
+		TArray<FLifeVairDispersionSource> Sources;
+		for (int32 Layer = 0; Layer < NumLayers; ++Layer)
+		{
+			Sources.Add({ Layer, (Used.SizeY / 2) * Used.SizeX + Used.SizeX / 2, 100.0f });
+		}
+		Solver.SetSources(MoveTemp(Sources));
+
+		FLifeVairDispersionField Input;
+		Input.Init(Used.SizeX, Used.SizeY, NumLayers);
+
+		// One step first so the worker threads are awake
+		Solver.Advance(Input, 1);
+
+		const double StartTime = FPlatformTime::Seconds();
+		Solver.Advance(Input, NumSteps);
+		const double Elapsed = FPlatformTime::Seconds() - StartTime;
+
+		const double CellSteps = double(Used.SizeX) * Used.SizeY * NumLayers * NumSteps * Solver.GetSubSteps();
+		UE_LOG(LogLifeVairDispersion, Display, TEXT("Dispersion benchmark : %dx%d, %d layers, %d steps of %d sub steps : %.3f ms per step, %.1f M cell updates/s"),
+			Used.SizeX, Used.SizeY, NumLayers, NumSteps, Solver.GetSubSteps(), Elapsed * 1000.0 / NumSteps, CellSteps / FMath::Max(Elapsed, 1e-9) / 1000000.0);
+	}
+}
+
+static FAutoConsoleCommand LifeVairDispersionBenchmarkCommand(
+	TEXT("LifeVair.Dispersion.Benchmark"),
+	TEXT("Steps the dispersion solver without any world and logs its cost. Args : [SizeX=256] [SizeY=256] [Steps=100] [Layers=6]\n")
+	TEXT("Headless : UnrealEditor-Cmd LifeVair.uproject -nullrhi -ExecCmds=\"LifeVair.Dispersion.Benchmark 128 128 200, quit\""),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&LifeVairDispersion::RunBenchmark));
+
+void FLifeVairDispersionField::Init(int32 InSizeX, int32 InSizeY, int32 InNumLayers)
+{
+	SizeX = InSizeX;
+	SizeY = InSizeY;
+	NumLayers = InNumLayers;
+	Values.Reset();
+	Values.SetNumZeroed(SizeX * SizeY * NumLayers);
+}
+
+float FLifeVairDispersionField::Sample(int32 Layer, float CellX, float CellY) const
+{
+	if (Layer < 0 || Layer >= NumLayers || GetNumCells() == 0)
+	{
+		return 0.0f;
+	}
+
+	// Values sit at the cell centers
+	const float X = FMath::Clamp(CellX - 0.5f, 0.0f, float(SizeX - 1));
+	const float Y = FMath::Clamp(CellY - 0.5f, 0.0f, float(SizeY - 1));
+	const int32 X0 = FMath::FloorToInt(X);
+	const int32 Y0 = FMath::FloorToInt(Y);
+	const int32 X1 = FMath::Min(X0 + 1, SizeX - 1);
+	const int32 Y1 = FMath::Min(Y0 + 1, SizeY - 1);
+
+	const float* Data = GetLayer(Layer);
+	const float North = FMath::Lerp(Data[Y0 * SizeX + X0], Data[Y0 * SizeX + X1], X - X0);
+	const float South = FMath::Lerp(Data[Y1 * SizeX + X0], Data[Y1 * SizeX + X1], X - X0);
+	return FMath::Lerp(North, South, Y - Y0);
+}
+
+void FLifeVairDispersionSolver::Init(const FLifeVairDispersionSettings& InSettings)
+{
+	Settings = InSettings;
+	Settings.SizeX = FMath::Max(2, Settings.SizeX);
+	Settings.SizeY = FMath::Max(2, Settings.SizeY);
+	Settings.CellSize = FMath::Max(1.0f, Settings.CellSize);
+	Settings.FixedStep = FMath::Max(0.001f, Settings.FixedStep);
+
+	const int32 NumLayers = FMath::Max(1, Settings.Pollutants.Num());
+	Fields[0].Init(Settings.SizeX, Settings.SizeY, NumLayers);
+	Fields[1].Init(Settings.SizeX, Settings.SizeY, NumLayers);
+	ResultIndex = 0;
+
+	// The center weight 1 - 4D - |Cx| - |Cy| - decay has to stay positive or the explicit scheme oscillates
+	const float CellArea = Settings.CellSize * Settings.CellSize;
+	const float Stability = (4.0f * Settings.Diffusion / CellArea + (FMath::Abs(Settings.Wind.X) + FMath::Abs(Settings.Wind.Y)) / Settings.CellSize + Settings.DecayRate) * Settings.FixedStep;
+	SubSteps = FMath::Clamp(FMath::CeilToInt(Stability / 0.9f), 1, LifeVairDispersion::MaxSubSteps);
+	if (Stability / SubSteps > 1.0f)
+	{
+		UE_LOG(LogLifeVairDispersion, Warning, TEXT("Dispersion step of %.3f s is unstable with this wind and diffusion even with %d sub steps, lower FixedStep or raise CellSize"), Settings.FixedStep, SubSteps);
+	}
+
+	SubStepSeconds = Settings.FixedStep / SubSteps;
+	DiffusionNumber = Settings.Diffusion * SubStepSeconds / CellArea;
+	CourantX = Settings.Wind.X * SubStepSeconds / Settings.CellSize;
+	CourantY = Settings.Wind.Y * SubStepSeconds / Settings.CellSize;
+	DecayFactor = FMath::Min(Settings.DecayRate * SubStepSeconds, 1.0f);
+}
+
+void FLifeVairDispersionSolver::Advance(const FLifeVairDispersionField& Input, int32 NumSteps)
+{
+	SCOPE_CYCLE_COUNTER(STAT_LifeVairDispersionAdvance);
+
+	const FLifeVairDispersionField* In = &Input;
+	int32 OutIndex = 0;
+	for (int32 SubStep = 0; SubStep < NumSteps * SubSteps; ++SubStep)
+	{
+		Step(*In, Fields[OutIndex]);
+		In = &Fields[OutIndex];
+		ResultIndex = OutIndex;
+		OutIndex ^= 1;
+	}
+}
+
+void FLifeVairDispersionSolver::Step(const FLifeVairDispersionField& In, FLifeVairDispersionField& Out) const
+{
+	check(In.Values.Num() == Out.Values.Num());
+
+	const int32 SizeX = Out.SizeX;
+	const int32 SizeY = Out.SizeY;
+	const int32 TasksPerLayer = FMath::DivideAndRoundUp(SizeY, LifeVairDispersion::RowsPerTask);
+
+	// Small grids cost less on one thread than the task scheduling they would need
+	const EParallelForFlags Flags = Out.Values.Num() < Settings.ParallelCells ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None;
+
+	ParallelFor(TasksPerLayer * Out.NumLayers, [this, &In, &Out, SizeX, SizeY, TasksPerLayer](int32 Task)
+	{
+		const int32 Layer = Task / TasksPerLayer;
+		const int32 RowStart = (Task % TasksPerLayer) * LifeVairDispersion::RowsPerTask;
+		const int32 RowEnd = FMath::Min(RowStart + LifeVairDispersion::RowsPerTask, SizeY);
+
+		LifeVairDispersion::StepRows(In.GetLayer(Layer), Out.GetLayer(Layer), SizeX, SizeY, RowStart, RowEnd, DiffusionNumber, CourantX, CourantY, DecayFactor);
+	}, Flags);
+
+	for (const FLifeVairDispersionSource& Source : Sources)
+	{
+		if (Source.Layer < Out.NumLayers && Source.Cell < Out.GetNumCells())
+		{
+			Out.GetLayer(Source.Layer)[Source.Cell] += Source.Rate * SubStepSeconds;
+		}
+	}
+}
+
+ULifeVairDispersionSubsystem::ULifeVairDispersionSubsystem()
+{
+	DefaultSettings.Pollutants.Add(TEXT("NOx"));
+	DefaultSettings.Pollutants.Add(TEXT("PM10"));
+	DefaultSettings.Pollutants.Add(TEXT("PM25"));
+	DefaultSettings.Pollutants.Add(TEXT("NH3"));
+	DefaultSettings.Pollutants.Add(TEXT("SO2"));
+	DefaultSettings.Pollutants.Add(TEXT("COV"));
+}
+
+bool ULifeVairDispersionSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	if (!Super::ShouldCreateSubsystem(Outer))
+	{
+		return false;
+	}
+
+	// Editor and preview worlds don't need a simulation
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && (World->WorldType == EWorldType::Game || World->WorldType == EWorldType::PIE);
+}
+
+void ULifeVairDispersionSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const UGameInstance* GameInstance = GetWorld()->GetGameInstance();
+	if (ULifeVairTerritorySubsystem* Territories = GameInstance ? GameInstance->GetSubsystem<ULifeVairTerritorySubsystem>() : nullptr)
+	{
+		TerritoryDataRebuiltHandle = Territories->OnTerritoryDataRebuilt.AddUObject(this, &ULifeVairDispersionSubsystem::OnTerritoryDataRebuilt);
+	}
+}
+
+void ULifeVairDispersionSubsystem::Deinitialize()
+{
+	const UGameInstance* GameInstance = GetWorld()->GetGameInstance();
+	if (ULifeVairTerritorySubsystem* Territories = GameInstance ? GameInstance->GetSubsystem<ULifeVairTerritorySubsystem>() : nullptr)
+	{
+		Territories->OnTerritoryDataRebuilt.Remove(TerritoryDataRebuiltHandle);
+	}
+	TerritoryDataRebuiltHandle.Reset();
+
+	StopDispersion();
+
+	Super::Deinitialize();
+}
+
+void ULifeVairDispersionSubsystem::StartDispersion(const FLifeVairDispersionSettings& Settings)
+{
+	StopDispersion();
+
+	Solver = MakeUnique<FLifeVairDispersionSolver>();
+	Solver->Init(Settings);
+
+	const FLifeVairDispersionSettings& Used = Solver->GetSettings();
+	Published.Init(Used.SizeX, Used.SizeY, FMath::Max(1, Used.Pollutants.Num()));
+	PublishedTime = 0.0f;
+	TimeAccumulator = 0.0f;
+
+	ResolveTerritoryIndices();
+
+	for (TPair<FName, FTerritorySource>& Source : TerritorySources)
+	{
+		UpdateSourceCells(Source.Value);
+	}
+
+	UE_LOG(LogLifeVairDispersion, Log, TEXT("Started dispersion on a %dx%d grid with %d pollutants, %d sub steps per step"), Used.SizeX, Used.SizeY, Used.Pollutants.Num(), Solver->GetSubSteps());
+}
+
+void ULifeVairDispersionSubsystem::StartDispersionWithDefaults()
+{
+	StartDispersion(DefaultSettings);
+}
+
+void ULifeVairDispersionSubsystem::ResolveTerritoryIndices()
+{
+	const UGameInstance* GameInstance = GetWorld()->GetGameInstance();
+	const ULifeVairTerritorySubsystem* Territories = GameInstance ? GameInstance->GetSubsystem<ULifeVairTerritorySubsystem>() : nullptr;
+
+	// Emission metric of each layer, sources without one don't emit on that layer
+	EmissionMetrics.Reset();
+	if (Solver)
+	{
+		const FLifeVairDispersionSettings& Settings = Solver->GetSettings();
+		for (const FName& Pollutant : Settings.Pollutants)
+		{
+			const FName Metric(*FString::Format(*Settings.EmissionMetricFormat, { Pollutant.ToString() }));
+			EmissionMetrics.Add(Territories ? Territories->FindMetric(Metric) : INDEX_NONE);
+		}
+	}
+
+	for (TPair<FName, FTerritorySource>& Source : TerritorySources)
+	{
+		ResolveSourceRow(Source.Key, Source.Value);
+	}
+}
+
+void ULifeVairDispersionSubsystem::ResolveSourceRow(FName Territory, FTerritorySource& Source) const
+{
+	const UGameInstance* GameInstance = GetWorld()->GetGameInstance();
+	const ULifeVairTerritorySubsystem* Territories = GameInstance ? GameInstance->GetSubsystem<ULifeVairTerritorySubsystem>() : nullptr;
+	Source.Row = Territories ? Territories->FindTerritory(Territory) : INDEX_NONE;
+	if (Source.Row == INDEX_NONE)
+	{
+		UE_LOG(LogLifeVairDispersion, Warning, TEXT("Dispersion source %s is not a known territory, it won't emit"), *Territory.ToString());
+	}
+}
+
+void ULifeVairDispersionSubsystem::StopDispersion()
+{
+	WaitForStep();
+
+	Solver.Reset();
+	Published = FLifeVairDispersionField();
+	PublishedTime = 0.0f;
+	TimeAccumulator = 0.0f;
+}
+
+void ULifeVairDispersionSubsystem::WaitForStep()
+{
+	if (RunningSteps > 0)
+	{
+		StepTask.Wait();
+		RunningSteps = 0;
+	}
+}
+
+void ULifeVairDispersionSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_LifeVairDispersionTick);
+
+	Super::Tick(DeltaTime);
+
+	if (!Solver)
+	{
+		return;
+	}
+
+	TimeAccumulator += DeltaTime;
+
+	if (RunningSteps > 0)
+	{
+		// Never wait on the solver, the field being sampled stays the previous one until it is done
+		if (!StepTask.IsCompleted())
+		{
+			return;
+		}
+
+		Swap(Published.Values, Solver->GetResult().Values);
+		PublishedTime += RunningSteps * Solver->GetSettings().FixedStep;
+		RunningSteps = 0;
+	}
+
+	const FLifeVairDispersionSettings& Settings = Solver->GetSettings();
+	int32 NumSteps = FMath::FloorToInt(TimeAccumulator / Settings.FixedStep);
+	if (NumSteps > Settings.MaxStepsPerFrame)
+	{
+		// Drop the backlog instead of catching up, the smog slows down on a loaded frame rather than the frame
+		NumSteps = Settings.MaxStepsPerFrame;
+		TimeAccumulator = 0.0f;
+	}
+	else
+	{
+		TimeAccumulator -= NumSteps * Settings.FixedStep;
+	}
+
+	if (NumSteps == 0)
+	{
+		return;
+	}
+
+	Solver->SetSources(GatherSources());
+	RunningSteps = NumSteps;
+
+	FLifeVairDispersionSolver* SolverPtr = Solver.Get();
+	const FLifeVairDispersionField* Input = &Published;
+	StepTask = UE::Tasks::Launch(TEXT("LifeVairDispersionStep"), [SolverPtr, Input, NumSteps]()
+	{
+		SolverPtr->Advance(*Input, NumSteps);
+	});
+}
+
+TStatId ULifeVairDispersionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULifeVairDispersionSubsystem, STATGROUP_Tickables);
+}
+
+void ULifeVairDispersionSubsystem::SetTerritorySource(FName Territory, FVector Location, float Radius)
+{
+	FTerritorySource& Source = TerritorySources.FindOrAdd(Territory);
+	Source.Location = Location;
+	Source.Radius = Radius;
+
+	ResolveSourceRow(Territory, Source);
+	UpdateSourceCells(Source);
+}
+
+void ULifeVairDispersionSubsystem::RemoveTerritorySource(FName Territory)
+{
+	TerritorySources.Remove(Territory);
+}
+
+void ULifeVairDispersionSubsystem::UpdateSourceCells(FTerritorySource& Source) const
+{
+	Source.Cells.Reset();
+	if (!Solver)
+	{
+		return;
+	}
+
+	const FLifeVairDispersionSettings& Settings = Solver->GetSettings();
+	const FVector2D Center = WorldToCell(Source.Location);
+	const float RadiusCells = FMath::Max(Source.Radius / Settings.CellSize, 0.5f);
+
+	const int32 MinX = FMath::Max(0, FMath::FloorToInt(Center.X - RadiusCells));
+	const int32 MaxX = FMath::Min(Settings.SizeX - 1, FMath::FloorToInt(Center.X + RadiusCells));
+	const int32 MinY = FMath::Max(0, FMath::FloorToInt(Center.Y - RadiusCells));
+	const int32 MaxY = FMath::Min(Settings.SizeY - 1, FMath::FloorToInt(Center.Y + RadiusCells));
+
+	for (int32 Y = MinY; Y <= MaxY; ++Y)
+	{
+		for (int32 X = MinX; X <= MaxX; ++X)
+		{
+			if (FVector2D::DistSquared(FVector2D(X + 0.5f, Y + 0.5f), Center) <= RadiusCells * RadiusCells)
+			{
+				Source.Cells.Add(Y * Settings.SizeX + X);
+			}
+		}
+	}
+
+	// A small radius still emits in the cell it is in
+	const int32 CenterX = FMath::FloorToInt(Center.X);
+	const int32 CenterY = FMath::FloorToInt(Center.Y);
+	if (Source.Cells.Num() == 0 && CenterX >= 0 && CenterX < Settings.SizeX && CenterY >= 0 && CenterY < Settings.SizeY)
+	{
+		Source.Cells.Add(CenterY * Settings.SizeX + CenterX);
+	}
+}
+
+TArray<FLifeVairDispersionSource> ULifeVairDispersionSubsystem::GatherSources() const
+{
+	TArray<FLifeVairDispersionSource> Sources;
+
+	const UGameInstance* GameInstance = GetWorld()->GetGameInstance();
+	const ULifeVairScenarioSubsystem* Scenario = GameInstance ? GameInstance->GetSubsystem<ULifeVairScenarioSubsystem>() : nullptr;
+	if (!Scenario)
+	{
+		return Sources;
+	}
+
+	// Emissions come from the scenario so the smog follows the actions the player enabled
+	const float EmissionScale = Solver->GetSettings().EmissionScale;
+	for (const TPair<FName, FTerritorySource>& Source : TerritorySources)
+	{
+		if (Source.Value.Row == INDEX_NONE || Source.Value.Cells.Num() == 0)
+		{
+			continue;
+		}
+
+		for (int32 Layer = 0; Layer < EmissionMetrics.Num(); ++Layer)
+		{
+			if (EmissionMetrics[Layer] == INDEX_NONE)
+			{
+				continue;
+			}
+
+			const float Rate = float(Scenario->GetScenarioMetricValue(Source.Value.Row, EmissionMetrics[Layer])) * EmissionScale / Source.Value.Cells.Num();
+			for (const int32 Cell : Source.Value.Cells)
+			{
+				Sources.Add({ Layer, Cell, Rate });
+			}
+		}
+	}
+	return Sources;
+}
+
+FVector2D ULifeVairDispersionSubsystem::WorldToCell(const FVector& Location) const
+{
+	if (!Solver)
+	{
+		return FVector2D::ZeroVector;
+	}
+
+	const FLifeVairDispersionSettings& Settings = Solver->GetSettings();
+	return FVector2D((Location.X - Settings.Origin.X) / Settings.CellSize, (Location.Y - Settings.Origin.Y) / Settings.CellSize);
+}
+
+float ULifeVairDispersionSubsystem::SampleConcentration(FVector Location, FName Pollutant) const
+{
+	if (!Solver)
+	{
+		return 0.0f;
+	}
+
+	const int32 Layer = Solver->GetSettings().Pollutants.IndexOfByKey(Pollutant);
+	const FVector2D Cell = WorldToCell(Location);
+	return Published.Sample(Layer, Cell.X, Cell.Y);
+}
+
+float ULifeVairDispersionSubsystem::SampleTotalConcentration(FVector Location) const
+{
+	if (!Solver)
+	{
+		return 0.0f;
+	}
+
+	const FVector2D Cell = WorldToCell(Location);
+	float Total = 0.0f;
+	for (int32 Layer = 0; Layer < Published.NumLayers; ++Layer)
+	{
+		Total += Published.Sample(Layer, Cell.X, Cell.Y);
+	}
+	return Total;
+}
@@ -0,0 +1,231 @@
+// Copyright : OK
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tasks/Task.h"
+#include "LifeVairDispersion.generated.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogLifeVairDispersion, Log, All);
+
+/*Grid and physics of the pollutant dispersion simulation. Keep the grid small on the headset, desktop can afford larger ones*/
+USTRUCT(BlueprintType)
+struct LIFEVAIR_API FLifeVairDispersionSettings
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LifeVair Dispersion", meta = (ClampMin = "2"))
+	int32 SizeX = 64;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LifeVair Dispersion", meta = (ClampMin = "2"))
+	int32 SizeY = 64;
+
+	/*World size of a cell in cm*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LifeVair Dispersion", meta = (ClampMin = "1.0"))
+	float CellSize = 5000.0f;
+
+	/*World XY of the corner of cell (0, 0)*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LifeVair Dispersion")
+	FVector2D Origin = FVector2D::ZeroVector;
+
+	/*One grid layer per pollutant, matched to the emission metrics through EmissionMetricFormat*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LifeVair Dispersion")
+	TArray<FName> Pollutants;
+
+	/*Emission metric of a pollutant, {0} is replaced by its name*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LifeVair Dispersion")
+	FString EmissionMetricFormat = TEXT("Emi_{0}_Immersion");
+
+	/*Concentration added per second per unit of the emission metric*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LifeVair Dispersion")
+	float EmissionScale = 1.0f;
+
+	/*Wind in cm/s*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LifeVair Dispersion")
+	FVector2D Wind = FVector2D(300.0f, 0.0f);
+
+	/*Diffusion coefficient in cm²/s*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LifeVair Dispersion", meta = (ClampMin = "0.0"))
+	float Diffusion = 1000000.0f;
+
+	/*Fraction of the concentration removed per second (deposition, chemistry)*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LifeVair Dispersion", meta = (ClampMin = "0.0"))
+	float DecayRate = 0.01f;
+
+	/*Simulated seconds per step, the solver splits it further when wind or diffusion would make it unstable*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LifeVair Dispersion", meta = (ClampMin = "0.001"))
+	float FixedStep = 0.2f;
+
+	/*Steps run for one frame at most, the simulation slows down rather than taking more CPU*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LifeVair Dispersion", meta = (ClampMin = "1"))
+	int32 MaxStepsPerFrame = 2;
+
+	/*Grids with fewer cells (times layers) than this are stepped on a single worker instead of being split over ParallelFor*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LifeVair Dispersion", meta = (ClampMin = "0"))
+	int32 ParallelCells = 32768;
+};
+
+/*Concentrations of every pollutant, layer major then row major so a layer row is contiguous*/
+struct LIFEVAIR_API FLifeVairDispersionField
+{
+	int32 SizeX = 0;
+	int32 SizeY = 0;
+	int32 NumLayers = 0;
+	TArray<float> Values;
+
+	void Init(int32 InSizeX, int32 InSizeY, int32 InNumLayers);
+
+	int32 GetNumCells() const { return SizeX * SizeY; }
+
+	const float* GetLayer(int32 Layer) const { return Values.GetData() + Layer * GetNumCells(); }
+	float* GetLayer(int32 Layer) { return Values.GetData() + Layer * GetNumCells(); }
+
+	/*Bilinear sample at a position in cell units, clamped to the grid*/
+	float Sample(int32 Layer, float CellX, float CellY) const;
+};
+
+/*Emission of one cell of one layer, in concentration per second*/
+struct FLifeVairDispersionSource
+{
+	int32 Layer;
+	int32 Cell;
+	float Rate;
+};
+
+/*
+ * Explicit advection-diffusion solver: upwind advection, 5 point diffusion, decay and point sources, with zero gradient borders.
+ * Owns its two ping-pong fields, the input field is only read so it can be the one the game is sampling.
+ */
+class LIFEVAIR_API FLifeVairDispersionSolver
+{
+public:
+	void Init(const FLifeVairDispersionSettings& InSettings);
+
+	const FLifeVairDispersionSettings& GetSettings() const { return Settings; }
+
+	void SetSources(TArray<FLifeVairDispersionSource>&& InSources) { Sources = MoveTemp(InSources); }
+
+	/*Runs NumSteps fixed steps starting from Input, the result is GetResult()*/
+	void Advance(const FLifeVairDispersionField& Input, int32 NumSteps);
+
+	FLifeVairDispersionField& GetResult() { return Fields[ResultIndex]; }
+
+	int32 GetSubSteps() const { return SubSteps; }
+
+private:
+	void Step(const FLifeVairDispersionField& In, FLifeVairDispersionField& Out) const;
+
+	FLifeVairDispersionSettings Settings;
+	TArray<FLifeVairDispersionSource> Sources;
+	FLifeVairDispersionField Fields[2];
+	int32 ResultIndex = 0;
+
+	// Per sub step coefficients, computed once from the settings
+	int32 SubSteps = 1;
+	float SubStepSeconds = 0.0f;
+	float DiffusionNumber = 0.0f;
+	float CourantX = 0.0f;
+	float CourantY = 0.0f;
+	float DecayFactor = 0.0f;
+};
+
+/*
+ * Runs the dispersion simulation of a game world. Fixed steps are run on a background task while the frame goes on,
+ * the finished field is swapped in on the next tick. Sampling reads the published field, which the solver only ever reads,
+ * so it never waits on the simulation and takes no lock.
+ * Territory sources emit the scenario value of their emission metrics, so enabled actions show up in the smog.
+ */
+UCLASS(Config = Game)
+class LIFEVAIR_API ULifeVairDispersionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	ULifeVairDispersionSubsystem();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/*Settings used by StartDispersionWithDefaults, override them per platform in the platform Game ini*/
+	UPROPERTY(Config, EditAnywhere, Category = "LifeVair Dispersion")
+	FLifeVairDispersionSettings DefaultSettings;
+
+	UFUNCTION(BlueprintCallable, Category = "LifeVair Dispersion")
+	void StartDispersion(const FLifeVairDispersionSettings& Settings);
+
+	UFUNCTION(BlueprintCallable, Category = "LifeVair Dispersion")
+	void StartDispersionWithDefaults();
+
+	/*Stops and clears the simulation, waits for the running step*/
+	UFUNCTION(BlueprintCallable, Category = "LifeVair Dispersion")
+	void StopDispersion();
+
+	UFUNCTION(BlueprintPure, Category = "LifeVair Dispersion")
+	bool IsDispersionRunning() const { return Solver.IsValid(); }
+
+	/*Makes a territory emit at Location, spread over the cells within Radius (cm)*/
+	UFUNCTION(BlueprintCallable, Category = "LifeVair Dispersion")
+	void SetTerritorySource(FName Territory, FVector Location, float Radius = 0.0f);
+
+	UFUNCTION(BlueprintCallable, Category = "LifeVair Dispersion")
+	void RemoveTerritorySource(FName Territory);
+
+	/*Concentration at a world location, bilinear between cells. Height is ignored*/
+	UFUNCTION(BlueprintPure, Category = "LifeVair Dispersion")
+	float SampleConcentration(FVector Location, FName Pollutant) const;
+
+	/*Sum of every pollutant at a world location*/
+	UFUNCTION(BlueprintPure, Category = "LifeVair Dispersion")
+	float SampleTotalConcentration(FVector Location) const;
+
+	/*Simulated seconds of the published field*/
+	UFUNCTION(BlueprintPure, Category = "LifeVair Dispersion")
+	float GetSimulationTime() const { return PublishedTime; }
+
+	/*Native access to the published field, valid until the next tick*/
+	const FLifeVairDispersionField& GetField() const { return Published; }
+
+	/*World position to cell units of the current grid*/
+	FVector2D WorldToCell(const FVector& Location) const;
+
+private:
+	struct FTerritorySource
+	{
+		int32 Row = INDEX_NONE;
+		FVector Location = FVector::ZeroVector;
+		float Radius = 0.0f;
+
+		// Grid cells the emission is spread over, recomputed when the grid changes
+		TArray<int32> Cells;
+	};
+
+	// Looks up the emission metrics and the source rows again, they change with the territory data
+	void ResolveTerritoryIndices();
+	void ResolveSourceRow(FName Territory, FTerritorySource& Source) const;
+	void OnTerritoryDataRebuilt() { ResolveTerritoryIndices(); }
+
+	void UpdateSourceCells(FTerritorySource& Source) const;
+	TArray<FLifeVairDispersionSource> GatherSources() const;
+	void WaitForStep();
+
+	TUniquePtr<FLifeVairDispersionSolver> Solver;
+	UE::Tasks::FTask StepTask;
+	int32 RunningSteps = 0;
+
+	// Game thread only, the solver reads it while it runs and it is only swapped once the step is done
+	FLifeVairDispersionField Published;
+	float PublishedTime = 0.0f;
+	float TimeAccumulator = 0.0f;
+
+	TMap<FName, FTerritorySource> TerritorySources;
+
+	// Emission metric column of each layer
+	TArray<int32> EmissionMetrics;
+
+	FDelegateHandle TerritoryDataRebuiltHandle;
+};
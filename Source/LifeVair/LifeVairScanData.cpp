@@ -0,0 +1,319 @@
+// Copyright : OK
+
+#include "LifeVairScanData.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/AssetManager.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/Texture2D.h"
+#include "GameFramework/PlayerController.h"
+#include "Internationalization/StringTable.h"
+#include "TimerManager.h"
+
+DEFINE_LOG_CATEGORY(LogLifeVairScanData);
+
+DECLARE_MEMORY_STAT(TEXT("LifeVair Scan Data Cache"), STAT_LifeVairScanDataCache, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("LifeVair Scan Data Cached Entries"), STAT_LifeVairScanDataEntries, STATGROUP_Game);
+
+void ULifeVairScanDataSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	BuildIndex();
+
+	GetGameInstance()->GetTimerManager().SetTimer(PrefetchTimer, FTimerDelegate::CreateUObject(this, &ULifeVairScanDataSubsystem::PrefetchNearPlayer), PrefetchInterval, true);
+}
+
+void ULifeVairScanDataSubsystem::Deinitialize()
+{
+	GetGameInstance()->GetTimerManager().ClearTimer(PrefetchTimer);
+
+	FlushScanDataCache();
+	Entries.Reset();
+	EntryById.Reset();
+	Scannables.Reset();
+
+	Super::Deinitialize();
+}
+
+ULifeVairScanDataSubsystem* ULifeVairScanDataSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<ULifeVairScanDataSubsystem>() : nullptr;
+}
+
+void ULifeVairScanDataSubsystem::BuildIndex()
+{
+	Entries.Reset();
+	EntryById.Reset();
+
+	// Only soft references and display names, cheap to keep loaded for the whole game
+	const UDataTable* Table = ScanDataTable.LoadSynchronous();
+	if (!Table)
+	{
+		UE_LOG(LogLifeVairScanData, Warning, TEXT("No scan data table at %s, scans won't find any data"), *ScanDataTable.ToString());
+		return;
+	}
+
+	if (!Table->GetRowStruct() || !Table->GetRowStruct()->IsChildOf(FLifeVairScanDataRow::StaticStruct()))
+	{
+		UE_LOG(LogLifeVairScanData, Error, TEXT("Scan data table %s doesn't use FLifeVairScanDataRow"), *Table->GetPathName());
+		return;
+	}
+
+	Entries.Reserve(Table->GetRowMap().Num());
+	for (const TPair<FName, uint8*>& Row : Table->GetRowMap())
+	{
+		const FLifeVairScanDataRow& Data = *reinterpret_cast<const FLifeVairScanDataRow*>(Row.Value);
+
+		FEntry& Entry = Entries.AddDefaulted_GetRef();
+		Entry.ScanId = Row.Key;
+		Entry.DisplayName = Data.DisplayName;
+		Entry.DescriptionTable = Data.DescriptionTable.IsNull() ? DefaultDescriptionTable : Data.DescriptionTable;
+		Entry.DescriptionKey = Data.DescriptionKey.IsEmpty() ? Row.Key.ToString() : Data.DescriptionKey;
+		Entry.Picture = Data.Picture;
+		EntryById.Add(Row.Key, Entries.Num() - 1);
+	}
+
+	UE_LOG(LogLifeVairScanData, Log, TEXT("Indexed %d scan entries from %s"), Entries.Num(), *Table->GetPathName());
+}
+
+bool ULifeVairScanDataSubsystem::GetScanData(FName ScanId, FLifeVairScanData& OutScanData)
+{
+	OutScanData = FLifeVairScanData();
+	OutScanData.ScanId = ScanId;
+
+	const int32* EntryIndex = EntryById.Find(ScanId);
+	if (!EntryIndex)
+	{
+		UE_LOG(LogLifeVairScanData, Warning, TEXT("No scan data for %s"), *ScanId.ToString());
+		return false;
+	}
+
+	// Payloads already in memory complete the request right away, so this can fill them in the same frame
+	RequestEntry(*EntryIndex, FStreamableManager::AsyncLoadHighPriority);
+
+	const FEntry& Entry = Entries[*EntryIndex];
+	OutScanData.DisplayName = Entry.DisplayName;
+	if (IsEntryLoaded(Entry))
+	{
+		TouchEntry(*EntryIndex);
+
+		if (const UStringTable* DescriptionTable = Entry.DescriptionTable.Get())
+		{
+			OutScanData.Description = FText::FromStringTable(DescriptionTable->GetStringTableId(), Entry.DescriptionKey);
+		}
+		OutScanData.Picture = Entry.Picture.Get();
+		OutScanData.bIsComplete = true;
+	}
+	return true;
+}
+
+void ULifeVairScanDataSubsystem::PrefetchScanData(FName ScanId)
+{
+	if (const int32* EntryIndex = EntryById.Find(ScanId))
+	{
+		RequestEntry(*EntryIndex, FStreamableManager::DefaultAsyncLoadPriority);
+	}
+}
+
+void ULifeVairScanDataSubsystem::RequestEntry(int32 EntryIndex, TAsyncLoadPriority Priority)
+{
+	FEntry& Entry = Entries[EntryIndex];
+	if (IsEntryLoaded(Entry))
+	{
+		return;
+	}
+
+	// Already streaming, OnScanDataReady tells when it is done
+	if (Entry.Handle.IsValid())
+	{
+		return;
+	}
+
+	TArray<FSoftObjectPath> Paths;
+	if (!Entry.DescriptionTable.IsNull())
+	{
+		Paths.Add(Entry.DescriptionTable.ToSoftObjectPath());
+	}
+	if (!Entry.Picture.IsNull())
+	{
+		Paths.Add(Entry.Picture.ToSoftObjectPath());
+	}
+
+	if (Paths.Num() == 0)
+	{
+		OnEntryLoaded(EntryIndex);
+		return;
+	}
+
+	Entry.Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(MoveTemp(Paths),
+		FStreamableDelegate::CreateUObject(this, &ULifeVairScanDataSubsystem::OnEntryLoaded, EntryIndex), Priority);
+
+	// The callback may already have run before the handle was stored
+	if (Entry.Handle.IsValid() && Entry.Handle->HasLoadCompleted())
+	{
+		OnEntryLoaded(EntryIndex);
+	}
+}
+
+void ULifeVairScanDataSubsystem::OnEntryLoaded(int32 EntryIndex)
+{
+	if (!Entries.IsValidIndex(EntryIndex))
+	{
+		return;
+	}
+
+	FEntry& Entry = Entries[EntryIndex];
+	if (IsEntryLoaded(Entry))
+	{
+		return;
+	}
+
+	// Estimated from what the entry keeps resident, shared assets are counted by every entry using them
+	Entry.CachedBytes = 0;
+	if (UTexture2D* Picture = Entry.Picture.Get())
+	{
+		Entry.CachedBytes += Picture->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+	}
+	if (const UStringTable* DescriptionTable = Entry.DescriptionTable.Get())
+	{
+		Entry.CachedBytes += FText::FromStringTable(DescriptionTable->GetStringTableId(), Entry.DescriptionKey).ToString().GetAllocatedSize();
+	}
+
+	Lru.AddHead(EntryIndex);
+	Entry.LruNode = Lru.GetHead();
+	CachedBytes += Entry.CachedBytes;
+
+	TrimCache(EntryIndex);
+
+	SET_MEMORY_STAT(STAT_LifeVairScanDataCache, CachedBytes);
+	SET_DWORD_STAT(STAT_LifeVairScanDataEntries, Lru.Num());
+
+	OnScanDataReady.Broadcast(Entry.ScanId);
+}
+
+void ULifeVairScanDataSubsystem::TouchEntry(int32 EntryIndex)
+{
+	FEntry& Entry = Entries[EntryIndex];
+	if (Entry.LruNode && Entry.LruNode != Lru.GetHead())
+	{
+		Lru.RemoveNode(Entry.LruNode, false);
+		Lru.AddHead(Entry.LruNode);
+	}
+}
+
+void ULifeVairScanDataSubsystem::TrimCache(int32 KeptEntryIndex)
+{
+	const int64 MaxBytes = int64(MaxCacheMegabytes) * 1024 * 1024;
+	while (CachedBytes > MaxBytes && Lru.Num() > 0)
+	{
+		// The entry just loaded stays, even alone over the budget
+		const int32 LeastRecent = Lru.GetTail()->GetValue();
+		if (LeastRecent == KeptEntryIndex)
+		{
+			break;
+		}
+		ReleaseEntry(LeastRecent);
+	}
+}
+
+void ULifeVairScanDataSubsystem::ReleaseEntry(int32 EntryIndex)
+{
+	FEntry& Entry = Entries[EntryIndex];
+	if (Entry.LruNode)
+	{
+		Lru.RemoveNode(Entry.LruNode);
+		Entry.LruNode = nullptr;
+		CachedBytes -= Entry.CachedBytes;
+		Entry.CachedBytes = 0;
+	}
+
+	if (Entry.Handle.IsValid())
+	{
+		// Memory comes back at the next garbage collection, once no other handle or scan result holds the assets
+		if (Entry.Handle->IsLoadingInProgress())
+		{
+			Entry.Handle->CancelHandle();
+		}
+		else
+		{
+			Entry.Handle->ReleaseHandle();
+		}
+		Entry.Handle.Reset();
+	}
+
+	SET_MEMORY_STAT(STAT_LifeVairScanDataCache, CachedBytes);
+	SET_DWORD_STAT(STAT_LifeVairScanDataEntries, Lru.Num());
+}
+
+void ULifeVairScanDataSubsystem::FlushScanDataCache()
+{
+	for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); ++EntryIndex)
+	{
+		ReleaseEntry(EntryIndex);
+	}
+}
+
+void ULifeVairScanDataSubsystem::RegisterScannable(USceneComponent* Scannable, FName ScanId)
+{
+	const int32* EntryIndex = EntryById.Find(ScanId);
+	if (!Scannable || !EntryIndex)
+	{
+		return;
+	}
+
+	UnregisterScannable(Scannable);
+	Scannables.Emplace(Scannable, *EntryIndex);
+}
+
+void ULifeVairScanDataSubsystem::UnregisterScannable(USceneComponent* Scannable)
+{
+	Scannables.RemoveAllSwap([Scannable](const TPair<TWeakObjectPtr<USceneComponent>, int32>& Registered)
+	{
+		return Registered.Key.Get() == Scannable;
+	});
+}
+
+void ULifeVairScanDataSubsystem::PrefetchNearPlayer()
+{
+	const APlayerController* PlayerController = GetGameInstance()->GetFirstLocalPlayerController();
+	if (!PlayerController || !PlayerController->PlayerCameraManager || Scannables.Num() == 0)
+	{
+		return;
+	}
+
+	const FVector ViewLocation = PlayerController->PlayerCameraManager->GetCameraLocation();
+	const float RadiusSquared = PrefetchRadius * PrefetchRadius;
+
+	// Entries neither loaded nor streaming, by distance
+	TArray<TPair<float, int32>, TInlineAllocator<16>> Candidates;
+	for (int32 Index = Scannables.Num() - 1; Index >= 0; --Index)
+	{
+		const USceneComponent* Scannable = Scannables[Index].Key.Get();
+		if (!Scannable)
+		{
+			Scannables.RemoveAtSwap(Index);
+			continue;
+		}
+
+		const FEntry& Entry = Entries[Scannables[Index].Value];
+		const float DistanceSquared = FVector::DistSquared(Scannable->GetComponentLocation(), ViewLocation);
+		if (DistanceSquared <= RadiusSquared && !IsEntryLoaded(Entry) && !Entry.Handle.IsValid())
+		{
+			Candidates.Emplace(DistanceSquared, Scannables[Index].Value);
+		}
+	}
+
+	Candidates.Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key < B.Key; });
+	for (int32 Index = 0, Requested = 0; Index < Candidates.Num() && Requested < MaxPrefetchPerPass; ++Index)
+	{
+		// Several scannables can share an entry
+		if (!Entries[Candidates[Index].Value].Handle.IsValid() && !IsEntryLoaded(Entries[Candidates[Index].Value]))
+		{
+			RequestEntry(Candidates[Index].Value, FStreamableManager::DefaultAsyncLoadPriority);
+			++Requested;
+		}
+	}
+}
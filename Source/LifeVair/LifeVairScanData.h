@@ -0,0 +1,165 @@
+// Copyright : OK
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/List.h"
+#include "Engine/DataTable.h"
+#include "Engine/EngineTypes.h"
+#include "Engine/StreamableManager.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "LifeVairScanData.generated.h"
+
+class UStringTable;
+class UTexture2D;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogLifeVairScanData, Log, All);
+
+/*A scan entry of the scan data table, the row name is the scan ID. Payloads are soft so only the index stays loaded*/
+USTRUCT(BlueprintType)
+struct LIFEVAIR_API FLifeVairScanDataRow : public FTableRowBase
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "LifeVair Scan Data")
+	FText DisplayName;
+
+	/*String table of the description, the default description table when None*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "LifeVair Scan Data")
+	TSoftObjectPtr<UStringTable> DescriptionTable;
+
+	/*Key of the description in its table, the scan ID when empty*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "LifeVair Scan Data")
+	FString DescriptionKey;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "LifeVair Scan Data")
+	TSoftObjectPtr<UTexture2D> Picture;
+};
+
+/*What a scan shows, payloads are empty until they are streamed in*/
+USTRUCT(BlueprintType)
+struct LIFEVAIR_API FLifeVairScanData
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "LifeVair Scan Data")
+	FName ScanId;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LifeVair Scan Data")
+	FText DisplayName;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LifeVair Scan Data")
+	FText Description;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LifeVair Scan Data")
+	TObjectPtr<UTexture2D> Picture = nullptr;
+
+	/*Every payload is loaded, otherwise OnScanDataReady is called once they are*/
+	UPROPERTY(BlueprintReadOnly, Category = "LifeVair Scan Data")
+	bool bIsComplete = false;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FLifeVairScanDataReadySignature, FName, ScanId);
+
+/*
+ * Scan data of the scannables. The scan data table is indexed at load, the description and picture of an entry are streamed
+ * asynchronously the first time it is scanned or comes near the player, and kept in an LRU cache bounded by MaxCacheMegabytes.
+ * Scannables register themselves so their entries are prefetched before they are scanned.
+ */
+UCLASS(Config = Game)
+class LIFEVAIR_API ULifeVairScanDataSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	static ULifeVairScanDataSubsystem* Get(const UObject* WorldContextObject);
+
+	/*Table of FLifeVairScanDataRow, loaded with the game instance*/
+	UPROPERTY(Config, EditAnywhere, Category = "LifeVair Scan Data")
+	TSoftObjectPtr<UDataTable> ScanDataTable;
+
+	UPROPERTY(Config, EditAnywhere, Category = "LifeVair Scan Data")
+	TSoftObjectPtr<UStringTable> DefaultDescriptionTable = TSoftObjectPtr<UStringTable>(FSoftObjectPath(TEXT("/Game/Core/Data/ScanData/ST_ScannableComponentDescription.ST_ScannableComponentDescription")));
+
+	/*Estimated memory of the cached payloads, the least recently scanned are released past it*/
+	UPROPERTY(Config, EditAnywhere, Category = "LifeVair Scan Data", meta = (ClampMin = "1"))
+	int32 MaxCacheMegabytes = 64;
+
+	/*Registered scannables closer than this to the player camera get their entry streamed in (cm)*/
+	UPROPERTY(Config, EditAnywhere, Category = "LifeVair Scan Data", meta = (ClampMin = "0.0"))
+	float PrefetchRadius = 600.0f;
+
+	UPROPERTY(Config, EditAnywhere, Category = "LifeVair Scan Data", meta = (ClampMin = "0.05"))
+	float PrefetchInterval = 0.5f;
+
+	/*Entries requested by one prefetch pass at most, the closest first*/
+	UPROPERTY(Config, EditAnywhere, Category = "LifeVair Scan Data", meta = (ClampMin = "1"))
+	int32 MaxPrefetchPerPass = 4;
+
+	/*Called when the payloads of an entry finished streaming in*/
+	UPROPERTY(BlueprintAssignable, Category = "LifeVair Scan Data")
+	FLifeVairScanDataReadySignature OnScanDataReady;
+
+	UFUNCTION(BlueprintPure, Category = "LifeVair Scan Data")
+	bool HasScanData(FName ScanId) const { return EntryById.Contains(ScanId); }
+
+	/*Returns what is loaded right away and streams the rest at high priority, false for an unknown ID*/
+	UFUNCTION(BlueprintCallable, Category = "LifeVair Scan Data")
+	bool GetScanData(FName ScanId, FLifeVairScanData& OutScanData);
+
+	/*Starts streaming an entry without scanning it*/
+	UFUNCTION(BlueprintCallable, Category = "LifeVair Scan Data")
+	void PrefetchScanData(FName ScanId);
+
+	/*Makes a scannable prefetch its entry when the player comes near it*/
+	UFUNCTION(BlueprintCallable, Category = "LifeVair Scan Data")
+	void RegisterScannable(USceneComponent* Scannable, FName ScanId);
+
+	UFUNCTION(BlueprintCallable, Category = "LifeVair Scan Data")
+	void UnregisterScannable(USceneComponent* Scannable);
+
+	/*Releases every cached payload*/
+	UFUNCTION(BlueprintCallable, Category = "LifeVair Scan Data")
+	void FlushScanDataCache();
+
+	UFUNCTION(BlueprintPure, Category = "LifeVair Scan Data")
+	int64 GetCachedBytes() const { return CachedBytes; }
+
+private:
+	struct FEntry
+	{
+		FName ScanId;
+		FText DisplayName;
+		TSoftObjectPtr<UStringTable> DescriptionTable;
+		FString DescriptionKey;
+		TSoftObjectPtr<UTexture2D> Picture;
+
+		TSharedPtr<FStreamableHandle> Handle;
+		int64 CachedBytes = 0;
+
+		// Position in Lru once loaded, null while not loaded or streaming
+		TDoubleLinkedList<int32>::TDoubleLinkedListNode* LruNode = nullptr;
+	};
+
+	void BuildIndex();
+	void RequestEntry(int32 EntryIndex, TAsyncLoadPriority Priority);
+	void OnEntryLoaded(int32 EntryIndex);
+	void ReleaseEntry(int32 EntryIndex);
+	void TouchEntry(int32 EntryIndex);
+	void TrimCache(int32 KeptEntryIndex);
+	bool IsEntryLoaded(const FEntry& Entry) const { return Entry.LruNode != nullptr; }
+	void PrefetchNearPlayer();
+
+	TArray<FEntry> Entries;
+	TMap<FName, int32> EntryById;
+
+	// Loaded entries, most recently used at the head
+	TDoubleLinkedList<int32> Lru;
+	int64 CachedBytes = 0;
+
+	TArray<TPair<TWeakObjectPtr<USceneComponent>, int32>> Scannables;
+	FTimerHandle PrefetchTimer;
+};
@@ -0,0 +1,513 @@
+// Copyright : OK
+
+#include "LifeVairScenario.h"
+#include "LifeVairTerritoryData.h"
+#include "LifeVairTerritoryAggregation.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+
+DEFINE_LOG_CATEGORY(LogLifeVairScenario);
+
+DECLARE_CYCLE_STAT(TEXT("LifeVair Scenario Apply Action"), STAT_LifeVairScenarioApplyAction, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("LifeVair Scenario Recomputed Indicators"), STAT_LifeVairScenarioRecomputedIndicators, STATGROUP_Game);
+
+void ULifeVairScenarioSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Base values come from the territory columns
+	ULifeVairTerritorySubsystem* Territories = Collection.InitializeDependency<ULifeVairTerritorySubsystem>();
+	if (Territories)
+	{
+		TerritoryDataRebuiltHandle = Territories->OnTerritoryDataRebuilt.AddUObject(this, &ULifeVairScenarioSubsystem::OnTerritoryDataRebuilt);
+	}
+
+	ResetScenario();
+}
+
+void ULifeVairScenarioSubsystem::Deinitialize()
+{
+	if (ULifeVairTerritorySubsystem* Territories = GetGameInstance()->GetSubsystem<ULifeVairTerritorySubsystem>())
+	{
+		Territories->OnTerritoryDataRebuilt.Remove(TerritoryDataRebuiltHandle);
+	}
+	TerritoryDataRebuiltHandle.Reset();
+
+	Actions.Reset();
+	ActionByName.Reset();
+	Indicators.Reset();
+	IndicatorByName.Reset();
+	ScenarioMetrics.Reset();
+	CellContributions.Reset();
+	UndoStack.Reset();
+	RedoStack.Reset();
+
+	Super::Deinitialize();
+}
+
+ULifeVairScenarioSubsystem* ULifeVairScenarioSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<ULifeVairScenarioSubsystem>() : nullptr;
+}
+
+const FLifeVairTerritoryColumns* ULifeVairScenarioSubsystem::GetTerritoryColumns() const
+{
+	const ULifeVairTerritorySubsystem* Territories = GetGameInstance()->GetSubsystem<ULifeVairTerritorySubsystem>();
+	return Territories && Territories->IsTerritoryDataReady() ? &Territories->GetColumns() : nullptr;
+}
+
+bool ULifeVairScenarioSubsystem::RegisterAction(const FLifeVairScenarioAction& Action)
+{
+	if (Action.Action.IsNone())
+	{
+		return false;
+	}
+
+	TArray<FName> ChangedIndicators;
+
+	int32 ActionIndex = INDEX_NONE;
+	bool bWasEnabled = false;
+	if (const int32* Existing = ActionByName.Find(Action.Action))
+	{
+		// Take the old deltas out of the scenario before replacing them
+		ActionIndex = *Existing;
+		bWasEnabled = Actions[ActionIndex].bEnabled;
+		ApplyActionState(ActionIndex, false, ChangedIndicators);
+		RemoveContributions(ActionIndex);
+	}
+	else
+	{
+		ActionIndex = Actions.AddDefaulted();
+		ActionByName.Add(Action.Action, ActionIndex);
+	}
+
+	FCompiledAction& CompiledAction = Actions[ActionIndex];
+	CompiledAction.Definition = Action;
+	CompileAction(CompiledAction);
+	AddContributions(ActionIndex);
+	LinkAction(ActionIndex);
+
+	ApplyActionState(ActionIndex, bWasEnabled, ChangedIndicators);
+	BroadcastChanged(ChangedIndicators);
+	return true;
+}
+
+bool ULifeVairScenarioSubsystem::RegisterIndicator(const FLifeVairScenarioIndicator& Indicator)
+{
+	if (Indicator.Indicator.IsNone())
+	{
+		return false;
+	}
+
+	int32 IndicatorIndex = INDEX_NONE;
+	if (const int32* Existing = IndicatorByName.Find(Indicator.Indicator))
+	{
+		IndicatorIndex = *Existing;
+		for (FCompiledAction& Action : Actions)
+		{
+			Action.Indicators.Remove(IndicatorIndex);
+		}
+	}
+	else
+	{
+		IndicatorIndex = Indicators.AddDefaulted();
+		IndicatorByName.Add(Indicator.Indicator, IndicatorIndex);
+	}
+
+	Indicators[IndicatorIndex].Definition = Indicator;
+	CompileIndicator(Indicators[IndicatorIndex]);
+	LinkIndicator(IndicatorIndex);
+
+	RecomputeIndicator(IndicatorIndex);
+	BroadcastChanged({ Indicator.Indicator });
+	return true;
+}
+
+bool ULifeVairScenarioSubsystem::SetActionEnabled(FName Action, bool bEnabled)
+{
+	const int32* ActionIndex = ActionByName.Find(Action);
+	if (!ActionIndex)
+	{
+		UE_LOG(LogLifeVairScenario, Warning, TEXT("Unknown scenario action %s"), *Action.ToString());
+		return false;
+	}
+
+	if (Actions[*ActionIndex].bEnabled == bEnabled)
+	{
+		return true;
+	}
+
+	PushUndo(*ActionIndex, !bEnabled);
+	RedoStack.Reset();
+
+	TArray<FName> ChangedIndicators;
+	ApplyActionState(*ActionIndex, bEnabled, ChangedIndicators);
+	BroadcastChanged(ChangedIndicators);
+	return true;
+}
+
+bool ULifeVairScenarioSubsystem::ToggleAction(FName Action)
+{
+	return SetActionEnabled(Action, !IsActionEnabled(Action));
+}
+
+bool ULifeVairScenarioSubsystem::IsActionEnabled(FName Action) const
+{
+	const int32* ActionIndex = ActionByName.Find(Action);
+	return ActionIndex && Actions[*ActionIndex].bEnabled;
+}
+
+bool ULifeVairScenarioSubsystem::Undo()
+{
+	if (UndoStack.Num() == 0)
+	{
+		return false;
+	}
+
+	const FUndoStep Step = UndoStack.Pop(false);
+	RedoStack.Add({ Step.Action, Actions[Step.Action].bEnabled });
+
+	TArray<FName> ChangedIndicators;
+	ApplyActionState(Step.Action, Step.bEnabled, ChangedIndicators);
+	BroadcastChanged(ChangedIndicators);
+	return true;
+}
+
+bool ULifeVairScenarioSubsystem::Redo()
+{
+	if (RedoStack.Num() == 0)
+	{
+		return false;
+	}
+
+	const FUndoStep Step = RedoStack.Pop(false);
+	PushUndo(Step.Action, Actions[Step.Action].bEnabled);
+
+	TArray<FName> ChangedIndicators;
+	ApplyActionState(Step.Action, Step.bEnabled, ChangedIndicators);
+	BroadcastChanged(ChangedIndicators);
+	return true;
+}
+
+void ULifeVairScenarioSubsystem::ResetScenario()
+{
+	UndoStack.Reset();
+	RedoStack.Reset();
+	CellContributions.Reset();
+
+	const FLifeVairTerritoryColumns* Columns = GetTerritoryColumns();
+	if (Columns)
+	{
+		ScenarioMetrics = Columns->Metrics;
+	}
+	else
+	{
+		ScenarioMetrics.Reset();
+	}
+
+	for (int32 ActionIndex = 0; ActionIndex < Actions.Num(); ++ActionIndex)
+	{
+		Actions[ActionIndex].bEnabled = false;
+		Actions[ActionIndex].Indicators.Reset();
+		CompileAction(Actions[ActionIndex]);
+		AddContributions(ActionIndex);
+	}
+
+	TArray<FName> ChangedIndicators;
+	for (int32 IndicatorIndex = 0; IndicatorIndex < Indicators.Num(); ++IndicatorIndex)
+	{
+		CompileIndicator(Indicators[IndicatorIndex]);
+		LinkIndicator(IndicatorIndex);
+
+		if (RecomputeIndicator(IndicatorIndex))
+		{
+			ChangedIndicators.Add(Indicators[IndicatorIndex].Definition.Indicator);
+		}
+	}
+	BroadcastChanged(ChangedIndicators);
+}
+
+double ULifeVairScenarioSubsystem::GetIndicatorValue(FName Indicator) const
+{
+	const int32* IndicatorIndex = IndicatorByName.Find(Indicator);
+	return IndicatorIndex ? Indicators[*IndicatorIndex].Value : 0.0;
+}
+
+double ULifeVairScenarioSubsystem::GetScenarioMetricValue(int32 Row, int32 Metric) const
+{
+	return ScenarioMetrics.IsValidIndex(Metric) && ScenarioMetrics[Metric].IsValidIndex(Row) ? ScenarioMetrics[Metric][Row] : 0.0;
+}
+
+TArrayView<const double> ULifeVairScenarioSubsystem::GetScenarioMetric(int32 Metric) const
+{
+	return ScenarioMetrics.IsValidIndex(Metric) ? TArrayView<const double>(ScenarioMetrics[Metric]) : TArrayView<const double>();
+}
+
+void ULifeVairScenarioSubsystem::CompileAction(FCompiledAction& Action) const
+{
+	Action.Deltas.Reset();
+
+	const FLifeVairTerritoryColumns* Columns = GetTerritoryColumns();
+	if (!Columns)
+	{
+		return;
+	}
+
+	for (const FLifeVairScenarioDelta& Delta : Action.Definition.Deltas)
+	{
+		const int32 Metric = Columns->FindMetric(Delta.Metric);
+		if (Metric == INDEX_NONE)
+		{
+			UE_LOG(LogLifeVairScenario, Warning, TEXT("Action %s changes unknown metric %s"), *Action.Definition.Action.ToString(), *Delta.Metric.ToString());
+			continue;
+		}
+
+		if (Delta.Territory.IsNone())
+		{
+			for (int32 Row = 0; Row < Columns->NumRows; ++Row)
+			{
+				Action.Deltas.Add({ Row, Metric, Delta.Operation, Delta.Value });
+			}
+			continue;
+		}
+
+		const int32 Row = Columns->FindRow(Delta.Territory);
+		if (Row == INDEX_NONE)
+		{
+			UE_LOG(LogLifeVairScenario, Warning, TEXT("Action %s changes unknown territory %s"), *Action.Definition.Action.ToString(), *Delta.Territory.ToString());
+			continue;
+		}
+		Action.Deltas.Add({ Row, Metric, Delta.Operation, Delta.Value });
+	}
+}
+
+void ULifeVairScenarioSubsystem::CompileIndicator(FCompiledIndicator& Indicator) const
+{
+	Indicator.Metrics.Reset();
+	Indicator.Rows.Reset();
+	Indicator.RowMask.Reset();
+	Indicator.PopulationMetric = INDEX_NONE;
+	Indicator.bAllRows = Indicator.Definition.Territories.Num() == 0;
+
+	const FLifeVairTerritoryColumns* Columns = GetTerritoryColumns();
+	if (!Columns)
+	{
+		return;
+	}
+
+	for (const FName& Metric : Indicator.Definition.Metrics)
+	{
+		const int32 MetricIndex = Columns->FindMetric(Metric);
+		if (MetricIndex == INDEX_NONE)
+		{
+			UE_LOG(LogLifeVairScenario, Warning, TEXT("Indicator %s reads unknown metric %s"), *Indicator.Definition.Indicator.ToString(), *Metric.ToString());
+			continue;
+		}
+		Indicator.Metrics.AddUnique(MetricIndex);
+	}
+
+	if (Indicator.Definition.Type == ELifeVairIndicatorType::PerCapita)
+	{
+		Indicator.PopulationMetric = Columns->FindMetric(Indicator.Definition.PopulationMetric);
+	}
+
+	Indicator.RowMask.Init(Indicator.bAllRows, Columns->NumRows);
+	for (const FName& Territory : Indicator.Definition.Territories)
+	{
+		const int32 Row = Columns->FindRow(Territory);
+		if (Row != INDEX_NONE && !Indicator.RowMask[Row])
+		{
+			Indicator.RowMask[Row] = true;
+			Indicator.Rows.Add(Row);
+		}
+	}
+}
+
+bool ULifeVairScenarioSubsystem::DoesDeltaAffect(const FCompiledIndicator& Indicator, const FCompiledDelta& Delta) const
+{
+	if (!Indicator.RowMask.IsValidIndex(Delta.Row) || !Indicator.RowMask[Delta.Row])
+	{
+		return false;
+	}
+	return Indicator.Metrics.Contains(Delta.Metric) || Delta.Metric == Indicator.PopulationMetric;
+}
+
+void ULifeVairScenarioSubsystem::AddContributions(int32 ActionIndex)
+{
+	const TArray<FCompiledDelta>& Deltas = Actions[ActionIndex].Deltas;
+	for (int32 DeltaIndex = 0; DeltaIndex < Deltas.Num(); ++DeltaIndex)
+	{
+		CellContributions.FindOrAdd(GetCellKey(Deltas[DeltaIndex].Row, Deltas[DeltaIndex].Metric)).Add(TPair<int32, int32>(ActionIndex, DeltaIndex));
+	}
+}
+
+void ULifeVairScenarioSubsystem::RemoveContributions(int32 ActionIndex)
+{
+	for (const FCompiledDelta& Delta : Actions[ActionIndex].Deltas)
+	{
+		const uint64 CellKey = GetCellKey(Delta.Row, Delta.Metric);
+		if (TArray<TPair<int32, int32>>* Contributions = CellContributions.Find(CellKey))
+		{
+			Contributions->RemoveAll([ActionIndex](const TPair<int32, int32>& Contribution) { return Contribution.Key == ActionIndex; });
+			if (Contributions->Num() == 0)
+			{
+				CellContributions.Remove(CellKey);
+			}
+		}
+	}
+}
+
+void ULifeVairScenarioSubsystem::LinkAction(int32 ActionIndex)
+{
+	FCompiledAction& Action = Actions[ActionIndex];
+	Action.Indicators.Reset();
+
+	for (int32 IndicatorIndex = 0; IndicatorIndex < Indicators.Num(); ++IndicatorIndex)
+	{
+		for (const FCompiledDelta& Delta : Action.Deltas)
+		{
+			if (DoesDeltaAffect(Indicators[IndicatorIndex], Delta))
+			{
+				Action.Indicators.Add(IndicatorIndex);
+				break;
+			}
+		}
+	}
+}
+
+void ULifeVairScenarioSubsystem::LinkIndicator(int32 IndicatorIndex)
+{
+	for (FCompiledAction& Action : Actions)
+	{
+		for (const FCompiledDelta& Delta : Action.Deltas)
+		{
+			if (DoesDeltaAffect(Indicators[IndicatorIndex], Delta))
+			{
+				Action.Indicators.AddUnique(IndicatorIndex);
+				break;
+			}
+		}
+	}
+}
+
+void ULifeVairScenarioSubsystem::ApplyActionState(int32 ActionIndex, bool bEnabled, TArray<FName>& OutChangedIndicators)
+{
+	SCOPE_CYCLE_COUNTER(STAT_LifeVairScenarioApplyAction);
+
+	FCompiledAction& Action = Actions[ActionIndex];
+	if (Action.bEnabled == bEnabled)
+	{
+		return;
+	}
+	Action.bEnabled = bEnabled;
+
+	if (const FLifeVairTerritoryColumns* Columns = GetTerritoryColumns())
+	{
+		for (const FCompiledDelta& Delta : Action.Deltas)
+		{
+			RecomputeCell(*Columns, Delta.Row, Delta.Metric);
+		}
+	}
+
+	// Only the indicators reading one of the changed cells
+	for (const int32 IndicatorIndex : Action.Indicators)
+	{
+		if (RecomputeIndicator(IndicatorIndex))
+		{
+			OutChangedIndicators.AddUnique(Indicators[IndicatorIndex].Definition.Indicator);
+		}
+	}
+}
+
+void ULifeVairScenarioSubsystem::RecomputeCell(const FLifeVairTerritoryColumns& Columns, int32 Row, int32 Metric)
+{
+	if (!ScenarioMetrics.IsValidIndex(Metric) || !ScenarioMetrics[Metric].IsValidIndex(Row))
+	{
+		return;
+	}
+
+	// Rebuilt from the base value so the result doesn't depend on the order actions were toggled in
+	double Value = Columns.GetValue(Row, Metric);
+	double Scale = 1.0;
+	if (const TArray<TPair<int32, int32>>* Contributions = CellContributions.Find(GetCellKey(Row, Metric)))
+	{
+		for (const TPair<int32, int32>& Contribution : *Contributions)
+		{
+			const FCompiledAction& Action = Actions[Contribution.Key];
+			if (!Action.bEnabled)
+			{
+				continue;
+			}
+
+			const FCompiledDelta& Delta = Action.Deltas[Contribution.Value];
+			if (Delta.Operation == ELifeVairDeltaOperation::Add)
+			{
+				Value += Delta.Value;
+			}
+			else
+			{
+				Scale *= Delta.Value;
+			}
+		}
+	}
+
+	ScenarioMetrics[Metric][Row] = Value * Scale;
+}
+
+bool ULifeVairScenarioSubsystem::RecomputeIndicator(int32 IndicatorIndex)
+{
+	INC_DWORD_STAT(STAT_LifeVairScenarioRecomputedIndicators);
+
+	FCompiledIndicator& Indicator = Indicators[IndicatorIndex];
+
+	auto SumMetric = [this, &Indicator](int32 Metric) -> double
+	{
+		if (!ScenarioMetrics.IsValidIndex(Metric))
+		{
+			return 0.0;
+		}
+		return Indicator.bAllRows ? LifeVairAggregation::Accumulate(ScenarioMetrics[Metric]).Sum : LifeVairAggregation::Accumulate(ScenarioMetrics[Metric], Indicator.Rows).Sum;
+	};
+
+	double Total = 0.0;
+	for (const int32 Metric : Indicator.Metrics)
+	{
+		Total += SumMetric(Metric);
+	}
+
+	double Value = Total;
+	if (Indicator.Definition.Type == ELifeVairIndicatorType::Mean)
+	{
+		const int32 NumRows = Indicator.bAllRows ? Indicator.RowMask.Num() : Indicator.Rows.Num();
+		Value = NumRows > 0 ? Total / NumRows : 0.0;
+	}
+	else if (Indicator.Definition.Type == ELifeVairIndicatorType::PerCapita)
+	{
+		const double Population = SumMetric(Indicator.PopulationMetric);
+		Value = Population > 0.0 ? Total / Population : 0.0;
+	}
+
+	const bool bChanged = Value != Indicator.Value;
+	Indicator.Value = Value;
+	return bChanged;
+}
+
+void ULifeVairScenarioSubsystem::PushUndo(int32 ActionIndex, bool bEnabled)
+{
+	UndoStack.Add({ ActionIndex, bEnabled });
+
+	if (MaxUndoSteps > 0 && UndoStack.Num() > MaxUndoSteps)
+	{
+		UndoStack.RemoveAt(0, UndoStack.Num() - MaxUndoSteps, false);
+	}
+}
+
+void ULifeVairScenarioSubsystem::BroadcastChanged(const TArray<FName>& ChangedIndicators)
+{
+	if (ChangedIndicators.Num() > 0)
+	{
+		OnIndicatorsChanged.Broadcast(ChangedIndicators);
+	}
+}
@@ -0,0 +1,234 @@
+// Copyright : OK
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "LifeVairScenario.generated.h"
+
+struct FLifeVairTerritoryColumns;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogLifeVairScenario, Log, All);
+
+UENUM(BlueprintType)
+enum class ELifeVairDeltaOperation : uint8
+{
+	/*Adds Value to the metric*/
+	Add,
+	/*Multiplies the metric by Value, applied after every Add*/
+	Multiply
+};
+
+/*Change of one metric made by an action*/
+USTRUCT(BlueprintType)
+struct LIFEVAIR_API FLifeVairScenarioDelta
+{
+	GENERATED_BODY()
+
+	/*Territory changed, None changes every territory*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LifeVair Scenario")
+	FName Territory;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LifeVair Scenario")
+	FName Metric;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LifeVair Scenario")
+	ELifeVairDeltaOperation Operation = ELifeVairDeltaOperation::Add;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LifeVair Scenario")
+	double Value = 0.0;
+};
+
+/*An action the player can apply, as the metric changes it makes*/
+USTRUCT(BlueprintType)
+struct LIFEVAIR_API FLifeVairScenarioAction
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LifeVair Scenario")
+	FName Action;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LifeVair Scenario")
+	TArray<FLifeVairScenarioDelta> Deltas;
+};
+
+UENUM(BlueprintType)
+enum class ELifeVairIndicatorType : uint8
+{
+	Sum,
+	/*Sum divided by the number of territories*/
+	Mean,
+	/*Sum divided by the summed PopulationMetric*/
+	PerCapita
+};
+
+/*A value shown by the dashboards, derived from the scenario metrics*/
+USTRUCT(BlueprintType)
+struct LIFEVAIR_API FLifeVairScenarioIndicator
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LifeVair Scenario")
+	FName Indicator;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LifeVair Scenario")
+	ELifeVairIndicatorType Type = ELifeVairIndicatorType::Sum;
+
+	/*Metrics added together*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LifeVair Scenario")
+	TArray<FName> Metrics;
+
+	/*Territories aggregated, empty for all of them*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LifeVair Scenario")
+	TArray<FName> Territories;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LifeVair Scenario")
+	FName PopulationMetric = TEXT("Inhabitants");
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FLifeVairIndicatorsChangedSignature, const TArray<FName>&, ChangedIndicators);
+
+/*
+ * What-if scenario over the territory metrics.
+ * Each action is a sparse list of metric cells it changes and each indicator knows the cells it reads, so toggling an action only
+ * recomputes its own cells (from the base value and every enabled action touching them) and the indicators that depend on them.
+ * Toggles are recorded on an undo/redo stack of action states.
+ */
+UCLASS(Config = Game)
+class LIFEVAIR_API ULifeVairScenarioSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	static ULifeVairScenarioSubsystem* Get(const UObject* WorldContextObject);
+
+	/*Undo steps kept, the oldest are dropped past this*/
+	UPROPERTY(Config, EditAnywhere, Category = "LifeVair Scenario")
+	int32 MaxUndoSteps = 64;
+
+	/*Called with the indicators whose value changed after a toggle, undo, redo or reset*/
+	UPROPERTY(BlueprintAssignable, Category = "LifeVair Scenario")
+	FLifeVairIndicatorsChangedSignature OnIndicatorsChanged;
+
+	/*Adds or replaces an action, a replaced action keeps its enabled state. Deltas on unknown territories or metrics are skipped*/
+	UFUNCTION(BlueprintCallable, Category = "LifeVair Scenario")
+	bool RegisterAction(const FLifeVairScenarioAction& Action);
+
+	/*Adds or replaces an indicator and computes its value*/
+	UFUNCTION(BlueprintCallable, Category = "LifeVair Scenario")
+	bool RegisterIndicator(const FLifeVairScenarioIndicator& Indicator);
+
+	UFUNCTION(BlueprintCallable, Category = "LifeVair Scenario")
+	bool SetActionEnabled(FName Action, bool bEnabled);
+
+	UFUNCTION(BlueprintCallable, Category = "LifeVair Scenario")
+	bool ToggleAction(FName Action);
+
+	UFUNCTION(BlueprintPure, Category = "LifeVair Scenario")
+	bool IsActionEnabled(FName Action) const;
+
+	UFUNCTION(BlueprintCallable, Category = "LifeVair Scenario")
+	bool Undo();
+
+	UFUNCTION(BlueprintCallable, Category = "LifeVair Scenario")
+	bool Redo();
+
+	UFUNCTION(BlueprintPure, Category = "LifeVair Scenario")
+	bool CanUndo() const { return UndoStack.Num() > 0; }
+
+	UFUNCTION(BlueprintPure, Category = "LifeVair Scenario")
+	bool CanRedo() const { return RedoStack.Num() > 0; }
+
+	/*Disables every action, clears the history and recompiles the actions and indicators against the current territory data*/
+	UFUNCTION(BlueprintCallable, Category = "LifeVair Scenario")
+	void ResetScenario();
+
+	UFUNCTION(BlueprintPure, Category = "LifeVair Scenario")
+	double GetIndicatorValue(FName Indicator) const;
+
+	/*Metric value with the enabled actions applied, rows and metrics are the ones of the territory subsystem*/
+	UFUNCTION(BlueprintPure, Category = "LifeVair Scenario")
+	double GetScenarioMetricValue(int32 Row, int32 Metric) const;
+
+	/*Native access to a scenario metric column*/
+	TArrayView<const double> GetScenarioMetric(int32 Metric) const;
+
+private:
+	struct FCompiledDelta
+	{
+		int32 Row;
+		int32 Metric;
+		ELifeVairDeltaOperation Operation;
+		double Value;
+	};
+
+	struct FCompiledAction
+	{
+		FLifeVairScenarioAction Definition;
+		TArray<FCompiledDelta> Deltas;
+		TArray<int32> Indicators;
+		bool bEnabled = false;
+	};
+
+	struct FCompiledIndicator
+	{
+		FLifeVairScenarioIndicator Definition;
+		TArray<int32> Metrics;
+		int32 PopulationMetric = INDEX_NONE;
+		TArray<int32> Rows;
+		TBitArray<> RowMask;
+		bool bAllRows = true;
+		double Value = 0.0;
+	};
+
+	struct FUndoStep
+	{
+		int32 Action;
+		bool bEnabled;
+	};
+
+	// Cell key of a metric/row pair in CellContributions
+	static uint64 GetCellKey(int32 Row, int32 Metric) { return (uint64(uint32(Metric)) << 32) | uint32(Row); }
+
+	const FLifeVairTerritoryColumns* GetTerritoryColumns() const;
+
+	// Every compiled row and metric index is stale once the territory data is rebuilt
+	void OnTerritoryDataRebuilt() { ResetScenario(); }
+
+	void CompileAction(FCompiledAction& Action) const;
+	void CompileIndicator(FCompiledIndicator& Indicator) const;
+	bool DoesDeltaAffect(const FCompiledIndicator& Indicator, const FCompiledDelta& Delta) const;
+
+	void AddContributions(int32 ActionIndex);
+	void RemoveContributions(int32 ActionIndex);
+	void LinkAction(int32 ActionIndex);
+	void LinkIndicator(int32 IndicatorIndex);
+
+	/*Applies an action state and recomputes what depends on it, adds the indicators that changed to OutChangedIndicators*/
+	void ApplyActionState(int32 ActionIndex, bool bEnabled, TArray<FName>& OutChangedIndicators);
+	void RecomputeCell(const FLifeVairTerritoryColumns& Columns, int32 Row, int32 Metric);
+	bool RecomputeIndicator(int32 IndicatorIndex);
+
+	void PushUndo(int32 ActionIndex, bool bEnabled);
+	void BroadcastChanged(const TArray<FName>& ChangedIndicators);
+
+	TArray<FCompiledAction> Actions;
+	TMap<FName, int32> ActionByName;
+
+	TArray<FCompiledIndicator> Indicators;
+	TMap<FName, int32> IndicatorByName;
+
+	// Base territory metrics with the enabled actions applied, Metrics[Metric][Row]
+	TArray<TArray<double>> ScenarioMetrics;
+
+	// Actions (action index, delta index) touching each changed cell
+	TMap<uint64, TArray<TPair<int32, int32>>> CellContributions;
+
+	TArray<FUndoStep> UndoStack;
+	TArray<FUndoStep> RedoStack;
+
+	FDelegateHandle TerritoryDataRebuiltHandle;
+};
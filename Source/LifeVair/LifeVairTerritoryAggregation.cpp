@@ -0,0 +1,368 @@
+// Copyright : OK
+
+#include "LifeVairTerritoryAggregation.h"
+#include "LifeVairTerritoryData.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/VectorRegister.h"
+
+DECLARE_CYCLE_STAT(TEXT("LifeVair Aggregate"), STAT_LifeVairAggregate, STATGROUP_Game);
+DECLARE_CYCLE_STAT(TEXT("LifeVair Group By"), STAT_LifeVairGroupBy, STATGROUP_Game);
+
+static TAutoConsoleVariable<int32> CVarLifeVairAggregationParallelRows(
+	TEXT("LifeVair.Aggregation.ParallelRows"),
+	16384,
+	TEXT("Selections with at least this many rows are aggregated with ParallelFor, 0 disables it."),
+	ECVF_Default);
+
+namespace LifeVairAggregation
+{
+	// Rows per ParallelFor task, big enough that a task outweighs its scheduling
+	static constexpr int32 ChunkSize = 4096;
+
+	FLifeVairMetricStats FAccumulator::ToStats() const
+	{
+		FLifeVairMetricStats Stats;
+		if (Count > 0)
+		{
+			Stats.Count = Count;
+			Stats.Sum = Sum;
+			Stats.Mean = Sum / Count;
+			Stats.Min = Min;
+			Stats.Max = Max;
+		}
+		return Stats;
+	}
+
+	// Folds the four lanes of the vector accumulators into Result
+	void MergeLanes(const VectorRegister4Double& Sum, const VectorRegister4Double& Min, const VectorRegister4Double& Max, int32 Count, FAccumulator& Result)
+	{
+		double SumLanes[4];
+		double MinLanes[4];
+		double MaxLanes[4];
+		VectorStore(Sum, SumLanes);
+		VectorStore(Min, MinLanes);
+		VectorStore(Max, MaxLanes);
+
+		FAccumulator Lanes;
+		Lanes.Sum = (SumLanes[0] + SumLanes[1]) + (SumLanes[2] + SumLanes[3]);
+		Lanes.Min = FMath::Min(FMath::Min(MinLanes[0], MinLanes[1]), FMath::Min(MinLanes[2], MinLanes[3]));
+		Lanes.Max = FMath::Max(FMath::Max(MaxLanes[0], MaxLanes[1]), FMath::Max(MaxLanes[2], MaxLanes[3]));
+		Lanes.Count = Count;
+		Result.Merge(Lanes);
+	}
+
+	FAccumulator AccumulateDense(const double* Values, int32 Num)
+	{
+		VectorRegister4Double Sum = VectorZeroDouble();
+		VectorRegister4Double Min = MakeVectorRegisterDouble(TNumericLimits<double>::Max(), TNumericLimits<double>::Max(), TNumericLimits<double>::Max(), TNumericLimits<double>::Max());
+		VectorRegister4Double Max = MakeVectorRegisterDouble(TNumericLimits<double>::Lowest(), TNumericLimits<double>::Lowest(), TNumericLimits<double>::Lowest(), TNumericLimits<double>::Lowest());
+
+		int32 Index = 0;
+		for (; Index + 4 <= Num; Index += 4)
+		{
+			const VectorRegister4Double Value = VectorLoad(Values + Index);
+			Sum = VectorAdd(Sum, Value);
+			Min = VectorMin(Min, Value);
+			Max = VectorMax(Max, Value);
+		}
+
+		FAccumulator Result;
+		if (Index > 0)
+		{
+			MergeLanes(Sum, Min, Max, Index, Result);
+		}
+
+		for (; Index < Num; ++Index)
+		{
+			Result.Add(Values[Index]);
+		}
+		return Result;
+	}
+
+	FAccumulator AccumulateGathered(const double* Values, const int32* Rows, int32 Num)
+	{
+		VectorRegister4Double Sum = VectorZeroDouble();
+		VectorRegister4Double Min = MakeVectorRegisterDouble(TNumericLimits<double>::Max(), TNumericLimits<double>::Max(), TNumericLimits<double>::Max(), TNumericLimits<double>::Max());
+		VectorRegister4Double Max = MakeVectorRegisterDouble(TNumericLimits<double>::Lowest(), TNumericLimits<double>::Lowest(), TNumericLimits<double>::Lowest(), TNumericLimits<double>::Lowest());
+
+		int32 Index = 0;
+		for (; Index + 4 <= Num; Index += 4)
+		{
+			const VectorRegister4Double Value = MakeVectorRegisterDouble(Values[Rows[Index]], Values[Rows[Index + 1]], Values[Rows[Index + 2]], Values[Rows[Index + 3]]);
+			Sum = VectorAdd(Sum, Value);
+			Min = VectorMin(Min, Value);
+			Max = VectorMax(Max, Value);
+		}
+
+		FAccumulator Result;
+		if (Index > 0)
+		{
+			MergeLanes(Sum, Min, Max, Index, Result);
+		}
+
+		for (; Index < Num; ++Index)
+		{
+			Result.Add(Values[Rows[Index]]);
+		}
+		return Result;
+	}
+
+	// Runs Kernel(Start, Count) over [0, Num), in chunks on the task graph when the selection is large enough
+	template<typename KernelType>
+	FAccumulator AccumulateChunked(int32 Num, KernelType&& Kernel)
+	{
+		const int32 ParallelRows = CVarLifeVairAggregationParallelRows.GetValueOnAnyThread();
+		if (ParallelRows <= 0 || Num < FMath::Max(ParallelRows, ChunkSize * 2))
+		{
+			return Kernel(0, Num);
+		}
+
+		const int32 NumChunks = FMath::DivideAndRoundUp(Num, ChunkSize);
+		TArray<FAccumulator, TInlineAllocator<64>> Partials;
+		Partials.SetNum(NumChunks);
+
+		ParallelFor(NumChunks, [&Partials, &Kernel, Num](int32 Chunk)
+		{
+			const int32 Start = Chunk * ChunkSize;
+			Partials[Chunk] = Kernel(Start, FMath::Min(ChunkSize, Num - Start));
+		});
+
+		FAccumulator Result;
+		for (const FAccumulator& Partial : Partials)
+		{
+			Result.Merge(Partial);
+		}
+		return Result;
+	}
+
+	FAccumulator Accumulate(TArrayView<const double> Values)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_LifeVairAggregate);
+
+		const double* Data = Values.GetData();
+		return AccumulateChunked(Values.Num(), [Data](int32 Start, int32 Count)
+		{
+			return AccumulateDense(Data + Start, Count);
+		});
+	}
+
+	FAccumulator Accumulate(TArrayView<const double> Values, TArrayView<const int32> Rows)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_LifeVairAggregate);
+
+		const double* Data = Values.GetData();
+		const int32* RowData = Rows.GetData();
+		return AccumulateChunked(Rows.Num(), [Data, RowData](int32 Start, int32 Count)
+		{
+			return AccumulateGathered(Data, RowData + Start, Count);
+		});
+	}
+
+	void GroupBy(TArrayView<const double> Values, TArrayView<const int32> Rows, TArrayView<const int32> RowCodes, int32 NumCodes, TArray<FAccumulator>& OutGroups)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_LifeVairGroupBy);
+
+		OutGroups.Reset();
+		OutGroups.SetNum(NumCodes);
+
+		// Codes are small dense integers so the groups are plain array slots, no hashing per row
+		auto GroupRange = [&Values, &Rows, &RowCodes](int32 Start, int32 Count, TArray<FAccumulator>& Groups)
+		{
+			for (int32 Index = Start; Index < Start + Count; ++Index)
+			{
+				const int32 Row = Rows[Index];
+				Groups[RowCodes[Row]].Add(Values[Row]);
+			}
+		};
+
+		const int32 ParallelRows = CVarLifeVairAggregationParallelRows.GetValueOnAnyThread();
+		if (ParallelRows <= 0 || Rows.Num() < FMath::Max(ParallelRows, ChunkSize * 2))
+		{
+			GroupRange(0, Rows.Num(), OutGroups);
+			return;
+		}
+
+		const int32 NumChunks = FMath::DivideAndRoundUp(Rows.Num(), ChunkSize);
+		TArray<TArray<FAccumulator>> Partials;
+		Partials.SetNum(NumChunks);
+
+		ParallelFor(NumChunks, [&Partials, &GroupRange, &Rows, NumCodes](int32 Chunk)
+		{
+			const int32 Start = Chunk * ChunkSize;
+			Partials[Chunk].SetNum(NumCodes);
+			GroupRange(Start, FMath::Min(ChunkSize, Rows.Num() - Start), Partials[Chunk]);
+		});
+
+		for (const TArray<FAccumulator>& Partial : Partials)
+		{
+			for (int32 Code = 0; Code < NumCodes; ++Code)
+			{
+				OutGroups[Code].Merge(Partial[Code]);
+			}
+		}
+	}
+
+	// The kernels don't range check, out of range rows are dropped once here. Returns Rows itself when they are all valid
+	TArrayView<const int32> GetValidRows(const TArray<int32>& Rows, const FLifeVairTerritoryColumns& Columns, TArray<int32>& Storage)
+	{
+		const int32 FirstInvalid = Rows.IndexOfByPredicate([&Columns](int32 Row) { return !Columns.IsValidRow(Row); });
+		if (FirstInvalid == INDEX_NONE)
+		{
+			return Rows;
+		}
+
+		Storage.Reset(Rows.Num());
+		Storage.Append(Rows.GetData(), FirstInvalid);
+		for (int32 Index = FirstInvalid + 1; Index < Rows.Num(); ++Index)
+		{
+			if (Columns.IsValidRow(Rows[Index]))
+			{
+				Storage.Add(Rows[Index]);
+			}
+		}
+		return Storage;
+	}
+}
+
+const FLifeVairTerritoryColumns* ULifeVairAggregationLibrary::GetColumns(const UObject* WorldContextObject)
+{
+	const ULifeVairTerritorySubsystem* Territories = ULifeVairTerritorySubsystem::Get(WorldContextObject);
+	return Territories && Territories->IsTerritoryDataReady() ? &Territories->GetColumns() : nullptr;
+}
+
+FLifeVairMetricStats ULifeVairAggregationLibrary::AggregateMetric(const UObject* WorldContextObject, const TArray<int32>& Rows, int32 Metric)
+{
+	const FLifeVairTerritoryColumns* Columns = GetColumns(WorldContextObject);
+	if (!Columns || !Columns->IsValidMetric(Metric))
+	{
+		return FLifeVairMetricStats();
+	}
+
+	TArray<int32> ValidRows;
+	return LifeVairAggregation::Accumulate(Columns->Metrics[Metric], LifeVairAggregation::GetValidRows(Rows, *Columns, ValidRows)).ToStats();
+}
+
+FLifeVairMetricStats ULifeVairAggregationLibrary::AggregateMetricForAllTerritories(const UObject* WorldContextObject, int32 Metric)
+{
+	const FLifeVairTerritoryColumns* Columns = GetColumns(WorldContextObject);
+	if (!Columns || !Columns->IsValidMetric(Metric))
+	{
+		return FLifeVairMetricStats();
+	}
+
+	return LifeVairAggregation::Accumulate(Columns->Metrics[Metric]).ToStats();
+}
+
+TArray<FLifeVairMetricStats> ULifeVairAggregationLibrary::AggregateMetrics(const UObject* WorldContextObject, const TArray<int32>& Rows, const TArray<int32>& Metrics)
+{
+	TArray<FLifeVairMetricStats> Results;
+	Results.SetNum(Metrics.Num());
+
+	const FLifeVairTerritoryColumns* Columns = GetColumns(WorldContextObject);
+	if (!Columns)
+	{
+		return Results;
+	}
+
+	TArray<int32> ValidRows;
+	const TArrayView<const int32> Selection = LifeVairAggregation::GetValidRows(Rows, *Columns, ValidRows);
+
+	for (int32 Index = 0; Index < Metrics.Num(); ++Index)
+	{
+		if (Columns->IsValidMetric(Metrics[Index]))
+		{
+			Results[Index] = LifeVairAggregation::Accumulate(Columns->Metrics[Metrics[Index]], Selection).ToStats();
+		}
+	}
+	return Results;
+}
+
+TArray<FLifeVairMetricShare> ULifeVairAggregationLibrary::GetMetricShares(const UObject* WorldContextObject, const TArray<int32>& Rows, const TArray<int32>& Metrics)
+{
+	TArray<FLifeVairMetricShare> Shares;
+	Shares.SetNum(Metrics.Num());
+
+	const FLifeVairTerritoryColumns* Columns = GetColumns(WorldContextObject);
+	if (!Columns)
+	{
+		return Shares;
+	}
+
+	TArray<int32> ValidRows;
+	const TArrayView<const int32> Selection = LifeVairAggregation::GetValidRows(Rows, *Columns, ValidRows);
+
+	double Total = 0.0;
+	for (int32 Index = 0; Index < Metrics.Num(); ++Index)
+	{
+		Shares[Index].Metric = Metrics[Index];
+		if (Columns->IsValidMetric(Metrics[Index]))
+		{
+			Shares[Index].Sum = LifeVairAggregation::Accumulate(Columns->Metrics[Metrics[Index]], Selection).Sum;
+			Total += Shares[Index].Sum;
+		}
+	}
+
+	if (Total != 0.0)
+	{
+		for (FLifeVairMetricShare& Share : Shares)
+		{
+			Share.Share = Share.Sum / Total;
+		}
+	}
+	return Shares;
+}
+
+double ULifeVairAggregationLibrary::GetPerCapita(const UObject* WorldContextObject, const TArray<int32>& Rows, int32 Metric, int32 PopulationMetric)
+{
+	const FLifeVairTerritoryColumns* Columns = GetColumns(WorldContextObject);
+	if (!Columns || !Columns->IsValidMetric(Metric) || !Columns->IsValidMetric(PopulationMetric))
+	{
+		return 0.0;
+	}
+
+	TArray<int32> ValidRows;
+	const TArrayView<const int32> Selection = LifeVairAggregation::GetValidRows(Rows, *Columns, ValidRows);
+
+	const double Population = LifeVairAggregation::Accumulate(Columns->Metrics[PopulationMetric], Selection).Sum;
+	return Population > 0.0 ? LifeVairAggregation::Accumulate(Columns->Metrics[Metric], Selection).Sum / Population : 0.0;
+}
+
+TArray<FLifeVairGroupStats> ULifeVairAggregationLibrary::GroupMetricBy(const UObject* WorldContextObject, const TArray<int32>& Rows, int32 Metric, ELifeVairTerritoryKey Key)
+{
+	TArray<FLifeVairGroupStats> Results;
+
+	const FLifeVairTerritoryColumns* Columns = GetColumns(WorldContextObject);
+	if (!Columns || !Columns->IsValidMetric(Metric))
+	{
+		return Results;
+	}
+
+	const TArray<int32>* RowCodes = &Columns->CountryCodes;
+	const TArray<FName>* Dictionary = &Columns->Countries;
+	if (Key == ELifeVairTerritoryKey::TerritoryType)
+	{
+		RowCodes = &Columns->TypeCodes;
+		Dictionary = &Columns->TerritoryTypes;
+	}
+	else if (Key == ELifeVairTerritoryKey::Scale)
+	{
+		RowCodes = &Columns->ScaleCodes;
+		Dictionary = &Columns->Scales;
+	}
+
+	TArray<int32> ValidRows;
+	TArray<LifeVairAggregation::FAccumulator> Groups;
+	LifeVairAggregation::GroupBy(Columns->Metrics[Metric], LifeVairAggregation::GetValidRows(Rows, *Columns, ValidRows), *RowCodes, Dictionary->Num(), Groups);
+
+	for (int32 Code = 0; Code < Groups.Num(); ++Code)
+	{
+		if (Groups[Code].Count > 0)
+		{
+			FLifeVairGroupStats& Group = Results.AddDefaulted_GetRef();
+			Group.Key = (*Dictionary)[Code];
+			Group.Stats = Groups[Code].ToStats();
+		}
+	}
+	return Results;
+}
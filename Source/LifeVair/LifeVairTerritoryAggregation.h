@@ -0,0 +1,146 @@
+// Copyright : OK
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "LifeVairTerritoryAggregation.generated.h"
+
+struct FLifeVairTerritoryColumns;
+
+/*Aggregate of one metric over a set of territories*/
+USTRUCT(BlueprintType)
+struct LIFEVAIR_API FLifeVairMetricStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "LifeVair Aggregation")
+	int32 Count = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LifeVair Aggregation")
+	double Sum = 0.0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LifeVair Aggregation")
+	double Mean = 0.0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LifeVair Aggregation")
+	double Min = 0.0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LifeVair Aggregation")
+	double Max = 0.0;
+};
+
+/*Part of one metric in the total of a set of metrics (sector shares)*/
+USTRUCT(BlueprintType)
+struct LIFEVAIR_API FLifeVairMetricShare
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "LifeVair Aggregation")
+	int32 Metric = INDEX_NONE;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LifeVair Aggregation")
+	double Sum = 0.0;
+
+	/*0..1 of the summed metrics, 0 when they sum to 0*/
+	UPROPERTY(BlueprintReadOnly, Category = "LifeVair Aggregation")
+	double Share = 0.0;
+};
+
+UENUM(BlueprintType)
+enum class ELifeVairTerritoryKey : uint8
+{
+	Country,
+	TerritoryType,
+	Scale
+};
+
+/*Aggregate of one metric for one country/type/scale*/
+USTRUCT(BlueprintType)
+struct LIFEVAIR_API FLifeVairGroupStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "LifeVair Aggregation")
+	FName Key;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LifeVair Aggregation")
+	FLifeVairMetricStats Stats;
+};
+
+/*
+ * Aggregation kernels over the territory metric columns. Four values are reduced per SIMD step and selections
+ * above LifeVair.Aggregation.ParallelRows are split in chunks over ParallelFor, partial results are merged in chunk order
+ * so the totals don't depend on the scheduling.
+ * Rows are read unchecked, callers pass rows already known to be in range.
+ */
+namespace LifeVairAggregation
+{
+	struct FAccumulator
+	{
+		double Sum = 0.0;
+		double Min = TNumericLimits<double>::Max();
+		double Max = TNumericLimits<double>::Lowest();
+		int32 Count = 0;
+
+		void Add(double Value)
+		{
+			Sum += Value;
+			Min = FMath::Min(Min, Value);
+			Max = FMath::Max(Max, Value);
+			++Count;
+		}
+
+		void Merge(const FAccumulator& Other)
+		{
+			Sum += Other.Sum;
+			Min = FMath::Min(Min, Other.Min);
+			Max = FMath::Max(Max, Other.Max);
+			Count += Other.Count;
+		}
+
+		FLifeVairMetricStats ToStats() const;
+	};
+
+	/*Every value of a column*/
+	LIFEVAIR_API FAccumulator Accumulate(TArrayView<const double> Values);
+
+	/*The given rows of a column*/
+	LIFEVAIR_API FAccumulator Accumulate(TArrayView<const double> Values, TArrayView<const int32> Rows);
+
+	/*One accumulator per code, RowCodes gives the code of each row (country/type/scale codes of the territory columns)*/
+	LIFEVAIR_API void GroupBy(TArrayView<const double> Values, TArrayView<const int32> Rows, TArrayView<const int32> RowCodes, int32 NumCodes, TArray<FAccumulator>& OutGroups);
+}
+
+/*Blueprint entry points, selections are territory rows and metrics are column indices of the territory subsystem*/
+UCLASS()
+class LIFEVAIR_API ULifeVairAggregationLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintCallable, meta=(WorldContext="WorldContextObject"), Category="LifeVair Aggregation")
+	static FLifeVairMetricStats AggregateMetric(const UObject* WorldContextObject, const TArray<int32>& Rows, int32 Metric);
+
+	UFUNCTION(BlueprintCallable, meta=(WorldContext="WorldContextObject"), Category="LifeVair Aggregation")
+	static FLifeVairMetricStats AggregateMetricForAllTerritories(const UObject* WorldContextObject, int32 Metric);
+
+	/*One result per metric, in the order of Metrics*/
+	UFUNCTION(BlueprintCallable, meta=(WorldContext="WorldContextObject"), Category="LifeVair Aggregation")
+	static TArray<FLifeVairMetricStats> AggregateMetrics(const UObject* WorldContextObject, const TArray<int32>& Rows, const TArray<int32>& Metrics);
+
+	/*Sum of each metric and its share of their total, e.g. the sector emissions of a pollutant*/
+	UFUNCTION(BlueprintCallable, meta=(WorldContext="WorldContextObject"), Category="LifeVair Aggregation")
+	static TArray<FLifeVairMetricShare> GetMetricShares(const UObject* WorldContextObject, const TArray<int32>& Rows, const TArray<int32>& Metrics);
+
+	/*Total of Metric divided by the total of PopulationMetric (Inhabitants) over the selection, 0 without population*/
+	UFUNCTION(BlueprintCallable, meta=(WorldContext="WorldContextObject"), Category="LifeVair Aggregation")
+	static double GetPerCapita(const UObject* WorldContextObject, const TArray<int32>& Rows, int32 Metric, int32 PopulationMetric);
+
+	/*Aggregate of Metric per country/type/scale of the selection, groups without any selected territory are left out*/
+	UFUNCTION(BlueprintCallable, meta=(WorldContext="WorldContextObject"), Category="LifeVair Aggregation")
+	static TArray<FLifeVairGroupStats> GroupMetricBy(const UObject* WorldContextObject, const TArray<int32>& Rows, int32 Metric, ELifeVairTerritoryKey Key);
+
+private:
+	static const FLifeVairTerritoryColumns* GetColumns(const UObject* WorldContextObject);
+};
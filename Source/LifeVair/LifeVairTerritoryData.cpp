@@ -0,0 +1,442 @@
+// Copyright : OK
+
+#include "LifeVairTerritoryData.h"
+#include "LifeVairDatabaseSubsystem.h"
+#include "LifeVairDatabaseSnapshot.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "HAL/PlatformTime.h"
+
+DEFINE_LOG_CATEGORY(LogLifeVairTerritory);
+
+const TArray<int32> FLifeVairTerritoryColumns::EmptyRows;
+
+namespace LifeVairTerritory
+{
+	int32 FindOrAddKey(TArray<FName>& Dictionary, TMap<FName, int32>& Codes, FName Key)
+	{
+		if (const int32* Code = Codes.Find(Key))
+		{
+			return *Code;
+		}
+
+		const int32 Code = Dictionary.Add(Key);
+		Codes.Add(Key, Code);
+		return Code;
+	}
+
+	void BuildCodeIndex(const TArray<FName>& Dictionary, TMap<FName, int32>& OutCodes)
+	{
+		OutCodes.Reset();
+		OutCodes.Reserve(Dictionary.Num());
+		for (int32 Code = 0; Code < Dictionary.Num(); ++Code)
+		{
+			OutCodes.Add(Dictionary[Code], Code);
+		}
+	}
+
+	void BuildRowIndex(const TArray<int32>& RowCodes, int32 NumCodes, TArray<TArray<int32>>& OutRows)
+	{
+		OutRows.Reset();
+		OutRows.SetNum(NumCodes);
+		for (int32 Row = 0; Row < RowCodes.Num(); ++Row)
+		{
+			if (OutRows.IsValidIndex(RowCodes[Row]))
+			{
+				OutRows[RowCodes[Row]].Add(Row);
+			}
+		}
+	}
+
+	const TArray<int32>& FindRows(const TMap<FName, int32>& Codes, const TArray<TArray<int32>>& RowsByCode, FName Key)
+	{
+		const int32* Code = Codes.Find(Key);
+		return Code && RowsByCode.IsValidIndex(*Code) ? RowsByCode[*Code] : FLifeVairTerritoryColumns::EmptyRows;
+	}
+}
+
+void FLifeVairTerritoryColumns::Reset()
+{
+	*this = FLifeVairTerritoryColumns();
+}
+
+int32 FLifeVairTerritoryColumns::AddRow(FName Territory, FName Country, FName TerritoryType, FName Scale)
+{
+	const int32 Row = NumRows++;
+
+	TerritoryNames.Add(Territory);
+	RowByTerritory.Add(Territory, Row);
+	CountryCodes.Add(LifeVairTerritory::FindOrAddKey(Countries, CountryByName, Country));
+	TypeCodes.Add(LifeVairTerritory::FindOrAddKey(TerritoryTypes, TypeByName, TerritoryType));
+	ScaleCodes.Add(LifeVairTerritory::FindOrAddKey(Scales, ScaleByName, Scale));
+
+	for (TArray<double>& Metric : Metrics)
+	{
+		Metric.Add(0.0);
+	}
+	return Row;
+}
+
+int32 FLifeVairTerritoryColumns::AddMetric(FName Metric)
+{
+	if (const int32* Existing = MetricByName.Find(Metric))
+	{
+		return *Existing;
+	}
+
+	const int32 Index = MetricNames.Add(Metric);
+	Metrics.AddDefaulted_GetRef().SetNumZeroed(NumRows);
+	MetricByName.Add(Metric, Index);
+	return Index;
+}
+
+void FLifeVairTerritoryColumns::BuildIndexes(const TArray<FString>& PollutantPrefixes)
+{
+	RowByTerritory.Reset();
+	RowByTerritory.Reserve(NumRows);
+	for (int32 Row = 0; Row < TerritoryNames.Num(); ++Row)
+	{
+		if (RowByTerritory.Contains(TerritoryNames[Row]))
+		{
+			UE_LOG(LogLifeVairTerritory, Warning, TEXT("Territory %s is in the table more than once, lookups return its first row"), *TerritoryNames[Row].ToString());
+			continue;
+		}
+		RowByTerritory.Add(TerritoryNames[Row], Row);
+	}
+
+	LifeVairTerritory::BuildCodeIndex(MetricNames, MetricByName);
+	LifeVairTerritory::BuildCodeIndex(Countries, CountryByName);
+	LifeVairTerritory::BuildCodeIndex(TerritoryTypes, TypeByName);
+	LifeVairTerritory::BuildCodeIndex(Scales, ScaleByName);
+
+	LifeVairTerritory::BuildRowIndex(CountryCodes, Countries.Num(), RowsByCountry);
+	LifeVairTerritory::BuildRowIndex(TypeCodes, TerritoryTypes.Num(), RowsByType);
+	LifeVairTerritory::BuildRowIndex(ScaleCodes, Scales.Num(), RowsByScale);
+
+	// Emi_NOx_Target, Emi_PM25_agriculture, Pop_NO2_Immersion... the part after the prefix is the pollutant
+	MetricsByPollutant.Reset();
+	for (int32 Metric = 0; Metric < MetricNames.Num(); ++Metric)
+	{
+		const FString Name = MetricNames[Metric].ToString();
+		for (const FString& Prefix : PollutantPrefixes)
+		{
+			const int32 PrefixLength = Prefix.Len() + 1;
+			if (Name.Len() <= PrefixLength || !Name.StartsWith(Prefix) || Name[Prefix.Len()] != TEXT('_'))
+			{
+				continue;
+			}
+
+			int32 PollutantEnd = Name.Find(TEXT("_"), ESearchCase::CaseSensitive, ESearchDir::FromStart, PrefixLength);
+			if (PollutantEnd == INDEX_NONE)
+			{
+				PollutantEnd = Name.Len();
+			}
+
+			MetricsByPollutant.FindOrAdd(FName(Name.Mid(PrefixLength, PollutantEnd - PrefixLength))).Add(Metric);
+			break;
+		}
+	}
+}
+
+int32 FLifeVairTerritoryColumns::FindRow(FName Territory) const
+{
+	const int32* Row = RowByTerritory.Find(Territory);
+	return Row ? *Row : INDEX_NONE;
+}
+
+int32 FLifeVairTerritoryColumns::FindMetric(FName Metric) const
+{
+	const int32* Index = MetricByName.Find(Metric);
+	return Index ? *Index : INDEX_NONE;
+}
+
+double FLifeVairTerritoryColumns::Sum(TArrayView<const int32> Rows, int32 Metric) const
+{
+	if (!IsValidMetric(Metric))
+	{
+		return 0.0;
+	}
+
+	const TArray<double>& Values = Metrics[Metric];
+	double Total = 0.0;
+	for (const int32 Row : Rows)
+	{
+		if (Values.IsValidIndex(Row))
+		{
+			Total += Values[Row];
+		}
+	}
+	return Total;
+}
+
+ULifeVairTerritorySubsystem::ULifeVairTerritorySubsystem()
+{
+	IgnoredColumns.Add(TEXT("Picture"));
+
+	PollutantMetricPrefixes.Add(TEXT("Emi"));
+	PollutantMetricPrefixes.Add(TEXT("Pop"));
+}
+
+void ULifeVairTerritorySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// The database has to be open before the table can be read
+	Collection.InitializeDependency<ULifeVairDatabaseSubsystem>();
+
+	RebuildTerritoryData();
+}
+
+void ULifeVairTerritorySubsystem::Deinitialize()
+{
+	OnTerritoryDataRebuilt.Clear();
+	Columns.Reset();
+	bIsReady = false;
+
+	Super::Deinitialize();
+}
+
+ULifeVairTerritorySubsystem* ULifeVairTerritorySubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<ULifeVairTerritorySubsystem>() : nullptr;
+}
+
+bool ULifeVairTerritorySubsystem::RebuildTerritoryData()
+{
+	const bool bBuilt = BuildTerritoryData();
+	OnTerritoryDataRebuilt.Broadcast();
+	return bBuilt;
+}
+
+bool ULifeVairTerritorySubsystem::BuildTerritoryData()
+{
+	Columns.Reset();
+	bIsReady = false;
+
+	ULifeVairDatabaseSubsystem* Database = GetGameInstance()->GetSubsystem<ULifeVairDatabaseSubsystem>();
+	if (!Database)
+	{
+		return false;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	// The snapshot is read in place, SQLite is only opened if it doesn't have the table
+	bool bBuilt = false;
+	const TCHAR* Source = TEXT("snapshot");
+	if (const FLifeVairDatabaseSnapshot* Snapshot = Database->GetSnapshot())
+	{
+		const FLifeVairSnapshotTable Table = Snapshot->FindTable(TerritoryTable);
+		bBuilt = Table.IsValid() && BuildFromSnapshot(Table);
+	}
+
+	if (!bBuilt)
+	{
+		Columns.Reset();
+		Source = TEXT("database");
+
+		if (!Database->EnsureDatabaseOpen())
+		{
+			UE_LOG(LogLifeVairTerritory, Warning, TEXT("No database open, territory data is empty"));
+			return false;
+		}
+
+		if (!BuildFromDatabase(*Database))
+		{
+			Columns.Reset();
+			return false;
+		}
+	}
+
+	Columns.BuildIndexes(PollutantMetricPrefixes);
+	bIsReady = true;
+
+	UE_LOG(LogLifeVairTerritory, Log, TEXT("Built territory data from the %s : %d territories, %d metrics, %d countries in %.2f ms"),
+		Source, Columns.NumRows, Columns.MetricNames.Num(), Columns.Countries.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	return true;
+}
+
+bool ULifeVairTerritorySubsystem::BuildFromDatabase(ULifeVairDatabaseSubsystem& Database)
+{
+	const FString Sql = FString::Printf(TEXT("select * from %s"), *LifeVairDatabase::QuoteIdentifier(TerritoryTable));
+
+	// Map the table columns to keys and metric columns once, rows then only read by index
+	const TArray<FString> TableColumns = Database.GetColumnNames(TerritoryTable);
+	if (TableColumns.Num() == 0)
+	{
+		UE_LOG(LogLifeVairTerritory, Warning, TEXT("Territory table %s is missing or has no columns"), *TerritoryTable);
+		return false;
+	}
+
+	const int32 TerritoryIndex = TableColumns.IndexOfByKey(TerritoryColumn);
+	const int32 CountryIndex = TableColumns.IndexOfByKey(CountryColumn);
+	const int32 TypeIndex = TableColumns.IndexOfByKey(TypeColumn);
+	const int32 ScaleIndex = TableColumns.IndexOfByKey(ScaleColumn);
+
+	if (TerritoryIndex == INDEX_NONE)
+	{
+		UE_LOG(LogLifeVairTerritory, Warning, TEXT("Territory table %s has no %s column"), *TerritoryTable, *TerritoryColumn);
+		return false;
+	}
+
+	// Table column of each metric
+	TArray<int32> MetricColumns;
+	for (int32 Column = 0; Column < TableColumns.Num(); ++Column)
+	{
+		if (IsKeyOrIgnoredColumn(TableColumns[Column]))
+		{
+			continue;
+		}
+
+		Columns.AddMetric(FName(*TableColumns[Column]));
+		MetricColumns.Add(Column);
+	}
+
+	FString Key;
+	auto ReadKey = [&Key](const FSQLitePreparedStatement& Row, int32 Column) -> FName
+	{
+		if (Column == INDEX_NONE || !Row.GetColumnValueByIndex(Column, Key))
+		{
+			return NAME_None;
+		}
+		return FName(*Key);
+	};
+
+	const int64 NumRows = Database.Execute(Sql, TArray<FString>(), [this, &ReadKey, &MetricColumns, TerritoryIndex, CountryIndex, TypeIndex, ScaleIndex](const FSQLitePreparedStatement& Row)
+	{
+		const int32 RowIndex = Columns.AddRow(ReadKey(Row, TerritoryIndex), ReadKey(Row, CountryIndex), ReadKey(Row, TypeIndex), ReadKey(Row, ScaleIndex));
+
+		for (int32 Metric = 0; Metric < MetricColumns.Num(); ++Metric)
+		{
+			// Null and non numeric cells read as 0
+			Row.GetColumnValueByIndex(MetricColumns[Metric], Columns.Metrics[Metric][RowIndex]);
+		}
+		return ESQLitePreparedStatementExecuteRowResult::Continue;
+	});
+
+	return NumRows != INDEX_NONE;
+}
+
+bool ULifeVairTerritorySubsystem::BuildFromSnapshot(const FLifeVairSnapshotTable& Table)
+{
+	const int32 TerritoryIndex = Table.FindColumn(TerritoryColumn);
+	if (TerritoryIndex == INDEX_NONE)
+	{
+		UE_LOG(LogLifeVairTerritory, Warning, TEXT("Territory table %s in the snapshot has no %s column"), *TerritoryTable, *TerritoryColumn);
+		return false;
+	}
+
+	const int32 CountryIndex = Table.FindColumn(CountryColumn);
+	const int32 TypeIndex = Table.FindColumn(TypeColumn);
+	const int32 ScaleIndex = Table.FindColumn(ScaleColumn);
+
+	// Rows first so that every metric column is added at its full size
+	const int32 NumRows = Table.GetNumRows();
+	for (int32 Row = 0; Row < NumRows; ++Row)
+	{
+		Columns.AddRow(Table.GetValueAsName(TerritoryIndex, Row),
+			CountryIndex != INDEX_NONE ? Table.GetValueAsName(CountryIndex, Row) : NAME_None,
+			TypeIndex != INDEX_NONE ? Table.GetValueAsName(TypeIndex, Row) : NAME_None,
+			ScaleIndex != INDEX_NONE ? Table.GetValueAsName(ScaleIndex, Row) : NAME_None);
+	}
+
+	for (int32 Column = 0; Column < Table.GetNumColumns(); ++Column)
+	{
+		const FString ColumnName = Table.GetColumnName(Column);
+		if (IsKeyOrIgnoredColumn(ColumnName))
+		{
+			continue;
+		}
+
+		TArray<double>& Values = Columns.Metrics[Columns.AddMetric(FName(*ColumnName))];
+		const TArrayView<const double> Numbers = Table.GetNumbers(Column);
+		if (Numbers.Num() == NumRows)
+		{
+			FMemory::Memcpy(Values.GetData(), Numbers.GetData(), NumRows * sizeof(double));
+		}
+		else
+		{
+			// A text column, converted the way SQLite would
+			for (int32 Row = 0; Row < NumRows; ++Row)
+			{
+				Values[Row] = FCString::Atod(*Table.GetValueAsString(Column, Row));
+			}
+		}
+	}
+	return true;
+}
+
+bool ULifeVairTerritorySubsystem::IsKeyOrIgnoredColumn(const FString& Column) const
+{
+	return Column == TerritoryColumn || Column == CountryColumn || Column == TypeColumn || Column == ScaleColumn || IgnoredColumns.Contains(Column);
+}
+
+FName ULifeVairTerritorySubsystem::GetTerritoryName(int32 Row) const
+{
+	return Columns.IsValidRow(Row) ? Columns.TerritoryNames[Row] : NAME_None;
+}
+
+FName ULifeVairTerritorySubsystem::GetTerritoryCountry(int32 Row) const
+{
+	return Columns.IsValidRow(Row) ? Columns.Countries[Columns.CountryCodes[Row]] : NAME_None;
+}
+
+FName ULifeVairTerritorySubsystem::GetTerritoryType(int32 Row) const
+{
+	return Columns.IsValidRow(Row) ? Columns.TerritoryTypes[Columns.TypeCodes[Row]] : NAME_None;
+}
+
+FName ULifeVairTerritorySubsystem::GetTerritoryScale(int32 Row) const
+{
+	return Columns.IsValidRow(Row) ? Columns.Scales[Columns.ScaleCodes[Row]] : NAME_None;
+}
+
+double ULifeVairTerritorySubsystem::GetTerritoryMetric(FName Territory, FName Metric) const
+{
+	return Columns.GetValue(Columns.FindRow(Territory), Columns.FindMetric(Metric));
+}
+
+TArray<int32> ULifeVairTerritorySubsystem::GetTerritoriesInCountry(FName Country) const
+{
+	return GetRowsInCountry(Country);
+}
+
+TArray<int32> ULifeVairTerritorySubsystem::GetTerritoriesOfType(FName TerritoryType) const
+{
+	return GetRowsOfType(TerritoryType);
+}
+
+TArray<int32> ULifeVairTerritorySubsystem::GetTerritoriesAtScale(FName Scale) const
+{
+	return GetRowsAtScale(Scale);
+}
+
+TArray<int32> ULifeVairTerritorySubsystem::GetPollutantMetrics(FName Pollutant) const
+{
+	const TArray<int32>* Metrics = Columns.MetricsByPollutant.Find(Pollutant);
+	return Metrics ? *Metrics : TArray<int32>();
+}
+
+TArray<FName> ULifeVairTerritorySubsystem::GetPollutants() const
+{
+	TArray<FName> Pollutants;
+	Columns.MetricsByPollutant.GetKeys(Pollutants);
+	return Pollutants;
+}
+
+const TArray<int32>& ULifeVairTerritorySubsystem::GetRowsInCountry(FName Country) const
+{
+	return LifeVairTerritory::FindRows(Columns.CountryByName, Columns.RowsByCountry, Country);
+}
+
+const TArray<int32>& ULifeVairTerritorySubsystem::GetRowsOfType(FName TerritoryType) const
+{
+	return LifeVairTerritory::FindRows(Columns.TypeByName, Columns.RowsByType, TerritoryType);
+}
+
+const TArray<int32>& ULifeVairTerritorySubsystem::GetRowsAtScale(FName Scale) const
+{
+	return LifeVairTerritory::FindRows(Columns.ScaleByName, Columns.RowsByScale, Scale);
+}
@@ -0,0 +1,202 @@
+// Copyright : OK
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "LifeVairTerritoryData.generated.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogLifeVairTerritory, Log, All);
+
+DECLARE_MULTICAST_DELEGATE(FLifeVairTerritoryDataRebuiltSignature);
+
+class ULifeVairDatabaseSubsystem;
+class FLifeVairSnapshotTable;
+
+/*
+ * Read only column store of the territory table.
+ * Every metric is one contiguous array indexed by row, the country/type/scale keys are stored as codes into small dictionaries
+ * so that filtering and aggregating never touches strings.
+ */
+struct LIFEVAIR_API FLifeVairTerritoryColumns
+{
+	int32 NumRows = 0;
+
+	// One per row, territory names are unique so the row is their code
+	TArray<FName> TerritoryNames;
+
+	// Key dictionaries, the row codes below index into these
+	TArray<FName> Countries;
+	TArray<FName> TerritoryTypes;
+	TArray<FName> Scales;
+
+	TArray<int32> CountryCodes;
+	TArray<int32> TypeCodes;
+	TArray<int32> ScaleCodes;
+
+	TArray<FName> MetricNames;
+
+	// Metrics[Metric][Row]
+	TArray<TArray<double>> Metrics;
+
+	// Indexes, rebuilt from the columns by BuildIndexes
+	TMap<FName, int32> RowByTerritory;
+	TMap<FName, int32> MetricByName;
+	TMap<FName, int32> CountryByName;
+	TMap<FName, int32> TypeByName;
+	TMap<FName, int32> ScaleByName;
+	TArray<TArray<int32>> RowsByCountry;
+	TArray<TArray<int32>> RowsByType;
+	TArray<TArray<int32>> RowsByScale;
+	TMap<FName, TArray<int32>> MetricsByPollutant;
+
+	void Reset();
+
+	/*Appends a row with every metric set to 0, returns its index*/
+	int32 AddRow(FName Territory, FName Country, FName TerritoryType, FName Scale);
+
+	/*Adds a metric column filled with 0 for the existing rows, returns its index*/
+	int32 AddMetric(FName Metric);
+
+	/*Rebuilds every index from the columns, PollutantPrefixes are the metric prefixes followed by a pollutant (Emi_NOx_Target, Pop_NO2_Immersion...)*/
+	void BuildIndexes(const TArray<FString>& PollutantPrefixes);
+
+	bool IsValidRow(int32 Row) const { return Row >= 0 && Row < NumRows; }
+	bool IsValidMetric(int32 Metric) const { return Metrics.IsValidIndex(Metric); }
+
+	int32 FindRow(FName Territory) const;
+	int32 FindMetric(FName Metric) const;
+
+	double GetValue(int32 Row, int32 Metric) const
+	{
+		return IsValidRow(Row) && IsValidMetric(Metric) ? Metrics[Metric][Row] : 0.0;
+	}
+
+	/*Sum of a metric over the given rows, invalid rows are skipped*/
+	double Sum(TArrayView<const int32> Rows, int32 Metric) const;
+
+	static const TArray<int32> EmptyRows;
+};
+
+/*
+ * Builds the territory column store once per game instance from the database subsystem and exposes indexed lookups to Blueprint.
+ * Rows and metrics are addressed by index so dashboards can look them up once and then read values without any per row allocation.
+ */
+UCLASS(Config = Game)
+class LIFEVAIR_API ULifeVairTerritorySubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	ULifeVairTerritorySubsystem();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	static ULifeVairTerritorySubsystem* Get(const UObject* WorldContextObject);
+
+	/*Table the store is built from*/
+	UPROPERTY(Config, EditAnywhere, Category = "LifeVair Territory")
+	FString TerritoryTable = TEXT("Territories");
+
+	/*Key columns, every other column is read as a metric unless listed in IgnoredColumns*/
+	UPROPERTY(Config, EditAnywhere, Category = "LifeVair Territory")
+	FString TerritoryColumn = TEXT("Territory");
+
+	UPROPERTY(Config, EditAnywhere, Category = "LifeVair Territory")
+	FString CountryColumn = TEXT("Country");
+
+	UPROPERTY(Config, EditAnywhere, Category = "LifeVair Territory")
+	FString TypeColumn = TEXT("Area_Type");
+
+	UPROPERTY(Config, EditAnywhere, Category = "LifeVair Territory")
+	FString ScaleColumn = TEXT("Scale");
+
+	UPROPERTY(Config, EditAnywhere, Category = "LifeVair Territory")
+	TArray<FString> IgnoredColumns;
+
+	/*Metric prefixes whose next part names a pollutant, used to build the pollutant index*/
+	UPROPERTY(Config, EditAnywhere, Category = "LifeVair Territory")
+	TArray<FString> PollutantMetricPrefixes;
+
+	/*Reads the whole territory table again, from the database snapshot when it has it, and rebuilds the indexes*/
+	UFUNCTION(BlueprintCallable, Category = "LifeVair Territory")
+	bool RebuildTerritoryData();
+
+	/*Called after every rebuild, successful or not. Row and metric indices looked up before it are no longer valid*/
+	FLifeVairTerritoryDataRebuiltSignature OnTerritoryDataRebuilt;
+
+	UFUNCTION(BlueprintPure, Category = "LifeVair Territory")
+	bool IsTerritoryDataReady() const { return bIsReady; }
+
+	UFUNCTION(BlueprintPure, Category = "LifeVair Territory")
+	int32 GetNumTerritories() const { return Columns.NumRows; }
+
+	/*Row of a territory, -1 if it isn't in the table*/
+	UFUNCTION(BlueprintPure, Category = "LifeVair Territory")
+	int32 FindTerritory(FName Territory) const { return Columns.FindRow(Territory); }
+
+	UFUNCTION(BlueprintPure, Category = "LifeVair Territory")
+	FName GetTerritoryName(int32 Row) const;
+
+	UFUNCTION(BlueprintPure, Category = "LifeVair Territory")
+	FName GetTerritoryCountry(int32 Row) const;
+
+	UFUNCTION(BlueprintPure, Category = "LifeVair Territory")
+	FName GetTerritoryType(int32 Row) const;
+
+	UFUNCTION(BlueprintPure, Category = "LifeVair Territory")
+	FName GetTerritoryScale(int32 Row) const;
+
+	UFUNCTION(BlueprintPure, Category = "LifeVair Territory")
+	TArray<FName> GetMetricNames() const { return Columns.MetricNames; }
+
+	/*Index of a metric column, -1 if there is none. Look it up once and use GetMetricValue in loops*/
+	UFUNCTION(BlueprintPure, Category = "LifeVair Territory")
+	int32 FindMetric(FName Metric) const { return Columns.FindMetric(Metric); }
+
+	UFUNCTION(BlueprintPure, Category = "LifeVair Territory")
+	double GetMetricValue(int32 Row, int32 Metric) const { return Columns.GetValue(Row, Metric); }
+
+	/*Convenience lookup by names, prefer FindTerritory/FindMetric + GetMetricValue when reading many values*/
+	UFUNCTION(BlueprintPure, Category = "LifeVair Territory")
+	double GetTerritoryMetric(FName Territory, FName Metric) const;
+
+	UFUNCTION(BlueprintPure, Category = "LifeVair Territory")
+	TArray<int32> GetTerritoriesInCountry(FName Country) const;
+
+	UFUNCTION(BlueprintPure, Category = "LifeVair Territory")
+	TArray<int32> GetTerritoriesOfType(FName TerritoryType) const;
+
+	UFUNCTION(BlueprintPure, Category = "LifeVair Territory")
+	TArray<int32> GetTerritoriesAtScale(FName Scale) const;
+
+	/*Metric columns about a pollutant (NOx, PM10, PM25...)*/
+	UFUNCTION(BlueprintPure, Category = "LifeVair Territory")
+	TArray<int32> GetPollutantMetrics(FName Pollutant) const;
+
+	UFUNCTION(BlueprintPure, Category = "LifeVair Territory")
+	TArray<FName> GetPollutants() const;
+
+	/*Sum of a metric over the given rows*/
+	UFUNCTION(BlueprintPure, Category = "LifeVair Territory")
+	double SumMetric(const TArray<int32>& Rows, int32 Metric) const { return Columns.Sum(Rows, Metric); }
+
+	/*Native access, the store stays valid until the next rebuild*/
+	const FLifeVairTerritoryColumns& GetColumns() const { return Columns; }
+
+	/*Native index lookups without copying the row lists*/
+	const TArray<int32>& GetRowsInCountry(FName Country) const;
+	const TArray<int32>& GetRowsOfType(FName TerritoryType) const;
+	const TArray<int32>& GetRowsAtScale(FName Scale) const;
+
+private:
+	bool BuildTerritoryData();
+	bool BuildFromDatabase(ULifeVairDatabaseSubsystem& Database);
+	bool BuildFromSnapshot(const FLifeVairSnapshotTable& Table);
+
+	bool IsKeyOrIgnoredColumn(const FString& Column) const;
+
+	FLifeVairTerritoryColumns Columns;
+	bool bIsReady = false;
+};
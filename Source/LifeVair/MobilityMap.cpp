@@ -1,2 +1,462 @@
 // Copyright : OK
 #include "MobilityMap.h"
+#include "MobilityStepComponent.h"
+#include "Algo/Reverse.h"
+#include "GameFramework/Actor.h"
+
+DEFINE_LOG_CATEGORY(LogLifeVairMobility);
+
+DECLARE_CYCLE_STAT(TEXT("LifeVair Mobility Rebuild Graph"), STAT_LifeVairMobilityRebuild, STATGROUP_Game);
+DECLARE_CYCLE_STAT(TEXT("LifeVair Mobility Find Route"), STAT_LifeVairMobilityFindRoute, STATGROUP_Game);
+
+namespace LifeVairMobility
+{
+	struct FQueuedStep
+	{
+		float Cost;
+		int32 Step;
+	};
+
+	// Min heap order for TArray::HeapPush / HeapPop
+	struct FQueuedStepLess
+	{
+		bool operator()(const FQueuedStep& A, const FQueuedStep& B) const { return A.Cost < B.Cost; }
+	};
+}
+
+UMobilityMap::UMobilityMap()
+{
+	auto AddMode = [this](FName Mode, float SpeedKmh, float EmissionsPerKm)
+	{
+		FMobilityTransportMode& TransportMode = TransportModes.AddDefaulted_GetRef();
+		TransportMode.Mode = Mode;
+		TransportMode.SpeedKmh = SpeedKmh;
+		TransportMode.EmissionsPerKm = EmissionsPerKm;
+	};
+	AddMode(TEXT("Walk"), 5.0f, 0.0f);
+	AddMode(TEXT("Bike"), 15.0f, 0.0f);
+	AddMode(TEXT("Bus"), 20.0f, 100.0f);
+	AddMode(TEXT("Car"), 40.0f, 200.0f);
+	AddMode(TEXT("Train"), 80.0f, 30.0f);
+}
+
+void UMobilityMap::OnRegister()
+{
+	Super::OnRegister();
+
+	MarkGraphDirty();
+}
+
+#if WITH_EDITOR
+void UMobilityMap::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	MarkGraphDirty();
+}
+#endif
+
+void UMobilityMap::EnsureGraph()
+{
+	if (bGraphDirty)
+	{
+		RebuildGraph();
+	}
+}
+
+void UMobilityMap::RebuildGraph()
+{
+	SCOPE_CYCLE_COUNTER(STAT_LifeVairMobilityRebuild);
+
+	bGraphDirty = false;
+	Steps.Reset();
+	StepIndices.Reset();
+	StepLocations.Reset();
+	ArrivingSteps.Reset();
+	EdgeOffsets.Reset();
+	EdgeTargets.Reset();
+	EdgeKilometers.Reset();
+	EdgeWeights.Reset();
+	RouteCaches.Reset();
+
+	const AActor* Owner = GetOwner();
+	if (!Owner)
+	{
+		return;
+	}
+
+	TInlineComponentArray<UMobilityStepComponent*> Components(Owner);
+	for (UMobilityStepComponent* Step : Components)
+	{
+		if (Step->IsRegistered())
+		{
+			StepIndices.Add(Step, Steps.Num());
+			Steps.Add(Step);
+			StepLocations.Add(Step->GetComponentLocation());
+			if (Step->ArrivingStep)
+			{
+				ArrivingSteps.Add(Steps.Num() - 1);
+			}
+		}
+	}
+
+	// Links go both ways whichever step declares them, links to steps of other actors are ignored
+	const int32 NumSteps = Steps.Num();
+	TArray<TArray<int32>> Neighbours;
+	Neighbours.SetNum(NumSteps);
+	for (int32 StepIndex = 0; StepIndex < NumSteps; ++StepIndex)
+	{
+		for (const UMobilityStepComponent* Adjacent : Steps[StepIndex]->AdjacentSteps)
+		{
+			const int32 AdjacentIndex = FindStep(Adjacent);
+			if (AdjacentIndex != INDEX_NONE && AdjacentIndex != StepIndex)
+			{
+				Neighbours[StepIndex].AddUnique(AdjacentIndex);
+				Neighbours[AdjacentIndex].AddUnique(StepIndex);
+			}
+		}
+	}
+
+	EdgeOffsets.Reserve(NumSteps + 1);
+	for (int32 StepIndex = 0; StepIndex < NumSteps; ++StepIndex)
+	{
+		EdgeOffsets.Add(EdgeTargets.Num());
+		Neighbours[StepIndex].Sort();
+		for (const int32 Target : Neighbours[StepIndex])
+		{
+			EdgeTargets.Add(Target);
+			EdgeKilometers.Add(FVector::Dist(StepLocations[StepIndex], StepLocations[Target]) * KilometersPerUnit);
+		}
+	}
+	EdgeOffsets.Add(EdgeTargets.Num());
+
+	// Time includes the stop at the step reached, so a route pays for every step after its start
+	EdgeWeights.SetNum(TransportModes.Num() * 2);
+	for (int32 ModeIndex = 0; ModeIndex < TransportModes.Num(); ++ModeIndex)
+	{
+		const FMobilityTransportMode& Mode = TransportModes[ModeIndex];
+		TArray<float>& TravelTimes = EdgeWeights[GetWeightsIndex(ModeIndex, EMobilityRouteCriterion::TravelTime)];
+		TArray<float>& Emissions = EdgeWeights[GetWeightsIndex(ModeIndex, EMobilityRouteCriterion::Emissions)];
+		TravelTimes.SetNumUninitialized(EdgeTargets.Num());
+		Emissions.SetNumUninitialized(EdgeTargets.Num());
+
+		for (int32 StepIndex = 0; StepIndex < NumSteps; ++StepIndex)
+		{
+			for (int32 Edge = EdgeOffsets[StepIndex]; Edge < EdgeOffsets[StepIndex + 1]; ++Edge)
+			{
+				const UMobilityStepComponent* Target = Steps[EdgeTargets[Edge]].Get();
+				const bool bAllowed = Steps[StepIndex]->AllowsMode(Mode.Mode) && Target->AllowsMode(Mode.Mode);
+				TravelTimes[Edge] = bAllowed ? EdgeKilometers[Edge] / FMath::Max(Mode.SpeedKmh, 0.1f) * 60.0f + Target->StopMinutes : MAX_flt;
+				Emissions[Edge] = bAllowed ? EdgeKilometers[Edge] * Mode.EmissionsPerKm : MAX_flt;
+			}
+		}
+	}
+
+	RouteCaches.SetNum(EdgeWeights.Num());
+	for (FRouteCache& Cache : RouteCaches)
+	{
+		Cache.Costs.SetNumUninitialized(NumSteps * NumSteps);
+		Cache.Previous.SetNumUninitialized(NumSteps * NumSteps);
+		Cache.SolvedSources.Init(false, NumSteps);
+	}
+
+	UE_LOG(LogLifeVairMobility, Log, TEXT("Built the mobility graph of %s : %d steps, %d links"), *GetNameSafe(Owner), NumSteps, EdgeTargets.Num() / 2);
+}
+
+int32 UMobilityMap::FindStep(const UMobilityStepComponent* Step) const
+{
+	const int32* Index = StepIndices.Find(Step);
+	return Index ? *Index : INDEX_NONE;
+}
+
+int32 UMobilityMap::FindMode(FName Mode) const
+{
+	return TransportModes.IndexOfByPredicate([Mode](const FMobilityTransportMode& TransportMode) { return TransportMode.Mode == Mode; });
+}
+
+int32 UMobilityMap::FindEdge(int32 From, int32 To) const
+{
+	for (int32 Edge = EdgeOffsets[From]; Edge < EdgeOffsets[From + 1]; ++Edge)
+	{
+		if (EdgeTargets[Edge] == To)
+		{
+			return Edge;
+		}
+	}
+	return INDEX_NONE;
+}
+
+void UMobilityMap::SolveFrom(int32 WeightsIndex, int32 Source)
+{
+	using namespace LifeVairMobility;
+
+	const int32 NumSteps = Steps.Num();
+	const TArray<float>& Weights = EdgeWeights[WeightsIndex];
+	FRouteCache& Cache = RouteCaches[WeightsIndex];
+	float* Costs = Cache.Costs.GetData() + Source * NumSteps;
+	int32* Previous = Cache.Previous.GetData() + Source * NumSteps;
+
+	for (int32 Step = 0; Step < NumSteps; ++Step)
+	{
+		Costs[Step] = MAX_flt;
+		Previous[Step] = INDEX_NONE;
+	}
+	Costs[Source] = 0.0f;
+
+	TArray<FQueuedStep, TInlineAllocator<64>> Queue;
+	Queue.HeapPush({ 0.0f, Source }, FQueuedStepLess());
+	while (Queue.Num() > 0)
+	{
+		FQueuedStep Current;
+		Queue.HeapPop(Current, FQueuedStepLess(), false);
+		if (Current.Cost > Costs[Current.Step])
+		{
+			continue;
+		}
+
+		for (int32 Edge = EdgeOffsets[Current.Step]; Edge < EdgeOffsets[Current.Step + 1]; ++Edge)
+		{
+			if (Weights[Edge] == MAX_flt)
+			{
+				continue;
+			}
+
+			const int32 Target = EdgeTargets[Edge];
+			const float Cost = Current.Cost + Weights[Edge];
+			if (Cost < Costs[Target])
+			{
+				Costs[Target] = Cost;
+				Previous[Target] = Current.Step;
+				Queue.HeapPush({ Cost, Target }, FQueuedStepLess());
+			}
+		}
+	}
+
+	Cache.SolvedSources[Source] = true;
+}
+
+bool UMobilityMap::FindPathFromCache(int32 WeightsIndex, int32 Source, int32 Target, TArray<int32>& OutPath)
+{
+	FRouteCache& Cache = RouteCaches[WeightsIndex];
+	if (!Cache.SolvedSources[Source])
+	{
+		SolveFrom(WeightsIndex, Source);
+	}
+
+	const int32 NumSteps = Steps.Num();
+	if (Cache.Costs[Source * NumSteps + Target] == MAX_flt)
+	{
+		return false;
+	}
+
+	OutPath.Reset();
+	for (int32 Step = Target; Step != INDEX_NONE; Step = Cache.Previous[Source * NumSteps + Step])
+	{
+		OutPath.Add(Step);
+	}
+	Algo::Reverse(OutPath);
+	return true;
+}
+
+bool UMobilityMap::FindPathAStar(int32 ModeIndex, EMobilityRouteCriterion Criterion, int32 Source, int32 Target, TArray<int32>& OutPath) const
+{
+	using namespace LifeVairMobility;
+
+	// Straight line cost to the target, never more than any route since edges are at least that long and stops only add time
+	const FMobilityTransportMode& Mode = TransportModes[ModeIndex];
+	const float CostPerKm = Criterion == EMobilityRouteCriterion::TravelTime ? 60.0f / FMath::Max(Mode.SpeedKmh, 0.1f) : Mode.EmissionsPerKm;
+	auto Heuristic = [this, Target, CostPerKm](int32 Step)
+	{
+		return FVector::Dist(StepLocations[Step], StepLocations[Target]) * KilometersPerUnit * CostPerKm;
+	};
+
+	const int32 NumSteps = Steps.Num();
+	const TArray<float>& Weights = EdgeWeights[GetWeightsIndex(ModeIndex, Criterion)];
+	TArray<float, TInlineAllocator<64>> Costs;
+	TArray<int32, TInlineAllocator<64>> Previous;
+	Costs.Init(MAX_flt, NumSteps);
+	Previous.Init(INDEX_NONE, NumSteps);
+	Costs[Source] = 0.0f;
+
+	TArray<FQueuedStep, TInlineAllocator<64>> Queue;
+	Queue.HeapPush({ Heuristic(Source), Source }, FQueuedStepLess());
+	while (Queue.Num() > 0)
+	{
+		FQueuedStep Current;
+		Queue.HeapPop(Current, FQueuedStepLess(), false);
+		if (Current.Step == Target)
+		{
+			break;
+		}
+		if (Current.Cost > Costs[Current.Step] + Heuristic(Current.Step))
+		{
+			continue;
+		}
+
+		for (int32 Edge = EdgeOffsets[Current.Step]; Edge < EdgeOffsets[Current.Step + 1]; ++Edge)
+		{
+			if (Weights[Edge] == MAX_flt)
+			{
+				continue;
+			}
+
+			const int32 Next = EdgeTargets[Edge];
+			const float Cost = Costs[Current.Step] + Weights[Edge];
+			if (Cost < Costs[Next])
+			{
+				Costs[Next] = Cost;
+				Previous[Next] = Current.Step;
+				Queue.HeapPush({ Cost + Heuristic(Next), Next }, FQueuedStepLess());
+			}
+		}
+	}
+
+	if (Costs[Target] == MAX_flt)
+	{
+		return false;
+	}
+
+	OutPath.Reset();
+	for (int32 Step = Target; Step != INDEX_NONE; Step = Previous[Step])
+	{
+		OutPath.Add(Step);
+	}
+	Algo::Reverse(OutPath);
+	return true;
+}
+
+FMobilityRoute UMobilityMap::MakeRoute(const TArray<int32>& Path, int32 ModeIndex) const
+{
+	FMobilityRoute Route;
+	for (int32 Index = 0; Index < Path.Num(); ++Index)
+	{
+		Route.Steps.Add(Steps[Path[Index]].Get());
+		if (Index == 0)
+		{
+			continue;
+		}
+
+		const int32 Edge = FindEdge(Path[Index - 1], Path[Index]);
+		const float TravelMinutes = Edge != INDEX_NONE ? EdgeWeights[GetWeightsIndex(ModeIndex, EMobilityRouteCriterion::TravelTime)][Edge] : MAX_flt;
+		if (TravelMinutes == MAX_flt)
+		{
+			return FMobilityRoute();
+		}
+
+		Route.TravelMinutes += TravelMinutes;
+		Route.Emissions += EdgeWeights[GetWeightsIndex(ModeIndex, EMobilityRouteCriterion::Emissions)][Edge];
+		Route.Kilometers += EdgeKilometers[Edge];
+	}
+	Route.bFound = Path.Num() > 0;
+	return Route;
+}
+
+FMobilityRoute UMobilityMap::FindRoute(UMobilityStepComponent* From, UMobilityStepComponent* To, FName Mode, EMobilityRouteCriterion Criterion)
+{
+	SCOPE_CYCLE_COUNTER(STAT_LifeVairMobilityFindRoute);
+
+	EnsureGraph();
+
+	const int32 Source = FindStep(From);
+	const int32 Target = FindStep(To);
+	const int32 ModeIndex = FindMode(Mode);
+	if (Source == INDEX_NONE || Target == INDEX_NONE || ModeIndex == INDEX_NONE)
+	{
+		UE_LOG(LogLifeVairMobility, Warning, TEXT("Can't find a route from %s to %s by %s, unknown step or mode"), *GetNameSafe(From), *GetNameSafe(To), *Mode.ToString());
+		return FMobilityRoute();
+	}
+
+	TArray<int32> Path;
+	const bool bFound = bCacheRoutes
+		? FindPathFromCache(GetWeightsIndex(ModeIndex, Criterion), Source, Target, Path)
+		: FindPathAStar(ModeIndex, Criterion, Source, Target, Path);
+	return bFound ? MakeRoute(Path, ModeIndex) : FMobilityRoute();
+}
+
+FMobilityRoute UMobilityMap::FindRouteToArrival(UMobilityStepComponent* From, FName Mode, EMobilityRouteCriterion Criterion)
+{
+	SCOPE_CYCLE_COUNTER(STAT_LifeVairMobilityFindRoute);
+
+	EnsureGraph();
+
+	const int32 Source = FindStep(From);
+	const int32 ModeIndex = FindMode(Mode);
+	if (Source == INDEX_NONE || ModeIndex == INDEX_NONE)
+	{
+		UE_LOG(LogLifeVairMobility, Warning, TEXT("Can't find a route from %s by %s, unknown step or mode"), *GetNameSafe(From), *Mode.ToString());
+		return FMobilityRoute();
+	}
+
+	// One Dijkstra from the start reaches every arriving step, so this always goes through the cache
+	const int32 WeightsIndex = GetWeightsIndex(ModeIndex, Criterion);
+	FRouteCache& Cache = RouteCaches[WeightsIndex];
+	if (!Cache.SolvedSources[Source])
+	{
+		SolveFrom(WeightsIndex, Source);
+	}
+
+	int32 BestArrival = INDEX_NONE;
+	for (const int32 Arrival : ArrivingSteps)
+	{
+		const float Cost = Cache.Costs[Source * Steps.Num() + Arrival];
+		if (Cost != MAX_flt && (BestArrival == INDEX_NONE || Cost < Cache.Costs[Source * Steps.Num() + BestArrival]))
+		{
+			BestArrival = Arrival;
+		}
+	}
+
+	TArray<int32> Path;
+	return BestArrival != INDEX_NONE && FindPathFromCache(WeightsIndex, Source, BestArrival, Path) ? MakeRoute(Path, ModeIndex) : FMobilityRoute();
+}
+
+FMobilityRoute UMobilityMap::EvaluateRoute(const TArray<UMobilityStepComponent*>& Route, FName Mode)
+{
+	EnsureGraph();
+
+	const int32 ModeIndex = FindMode(Mode);
+	if (ModeIndex == INDEX_NONE)
+	{
+		return FMobilityRoute();
+	}
+
+	TArray<int32> Path;
+	Path.Reserve(Route.Num());
+	for (const UMobilityStepComponent* Step : Route)
+	{
+		const int32 StepIndex = FindStep(Step);
+		if (StepIndex == INDEX_NONE)
+		{
+			return FMobilityRoute();
+		}
+		Path.Add(StepIndex);
+	}
+
+	// Not adjacent or not allowed steps make MakeRoute return a route that isn't found
+	return MakeRoute(Path, ModeIndex);
+}
+
+TArray<UMobilityStepComponent*> UMobilityMap::GetSteps()
+{
+	EnsureGraph();
+
+	TArray<UMobilityStepComponent*> Result;
+	Result.Reserve(Steps.Num());
+	for (const TWeakObjectPtr<UMobilityStepComponent>& Step : Steps)
+	{
+		Result.Add(Step.Get());
+	}
+	return Result;
+}
+
+TArray<UMobilityStepComponent*> UMobilityMap::GetArrivingSteps()
+{
+	EnsureGraph();
+
+	TArray<UMobilityStepComponent*> Result;
+	Result.Reserve(ArrivingSteps.Num());
+	for (const int32 Arrival : ArrivingSteps)
+	{
+		Result.Add(Steps[Arrival].Get());
+	}
+	return Result;
+}
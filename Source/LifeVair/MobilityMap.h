@@ -4,15 +4,150 @@
 
 #include "CoreMinimal.h"
 #include "Components/StaticMeshComponent.h"
+#include "UObject/ObjectKey.h"
 #include "MobilityMap.generated.h"
 
-/**
- * 
+class UMobilityStepComponent;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogLifeVairMobility, Log, All);
+
+UENUM(BlueprintType)
+enum class EMobilityRouteCriterion : uint8
+{
+	/*Fastest route, in minutes*/
+	TravelTime,
+	/*Route emitting the least, in grams of CO2*/
+	Emissions
+};
+
+/*A way of travelling between steps, costs scale with the distance between steps*/
+USTRUCT(BlueprintType)
+struct LIFEVAIR_API FMobilityTransportMode
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mobility")
+	FName Mode;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mobility", meta = (ClampMin = "0.1"))
+	float SpeedKmh = 5.0f;
+
+	/*Grams of CO2 per km travelled*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mobility", meta = (ClampMin = "0.0"))
+	float EmissionsPerKm = 0.0f;
+};
+
+USTRUCT(BlueprintType)
+struct LIFEVAIR_API FMobilityRoute
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Mobility")
+	bool bFound = false;
+
+	/*Steps from the start to the destination, both included*/
+	UPROPERTY(BlueprintReadOnly, Category = "Mobility")
+	TArray<TObjectPtr<UMobilityStepComponent>> Steps;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Mobility")
+	float TravelMinutes = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Mobility")
+	float Emissions = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Mobility")
+	float Kilometers = 0.0f;
+};
+
+/*
+ * Map of the mobility riddle. Builds a route graph from the UMobilityStepComponents of its actor, stored as compact adjacency
+ * arrays with one edge weight array per transport mode and criterion. Shortest routes are cached per start step (one Dijkstra fills
+ * the routes to every step), the graph and the cache are only rebuilt when a step changes.
  */
-UCLASS()
+UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class LIFEVAIR_API UMobilityMap : public UStaticMeshComponent
 {
 	GENERATED_BODY()
+
 public:
-	
+	UMobilityMap();
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Mobility")
+	TArray<FMobilityTransportMode> TransportModes;
+
+	/*Km represented by one world unit of the map*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Mobility", meta = (ClampMin = "0.0"))
+	float KilometersPerUnit = 0.1f;
+
+	/*Keeps the routes from every start step queried, otherwise each query runs its own A* search*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Mobility")
+	bool bCacheRoutes = true;
+
+	/*Rebuilds the graph on the next query, called by the steps when they change*/
+	UFUNCTION(BlueprintCallable, Category = "Mobility")
+	void MarkGraphDirty() { bGraphDirty = true; }
+
+	UFUNCTION(BlueprintCallable, Category = "Mobility")
+	void RebuildGraph();
+
+	/*Best route between two steps of this map for a transport mode*/
+	UFUNCTION(BlueprintCallable, Category = "Mobility")
+	FMobilityRoute FindRoute(UMobilityStepComponent* From, UMobilityStepComponent* To, FName Mode, EMobilityRouteCriterion Criterion);
+
+	/*Best route from a step to the closest arriving step*/
+	UFUNCTION(BlueprintCallable, Category = "Mobility")
+	FMobilityRoute FindRouteToArrival(UMobilityStepComponent* From, FName Mode, EMobilityRouteCriterion Criterion);
+
+	/*Costs of a route placed by the player, not found when two consecutive steps aren't adjacent or the mode can't stop at one of them*/
+	UFUNCTION(BlueprintCallable, Category = "Mobility")
+	FMobilityRoute EvaluateRoute(const TArray<UMobilityStepComponent*>& Route, FName Mode);
+
+	UFUNCTION(BlueprintCallable, Category = "Mobility")
+	TArray<UMobilityStepComponent*> GetSteps();
+
+	UFUNCTION(BlueprintCallable, Category = "Mobility")
+	TArray<UMobilityStepComponent*> GetArrivingSteps();
+
+protected:
+	virtual void OnRegister() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+	// Shortest routes of one mode and criterion, Costs and Previous are [Source * NumSteps + Target]
+	struct FRouteCache
+	{
+		TArray<float> Costs;
+		TArray<int32> Previous;
+		TBitArray<> SolvedSources;
+	};
+
+	void EnsureGraph();
+	int32 FindStep(const UMobilityStepComponent* Step) const;
+	int32 FindMode(FName Mode) const;
+	int32 FindEdge(int32 From, int32 To) const;
+	int32 GetWeightsIndex(int32 ModeIndex, EMobilityRouteCriterion Criterion) const { return ModeIndex * 2 + int32(Criterion); }
+
+	void SolveFrom(int32 WeightsIndex, int32 Source);
+	bool FindPathFromCache(int32 WeightsIndex, int32 Source, int32 Target, TArray<int32>& OutPath);
+	bool FindPathAStar(int32 ModeIndex, EMobilityRouteCriterion Criterion, int32 Source, int32 Target, TArray<int32>& OutPath) const;
+	FMobilityRoute MakeRoute(const TArray<int32>& Path, int32 ModeIndex) const;
+
+	bool bGraphDirty = true;
+
+	TArray<TWeakObjectPtr<UMobilityStepComponent>> Steps;
+	TMap<TObjectKey<UMobilityStepComponent>, int32> StepIndices;
+	TArray<FVector> StepLocations;
+	TArray<int32> ArrivingSteps;
+
+	// Edges of step i are EdgeTargets[EdgeOffsets[i] .. EdgeOffsets[i + 1]]
+	TArray<int32> EdgeOffsets;
+	TArray<int32> EdgeTargets;
+	TArray<float> EdgeKilometers;
+
+	// Edge weights per mode and criterion (GetWeightsIndex), MAX_flt where the mode can't take the edge
+	TArray<TArray<float>> EdgeWeights;
+	TArray<FRouteCache> RouteCaches;
 };
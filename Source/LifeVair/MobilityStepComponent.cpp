@@ -2,3 +2,66 @@
 
 
 #include "MobilityStepComponent.h"
+#include "MobilityMap.h"
+#include "GameFramework/Actor.h"
+
+void UMobilityStepComponent::SetAdjacentSteps(const TArray<UMobilityStepComponent*>& Steps)
+{
+	AdjacentSteps = Steps;
+	NotifyMap();
+}
+
+void UMobilityStepComponent::AddAdjacentStep(UMobilityStepComponent* Step)
+{
+	if (Step && Step != this && !AdjacentSteps.Contains(Step))
+	{
+		AdjacentSteps.Add(Step);
+		NotifyMap();
+	}
+}
+
+void UMobilityStepComponent::SetArrivingStep(bool bArriving)
+{
+	if (ArrivingStep != bArriving)
+	{
+		ArrivingStep = bArriving;
+		NotifyMap();
+	}
+}
+
+UMobilityMap* UMobilityStepComponent::GetMobilityMap() const
+{
+	const AActor* Owner = GetOwner();
+	return Owner ? Owner->FindComponentByClass<UMobilityMap>() : nullptr;
+}
+
+void UMobilityStepComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	NotifyMap();
+}
+
+void UMobilityStepComponent::OnUnregister()
+{
+	NotifyMap();
+
+	Super::OnUnregister();
+}
+
+#if WITH_EDITOR
+void UMobilityStepComponent::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	NotifyMap();
+}
+#endif
+
+void UMobilityStepComponent::NotifyMap() const
+{
+	if (UMobilityMap* Map = GetMobilityMap())
+	{
+		Map->MarkGraphDirty();
+	}
+}
@@ -6,17 +6,56 @@
 #include "Components/StaticMeshComponent.h"
 #include "MobilityStepComponent.generated.h"
 
-/**
- * 
- */
-UCLASS()
+class UMobilityMap;
+
+/*A step of the mobility riddle map, linked to its adjacent steps. The UMobilityMap of its actor builds the route graph from them*/
+UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class LIFEVAIR_API UMobilityStepComponent : public UStaticMeshComponent
 {
 	GENERATED_BODY()
 
-	/*UPROPERTY(EditDefaultsOnly,Category = "Step Settings")
-	bool ArrivingStep;
+public:
+	/*Destination of a journey*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Step Settings")
+	bool ArrivingStep = false;
+
+	/*Steps reachable from this one, links go both ways*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Step Settings")
+	TArray<TObjectPtr<UMobilityStepComponent>> AdjacentSteps;
+
+	/*Transport modes that can stop here, empty for every mode of the map*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Step Settings")
+	TArray<FName> AllowedModes;
+
+	/*Minutes lost when a journey goes through this step (waiting, changing)*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Step Settings", meta = (ClampMin = "0.0"))
+	float StopMinutes = 0.0f;
+
+	UFUNCTION(BlueprintCallable, Category = "Step Settings")
+	void SetAdjacentSteps(const TArray<UMobilityStepComponent*>& Steps);
+
+	UFUNCTION(BlueprintCallable, Category = "Step Settings")
+	void AddAdjacentStep(UMobilityStepComponent* Step);
+
+	UFUNCTION(BlueprintCallable, Category = "Step Settings")
+	void SetArrivingStep(bool bArriving);
+
+	UFUNCTION(BlueprintPure, Category = "Step Settings")
+	bool AllowsMode(FName Mode) const { return AllowedModes.Num() == 0 || AllowedModes.Contains(Mode); }
+
+	/*Map of the actor owning this step*/
+	UFUNCTION(BlueprintPure, Category = "Step Settings")
+	UMobilityMap* GetMobilityMap() const;
+
+protected:
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
 
-	UPROPERTY(EditDefaultsOnly,Category = "Step Settings")
-	TArray<UMobilityStepComponent*> AdjacentSteps;*/
+private:
+	// Step settings changed, the map graph has to be rebuilt
+	void NotifyMap() const;
 };
@@ -10,6 +10,6 @@ public class LifeVairEditorTarget : TargetRules
 		Type = TargetType.Editor;
 		DefaultBuildSettings = BuildSettingsVersion.V2;
 
-		ExtraModuleNames.AddRange(new string[] { "LifeVair" });
+		ExtraModuleNames.AddRange(new string[] { "LifeVair", "LifeVairEditor" });
 	}
 }
\ No newline at end of file
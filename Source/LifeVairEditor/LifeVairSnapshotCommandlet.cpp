@@ -0,0 +1,32 @@
+// Copyright : OK
+
+#include "LifeVairSnapshotCommandlet.h"
+#include "LifeVairDatabaseSnapshot.h"
+#include "LifeVairDatabaseSubsystem.h"
+#include "LifeVairTerritoryData.h"
+#include "Misc/Parse.h"
+
+ULifeVairSnapshotCommandlet::ULifeVairSnapshotCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 ULifeVairSnapshotCommandlet::Main(const FString& Params)
+{
+	const ULifeVairDatabaseSubsystem* DatabaseSettings = GetDefault<ULifeVairDatabaseSubsystem>();
+	const ULifeVairTerritorySubsystem* TerritorySettings = GetDefault<ULifeVairTerritorySubsystem>();
+
+	FString DatabasePath = DatabaseSettings->DatabaseFile;
+	FString SnapshotPath = DatabaseSettings->SnapshotFile;
+	FParse::Value(*Params, TEXT("Database="), DatabasePath);
+	FParse::Value(*Params, TEXT("Output="), SnapshotPath);
+
+	TArray<FString> Tables = DatabaseSettings->SnapshotTables;
+	Tables.AddUnique(TerritorySettings->TerritoryTable);
+
+	const bool bExported = LifeVairSnapshot::Export(ULifeVairDatabaseSubsystem::ResolveDatabasePath(DatabasePath), Tables, ULifeVairDatabaseSubsystem::ResolveDatabasePath(SnapshotPath));
+	return bExported ? 0 : 1;
+}
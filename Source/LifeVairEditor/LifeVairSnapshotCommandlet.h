@@ -0,0 +1,23 @@
+// Copyright : OK
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "LifeVairSnapshotCommandlet.generated.h"
+
+/*
+ * Exports the snapshot tables of the database to the binary snapshot loaded at startup. Run it before cooking whenever the database changes :
+ * UnrealEditor-Cmd LifeVair.uproject -run=LifeVairSnapshot [-Database=<path>] [-Output=<path>]
+ * Paths default to the DatabaseFile and SnapshotFile of the database subsystem.
+ */
+UCLASS()
+class LIFEVAIREDITOR_API ULifeVairSnapshotCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	ULifeVairSnapshotCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};